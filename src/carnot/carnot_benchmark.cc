@@ -0,0 +1,701 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// An end-to-end benchmark of Carnot on synthetic observability data.
+//
+// Generates tables shaped like the Stirling http_events, conn_stats, process_stats and
+// stack_traces tables, and runs a fixed catalogue of PxL scripts modeled on the px/* scripts
+// against them through the standalone Carnot path. Besides time per query, every benchmark
+// reports:
+//   rows_per_sec:        input rows scanned per second of query wall time.
+//   peak_rss_bytes:      the peak resident set size of the process while running queries.
+//   query_rss_bytes:     the growth of the peak RSS over the RSS before running queries, i.e.
+//                        the query working set on top of the generated tables.
+//   op_<pf>_<id>_self_ms: the average self time of each operator, keyed by plan fragment and
+//                        node id (the operator names are logged by Carnot in analyze mode).
+//
+// Regression comparison: save the output of a run with
+//   --benchmark_out=baseline.json --benchmark_out_format=json
+// and pass it to a later run with --carnot_benchmark_baseline=baseline.json. Every benchmark
+// then also reports baseline_ratio (rows_per_sec relative to the baseline), and logs a warning
+// when it falls below 1 - --carnot_benchmark_regression_threshold.
+//
+// The 100M row cases need tens of GB of memory and are skipped unless
+// --carnot_benchmark_max_rows is raised.
+
+#include <benchmark/benchmark.h>
+#include <rapidjson/document.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/strings/ascii.h>
+#include <absl/strings/numbers.h>
+#include <absl/strings/strip.h>
+#include <sole.hpp>
+
+#include "src/carnot/carnot.h"
+#include "src/carnot/exec/local_grpc_result_server.h"
+#include "src/carnot/funcs/funcs.h"
+#include "src/carnot/udf/registry.h"
+#include "src/common/base/base.h"
+#include "src/common/datagen/datagen.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/table_store.h"
+
+DEFINE_int64(carnot_benchmark_max_rows,
+             gflags::Int64FromEnv("PL_CARNOT_BENCHMARK_MAX_ROWS", 10 * 1000 * 1000),
+             "Benchmarks on tables with more rows than this are skipped.");
+
+DEFINE_string(carnot_benchmark_baseline, gflags::StringFromEnv("PL_CARNOT_BENCHMARK_BASELINE", ""),
+              "The JSON output (--benchmark_out) of a previous run to compare throughput against.");
+
+DEFINE_double(carnot_benchmark_regression_threshold,
+              gflags::DoubleFromEnv("PL_CARNOT_BENCHMARK_REGRESSION_THRESHOLD", 0.1),
+              "The relative drop in rows_per_sec from the baseline that is flagged as a "
+              "regression.");
+
+DEFINE_bool(carnot_benchmark_operator_stats,
+            gflags::BoolFromEnv("PL_CARNOT_BENCHMARK_OPERATOR_STATS", true),
+            "Whether to run queries in analyze mode and report per-operator time.");
+
+namespace px {
+namespace carnot {
+namespace {
+
+using table_store::Table;
+using table_store::TableStore;
+using table_store::schema::Relation;
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+using types::DataType;
+
+constexpr int64_t kRowsPerBatch = 10000;
+
+// All tables cover the same hour of data, so that time windows line up across tables.
+constexpr int64_t kStartTimeNS = 1600000000LL * 1000 * 1000 * 1000;
+constexpr int64_t kTimeSpanNS = 3600LL * 1000 * 1000 * 1000;
+
+constexpr int kNumServices = 50;
+constexpr int kNumUPIDs = 500;
+constexpr int kNumRemoteAddrs = 1000;
+constexpr int kNumReqPaths = 200;
+constexpr int kNumStackTraces = 5000;
+
+//-----------------------------------------------------------------------------
+// Data generation
+//-----------------------------------------------------------------------------
+
+// Every UPID belongs to one service, so per-UPID and per-service results agree across tables.
+std::string ServiceName(int upid_idx) {
+  return absl::Substitute("px-sock-shop/service-$0", upid_idx % kNumServices);
+}
+
+types::UInt128Value UPIDValue(int upid_idx) {
+  return types::UInt128Value(/*asid*/ 1, static_cast<uint64_t>(upid_idx));
+}
+
+std::string RemoteAddr(int idx) {
+  return absl::Substitute("10.$0.$1.$2", idx / 65536, (idx / 256) % 256, idx % 256);
+}
+
+std::string ReqPath(int idx) { return absl::Substitute("/api/v1/resource-$0/items", idx); }
+
+std::string StackTrace(int idx) {
+  return absl::Substitute("main;runtime.goexit;net/http.(*conn).serve;handler_$0;work_$1", idx % 97,
+                          idx);
+}
+
+std::unique_ptr<datagen::IntGenerator> Uniform(int max, uint32_t seed) {
+  datagen::UniformParams params(0, max);
+  auto gen = std::make_unique<datagen::UniformGenerator>(&params);
+  gen->Seed(seed);
+  return gen;
+}
+
+std::unique_ptr<datagen::IntGenerator> Zipfian(int max, uint32_t seed) {
+  datagen::ZipfianParams params(/*zipf_q*/ 2, /*zipf_v*/ 2, max);
+  auto gen = std::make_unique<datagen::ZipfianGenerator>(&params);
+  gen->Seed(seed);
+  return gen;
+}
+
+std::unique_ptr<datagen::IntGenerator> Normal(double sigma, int max, uint32_t seed) {
+  datagen::NormalParams params(sigma, max);
+  auto gen = std::make_unique<datagen::NormalGenerator>(&params);
+  gen->Seed(seed);
+  return gen;
+}
+
+template <typename... TColumns>
+Status WriteBatch(Table* table, const Relation& relation, const TColumns&... columns) {
+  std::vector<std::shared_ptr<arrow::Array>> arrays = {
+      types::ToArrow(columns, arrow::default_memory_pool())...};
+  RowBatch rb(RowDescriptor(relation.col_types()), arrays[0]->length());
+  for (auto& array : arrays) {
+    PL_RETURN_IF_ERROR(rb.AddColumn(array));
+  }
+  return table->WriteRowBatch(rb);
+}
+
+// Generates num_rows rows, kRowsPerBatch at a time. gen_batch(first_row, batch_rows) must
+// write a single batch to the table.
+template <typename TGenBatchFn>
+StatusOr<std::shared_ptr<Table>> GenerateTable(std::string_view name, const Relation& relation,
+                                               int64_t num_rows, TGenBatchFn gen_batch) {
+  auto table = std::make_shared<Table>(name, relation, std::numeric_limits<int64_t>::max());
+  for (int64_t first_row = 0; first_row < num_rows; first_row += kRowsPerBatch) {
+    int64_t batch_rows = std::min(kRowsPerBatch, num_rows - first_row);
+    PL_RETURN_IF_ERROR(gen_batch(table.get(), first_row, batch_rows));
+  }
+  return table;
+}
+
+types::Time64NSValue RowTime(int64_t row, int64_t num_rows) {
+  return kStartTimeNS + static_cast<int64_t>(static_cast<double>(row) / num_rows * kTimeSpanNS);
+}
+
+StatusOr<std::shared_ptr<Table>> GenerateHTTPEvents(int64_t num_rows) {
+  Relation relation(
+      {DataType::TIME64NS, DataType::UINT128, DataType::STRING, DataType::STRING, DataType::STRING,
+       DataType::INT64, DataType::INT64, DataType::INT64, DataType::STRING},
+      {"time_", "upid", "remote_addr", "req_method", "req_path", "resp_status", "resp_body_size",
+       "latency", "service"});
+
+  auto upid_gen = Uniform(kNumUPIDs - 1, 1);
+  auto addr_gen = Zipfian(kNumRemoteAddrs - 1, 2);
+  auto path_gen = Zipfian(kNumReqPaths - 1, 3);
+  auto pct_gen = Uniform(99, 4);
+  auto size_gen = Normal(/*sigma*/ 2000, /*max*/ 8192, 5);
+  auto latency_gen = Normal(/*sigma*/ 2 * 1000 * 1000, /*max*/ 10 * 1000 * 1000, 6);
+
+  return GenerateTable(
+      "http_events", relation, num_rows, [&](Table* table, int64_t first_row, int64_t n) {
+        std::vector<types::Time64NSValue> time(n);
+        std::vector<types::UInt128Value> upid(n);
+        std::vector<types::StringValue> remote_addr(n);
+        std::vector<types::StringValue> req_method(n);
+        std::vector<types::StringValue> req_path(n);
+        std::vector<types::Int64Value> resp_status(n);
+        std::vector<types::Int64Value> resp_body_size(n);
+        std::vector<types::Int64Value> latency(n);
+        std::vector<types::StringValue> service(n);
+
+        for (int64_t i = 0; i < n; ++i) {
+          int upid_idx = upid_gen->Generate();
+          int pct = pct_gen->Generate();
+          time[i] = RowTime(first_row + i, num_rows);
+          upid[i] = UPIDValue(upid_idx);
+          remote_addr[i] = RemoteAddr(addr_gen->Generate());
+          req_method[i] = pct < 70 ? "GET" : pct < 95 ? "POST" : "PUT";
+          req_path[i] = ReqPath(path_gen->Generate());
+          resp_status[i] = pct < 95 ? 200 : pct < 98 ? 404 : 503;
+          resp_body_size[i] = std::max(0, size_gen->Generate());
+          // A long tail of slow requests on top of the normally distributed latencies.
+          latency[i] = std::max(0, latency_gen->Generate()) * (pct == 0 ? 20 : 1);
+          service[i] = ServiceName(upid_idx);
+        }
+        return WriteBatch(table, relation, time, upid, remote_addr, req_method, req_path,
+                          resp_status, resp_body_size, latency, service);
+      });
+}
+
+StatusOr<std::shared_ptr<Table>> GenerateConnStats(int64_t num_rows) {
+  Relation relation({DataType::TIME64NS, DataType::UINT128, DataType::STRING, DataType::INT64,
+                     DataType::INT64, DataType::INT64, DataType::INT64, DataType::INT64,
+                     DataType::STRING},
+                    {"time_", "upid", "remote_addr", "remote_port", "trace_role", "conn_open",
+                     "bytes_sent", "bytes_recv", "service"});
+
+  auto upid_gen = Uniform(kNumUPIDs - 1, 11);
+  auto addr_gen = Zipfian(kNumRemoteAddrs - 1, 12);
+  auto role_gen = Uniform(1, 13);
+  auto bytes_gen = Normal(/*sigma*/ 100000, /*max*/ 1000000, 14);
+
+  return GenerateTable(
+      "conn_stats", relation, num_rows, [&](Table* table, int64_t first_row, int64_t n) {
+        std::vector<types::Time64NSValue> time(n);
+        std::vector<types::UInt128Value> upid(n);
+        std::vector<types::StringValue> remote_addr(n);
+        std::vector<types::Int64Value> remote_port(n);
+        std::vector<types::Int64Value> trace_role(n);
+        std::vector<types::Int64Value> conn_open(n);
+        std::vector<types::Int64Value> bytes_sent(n);
+        std::vector<types::Int64Value> bytes_recv(n);
+        std::vector<types::StringValue> service(n);
+
+        for (int64_t i = 0; i < n; ++i) {
+          int64_t row = first_row + i;
+          int upid_idx = upid_gen->Generate();
+          int addr_idx = addr_gen->Generate();
+          time[i] = RowTime(row, num_rows);
+          upid[i] = UPIDValue(upid_idx);
+          remote_addr[i] = RemoteAddr(addr_idx);
+          remote_port[i] = 8000 + addr_idx % 100;
+          trace_role[i] = 1 + role_gen->Generate();
+          // conn_stats columns are cumulative counters.
+          conn_open[i] = 1 + row / kNumUPIDs;
+          bytes_sent[i] = row / kNumUPIDs * 1000 + std::max(0, bytes_gen->Generate());
+          bytes_recv[i] = row / kNumUPIDs * 4000 + std::max(0, bytes_gen->Generate());
+          service[i] = ServiceName(upid_idx);
+        }
+        return WriteBatch(table, relation, time, upid, remote_addr, remote_port, trace_role,
+                          conn_open, bytes_sent, bytes_recv, service);
+      });
+}
+
+StatusOr<std::shared_ptr<Table>> GenerateProcessStats(int64_t num_rows) {
+  Relation relation({DataType::TIME64NS, DataType::UINT128, DataType::INT64, DataType::INT64,
+                     DataType::INT64, DataType::INT64, DataType::INT64, DataType::INT64,
+                     DataType::STRING},
+                    {"time_", "upid", "cpu_utime_ns", "cpu_ktime_ns", "rss_bytes", "vsize_bytes",
+                     "read_bytes", "write_bytes", "service"});
+
+  auto cpu_gen = Normal(/*sigma*/ 1000000, /*max*/ 10000000, 21);
+  auto mem_gen = Normal(/*sigma*/ 10000000, /*max*/ 200000000, 22);
+  auto io_gen = Uniform(100000, 23);
+
+  return GenerateTable(
+      "process_stats", relation, num_rows, [&](Table* table, int64_t first_row, int64_t n) {
+        std::vector<types::Time64NSValue> time(n);
+        std::vector<types::UInt128Value> upid(n);
+        std::vector<types::Int64Value> cpu_utime_ns(n);
+        std::vector<types::Int64Value> cpu_ktime_ns(n);
+        std::vector<types::Int64Value> rss_bytes(n);
+        std::vector<types::Int64Value> vsize_bytes(n);
+        std::vector<types::Int64Value> read_bytes(n);
+        std::vector<types::Int64Value> write_bytes(n);
+        std::vector<types::StringValue> service(n);
+
+        for (int64_t i = 0; i < n; ++i) {
+          // process_stats samples every process in turn.
+          int64_t row = first_row + i;
+          int upid_idx = row % kNumUPIDs;
+          int64_t sample = row / kNumUPIDs;
+          time[i] = RowTime(row, num_rows);
+          upid[i] = UPIDValue(upid_idx);
+          cpu_utime_ns[i] = sample * 10000000 + std::max(0, cpu_gen->Generate());
+          cpu_ktime_ns[i] = sample * 2000000 + std::max(0, cpu_gen->Generate());
+          rss_bytes[i] = std::max(0, mem_gen->Generate());
+          vsize_bytes[i] = 4 * rss_bytes[i].val;
+          read_bytes[i] = sample * 50000 + io_gen->Generate();
+          write_bytes[i] = sample * 20000 + io_gen->Generate();
+          service[i] = ServiceName(upid_idx);
+        }
+        return WriteBatch(table, relation, time, upid, cpu_utime_ns, cpu_ktime_ns, rss_bytes,
+                          vsize_bytes, read_bytes, write_bytes, service);
+      });
+}
+
+StatusOr<std::shared_ptr<Table>> GenerateStackTraces(int64_t num_rows) {
+  Relation relation(
+      {DataType::TIME64NS, DataType::UINT128, DataType::INT64, DataType::STRING, DataType::INT64},
+      {"time_", "upid", "stack_trace_id", "stack_trace", "count"});
+
+  auto upid_gen = Uniform(kNumUPIDs - 1, 31);
+  auto stack_gen = Zipfian(kNumStackTraces - 1, 32);
+  auto count_gen = Uniform(10, 33);
+
+  return GenerateTable(
+      "stack_traces", relation, num_rows, [&](Table* table, int64_t first_row, int64_t n) {
+        std::vector<types::Time64NSValue> time(n);
+        std::vector<types::UInt128Value> upid(n);
+        std::vector<types::Int64Value> stack_trace_id(n);
+        std::vector<types::StringValue> stack_trace(n);
+        std::vector<types::Int64Value> count(n);
+
+        for (int64_t i = 0; i < n; ++i) {
+          int stack_idx = stack_gen->Generate();
+          time[i] = RowTime(first_row + i, num_rows);
+          upid[i] = UPIDValue(upid_gen->Generate());
+          stack_trace_id[i] = stack_idx;
+          stack_trace[i] = StackTrace(stack_idx);
+          count[i] = 1 + count_gen->Generate();
+        }
+        return WriteBatch(table, relation, time, upid, stack_trace_id, stack_trace, count);
+      });
+}
+
+using GenerateTableFn = StatusOr<std::shared_ptr<Table>> (*)(int64_t num_rows);
+
+const std::map<std::string, GenerateTableFn>& TableGenerators() {
+  static const auto* generators = new std::map<std::string, GenerateTableFn>{
+      {"http_events", &GenerateHTTPEvents},
+      {"conn_stats", &GenerateConnStats},
+      {"process_stats", &GenerateProcessStats},
+      {"stack_traces", &GenerateStackTraces},
+  };
+  return *generators;
+}
+
+// Holds the generated tables for one table size. Generating 10M+ rows takes a while, so the
+// tables are generated lazily, and kept until a benchmark asks for a different size.
+class Dataset {
+ public:
+  static Dataset* Get(int64_t num_rows) {
+    static std::unique_ptr<Dataset> dataset;
+    if (dataset == nullptr || dataset->num_rows_ != num_rows) {
+      // Release the previous tables first, to keep peak memory down.
+      dataset.reset();
+      dataset.reset(new Dataset(num_rows));
+    }
+    return dataset.get();
+  }
+
+  Status EnsureTables(const std::vector<std::string>& table_names) {
+    for (const auto& name : table_names) {
+      if (table_store_->GetTable(name) != nullptr) {
+        continue;
+      }
+      auto iter = TableGenerators().find(name);
+      if (iter == TableGenerators().end()) {
+        return error::InvalidArgument("No generator for table $0", name);
+      }
+      LOG(INFO) << absl::Substitute("Generating $0 rows for table $1", num_rows_, name);
+      PL_ASSIGN_OR_RETURN(std::shared_ptr<Table> table, iter->second(num_rows_));
+      table_store_->AddTable(name, table);
+    }
+    return Status::OK();
+  }
+
+  std::shared_ptr<TableStore> table_store() const { return table_store_; }
+
+ private:
+  explicit Dataset(int64_t num_rows)
+      : num_rows_(num_rows), table_store_(std::make_shared<TableStore>()) {}
+
+  const int64_t num_rows_;
+  std::shared_ptr<TableStore> table_store_;
+};
+
+//-----------------------------------------------------------------------------
+// Script catalogue
+//-----------------------------------------------------------------------------
+
+struct Script {
+  std::string name;
+  // The tables read by the script. Throughput is reported over the sum of their rows.
+  std::vector<std::string> tables;
+  std::string pxl;
+};
+
+// Modeled on px/service_stats: windowed latency quantiles, error rate and throughput per service.
+constexpr char kServiceStatsPxL[] = R"pxl(
+import px
+
+window_ns = px.DurationNanos(10 * 1000 * 1000 * 1000)
+
+df = px.DataFrame(table='http_events')
+df.failure = df.resp_status >= 400
+df.timestamp = px.bin(df.time_, window_ns)
+df = df.groupby(['service', 'timestamp']).agg(
+    latency_quantiles=('latency', px.quantiles),
+    error_rate=('failure', px.mean),
+    throughput_total=('latency', px.count),
+    resp_bytes_total=('resp_body_size', px.sum),
+)
+df.latency_p50 = px.pluck_float64(df.latency_quantiles, 'p50')
+df.latency_p99 = px.pluck_float64(df.latency_quantiles, 'p99')
+df = df.groupby('service').agg(
+    latency_p50=('latency_p50', px.mean),
+    latency_p99=('latency_p99', px.mean),
+    error_rate=('error_rate', px.mean),
+    throughput_total=('throughput_total', px.sum),
+    resp_bytes_total=('resp_bytes_total', px.sum),
+)
+px.display(df, 'service_stats')
+)pxl";
+
+// Modeled on px/http_request_stats: latency quantiles per endpoint.
+constexpr char kEndpointLatencyPxL[] = R"pxl(
+import px
+
+df = px.DataFrame(table='http_events', select=['service', 'req_method', 'req_path', 'latency'])
+df = df.groupby(['service', 'req_method', 'req_path']).agg(
+    latency_quantiles=('latency', px.quantiles),
+)
+df.latency_p50 = px.pluck_float64(df.latency_quantiles, 'p50')
+df.latency_p90 = px.pluck_float64(df.latency_quantiles, 'p90')
+df.latency_p99 = px.pluck_float64(df.latency_quantiles, 'p99')
+px.display(df[['service', 'req_method', 'req_path', 'latency_p50', 'latency_p90', 'latency_p99']],
+           'endpoint_latency')
+)pxl";
+
+// Modeled on px/http_errors: a selective filter followed by a small aggregate.
+constexpr char kHTTPErrorsPxL[] = R"pxl(
+import px
+
+df = px.DataFrame(table='http_events', select=['service', 'req_path', 'resp_status', 'latency'])
+df = df[df.resp_status >= 500]
+df = df.groupby(['service', 'req_path', 'resp_status']).agg(
+    errors=('latency', px.count),
+    latency=('latency', px.mean),
+)
+px.display(df, 'http_errors')
+)pxl";
+
+// Modeled on px/cluster: per-process aggregates of two tables, joined on upid.
+constexpr char kServiceResourcesPxL[] = R"pxl(
+import px
+
+http = px.DataFrame(table='http_events', select=['upid', 'latency'])
+http = http.groupby('upid').agg(
+    requests=('latency', px.count),
+    latency=('latency', px.mean),
+)
+
+proc = px.DataFrame(table='process_stats',
+                    select=['upid', 'service', 'cpu_utime_ns', 'rss_bytes'])
+proc = proc.groupby(['upid', 'service']).agg(
+    cpu_max=('cpu_utime_ns', px.max),
+    cpu_min=('cpu_utime_ns', px.min),
+    rss=('rss_bytes', px.mean),
+)
+proc.cpu = proc.cpu_max - proc.cpu_min
+
+df = http.merge(proc, how='inner', left_on='upid', right_on='upid', suffixes=['', '_x'])
+df = df.groupby('service').agg(
+    requests=('requests', px.sum),
+    latency=('latency', px.mean),
+    cpu=('cpu', px.sum),
+    rss=('rss', px.mean),
+)
+px.display(df, 'service_resources')
+)pxl";
+
+// Modeled on px/perf_flamegraph: raw rows joined against a small per-process table.
+constexpr char kFlamegraphPxL[] = R"pxl(
+import px
+
+stacks = px.DataFrame(table='stack_traces', select=['upid', 'stack_trace_id', 'count'])
+
+proc = px.DataFrame(table='process_stats', select=['upid', 'service'])
+proc = proc.groupby(['upid', 'service']).agg()
+
+df = stacks.merge(proc, how='inner', left_on='upid', right_on='upid', suffixes=['', '_x'])
+df = df.groupby(['service', 'stack_trace_id']).agg(count=('count', px.sum))
+px.display(df, 'flamegraph')
+)pxl";
+
+// Modeled on px/net_flow_graph, limited to the first k flows. PxL has no sort, so this measures
+// the aggregate followed by a limit rather than a true top-k.
+constexpr char kNetFlowTopKPxL[] = R"pxl(
+import px
+
+df = px.DataFrame(table='conn_stats')
+df = df[df.trace_role == 1]
+df = df.groupby(['service', 'remote_addr', 'remote_port']).agg(
+    bytes_sent_max=('bytes_sent', px.max),
+    bytes_sent_min=('bytes_sent', px.min),
+    bytes_recv_max=('bytes_recv', px.max),
+    bytes_recv_min=('bytes_recv', px.min),
+    conns=('conn_open', px.max),
+)
+df.bytes_total = (df.bytes_sent_max - df.bytes_sent_min) + (df.bytes_recv_max - df.bytes_recv_min)
+df = df[df.bytes_total > 0]
+df = df.head(100)
+px.display(df[['service', 'remote_addr', 'remote_port', 'bytes_total', 'conns']], 'net_flow')
+)pxl";
+
+const std::vector<Script>& ScriptCatalogue() {
+  static const auto* scripts = new std::vector<Script>{
+      {"service_stats", {"http_events"}, kServiceStatsPxL},
+      {"endpoint_latency", {"http_events"}, kEndpointLatencyPxL},
+      {"http_errors", {"http_events"}, kHTTPErrorsPxL},
+      {"service_resources", {"http_events", "process_stats"}, kServiceResourcesPxL},
+      {"flamegraph", {"stack_traces", "process_stats"}, kFlamegraphPxL},
+      {"net_flow_topk", {"conn_stats"}, kNetFlowTopKPxL},
+  };
+  return *scripts;
+}
+
+//-----------------------------------------------------------------------------
+// Measurement helpers
+//-----------------------------------------------------------------------------
+
+// Reads a "<key>: <value> kB" entry of /proc/self/status, in bytes.
+int64_t ProcStatusBytes(std::string_view key) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    std::string_view entry(line);
+    if (!absl::ConsumePrefix(&entry, key) || !absl::ConsumePrefix(&entry, ":")) {
+      continue;
+    }
+    entry = absl::StripSuffix(absl::StripAsciiWhitespace(entry), " kB");
+    int64_t kb;
+    return absl::SimpleAtoi(entry, &kb) ? kb * 1024 : -1;
+  }
+  return -1;
+}
+
+// Resets the peak RSS (VmHWM) of the process to its current RSS. Requires Linux 4.0+.
+void ResetPeakRSS() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+}
+
+// Returns rows_per_sec per benchmark name, from the JSON output of a previous run.
+const absl::flat_hash_map<std::string, double>& Baseline() {
+  static const auto* baseline = [] {
+    auto* baseline = new absl::flat_hash_map<std::string, double>();
+    if (FLAGS_carnot_benchmark_baseline.empty()) {
+      return baseline;
+    }
+    std::string contents = FileContentsOrDie(FLAGS_carnot_benchmark_baseline);
+    rapidjson::Document doc;
+    doc.Parse(contents.data(), contents.size());
+    if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember("benchmarks")) {
+      LOG(FATAL) << absl::Substitute("$0 is not a benchmark JSON output file.",
+                                     FLAGS_carnot_benchmark_baseline);
+    }
+    for (const auto& run : doc["benchmarks"].GetArray()) {
+      if (!run.HasMember("name") || !run.HasMember("rows_per_sec")) {
+        continue;
+      }
+      if (run.HasMember("run_type") &&
+          std::string_view(run["run_type"].GetString()) != "iteration") {
+        // Skip the mean/median/stddev aggregates of repeated runs.
+        continue;
+      }
+      // Strip the "/real_time" and other suffixes appended by the benchmark library.
+      std::string name = run["name"].GetString();
+      name = name.substr(0, name.find("/real_time"));
+      (*baseline)[name] = run["rows_per_sec"].GetDouble();
+    }
+    return baseline;
+  }();
+  return *baseline;
+}
+
+std::unique_ptr<Carnot> SetUpCarnot(std::shared_ptr<TableStore> table_store,
+                                    exec::LocalGRPCResultSinkServer* server) {
+  auto func_registry = std::make_unique<udf::Registry>("default_registry");
+  funcs::RegisterFuncsOrDie(func_registry.get());
+  auto clients_config = std::make_unique<Carnot::ClientsConfig>(Carnot::ClientsConfig{
+      [server](const std::string& address, const std::string&) {
+        return server->StubGenerator(address);
+      },
+      [](grpc::ClientContext*) {},
+  });
+  auto server_config = std::make_unique<Carnot::ServerConfig>();
+  server_config->grpc_server_port = 0;
+
+  return Carnot::Create(sole::uuid4(), std::move(func_registry), table_store,
+                        std::move(clients_config), std::move(server_config))
+      .ConsumeValueOrDie();
+}
+
+//-----------------------------------------------------------------------------
+// Benchmark
+//-----------------------------------------------------------------------------
+
+// NOLINTNEXTLINE(runtime/references)
+void BM_CarnotScript(benchmark::State& state, const std::string& benchmark_name,
+                     const Script& script, int64_t num_rows) {
+  if (num_rows > FLAGS_carnot_benchmark_max_rows) {
+    state.SkipWithError("Table size is above --carnot_benchmark_max_rows.");
+    return;
+  }
+
+  Dataset* dataset = Dataset::Get(num_rows);
+  PL_CHECK_OK(dataset->EnsureTables(script.tables));
+
+  exec::LocalGRPCResultSinkServer server;
+  std::unique_ptr<Carnot> carnot = SetUpCarnot(dataset->table_store(), &server);
+
+  const bool analyze = FLAGS_carnot_benchmark_operator_stats;
+  const int64_t rss_before = ProcStatusBytes("VmRSS");
+  ResetPeakRSS();
+
+  int64_t rows_processed = 0;
+  std::chrono::nanoseconds query_time{0};
+  std::map<std::pair<int64_t, int64_t>, int64_t> op_self_time_ns;
+
+  for (auto _ : state) {
+    auto start = std::chrono::steady_clock::now();
+    Status s = carnot->ExecuteQuery(script.pxl, sole::uuid4(), CurrentTimeNS(), analyze);
+    query_time += std::chrono::steady_clock::now() - start;
+    if (!s.ok()) {
+      state.SkipWithError(s.msg().c_str());
+      return;
+    }
+
+    state.PauseTiming();
+    auto exec_stats = server.exec_stats().ConsumeValueOrDie();
+    rows_processed += exec_stats.execution_stats().records_processed();
+    for (const auto& agent_stats : exec_stats.agent_execution_stats()) {
+      for (const auto& op_stats : agent_stats.operator_execution_stats()) {
+        op_self_time_ns[{op_stats.plan_fragment_id(), op_stats.node_id()}] +=
+            op_stats.self_execution_time_ns();
+      }
+    }
+    server.ResetQueryResults();
+    state.ResumeTiming();
+  }
+
+  const double iterations = state.iterations();
+  const double rows_per_sec = rows_processed / std::chrono::duration<double>(query_time).count();
+  const int64_t peak_rss = ProcStatusBytes("VmHWM");
+
+  state.SetItemsProcessed(rows_processed);
+  state.counters["rows_per_sec"] = rows_per_sec;
+  state.counters["peak_rss_bytes"] = peak_rss;
+  state.counters["query_rss_bytes"] = std::max<int64_t>(0, peak_rss - rss_before);
+  for (const auto& [op, self_time_ns] : op_self_time_ns) {
+    state.counters[absl::Substitute("op_$0_$1_self_ms", op.first, op.second)] =
+        self_time_ns / iterations / 1e6;
+  }
+
+  auto iter = Baseline().find(benchmark_name);
+  if (iter != Baseline().end() && iter->second > 0) {
+    double ratio = rows_per_sec / iter->second;
+    state.counters["baseline_ratio"] = ratio;
+    LOG_IF(WARNING, ratio < 1 - FLAGS_carnot_benchmark_regression_threshold) << absl::Substitute(
+        "REGRESSION: $0 processed $1 rows/s vs $2 rows/s in the baseline ($3%).", benchmark_name,
+        rows_per_sec, iter->second, static_cast<int>(ratio * 100));
+  }
+}
+
+// Register by table size first, so that the tables of a size are generated once and shared by
+// all scripts.
+bool RegisterCarnotBenchmarks() {
+  for (int64_t num_rows : {1000 * 1000, 10 * 1000 * 1000, 100 * 1000 * 1000}) {
+    for (const Script& script : ScriptCatalogue()) {
+      std::string name = absl::Substitute("BM_CarnotScript/$0/rows:$1", script.name, num_rows);
+      benchmark::RegisterBenchmark(name.c_str(), BM_CarnotScript, name, script, num_rows)
+          ->Unit(benchmark::kMillisecond)
+          ->UseRealTime();
+    }
+  }
+  return true;
+}
+
+[[maybe_unused]] const bool kRegistered = RegisterCarnotBenchmarks();
+
+}  // namespace
+}  // namespace carnot
+}  // namespace px
@@ -16,10 +16,20 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include <absl/strings/str_split.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
 #include <parser.hpp>
 #include <sole.hpp>
 
@@ -28,6 +38,7 @@
 #include "src/carnot/exec/local_grpc_result_server.h"
 #include "src/carnot/funcs/funcs.h"
 #include "src/common/base/base.h"
+#include "src/shared/types/arrow_adapter.h"
 #include "src/shared/types/column_wrapper.h"
 #include "src/shared/types/type_utils.h"
 #include "src/table_store/table_store.h"
@@ -46,6 +57,20 @@ DEFINE_string(table_name, gflags::StringFromEnv("TABLE_NAME", "csv_table"),
 DEFINE_int64(rowbatch_size, gflags::Int64FromEnv("ROWBATCH_SIZE", 100),
              "The size of the rowbatches.");
 
+DEFINE_string(input_format, gflags::StringFromEnv("INPUT_FORMAT", "csv"),
+              "The format of the input file, either 'csv' or 'arrow' (Arrow IPC file format).");
+
+DEFINE_string(output_format, gflags::StringFromEnv("OUTPUT_FORMAT", "csv"),
+              "The format of the output file, either 'csv' or 'arrow' (Arrow IPC file format).");
+
+DEFINE_string(columns, gflags::StringFromEnv("COLUMNS", ""),
+              "Comma separated list of the columns to load from an arrow input file. "
+              "All columns are loaded if empty.");
+
+DEFINE_int64(load_threads, gflags::Int64FromEnv("LOAD_THREADS", 0),
+             "The number of threads used to decode an arrow input file. "
+             "Defaults to the number of cores if 0.");
+
 using px::types::DataType;
 
 namespace {
@@ -201,6 +226,248 @@ std::shared_ptr<px::table_store::Table> GetTableFromCsv(const std::string& filen
   return table;
 }
 
+/**
+ * Gets the corresponding px::DataType of a column in an arrow file.
+ * Time columns can be stored as time64[ns], timestamp[ns], or int64 named "time_", and UINT128
+ * columns as fixed_size_binary(16) so that other Arrow implementations can read them.
+ * @param field the arrow field of the column.
+ * @return the px::DataType.
+ */
+px::StatusOr<DataType> GetTypeFromArrowField(const arrow::Field& field) {
+  const auto& type = *field.type();
+  switch (type.id()) {
+    case arrow::Type::BOOL:
+      return DataType::BOOLEAN;
+    case arrow::Type::INT64:
+      return field.name() == "time_" ? DataType::TIME64NS : DataType::INT64;
+    case arrow::Type::DOUBLE:
+      return DataType::FLOAT64;
+    case arrow::Type::STRING:
+      return DataType::STRING;
+    case arrow::Type::UINT128:
+      return DataType::UINT128;
+    case arrow::Type::TIME64:
+      if (static_cast<const arrow::Time64Type&>(type).unit() == arrow::TimeUnit::NANO) {
+        return DataType::TIME64NS;
+      }
+      break;
+    case arrow::Type::TIMESTAMP:
+      if (static_cast<const arrow::TimestampType&>(type).unit() == arrow::TimeUnit::NANO) {
+        return DataType::TIME64NS;
+      }
+      break;
+    case arrow::Type::FIXED_SIZE_BINARY:
+      if (static_cast<const arrow::FixedSizeBinaryType&>(type).byte_width() ==
+          sizeof(absl::uint128)) {
+        return DataType::UINT128;
+      }
+      break;
+    default:
+      break;
+  }
+  return px::error::InvalidArgument("Column '$0' has unsupported arrow type $1.", field.name(),
+                                    type.ToString());
+}
+
+/**
+ * Converts an array read from an arrow file into the arrow type that Carnot uses for the given
+ * px::DataType. Arrays that already have that type are returned as is, without a copy.
+ */
+px::StatusOr<std::shared_ptr<arrow::Array>> ToCarnotArray(DataType type,
+                                                           const std::shared_ptr<arrow::Array>& arr,
+                                                           arrow::MemoryPool* mem_pool) {
+  if (arr->null_count() > 0) {
+    return px::error::InvalidArgument("Null values are not supported.");
+  }
+  if (arr->type_id() == px::types::ToArrowType(type)) {
+    return arr;
+  }
+  switch (type) {
+    case DataType::TIME64NS: {
+      // int64 and timestamp[ns] have the same layout as time64[ns], so only the type changes.
+      auto data = arr->data()->Copy();
+      data->type = arrow::time64(arrow::TimeUnit::NANO);
+      return arrow::MakeArray(data);
+    }
+    case DataType::UINT128: {
+      const auto* fsb = static_cast<const arrow::FixedSizeBinaryArray*>(arr.get());
+      std::vector<px::types::UInt128Value> vals;
+      vals.reserve(arr->length());
+      for (int64_t i = 0; i < arr->length(); ++i) {
+        uint64_t low;
+        uint64_t high;
+        std::memcpy(&low, fsb->GetValue(i), sizeof(low));
+        std::memcpy(&high, fsb->GetValue(i) + sizeof(low), sizeof(high));
+        vals.emplace_back(high, low);
+      }
+      return px::types::ToArrow(vals, mem_pool);
+    }
+    default:
+      return px::error::Internal("Unexpected arrow type $0 for column of type $1.",
+                                 arr->type()->ToString(), px::types::ToString(type));
+  }
+}
+
+/**
+ * Decodes record batches of the arrow file into row batches, until there are none left. Each call
+ * opens its own reader on the shared memory map, since readers are not thread-safe. The arrays
+ * reference the memory map directly, so only the columns that need a conversion get copied.
+ * @param file the memory mapped arrow file.
+ * @param projection the indices of the columns to load in the file.
+ * @param desc the row descriptor of the loaded columns.
+ * @param next_batch the index of the next record batch to be decoded, shared by all threads.
+ * @param row_batches the decoded row batches, indexed by their record batch index.
+ */
+px::Status DecodeArrowBatches(const std::shared_ptr<arrow::io::MemoryMappedFile>& file,
+                              const std::vector<int>& projection,
+                              const px::table_store::schema::RowDescriptor& desc,
+                              std::atomic<int>* next_batch,
+                              std::vector<px::table_store::schema::RowBatch>* row_batches) {
+  std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader;
+  PL_RETURN_IF_ERROR(arrow::ipc::RecordBatchFileReader::Open(file.get(), &reader));
+
+  for (int i = next_batch->fetch_add(1); i < reader->num_record_batches();
+       i = next_batch->fetch_add(1)) {
+    std::shared_ptr<arrow::RecordBatch> record_batch;
+    PL_RETURN_IF_ERROR(reader->ReadRecordBatch(i, &record_batch));
+
+    px::table_store::schema::RowBatch rb(desc, record_batch->num_rows());
+    for (size_t col_idx = 0; col_idx < projection.size(); ++col_idx) {
+      PL_ASSIGN_OR_RETURN(auto arr, ToCarnotArray(desc.type(col_idx),
+                                                  record_batch->column(projection[col_idx]),
+                                                  arrow::default_memory_pool()));
+      PL_RETURN_IF_ERROR(rb.AddColumn(arr));
+    }
+    (*row_batches)[i] = std::move(rb);
+  }
+  return px::Status::OK();
+}
+
+/**
+ * Loads the given columns of an Arrow IPC file into a Carnot table. The file is memory mapped and
+ * its record batches are decoded in parallel, then handed to the table's cold store as is.
+ * @param filename The filename of the arrow file to load.
+ * @param table_name The name of the table.
+ * @param columns The names of the columns to load, or all columns if empty.
+ * @param num_threads The number of threads to decode record batches with.
+ * @return The Carnot table.
+ */
+px::StatusOr<std::shared_ptr<px::table_store::Table>> GetTableFromArrowFile(
+    const std::string& filename, const std::string& table_name,
+    const std::vector<std::string>& columns, int64_t num_threads) {
+  std::shared_ptr<arrow::io::MemoryMappedFile> file;
+  PL_RETURN_IF_ERROR(
+      arrow::io::MemoryMappedFile::Open(filename, arrow::io::FileMode::READ, &file));
+  int64_t file_size = 0;
+  PL_RETURN_IF_ERROR(file->GetSize(&file_size));
+
+  std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader;
+  PL_RETURN_IF_ERROR(arrow::ipc::RecordBatchFileReader::Open(file.get(), &reader));
+  auto schema = reader->schema();
+
+  std::vector<int> projection;
+  if (columns.empty()) {
+    for (int i = 0; i < schema->num_fields(); ++i) {
+      projection.push_back(i);
+    }
+  }
+  for (const auto& col : columns) {
+    int idx = schema->GetFieldIndex(col);
+    if (idx == -1) {
+      return px::error::InvalidArgument("Column '$0' not found in $1.", col, filename);
+    }
+    projection.push_back(idx);
+  }
+
+  std::vector<DataType> types;
+  std::vector<std::string> names;
+  for (int idx : projection) {
+    PL_ASSIGN_OR_RETURN(DataType type, GetTypeFromArrowField(*schema->field(idx)));
+    types.push_back(type);
+    names.push_back(schema->field(idx)->name());
+  }
+  px::table_store::schema::RowDescriptor desc(types);
+
+  std::vector<px::table_store::schema::RowBatch> row_batches(
+      reader->num_record_batches(), px::table_store::schema::RowBatch(desc, 0));
+  if (num_threads <= 0) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  num_threads = std::max<int64_t>(1, std::min<int64_t>(num_threads, row_batches.size()));
+
+  std::atomic<int> next_batch{0};
+  std::vector<px::Status> statuses(num_threads);
+  std::vector<std::thread> threads;
+  for (int64_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t] {
+      statuses[t] = DecodeArrowBatches(file, projection, desc, &next_batch, &row_batches);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& s : statuses) {
+    PL_RETURN_IF_ERROR(s);
+  }
+
+  // The table must be able to hold the whole file, which can be larger than the default limit.
+  px::table_store::schema::Relation rel(types, names);
+  auto table = std::make_shared<px::table_store::Table>(
+      table_name, rel, std::max<int64_t>(FLAGS_table_store_table_size_limit, file_size));
+  for (const auto& rb : row_batches) {
+    PL_RETURN_IF_ERROR(table->WriteColdBatch(rb));
+  }
+  return table;
+}
+
+/**
+ * Write the result batches to an Arrow IPC file. UINT128 columns are written as
+ * fixed_size_binary(16), and columns are named by their index since results carry no names.
+ * @param filename The name of the output arrow file.
+ * @param result_batches The batches to write.
+ */
+px::Status TableToArrowFile(const std::string& filename,
+                            const std::vector<px::carnot::RowBatch>& result_batches) {
+  std::shared_ptr<arrow::io::FileOutputStream> out;
+  PL_RETURN_IF_ERROR(arrow::io::FileOutputStream::Open(filename, &out));
+  if (result_batches.empty()) {
+    return out->Close();
+  }
+
+  std::shared_ptr<arrow::Schema> schema;
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
+  for (const auto& rb : result_batches) {
+    std::vector<std::shared_ptr<arrow::Array>> arrays;
+    for (int64_t col_idx = 0; col_idx < rb.num_columns(); ++col_idx) {
+      auto arr = rb.ColumnAt(col_idx);
+      if (rb.desc().type(col_idx) == DataType::UINT128) {
+        arrow::FixedSizeBinaryBuilder builder(arrow::fixed_size_binary(sizeof(absl::uint128)));
+        PL_RETURN_IF_ERROR(builder.Reserve(arr->length()));
+        for (int64_t i = 0; i < arr->length(); ++i) {
+          absl::uint128 val = px::types::GetValue(static_cast<arrow::UInt128Array*>(arr.get()), i);
+          uint64_t words[2] = {absl::Uint128Low64(val), absl::Uint128High64(val)};
+          PL_RETURN_IF_ERROR(builder.Append(reinterpret_cast<const uint8_t*>(words)));
+        }
+        PL_RETURN_IF_ERROR(builder.Finish(&arr));
+      }
+      arrays.push_back(arr);
+    }
+
+    if (writer == nullptr) {
+      std::vector<std::shared_ptr<arrow::Field>> fields;
+      for (size_t i = 0; i < arrays.size(); ++i) {
+        fields.push_back(arrow::field(absl::Substitute("col$0", i), arrays[i]->type()));
+      }
+      schema = arrow::schema(fields);
+      PL_RETURN_IF_ERROR(arrow::ipc::RecordBatchFileWriter::Open(out.get(), schema, &writer));
+    }
+    PL_RETURN_IF_ERROR(
+        writer->WriteRecordBatch(*arrow::RecordBatch::Make(schema, rb.num_rows(), arrays)));
+  }
+  PL_RETURN_IF_ERROR(writer->Close());
+  return out->Close();
+}
+
 /**
  * Write the table to a CSV.
  * @param filename The name of the output CSV file.
@@ -238,7 +505,22 @@ int main(int argc, char* argv[]) {
   auto rb_size = FLAGS_rowbatch_size;
   auto table_name = FLAGS_table_name;
 
-  auto table = GetTableFromCsv(filename, rb_size);
+  std::shared_ptr<px::table_store::Table> table;
+  if (FLAGS_input_format == "arrow") {
+    std::vector<std::string> columns;
+    if (!FLAGS_columns.empty()) {
+      columns = absl::StrSplit(FLAGS_columns, ",");
+    }
+    auto table_or_s = GetTableFromArrowFile(filename, table_name, columns, FLAGS_load_threads);
+    if (!table_or_s.ok()) {
+      LOG(FATAL) << absl::Substitute("Failed to load arrow file: $0", table_or_s.msg());
+    }
+    table = table_or_s.ConsumeValueOrDie();
+  } else if (FLAGS_input_format == "csv") {
+    table = GetTableFromCsv(filename, rb_size);
+  } else {
+    LOG(FATAL) << absl::Substitute("Unknown input format '$0'.", FLAGS_input_format);
+  }
 
   // Execute query.
   auto table_store = std::make_shared<px::table_store::TableStore>();
@@ -271,7 +553,14 @@ int main(int argc, char* argv[]) {
   }
   std::string output_name = *(result_server.output_tables().begin());
   LOG(INFO) << absl::Substitute("Writing results for output table: $0", output_name);
-  // Write output table to CSV.
-  TableToCsv(output_filename, result_server.query_results(output_name));
+  if (FLAGS_output_format == "arrow") {
+    auto s = TableToArrowFile(output_filename, result_server.query_results(output_name));
+    if (!s.ok()) {
+      LOG(FATAL) << absl::Substitute("Failed to write arrow file: $0", s.msg());
+    }
+  } else {
+    // Write output table to CSV.
+    TableToCsv(output_filename, result_server.query_results(output_name));
+  }
   return 0;
 }
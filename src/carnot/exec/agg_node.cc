@@ -22,7 +22,10 @@
 #include <arrow/array/builder_base.h>
 #include <arrow/status.h>
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <string>
 
 #include <magic_enum.hpp>
 
@@ -35,6 +38,10 @@
 #include "src/shared/types/type_utils.h"
 #include "src/shared/types/types.h"
 
+DEFINE_int32(carnot_agg_partitions, gflags::Int32FromEnv("PL_CARNOT_AGG_PARTITIONS", 1),
+             "The number of threads that group by aggregates partition their groups across. "
+             "Meant for Kelvin, where the aggregates see the rows of every PEM.");
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -78,6 +85,29 @@ void ExtractToColumnWrapper(const std::vector<GroupArgs>& group_args,
   }
 }
 
+// The serialized states of a group's values are packed into a single string, each of them
+// prefixed by its length.
+void AppendPartialState(std::string_view state, std::string* out) {
+  uint32_t len = state.size();
+  out->append(reinterpret_cast<const char*>(&len), sizeof(len));
+  out->append(state);
+}
+
+StatusOr<std::string_view> ConsumePartialState(std::string_view* serialized) {
+  uint32_t len;
+  if (serialized->size() < sizeof(len)) {
+    return error::InvalidArgument("Truncated partial aggregate state");
+  }
+  std::memcpy(&len, serialized->data(), sizeof(len));
+  serialized->remove_prefix(sizeof(len));
+  if (serialized->size() < len) {
+    return error::InvalidArgument("Truncated partial aggregate state");
+  }
+  std::string_view state = serialized->substr(0, len);
+  serialized->remove_prefix(len);
+  return state;
+}
+
 }  // namespace
 
 std::string AggNode::DebugStringImpl() {
@@ -106,11 +136,23 @@ Status AggNode::InitImpl(const plan::Operator& plan_node) {
     }
   }
 
-  size_t output_size = plan_node_->values().size() + plan_node_->groups().size();
+  // A partial aggregate emits all of its values as a single column of serialized states.
+  size_t num_value_cols = EmitsPartialStates() ? 1 : plan_node_->values().size();
+  size_t output_size = num_value_cols + plan_node_->groups().size();
   if (output_size != output_descriptor_->size()) {
     return error::InvalidArgument("Output size mismatch in aggregate");
   }
 
+  if (MergesPartialStates()) {
+    // The partial aggregate appends the serialized states after its groups.
+    partial_states_col_idx_ = static_cast<int64_t>(input_descriptor_->size()) - 1;
+    if (partial_states_col_idx_ < 0 ||
+        input_descriptor_->type(partial_states_col_idx_) != types::STRING) {
+      return error::InvalidArgument(
+          "Aggregate merging partial states expects them in its last input column");
+    }
+  }
+
   if (HasNoGroups()) {
     return Status::OK();
   }
@@ -128,8 +170,7 @@ Status AggNode::InitImpl(const plan::Operator& plan_node) {
     group_data_types_.emplace_back(input_descriptor_->type(group.idx));
   }
 
-  auto values_size = plan_node_->values().size();
-  for (size_t i = 0; i < values_size; ++i) {
+  for (size_t i = 0; i < num_value_cols; ++i) {
     auto values_idx = i + groups_size;
     DCHECK(values_idx < output_descriptor_->size());
     value_data_types_.emplace_back(output_descriptor_->type(values_idx));
@@ -144,9 +185,51 @@ Status AggNode::PrepareImpl(ExecState* exec_state) {
 }
 
 Status AggNode::OpenImpl(ExecState* exec_state) {
+  for (const auto& value : plan_node_->values()) {
+    uda_defs_.push_back(exec_state->GetUDADefinition(value->uda_id()));
+    if ((EmitsPartialStates() || MergesPartialStates()) && !uda_defs_.back()->supports_partial()) {
+      return error::InvalidArgument("UDA '$0' does not support partial aggregates", value->name());
+    }
+  }
   if (HasNoGroups()) {
     PL_RETURN_IF_ERROR(CreateUDAInfoValues(&udas_no_groups_, exec_state));
+  } else if (num_partitions_ > 1) {
+    for (size_t i = 0; i < num_partitions_; ++i) {
+      partitions_.push_back(std::make_unique<AggPartition>());
+    }
+    partition_pool_ = std::make_unique<ForkJoinPool>(num_partitions_);
+  } else {
+    PL_RETURN_IF_ERROR(InitInlineStates());
+  }
+  return Status::OK();
+}
+
+Status AggNode::InitInlineStates() {
+  // Inline states can't be serialized, so split aggregates keep per group UDA instances.
+  if (plan_node_->values().empty() || EmitsPartialStates() || MergesPartialStates()) {
+    return Status::OK();
+  }
+  auto align_up = [](size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+  };
+  size_t max_alignment = 1;
+  for (auto* def : uda_defs_) {
+    if (!def->has_inline_state()) {
+      return Status::OK();
+    }
+    max_alignment = std::max(max_alignment, def->state_alignment());
+  }
+  DCHECK_LE(max_alignment, alignof(std::max_align_t));
+
+  size_t offset = 0;
+  for (auto* def : uda_defs_) {
+    offset = align_up(offset, def->state_alignment());
+    state_offsets_.push_back(offset);
+    offset += def->state_size();
   }
+  // Round up the block so that consecutive blocks in a chunk stay aligned.
+  state_block_size_ = align_up(offset, max_alignment);
+  inline_states_ = true;
   return Status::OK();
 }
 
@@ -154,12 +237,21 @@ Status AggNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_
   if (HasNoGroups()) {
     return AggregateGroupByNone(exec_state, rb);
   }
+  if (Partitioned()) {
+    return AggregateGroupByClausePartitioned(exec_state, rb);
+  }
   return AggregateGroupByClause(exec_state, rb);
 }
 
 Status AggNode::CloseImpl(ExecState*) {
   udas_no_groups_.clear();
   group_args_chunk_.clear();
+  // Stop the partition threads before their state goes away.
+  partition_pool_.reset();
+  partitions_.clear();
+  agg_hash_map_.clear();
+  inline_hash_values_.clear();
+  state_chunks_.clear();
   group_args_pool_.Clear();
   udas_pool_.Clear();
 
@@ -176,27 +268,47 @@ Status AggNode::ClearAggState(ExecState* exec_state) {
     PL_RETURN_IF_ERROR(CreateUDAInfoValues(&udas_no_groups_, exec_state));
   }
   agg_hash_map_.clear();
+  inline_hash_values_.clear();
+  num_state_blocks_ = 0;
+  for (auto& partition : partitions_) {
+    partition->agg_hash_map.clear();
+  }
   return Status::OK();
 }
 
 Status AggNode::AggregateGroupByNone(ExecState* exec_state, const RowBatch& rb) {
   auto values = plan_node_->values();
-  for (size_t i = 0; i < values.size(); ++i) {
-    PL_RETURN_IF_ERROR(
-        EvaluateSingleExpressionNoGroups(exec_state, udas_no_groups_[i], values[i].get(), rb));
+  if (MergesPartialStates()) {
+    auto* states = rb.ColumnAt(partial_states_col_idx_).get();
+    for (int64_t row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
+      PL_RETURN_IF_ERROR(MergePartialStates(types::GetStringViewFromArrowArray(states, row_idx),
+                                            &udas_no_groups_));
+    }
+  } else {
+    for (size_t i = 0; i < values.size(); ++i) {
+      PL_RETURN_IF_ERROR(
+          EvaluateSingleExpressionNoGroups(exec_state, udas_no_groups_[i], values[i].get(), rb));
+    }
   }
 
   if (ReadyToEmitBatches(rb)) {
     RowBatch output_rb(*output_descriptor_, 1);
-    for (size_t i = 0; i < values.size(); ++i) {
-      const auto& uda_info = udas_no_groups_[i];
-      auto builder = types::MakeArrowBuilder(uda_info.def->finalize_return_type(),
-                                             exec_state->exec_mem_pool());
-      PL_RETURN_IF_ERROR(
-          uda_info.def->FinalizeArrow(uda_info.uda.get(), function_ctx_.get(), builder.get()));
+    if (EmitsPartialStates()) {
+      auto builder = types::MakeArrowBuilder(types::STRING, exec_state->exec_mem_pool());
+      PL_RETURN_IF_ERROR(SerializePartialStates(udas_no_groups_, builder.get()));
       SharedArray out_col;
       PL_RETURN_IF_ERROR(builder->Finish(&out_col));
       PL_RETURN_IF_ERROR(output_rb.AddColumn(out_col));
+    } else {
+      for (const auto& uda_info : udas_no_groups_) {
+        auto builder = types::MakeArrowBuilder(uda_info.def->finalize_return_type(),
+                                               exec_state->exec_mem_pool());
+        PL_RETURN_IF_ERROR(
+            uda_info.def->FinalizeArrow(uda_info.uda.get(), function_ctx_.get(), builder.get()));
+        SharedArray out_col;
+        PL_RETURN_IF_ERROR(builder->Finish(&out_col));
+        PL_RETURN_IF_ERROR(output_rb.AddColumn(out_col));
+      }
     }
     output_rb.set_eow(rb.eow());
     output_rb.set_eos(rb.eos());
@@ -245,7 +357,8 @@ Status AggNode::HashRowBatch(ExecState* exec_state, const RowBatch& rb) {
     // If not in hash then insert
     if (it == agg_hash_map_.end()) {
       // Create a val array.
-      val = CreateAggHashValue(exec_state);
+      val = inline_states_ ? CreateInlineAggHashValue()
+                           : CreateAggHashValue(exec_state, &udas_pool_);
       agg_hash_map_[ga.rt] = val;
       // We have inserted this, so the stored RowTuple is now in the table.
       ga.rt = nullptr;
@@ -255,7 +368,10 @@ Status AggNode::HashRowBatch(ExecState* exec_state, const RowBatch& rb) {
     ga.av = val;
   }
 
-  auto values = plan_node_->values();
+  if (inline_states_) {
+    return UpdateInlineStates(exec_state, rb);
+  }
+
   // Now extract the values in the agg hash value.
   for (size_t i = 0; i < stored_cols_data_types_.size(); ++i) {
     const auto& rb_col_idx = stored_cols_to_plan_idx_[i];
@@ -300,7 +416,8 @@ Status AggNode::ResetGroupArgs() {
   return Status::OK();
 }
 
-Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, RowBatch* output_rb) {
+Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, const AggHashMap& agg_hash_map,
+                                            RowBatch* output_rb) {
   PL_UNUSED(exec_state);
   DCHECK(output_rb != nullptr);
   std::vector<std::unique_ptr<arrow::ArrayBuilder>> group_builders;
@@ -313,7 +430,7 @@ Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, RowBatch* out
   }
 
   // Agg into agg values and emit!
-  for (const auto& kv : agg_hash_map_) {
+  for (const auto& kv : agg_hash_map) {
     auto* groups_rt = kv.first;
     auto* val = kv.second;
 
@@ -324,8 +441,19 @@ Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, RowBatch* out
       PL_SWITCH_FOREACH_DATATYPE(group_data_types_[i], TYPE_CASE);
 #undef TYPE_CASE
     }
+    if (inline_states_) {
+      for (size_t i = 0; i < uda_defs_.size(); ++i) {
+        PL_RETURN_IF_ERROR(uda_defs_[i]->FinalizeStateArrow(val->states + state_offsets_[i],
+                                                            value_builders[i].get()));
+      }
+      continue;
+    }
     // Actually Finalize the UDA based on the column wrapper chunks.
     PL_RETURN_IF_ERROR(EvaluateAggHashValue(exec_state, val));
+    if (EmitsPartialStates()) {
+      PL_RETURN_IF_ERROR(SerializePartialStates(val->udas, value_builders[0].get()));
+      continue;
+    }
     for (size_t i = 0; i < val->udas.size(); ++i) {
       const auto& uda_info = val->udas[i];
       PL_RETURN_IF_ERROR(uda_info.def->FinalizeArrow(uda_info.uda.get(), function_ctx_.get(),
@@ -359,13 +487,13 @@ Status AggNode::AggregateGroupByClause(ExecState* exec_state, const RowBatch& rb
   // 5. If it's the last batch then emit the values.
   PL_RETURN_IF_ERROR(ExtractRowTupleForBatch(rb));
   PL_RETURN_IF_ERROR(HashRowBatch(exec_state, rb));
-  if (plan_node_->values().size() > 0) {
+  if (plan_node_->values().size() > 0 && !inline_states_) {
     PL_RETURN_IF_ERROR(EvaluatePartialAggregates(exec_state, rb.num_rows()));
   }
   PL_RETURN_IF_ERROR(ResetGroupArgs());
   if (ReadyToEmitBatches(rb)) {
     RowBatch output_rb(*output_descriptor_, agg_hash_map_.size());
-    PL_RETURN_IF_ERROR(ConvertAggHashMapToRowBatch(exec_state, &output_rb));
+    PL_RETURN_IF_ERROR(ConvertAggHashMapToRowBatch(exec_state, agg_hash_map_, &output_rb));
     output_rb.set_eow(rb.eow());
     output_rb.set_eos(rb.eos());
     PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, output_rb));
@@ -374,19 +502,80 @@ Status AggNode::AggregateGroupByClause(ExecState* exec_state, const RowBatch& rb
   return Status::OK();
 }
 
-StatusOr<types::DataType> AggNode::GetTypeOfDep(const plan::ScalarExpression& expr) const {
-  // Agg exprs can only be of type col, or  const.
-  switch (expr.ExpressionType()) {
-    case plan::Expression::kColumn: {
-      auto idx = static_cast<const plan::Column*>(&expr)->Index();
-      return input_descriptor_->type(idx);
+Status AggNode::AggregatePartition(ExecState* exec_state, const RowBatch& rb,
+                                   AggPartition* partition) {
+  // Each row's group args are only touched by the partition that owns the row.
+  for (int64_t row_idx : partition->rows) {
+    auto& ga = group_args_chunk_[row_idx];
+    auto it = partition->agg_hash_map.find(ga.rt);
+    if (it == partition->agg_hash_map.end()) {
+      ga.av = CreateAggHashValue(exec_state, &partition->udas_pool);
+      partition->agg_hash_map[ga.rt] = ga.av;
+      ga.rt = nullptr;
+    } else {
+      ga.av = it->second;
+    }
+  }
+
+  for (size_t i = 0; i < stored_cols_data_types_.size(); ++i) {
+    auto* arr = rb.ColumnAt(stored_cols_to_plan_idx_[i]).get();
+    for (int64_t row_idx : partition->rows) {
+      auto* col_wrapper = group_args_chunk_[row_idx].av->agg_cols[i].get();
+#define TYPE_CASE(_dt_) types::ExtractValueToColumnWrapper<_dt_>(col_wrapper, arr, row_idx);
+      PL_SWITCH_FOREACH_DATATYPE(stored_cols_data_types_[i], TYPE_CASE);
+#undef TYPE_CASE
+    }
+  }
+
+  if (plan_node_->values().empty() || stored_cols_data_types_.empty()) {
+    return Status::OK();
+  }
+  for (int64_t row_idx : partition->rows) {
+    auto* av = group_args_chunk_[row_idx].av;
+    if (av->agg_cols[0]->Size() > kAggCompactionThreshold) {
+      PL_RETURN_IF_ERROR(EvaluateAggHashValue(exec_state, av));
+    }
+  }
+  return Status::OK();
+}
+
+Status AggNode::AggregateGroupByClausePartitioned(ExecState* exec_state, const RowBatch& rb) {
+  PL_RETURN_IF_ERROR(ExtractRowTupleForBatch(rb));
+
+  // Route every row to the partition that owns its group.
+  for (auto& partition : partitions_) {
+    partition->rows.clear();
+  }
+  RowTuplePtrHasher hasher;
+  for (int64_t row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
+    partitions_[PartitionOf(hasher(group_args_chunk_[row_idx].rt))]->rows.push_back(row_idx);
+  }
+  PL_RETURN_IF_ERROR(partition_pool_->Run([&](size_t p) -> Status {
+    return AggregatePartition(exec_state, rb, partitions_[p].get());
+  }));
+  PL_RETURN_IF_ERROR(ResetGroupArgs());
+
+  if (!ReadyToEmitBatches(rb)) {
+    return Status::OK();
+  }
+  std::vector<std::unique_ptr<RowBatch>> output_rbs(partitions_.size());
+  PL_RETURN_IF_ERROR(partition_pool_->Run([&](size_t p) -> Status {
+    const auto& agg_hash_map = partitions_[p]->agg_hash_map;
+    output_rbs[p] = std::make_unique<RowBatch>(*output_descriptor_, agg_hash_map.size());
+    return ConvertAggHashMapToRowBatch(exec_state, agg_hash_map, output_rbs[p].get());
+  }));
+  // The partitions hold disjoint groups, so their batches are simply sent one after the other,
+  // with the last one carrying eow/eos.
+  for (size_t p = 0; p < output_rbs.size(); ++p) {
+    bool last = p + 1 == output_rbs.size();
+    if (!last && output_rbs[p]->num_rows() == 0) {
+      continue;
     }
-    case plan::Expression::kConstant:
-      return static_cast<const plan::ScalarValue*>(&expr)->DataType();
-    default:
-      return error::InvalidArgument("Invalid expression type in agg: $0",
-                                    magic_enum::enum_name(expr.ExpressionType()));
+    output_rbs[p]->set_eow(last && rb.eow());
+    output_rbs[p]->set_eos(last && rb.eos());
+    PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, *output_rbs[p]));
   }
+  return ClearAggState(exec_state);
 }
 
 Status AggNode::EvaluateSingleExpressionNoGroups(ExecState* exec_state, const UDAInfo& uda_info,
@@ -432,6 +621,15 @@ Status AggNode::EvaluateSingleExpressionNoGroups(ExecState* exec_state, const UD
 }
 
 Status AggNode::EvaluateAggHashValue(ExecState* exec_state, AggHashValue* val) {
+  if (MergesPartialStates()) {
+    // The only stored column holds the serialized states.
+    const auto& states = *val->agg_cols[0];
+    for (size_t i = 0; i < states.Size(); ++i) {
+      PL_RETURN_IF_ERROR(MergePartialStates(states.GetView(i), &val->udas));
+    }
+    val->agg_cols[0]->Clear();
+    return Status::OK();
+  }
   size_t values_size = plan_node_->values().size();
   for (size_t i = 0; i < values_size; ++i) {
     const auto& uda_info = val->udas[i];
@@ -449,7 +647,7 @@ Status AggNode::EvaluateAggHashValue(ExecState* exec_state, AggHashValue* val) {
                         const std::vector<StatusOr<types::SharedColumnWrapper>>& children)
                         -> types::SharedColumnWrapper {
       DCHECK_EQ(children.size(), 0ULL);
-      return val->agg_cols[plan_cols_to_stored_map_[col.Index()]];
+      return val->agg_cols[plan_cols_to_stored_map_.at(col.Index())];
     });
 
     walker.OnAggregateExpression(
@@ -480,7 +678,43 @@ Status AggNode::EvaluateAggHashValue(ExecState* exec_state, AggHashValue* val) {
   return Status::OK();
 }
 
+Status AggNode::SerializePartialStates(const std::vector<UDAInfo>& udas,
+                                       arrow::ArrayBuilder* builder) {
+  std::string serialized;
+  std::string state;
+  for (const auto& uda_info : udas) {
+    PL_RETURN_IF_ERROR(uda_info.def->Serialize(uda_info.uda.get(), function_ctx_.get(), &state));
+    AppendPartialState(state, &serialized);
+  }
+  PL_RETURN_IF_ERROR(static_cast<arrow::StringBuilder*>(builder)->Append(serialized));
+  return Status::OK();
+}
+
+Status AggNode::MergePartialStates(std::string_view serialized, std::vector<UDAInfo>* udas) {
+  for (size_t i = 0; i < udas->size(); ++i) {
+    const auto& uda_info = (*udas)[i];
+    PL_ASSIGN_OR_RETURN(std::string_view state, ConsumePartialState(&serialized));
+    PL_ASSIGN_OR_RETURN(auto partial, MakeUDA(i));
+    PL_RETURN_IF_ERROR(uda_info.def->Deserialize(partial.get(), function_ctx_.get(),
+                                                 types::StringValue(state.data(), state.size())));
+    PL_RETURN_IF_ERROR(uda_info.def->Merge(uda_info.uda.get(), partial.get(), function_ctx_.get()));
+  }
+  if (!serialized.empty()) {
+    return error::InvalidArgument("Partial aggregate state has $0 trailing bytes",
+                                  serialized.size());
+  }
+  return Status::OK();
+}
+
 Status AggNode::CreateColumnMapping() {
+  if (MergesPartialStates()) {
+    // The value expressions refer to the input of the partial aggregate, so the serialized states
+    // are the only column to store.
+    plan_cols_to_stored_map_[partial_states_col_idx_] = 0;
+    stored_cols_to_plan_idx_.emplace_back(partial_states_col_idx_);
+    stored_cols_data_types_.emplace_back(types::STRING);
+    return Status::OK();
+  }
   for (const auto& expr : plan_node_->values()) {
     plan::ExpressionWalker<int> walker;
 
@@ -506,8 +740,8 @@ Status AggNode::CreateColumnMapping() {
   return Status::OK();
 }
 
-AggHashValue* AggNode::CreateAggHashValue(ExecState* exec_state) {
-  auto* val = udas_pool_.Add(new AggHashValue);
+AggHashValue* AggNode::CreateAggHashValue(ExecState* exec_state, ObjectPool* udas_pool) {
+  auto* val = udas_pool->Add(new AggHashValue);
   PL_CHECK_OK(CreateUDAInfoValues(&(val->udas), exec_state));
   for (const auto& dt : stored_cols_data_types_) {
     val->agg_cols.emplace_back(types::ColumnWrapper::Make(dt, 0));
@@ -515,32 +749,86 @@ AggHashValue* AggNode::CreateAggHashValue(ExecState* exec_state) {
   return val;
 }
 
-Status AggNode::CreateUDAInfoValues(std::vector<UDAInfo>* val, ExecState* exec_state) {
-  CHECK(val != nullptr);
-  CHECK_EQ(val->size(), 0ULL);
+AggHashValue* AggNode::CreateInlineAggHashValue() {
+  size_t chunk_idx = num_state_blocks_ / kStateBlocksPerChunk;
+  if (chunk_idx == state_chunks_.size()) {
+    state_chunks_.push_back(std::make_unique<char[]>(kStateBlocksPerChunk * state_block_size_));
+  }
+  char* states = state_chunks_[chunk_idx].get() +
+                 (num_state_blocks_ % kStateBlocksPerChunk) * state_block_size_;
+  ++num_state_blocks_;
+  for (size_t i = 0; i < uda_defs_.size(); ++i) {
+    uda_defs_[i]->InitState(states + state_offsets_[i]);
+  }
 
-  for (const auto& value : plan_node_->values()) {
-    std::vector<types::DataType> types;
-    types.reserve(value->Deps().size());
+  auto* val = &inline_hash_values_.emplace_back();
+  val->states = states;
+  return val;
+}
+
+Status AggNode::UpdateInlineStates(ExecState* exec_state, const RowBatch& rb) {
+  size_t num_rows = rb.num_rows();
+  if (num_rows == 0) {
+    return Status::OK();
+  }
+  group_states_.resize(num_rows);
+  for (size_t row_idx = 0; row_idx < num_rows; ++row_idx) {
+    DCHECK(group_args_chunk_[row_idx].av != nullptr);
+    group_states_[row_idx] = group_args_chunk_[row_idx].av->states;
+  }
+
+  // Agg exprs can only take columns or constants, so the args are read straight from the batch.
+  for (const auto& [i, value] : Enumerate(plan_node_->values())) {
+    std::vector<SharedArray> args;
+    std::vector<const arrow::Array*> raw_args;
     for (auto* dep : value->Deps()) {
-      PL_ASSIGN_OR_RETURN(auto type, GetTypeOfDep(*dep));
-      types.push_back(type);
+      switch (dep->ExpressionType()) {
+        case plan::Expression::kColumn:
+          args.push_back(rb.ColumnAt(static_cast<const plan::Column*>(dep)->Index()));
+          break;
+        case plan::Expression::kConstant:
+          args.push_back(
+              EvalScalarToArrow(exec_state, *static_cast<const plan::ScalarValue*>(dep), num_rows));
+          break;
+        default:
+          return error::InvalidArgument("Invalid expression type in agg: $0",
+                                        magic_enum::enum_name(dep->ExpressionType()));
+      }
+      raw_args.push_back(args.back().get());
     }
-    auto def = exec_state->GetUDADefinition(value->uda_id());
-    auto uda = def->Make();
+    PL_RETURN_IF_ERROR(
+        uda_defs_[i]->ExecBatchUpdateState(group_states_.data(), state_offsets_[i], raw_args));
+  }
+  return Status::OK();
+}
 
-    std::vector<std::shared_ptr<types::BaseValueType>> init_args;
-    for (const auto& arg : value->init_arguments()) {
-      init_args.push_back(arg.ToBaseValueType());
-    }
-    // We currently don't use FunctionContext in UDAs so continuing that tradition here, but at some
-    // point we probably want to change this.
-    PL_RETURN_IF_ERROR(def->ExecInit(uda.get(), nullptr, init_args));
-    val->emplace_back(std::move(uda), def);
+Status AggNode::CreateUDAInfoValues(std::vector<UDAInfo>* val, ExecState* exec_state) {
+  CHECK(val != nullptr);
+  CHECK_EQ(val->size(), 0ULL);
+
+  PL_UNUSED(exec_state);
+  DCHECK_EQ(uda_defs_.size(), plan_node_->values().size());
+  for (size_t i = 0; i < uda_defs_.size(); ++i) {
+    PL_ASSIGN_OR_RETURN(auto uda, MakeUDA(i));
+    val->emplace_back(std::move(uda), uda_defs_[i]);
   }
   return Status::OK();
 }
 
+StatusOr<std::unique_ptr<udf::UDA>> AggNode::MakeUDA(size_t value_idx) const {
+  auto* def = uda_defs_[value_idx];
+  auto uda = def->Make();
+
+  std::vector<std::shared_ptr<types::BaseValueType>> init_args;
+  for (const auto& arg : plan_node_->values()[value_idx]->init_arguments()) {
+    init_args.push_back(arg.ToBaseValueType());
+  }
+  // We currently don't use FunctionContext in UDAs so continuing that tradition here, but at some
+  // point we probably want to change this.
+  PL_RETURN_IF_ERROR(def->ExecInit(uda.get(), nullptr, init_args));
+  return uda;
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
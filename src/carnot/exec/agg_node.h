@@ -17,16 +17,20 @@
  */
 
 #pragma once
+#include <algorithm>
 #include <cstddef>
+#include <deque>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/exec/expression_evaluator.h"
+#include "src/carnot/exec/fork_join_pool.h"
 #include "src/carnot/exec/row_tuple.h"
 #include "src/carnot/plan/operators.h"
 #include "src/carnot/plan/scalar_expression.h"
@@ -40,6 +44,8 @@
 #include "src/shared/types/types.h"
 #include "src/table_store/table_store.h"
 
+DECLARE_int32(carnot_agg_partitions);
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -55,6 +61,9 @@ struct UDAInfo {
 struct AggHashValue {
   std::vector<UDAInfo> udas;
   std::vector<types::SharedColumnWrapper> agg_cols;
+  // When every UDA keeps an inline state, the group's states are stored back to back here
+  // instead of in udas/agg_cols (unowned).
+  char* states = nullptr;
 };
 
 struct GroupArgs {
@@ -67,12 +76,19 @@ class AggNode : public ProcessingNode {
   using AggHashMap = AbslRowTupleHashMap<AggHashValue*>;
 
  public:
-  AggNode() = default;
+  // With more than one partition, group by aggregates hash partition their rows by group key across
+  // that many threads. Each partition owns a disjoint set of groups, and at emission every
+  // partition produces its own output row batch.
+  explicit AggNode(int64_t num_partitions)
+      : num_partitions_(static_cast<size_t>(std::max<int64_t>(num_partitions, 1))) {}
+  AggNode() : AggNode(FLAGS_carnot_agg_partitions) {}
   virtual ~AggNode() = default;
 
  protected:
   Status AggregateGroupByNone(ExecState* exec_state, const table_store::schema::RowBatch& rb);
   Status AggregateGroupByClause(ExecState* exec_state, const table_store::schema::RowBatch& rb);
+  Status AggregateGroupByClausePartitioned(ExecState* exec_state,
+                                           const table_store::schema::RowBatch& rb);
 
   std::string DebugStringImpl() override;
   Status InitImpl(const plan::Operator& plan_node) override;
@@ -85,6 +101,15 @@ class AggNode : public ProcessingNode {
  private:
   AggHashMap agg_hash_map_;
   bool HasNoGroups() const { return plan_node_->groups().empty(); }
+  // A split aggregate runs as a partial aggregate, which emits the serialized UDA states of each
+  // group in a single string column instead of finalized values, followed by a finalizing
+  // aggregate, which merges those states and finalizes them.
+  bool EmitsPartialStates() const {
+    return plan_node_->partial_agg() && !plan_node_->finalize_results();
+  }
+  bool MergesPartialStates() const {
+    return plan_node_->finalize_results() && !plan_node_->partial_agg();
+  }
   // ReadyToEmitBatches returns true when the input stream has reached a point where output batches
   // can be emitted. In the windowed aggregate case, this happens whenever end of window (eow) is
   // reached. In the blocking aggregate case, this happens at eos only.
@@ -96,11 +121,17 @@ class AggNode : public ProcessingNode {
                                           plan::AggregateExpression* expr,
                                           const table_store::schema::RowBatch& rb);
   Status EvaluateAggHashValue(ExecState* exec_state, AggHashValue* val);
-  StatusOr<types::DataType> GetTypeOfDep(const plan::ScalarExpression& expr) const;
+
+  // Serializes the states of udas into a single value of the string builder.
+  Status SerializePartialStates(const std::vector<UDAInfo>& udas, arrow::ArrayBuilder* builder);
+  // Merges the states serialized by SerializePartialStates into udas.
+  Status MergePartialStates(std::string_view serialized, std::vector<UDAInfo>* udas);
 
   // Store information about aggregate node from the query planner.
   std::unique_ptr<plan::AggregateOperator> plan_node_;
   std::unique_ptr<table_store::schema::RowDescriptor> input_descriptor_;
+  // The input column with the serialized states, when merging partial aggregates.
+  int64_t partial_states_col_idx_ = -1;
 
   std::unique_ptr<udf::FunctionContext> function_ctx_;
 
@@ -131,8 +162,52 @@ class AggNode : public ProcessingNode {
   // This vector holds pointers to the row_tuples which are managed by the group_args_pool_.
 
   std::vector<GroupArgs> group_args_chunk_;
+
+  // The UDA definitions of the values, resolved once so that partitions can create UDAs without
+  // going through the exec state.
+  std::vector<udf::UDADefinition*> uda_defs_;
   // END: Variables specific to GroupBy Agg.
 
+  // Variables specific to inline state GroupBy Agg.
+  // If every UDA of the aggregate has a fixed-size inline state (and the aggregate isn't
+  // partitioned), the group's UDA states are updated in place straight from the input batch,
+  // which skips both the per group UDA instances and the buffered agg_cols.
+  bool inline_states_ = false;
+  // The offset of each value's state within a group's state block, and the size of the block.
+  std::vector<size_t> state_offsets_;
+  size_t state_block_size_ = 0;
+  // Group state blocks are carved out of fixed size chunks that are reused across windows.
+  static constexpr size_t kStateBlocksPerChunk = 1024;
+  std::vector<std::unique_ptr<char[]>> state_chunks_;
+  size_t num_state_blocks_ = 0;
+  std::deque<AggHashValue> inline_hash_values_;
+  // The state block of every row of the current row batch.
+  std::vector<char*> group_states_;
+  Status InitInlineStates();
+  AggHashValue* CreateInlineAggHashValue();
+  Status UpdateInlineStates(ExecState* exec_state, const table_store::schema::RowBatch& rb);
+  // END: Variables specific to inline state GroupBy Agg.
+
+  // Variables specific to partitioned GroupBy Agg.
+  struct AggPartition {
+    AggHashMap agg_hash_map;
+    ObjectPool udas_pool{"partition_udas_pool"};
+    // Indices of the rows of the current row batch that belong to this partition.
+    std::vector<int64_t> rows;
+  };
+  size_t num_partitions_ = 1;
+  std::vector<std::unique_ptr<AggPartition>> partitions_;
+  std::unique_ptr<ForkJoinPool> partition_pool_;
+  bool Partitioned() const { return !partitions_.empty(); }
+  size_t PartitionOf(size_t group_hash) const {
+    // Take the partition from the high bits of a remixed hash, so that the low bits the hash map
+    // itself probes with stay uniform within a partition.
+    return ((group_hash * 0x9E3779B97F4A7C15ULL) >> 32) % partitions_.size();
+  }
+  Status AggregatePartition(ExecState* exec_state, const table_store::schema::RowBatch& rb,
+                            AggPartition* partition);
+  // END: Variables specific to partitioned GroupBy Agg.
+
   // Creates a mapping between plan cols and stored cols (see above comment).
   Status CreateColumnMapping();
 
@@ -140,15 +215,16 @@ class AggNode : public ProcessingNode {
   Status HashRowBatch(ExecState* exec_state, const table_store::schema::RowBatch& rb);
   Status EvaluatePartialAggregates(ExecState* exec_state, size_t num_records);
   Status ResetGroupArgs();
-  Status ConvertAggHashMapToRowBatch(ExecState* exec_state,
+  Status ConvertAggHashMapToRowBatch(ExecState* exec_state, const AggHashMap& agg_hash_map,
                                      table_store::schema::RowBatch* output_rb);
 
-  AggHashValue* CreateAggHashValue(ExecState* exec_state);
+  AggHashValue* CreateAggHashValue(ExecState* exec_state, ObjectPool* udas_pool);
   RowTuple* CreateGroupArgsRowTuple() {
     return group_args_pool_.Add(new RowTuple(&group_data_types_));
   }
 
   Status CreateUDAInfoValues(std::vector<UDAInfo>* val, ExecState* exec_state);
+  StatusOr<std::unique_ptr<udf::UDA>> MakeUDA(size_t value_idx) const;
 };
 
 }  // namespace exec
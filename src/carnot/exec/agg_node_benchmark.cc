@@ -0,0 +1,143 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <google/protobuf/text_format.h>
+#include <sole.hpp>
+
+#include "src/carnot/exec/agg_node.h"
+#include "src/carnot/exec/test_utils.h"
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/carnot/udf/registry.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/types.h"
+
+using px::carnot::exec::AggNode;
+using px::carnot::exec::ExecState;
+using px::carnot::exec::MockMetricsStubGenerator;
+using px::carnot::exec::MockResultSinkStubGenerator;
+using px::carnot::exec::MockTraceStubGenerator;
+using px::carnot::exec::RowBatchBuilder;
+using px::table_store::schema::RowBatch;
+using px::table_store::schema::RowDescriptor;
+using px::types::DataType;
+using px::types::Int64Value;
+
+class SumUDA : public px::carnot::udf::UDA {
+ public:
+  void Update(px::carnot::udf::FunctionContext*, Int64Value arg) { sum_ = sum_.val + arg.val; }
+  void Merge(px::carnot::udf::FunctionContext*, const SumUDA& other) {
+    sum_ = sum_.val + other.sum_.val;
+  }
+  Int64Value Finalize(px::carnot::udf::FunctionContext*) { return sum_; }
+
+ protected:
+  Int64Value sum_ = 0;
+};
+
+constexpr char kSumByGroupAgg[] = R"(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  values {
+    name: "sum"
+    args {
+      column {
+        node: 0
+        index: 1
+      }
+    }
+  }
+  groups {
+    node: 0
+    index: 0
+  }
+  group_names: "group"
+  value_names: "sum"
+})";
+
+constexpr int64_t kNumPEMs = 32;
+constexpr int64_t kBatchesPerPEM = 8;
+constexpr int64_t kRowsPerBatch = 1024;
+
+// Builds the row batches a Kelvin aggregate sees from kNumPEMs streams, in the order the streams
+// interleave.
+std::vector<std::unique_ptr<RowBatch>> SimulatedPEMStreams(int64_t num_groups) {
+  RowDescriptor rd({DataType::INT64, DataType::INT64});
+  std::mt19937_64 rng(37);
+  std::uniform_int_distribution<int64_t> group_dist(0, num_groups - 1);
+  std::vector<std::unique_ptr<RowBatch>> batches;
+  for (int64_t b = 0; b < kBatchesPerPEM; ++b) {
+    for (int64_t pem = 0; pem < kNumPEMs; ++pem) {
+      std::vector<Int64Value> groups(kRowsPerBatch);
+      std::vector<Int64Value> values(kRowsPerBatch);
+      for (int64_t i = 0; i < kRowsPerBatch; ++i) {
+        groups[i] = group_dist(rng);
+        values[i] = i;
+      }
+      bool last = b == kBatchesPerPEM - 1 && pem == kNumPEMs - 1;
+      batches.push_back(std::make_unique<RowBatch>(RowBatchBuilder(rd, kRowsPerBatch, last, last)
+                                                       .AddColumn<Int64Value>(groups)
+                                                       .AddColumn<Int64Value>(values)
+                                                       .get()));
+    }
+  }
+  return batches;
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_AggNodePartitioned(benchmark::State& state) {
+  int64_t num_partitions = state.range(0);
+  int64_t num_groups = state.range(1);
+
+  auto func_registry = std::make_unique<px::carnot::udf::Registry>("test_registry");
+  PL_CHECK_OK(func_registry->Register<SumUDA>("sum"));
+  auto table_store = std::make_shared<px::table_store::TableStore>();
+  auto exec_state = std::make_unique<ExecState>(
+      func_registry.get(), table_store, MockResultSinkStubGenerator, MockMetricsStubGenerator,
+      MockTraceStubGenerator, sole::uuid4(), nullptr);
+  PL_CHECK_OK(exec_state->AddUDA(0, "sum", {DataType::INT64}));
+
+  px::carnot::planpb::Operator op_pb;
+  CHECK(google::protobuf::TextFormat::MergeFromString(kSumByGroupAgg, &op_pb));
+  auto plan_node = px::carnot::plan::AggregateOperator::FromProto(op_pb, 1);
+  RowDescriptor input_rd({DataType::INT64, DataType::INT64});
+  RowDescriptor output_rd({DataType::INT64, DataType::INT64});
+
+  auto batches = SimulatedPEMStreams(num_groups);
+
+  for (auto _ : state) {
+    AggNode node(num_partitions);
+    PL_CHECK_OK(node.Init(*plan_node, output_rd, {input_rd}));
+    PL_CHECK_OK(node.Prepare(exec_state.get()));
+    PL_CHECK_OK(node.Open(exec_state.get()));
+    for (const auto& rb : batches) {
+      PL_CHECK_OK(node.ConsumeNext(exec_state.get(), *rb, 0));
+    }
+    PL_CHECK_OK(node.Close(exec_state.get()));
+  }
+  state.SetItemsProcessed(state.iterations() * kNumPEMs * kBatchesPerPEM * kRowsPerBatch);
+}
+
+BENCHMARK(BM_AggNodePartitioned)
+    ->ArgsProduct({{1, 2, 4, 8}, {1 << 10, 1 << 16, 1 << 20}})
+    ->Unit(benchmark::kMillisecond);
@@ -19,6 +19,8 @@
 #include "src/carnot/exec/agg_node.h"
 
 #include <algorithm>
+#include <string>
+#include <vector>
 
 #include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
@@ -53,6 +55,31 @@ class MinSumUDA : public udf::UDA {
   types::Int64Value sum_ = 0;
 };
 
+// MinSumUDA with its sum kept in an inline state.
+class InlineMinSumUDA : public udf::UDA {
+ public:
+  struct State {
+    int64_t sum = 0;
+  };
+
+  static void UpdateState(State* state, types::Int64Value arg1, types::Int64Value arg2) {
+    state->sum += std::min(arg1.val, arg2.val);
+  }
+  static void MergeState(State* state, const State& other) { state->sum += other.sum; }
+  static types::Int64Value FinalizeState(const State& state) { return state.sum; }
+
+  void Update(udf::FunctionContext*, types::Int64Value arg1, types::Int64Value arg2) {
+    UpdateState(&state_, arg1, arg2);
+  }
+  void Merge(udf::FunctionContext*, const InlineMinSumUDA& other) {
+    MergeState(&state_, other.state_);
+  }
+  types::Int64Value Finalize(udf::FunctionContext*) { return FinalizeState(state_); }
+
+ protected:
+  State state_;
+};
+
 class MinSumWithInitUDA : public udf::UDA {
  public:
   Status Init(udf::FunctionContext*, types::Int64Value init_val) {
@@ -71,6 +98,39 @@ class MinSumWithInitUDA : public udf::UDA {
   types::Int64Value sum_ = 0;
 };
 
+// MinSumUDA that supports partial aggregates, serializing its sum as a decimal string.
+class PartialMinSumUDA : public udf::UDA {
+ public:
+  void Update(udf::FunctionContext*, types::Int64Value arg1, types::Int64Value arg2) {
+    sum_ = sum_.val + std::min(arg1.val, arg2.val);
+  }
+  void Merge(udf::FunctionContext*, const PartialMinSumUDA& other) {
+    sum_ = sum_.val + other.sum_.val;
+  }
+  types::Int64Value Finalize(udf::FunctionContext*) { return sum_; }
+  types::StringValue Serialize(udf::FunctionContext*) { return absl::StrCat(sum_.val); }
+  Status Deserialize(udf::FunctionContext*, const types::StringValue& data) {
+    if (!absl::SimpleAtoi(data, &sum_.val)) {
+      return error::InvalidArgument("Invalid partial minsum: $0", data);
+    }
+    return Status::OK();
+  }
+
+ protected:
+  types::Int64Value sum_ = 0;
+};
+
+// Packs the serialized states of a group's values the way a partial aggregate emits them.
+std::string PartialStates(const std::vector<std::string>& states) {
+  std::string out;
+  for (const auto& state : states) {
+    uint32_t len = state.size();
+    out.append(reinterpret_cast<const char*>(&len), sizeof(len));
+    out.append(state);
+  }
+  return out;
+}
+
 constexpr char kBlockingNoGroupAgg[] = R"(
 op_type: AGGREGATE_OPERATOR
 agg_op {
@@ -201,6 +261,51 @@ agg_op {
   value_names: "value1"
 })";
 
+constexpr char kWindowedSingleGroupInlineAgg[] = R"(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  windowed: true
+  values {
+    name: "inline_minsum"
+    args {
+      column {
+        node:0
+        index: 0
+      }
+    }
+    args {
+      column {
+        node:0
+        index: 1
+      }
+    }
+    id: 2
+  }
+  values {
+    name: "inline_minsum"
+    args {
+      column {
+        node:0
+        index: 1
+      }
+    }
+    args {
+      constant {
+        data_type: INT64
+        int64_value: 3
+      }
+    }
+    id: 2
+  }
+  groups {
+     node: 0
+     index: 0
+  }
+  group_names: "g1"
+  value_names: "value1"
+  value_names: "value2"
+})";
+
 constexpr char kSingleGroupNoValues[] = R"(
 op_type: AGGREGATE_OPERATOR
 agg_op {
@@ -270,6 +375,92 @@ agg_op {
   value_names: "value1"
 })";
 
+constexpr char kPartialSingleGroupAgg[] = R"(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  windowed: false
+  values {
+    name: "partial_minsum"
+    args {
+      column {
+        node:0
+        index: 0
+      }
+    }
+    args {
+      column {
+        node:0
+        index: 1
+      }
+    }
+    id: 3
+  }
+  groups {
+     node: 0
+     index: 0
+  }
+  group_names: "g1"
+  value_names: "value1"
+  partial_agg: true
+  finalize_results: false
+})";
+
+// The values of a finalizing aggregate still refer to the input of the partial aggregate.
+constexpr char kFinalizeSingleGroupAgg[] = R"(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  windowed: false
+  values {
+    name: "partial_minsum"
+    args {
+      column {
+        node:0
+        index: 0
+      }
+    }
+    args {
+      column {
+        node:0
+        index: 1
+      }
+    }
+    id: 3
+  }
+  groups {
+     node: 0
+     index: 0
+  }
+  group_names: "g1"
+  value_names: "value1"
+  partial_agg: false
+  finalize_results: true
+})";
+
+constexpr char kFinalizeNoGroupAgg[] = R"(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  windowed: false
+  values {
+    name: "partial_minsum"
+    args {
+      column {
+        node:0
+        index: 0
+      }
+    }
+    args {
+      column {
+        node:0
+        index: 1
+      }
+    }
+    id: 3
+  }
+  value_names: "value1"
+  partial_agg: false
+  finalize_results: true
+})";
+
 std::unique_ptr<ExecState> MakeTestExecState(udf::Registry* registry) {
   auto table_store = std::make_shared<table_store::TableStore>();
   return std::make_unique<ExecState>(registry, table_store, MockResultSinkStubGenerator,
@@ -289,11 +480,15 @@ class AggNodeTest : public ::testing::Test {
     func_registry_ = std::make_unique<udf::Registry>("test");
     EXPECT_TRUE(func_registry_->Register<MinSumUDA>("minsum").ok());
     EXPECT_TRUE(func_registry_->Register<MinSumWithInitUDA>("minsum_w_init").ok());
+    EXPECT_TRUE(func_registry_->Register<InlineMinSumUDA>("inline_minsum").ok());
+    EXPECT_TRUE(func_registry_->Register<PartialMinSumUDA>("partial_minsum").ok());
 
     exec_state_ = MakeTestExecState(func_registry_.get());
     EXPECT_OK(exec_state_->AddUDA(0, "minsum",
                                   std::vector<types::DataType>({types::INT64, types::INT64})));
     EXPECT_OK(exec_state_->AddUDA(1, "minsum_w_init", {types::INT64, types::INT64, types::INT64}));
+    EXPECT_OK(exec_state_->AddUDA(2, "inline_minsum", {types::INT64, types::INT64}));
+    EXPECT_OK(exec_state_->AddUDA(3, "partial_minsum", {types::INT64, types::INT64}));
   }
 
  protected:
@@ -383,6 +578,49 @@ TEST_F(AggNodeTest, single_group_blocking) {
       .Close();
 }
 
+TEST_F(AggNodeTest, single_group_blocking_partitioned) {
+  auto plan_node = PlanNodeFromPbtxt(kBlockingSingleGroupAgg);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  constexpr int64_t kNumPartitions = 4;
+  constexpr int64_t kNumGroups = 64;
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get(), kNumPartitions);
+
+  // Every group shows up twice in the first batch and once in the second, and the second column
+  // is chosen so that minsum adds up the group key: min(g, 1000) twice and min(g, 0) once.
+  std::vector<types::Int64Value> groups1, values1, groups2, values2, expected_groups,
+      expected_values;
+  for (int64_t g = 0; g < kNumGroups; ++g) {
+    groups1.insert(groups1.end(), {g, g});
+    values1.insert(values1.end(), {1000, 1000});
+    groups2.push_back(g);
+    values2.push_back(0);
+    expected_groups.push_back(g);
+    expected_values.push_back(2 * g);
+  }
+
+  // With this many groups every partition owns some, so each emits one batch.
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 2 * kNumGroups, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>(groups1)
+                       .AddColumn<types::Int64Value>(values1)
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, kNumGroups, true, true)
+                       .AddColumn<types::Int64Value>(groups2)
+                       .AddColumn<types::Int64Value>(values2)
+                       .get(),
+                   0, kNumPartitions)
+      .ExpectRowBatchesData(RowBatchBuilder(output_rd, kNumGroups, true, true)
+                                .AddColumn<types::Int64Value>(expected_groups)
+                                .AddColumn<types::Int64Value>(expected_values)
+                                .get(),
+                            kNumPartitions)
+      .Close();
+}
+
 TEST_F(AggNodeTest, multiple_groups_blocking) {
   auto plan_node = PlanNodeFromPbtxt(kBlockingMultipleGroupAgg);
   RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64, types::DataType::INT64});
@@ -530,6 +768,38 @@ TEST_F(AggNodeTest, single_group_windowed) {
       .Close();
 }
 
+TEST_F(AggNodeTest, single_group_windowed_inline_state) {
+  auto plan_node = PlanNodeFromPbtxt(kWindowedSingleGroupInlineAgg);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64, types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  // The second window reuses the state blocks of the first, so it must start from fresh states.
+  for (bool eos : {false, true}) {
+    tester
+        .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                         .AddColumn<types::Int64Value>({1, 1, 2, 2})
+                         .AddColumn<types::Int64Value>({2, 3, 3, 1})
+                         .get(),
+                     0, 0)
+        .ConsumeNext(RowBatchBuilder(input_rd, 4, true, eos)
+                         .AddColumn<types::Int64Value>({5, 6, 3, 4})
+                         .AddColumn<types::Int64Value>({1, 5, 3, 8})
+                         .get(),
+                     0)
+        .ExpectRowBatch(RowBatchBuilder(output_rd, 6, true, eos)
+                            .AddColumn<types::Int64Value>({1, 2, 3, 4, 5, 6})
+                            .AddColumn<types::Int64Value>({2, 3, 3, 4, 1, 5})
+                            .AddColumn<types::Int64Value>({5, 4, 3, 3, 1, 3})
+                            .get(),
+                        false);
+  }
+  tester.Close();
+}
+
 TEST_F(AggNodeTest, no_aggregate_expressions) {
   auto plan_node = PlanNodeFromPbtxt(kSingleGroupNoValues);
   RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
@@ -611,6 +881,107 @@ TEST_F(AggNodeTest, single_group_blocking_init_args) {
       .Close();
 }
 
+TEST_F(AggNodeTest, single_group_partial) {
+  auto plan_node = PlanNodeFromPbtxt(kPartialSingleGroupAgg);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::STRING});
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 1, 2, 2})
+                       .AddColumn<types::Int64Value>({2, 3, 3, 1})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, true, true)
+                       .AddColumn<types::Int64Value>({5, 6, 3, 4})
+                       .AddColumn<types::Int64Value>({1, 5, 3, 8})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 6, true, true)
+                          .AddColumn<types::Int64Value>({1, 2, 3, 4, 5, 6})
+                          .AddColumn<types::StringValue>(
+                              {PartialStates({"2"}), PartialStates({"3"}), PartialStates({"3"}),
+                               PartialStates({"4"}), PartialStates({"1"}), PartialStates({"5"})})
+                          .get(),
+                      false)
+      .Close();
+}
+
+TEST_F(AggNodeTest, single_group_finalize) {
+  auto plan_node = PlanNodeFromPbtxt(kFinalizeSingleGroupAgg);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::STRING});
+
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  // Each row is the partial aggregate of a group from one of the agents.
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 3, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2, 1})
+                       .AddColumn<types::StringValue>(
+                           {PartialStates({"2"}), PartialStates({"3"}), PartialStates({"5"})})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, true, true)
+                       .AddColumn<types::Int64Value>({2, 3})
+                       .AddColumn<types::StringValue>({PartialStates({"4"}), PartialStates({"6"})})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 3, true, true)
+                          .AddColumn<types::Int64Value>({1, 2, 3})
+                          .AddColumn<types::Int64Value>({7, 7, 6})
+                          .get(),
+                      false)
+      .Close();
+}
+
+TEST_F(AggNodeTest, no_groups_finalize) {
+  auto plan_node = PlanNodeFromPbtxt(kFinalizeNoGroupAgg);
+  RowDescriptor input_rd({types::DataType::STRING});
+
+  RowDescriptor output_rd({types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::StringValue>({PartialStates({"2"}), PartialStates({"3"})})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 1, true, true)
+                       .AddColumn<types::StringValue>({PartialStates({"10"})})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 1, true, true)
+                          .AddColumn<types::Int64Value>({Int64Value(15)})
+                          .get(),
+                      false)
+      .Close();
+}
+
+TEST_F(AggNodeTest, partial_agg_requires_partial_uda) {
+  planpb::Operator op_pb;
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(kBlockingSingleGroupAgg, &op_pb));
+  op_pb.mutable_agg_op()->set_partial_agg(true);
+  auto plan_node = plan::AggregateOperator::FromProto(op_pb, 1);
+
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::STRING});
+
+  AggNode node;
+  ASSERT_OK(node.Init(*plan_node, output_rd, {input_rd}));
+  ASSERT_OK(node.Prepare(exec_state_.get()));
+  // minsum can't be serialized, so it can't run as a partial aggregate.
+  EXPECT_NOT_OK(node.Open(exec_state_.get()));
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
@@ -115,6 +115,11 @@ Status EquijoinNode::InitImpl(const plan::Operator& plan_node) {
   return Status::OK();
 }
 
+bool EquijoinNode::EnableRuntimeFilter() {
+  publish_runtime_filter_ = !probe_spec_.emit_unmatched_rows;
+  return publish_runtime_filter_;
+}
+
 Status EquijoinNode::InitializeColumnBuilders() {
   for (size_t i = 0; i < output_descriptor_->size(); ++i) {
     column_builders_[i] =
@@ -420,6 +425,9 @@ Status EquijoinNode::ConsumeBuildBatch(ExecState* exec_state,
   PL_RETURN_IF_ERROR(HashRowBatch(rb));
 
   if (build_eos_) {
+    if (publish_runtime_filter_) {
+      PL_RETURN_IF_ERROR(PublishRuntimeFilter(exec_state));
+    }
     while (probe_batches_.size()) {
       PL_RETURN_IF_ERROR(DoProbe(exec_state, probe_batches_.front()));
       probe_batches_.pop();
@@ -428,6 +436,16 @@ Status EquijoinNode::ConsumeBuildBatch(ExecState* exec_state,
   return Status::OK();
 }
 
+Status EquijoinNode::PublishRuntimeFilter(ExecState* exec_state) {
+  PL_ASSIGN_OR_RETURN(std::shared_ptr<RuntimeJoinFilter> filter,
+                      RuntimeJoinFilter::Create(key_data_types_, build_buffer_.size()));
+  for (const auto& entry : build_buffer_) {
+    filter->Insert(*entry.first);
+  }
+  exec_state->AddRuntimeJoinFilter(plan_node_->id(), std::move(filter));
+  return Status::OK();
+}
+
 Status EquijoinNode::ConsumeProbeBatch(ExecState* exec_state,
                                        const table_store::schema::RowBatch& rb) {
   if (!build_eos_) {
@@ -64,6 +64,20 @@ class EquijoinNode : public ProcessingNode {
   EquijoinNode() = default;
   virtual ~EquijoinNode() = default;
 
+  /**
+   * Makes the node publish a RuntimeJoinFilter of its build side keys to the ExecState once the
+   * build side is complete, under the id of the join operator. Must be called after Init.
+   * @return false if the probe side can't be filtered, because the join emits unmatched probe
+   * rows.
+   */
+  bool EnableRuntimeFilter();
+
+  // The parent index of the probe side and the indices of its key columns. Valid after Init.
+  size_t probe_parent_index() const {
+    return probe_table_ == EquijoinNode::JoinInputTable::kLeftTable ? 0 : 1;
+  }
+  const std::vector<int64_t>& probe_key_indices() const { return probe_spec_.key_indices; }
+
  protected:
   std::string DebugStringImpl() override;
   Status InitImpl(const plan::Operator& plan_node) override;
@@ -89,8 +103,10 @@ class EquijoinNode : public ProcessingNode {
   Status NextOutputBatch(ExecState* exec_state);
   Status ConsumeBuildBatch(ExecState* exec_state, const table_store::schema::RowBatch& rb);
   Status ConsumeProbeBatch(ExecState* exec_state, const table_store::schema::RowBatch& rb);
+  Status PublishRuntimeFilter(ExecState* exec_state);
 
   bool build_eos_ = false;
+  bool publish_runtime_filter_ = false;
   bool probe_eos_ = false;
   // Note whether the left or the right table is the probe table.
   JoinInputTable probe_table_;
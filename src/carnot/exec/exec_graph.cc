@@ -22,6 +22,8 @@
 #include <memory>
 #include <set>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "src/carnot/exec/agg_node.h"
 #include "src/carnot/exec/empty_source_node.h"
@@ -43,6 +45,16 @@
 #include "src/common/perf/perf.h"
 #include "src/table_store/table_store.h"
 
+DEFINE_bool(carnot_late_materialization,
+            gflags::BoolFromEnv("PL_CARNOT_LATE_MATERIALIZATION", true),
+            "Whether memory sources may apply the predicate of the filter that directly consumes "
+            "them, and only read the other columns for rows that pass it.");
+DEFINE_bool(carnot_runtime_join_filters,
+            gflags::BoolFromEnv("PL_CARNOT_RUNTIME_JOIN_FILTERS", true),
+            "Whether joins may publish a bloom filter of their build side keys, which the memory "
+            "source on their probe side uses to drop rows that can't match. Only applies when "
+            "the join and that memory source are in the same plan fragment.");
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -62,6 +74,7 @@ Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState
 
   std::unordered_map<int64_t, ExecNode*> nodes;
   std::unordered_map<int64_t, RowDescriptor> descriptors;
+  std::unordered_map<int64_t, MemorySourceNode*> memory_sources;
   return plan::PlanFragmentWalker()
       .OnMap([&](auto& node) {
         return OnOperatorImpl<plan::MapOperator, MapNode>(node, &descriptors);
@@ -73,10 +86,14 @@ Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState
         return OnOperatorImpl<plan::AggregateOperator, AggNode>(node, &descriptors);
       })
       .OnMemorySource([&](auto& node) {
-        return OnOperatorImpl<plan::MemorySourceOperator, MemorySourceNode>(node, &descriptors);
+        PL_RETURN_IF_ERROR(
+            OnOperatorImpl<plan::MemorySourceOperator, MemorySourceNode>(node, &descriptors));
+        memory_sources[node.id()] = static_cast<MemorySourceNode*>(nodes_[node.id()]);
+        return Status::OK();
       })
       .OnFilter([&](auto& node) {
-        return OnOperatorImpl<plan::FilterOperator, FilterNode>(node, &descriptors);
+        PL_RETURN_IF_ERROR(OnOperatorImpl<plan::FilterOperator, FilterNode>(node, &descriptors));
+        return MaybePushDownFilter(node, memory_sources);
       })
       .OnLimit([&](auto& node) {
         return OnOperatorImpl<plan::LimitOperator, LimitNode>(node, &descriptors);
@@ -85,7 +102,8 @@ Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState
         return OnOperatorImpl<plan::UnionOperator, UnionNode>(node, &descriptors);
       })
       .OnJoin([&](auto& node) {
-        return OnOperatorImpl<plan::JoinOperator, EquijoinNode>(node, &descriptors);
+        PL_RETURN_IF_ERROR(OnOperatorImpl<plan::JoinOperator, EquijoinNode>(node, &descriptors));
+        return MaybeAddRuntimeJoinFilter(node, memory_sources);
       })
       .OnGRPCSource([&](auto& node) {
         auto s = OnOperatorImpl<plan::GRPCSourceOperator, GRPCSourceNode>(node, &descriptors);
@@ -111,6 +129,72 @@ Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState
       .Walk(pf_);
 }
 
+Status ExecutionGraph::MaybePushDownFilter(
+    const plan::FilterOperator& filter,
+    const std::unordered_map<int64_t, MemorySourceNode*>& memory_sources) {
+  if (!FLAGS_carnot_late_materialization) {
+    return Status::OK();
+  }
+  // The predicate can only be applied by the source if the filter is the sole consumer of the
+  // source's output.
+  auto parents = pf_->dag().ParentsOf(filter.id());
+  if (parents.size() != 1 || pf_->dag().DependenciesOf(parents[0]).size() != 1) {
+    return Status::OK();
+  }
+  auto source = memory_sources.find(parents[0]);
+  if (source == memory_sources.end()) {
+    return Status::OK();
+  }
+  PL_ASSIGN_OR_RETURN(bool applied,
+                      source->second->PushDownFilterPredicate(filter.pb().expression()));
+  if (applied) {
+    static_cast<FilterNode*>(nodes_[filter.id()])->SetPredicateAppliedUpstream();
+  }
+  return Status::OK();
+}
+
+Status ExecutionGraph::MaybeAddRuntimeJoinFilter(
+    const plan::JoinOperator& join,
+    const std::unordered_map<int64_t, MemorySourceNode*>& memory_sources) {
+  if (!FLAGS_carnot_runtime_join_filters) {
+    return Status::OK();
+  }
+  auto parents = pf_->dag().ParentsOf(join.id());
+  if (parents.size() != 2) {
+    return Status::OK();
+  }
+  auto* join_node = static_cast<EquijoinNode*>(nodes_.at(join.id()));
+
+  // Walk up from the probe side of the join, through any filters, to the memory source that scans
+  // it. Rows can only be dropped early if the join is the sole consumer of every operator along
+  // the way.
+  int64_t op_id = parents[join_node->probe_parent_index()];
+  std::vector<int64_t> key_cols = join_node->probe_key_indices();
+  while (true) {
+    if (pf_->dag().DependenciesOf(op_id).size() != 1) {
+      return Status::OK();
+    }
+    if (memory_sources.find(op_id) != memory_sources.end()) {
+      break;
+    }
+    auto* op = pf_->nodes().at(op_id).get();
+    auto op_parents = pf_->dag().ParentsOf(op_id);
+    if (op->op_type() != planpb::FILTER_OPERATOR || op_parents.size() != 1) {
+      return Status::OK();
+    }
+    auto selected_cols = static_cast<plan::FilterOperator*>(op)->selected_cols();
+    for (auto& col : key_cols) {
+      col = selected_cols[col];
+    }
+    op_id = op_parents[0];
+  }
+
+  if (join_node->EnableRuntimeFilter()) {
+    memory_sources.at(op_id)->AddRuntimeJoinFilter(join.id(), std::move(key_cols));
+  }
+  return Status::OK();
+}
+
 bool ExecutionGraph::YieldWithTimeout() {
   std::unique_lock<std::mutex> lock(execution_mutex_);
   if (continue_) {
@@ -174,6 +258,33 @@ Status ExecutionGraph::CheckDownstreamGRPCConnectionsHealth() {
   return Status::OK();
 }
 
+bool ExecutionGraph::DownstreamSinksStopped(int64_t source_id) {
+  if (grpc_sinks_.empty()) {
+    return false;
+  }
+  auto it = source_sinks_.find(source_id);
+  if (it == source_sinks_.end()) {
+    std::vector<int64_t> sinks;
+    for (int64_t dep : pf_->dag().TransitiveDepsFrom(source_id)) {
+      auto node = nodes_.find(dep);
+      if (node != nodes_.end() && node->second->IsSink()) {
+        sinks.push_back(dep);
+      }
+    }
+    it = source_sinks_.emplace(source_id, std::move(sinks)).first;
+  }
+  if (it->second.empty()) {
+    return false;
+  }
+  for (int64_t sink_id : it->second) {
+    if (!grpc_sinks_.contains(sink_id) ||
+        !static_cast<GRPCSinkNode*>(nodes_.at(sink_id))->downstream_stopped()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 Status ExecutionGraph::ExecuteSources() {
   absl::flat_hash_set<SourceNode*> running_sources;
 
@@ -214,6 +325,9 @@ Status ExecutionGraph::ExecuteSources() {
         }
         PL_RETURN_IF_ERROR(source->GenerateNext(exec_state_));
       }
+      if (DownstreamSinksStopped(source_to_id[source])) {
+        exec_state_->StopSource(source_to_id[source]);
+      }
 
       // keep_running will be set to false when a downstream limit for this particular
       // source (set in exec_state) has been reached.
@@ -274,6 +388,14 @@ Status ExecutionGraph::ExecuteSources() {
         }
       }
       PL_RETURN_IF_ERROR(CheckDownstreamGRPCConnectionsHealth());
+      // The connection checks may have found that the destinations of some sinks no longer need
+      // data, in which case the sources that only feed those sinks are done.
+      for (SourceNode* source : running_sources) {
+        if (DownstreamSinksStopped(source_to_id.at(source))) {
+          exec_state_->StopSource(source_to_id.at(source));
+          completed_sources_wait_loop.insert(source);
+        }
+      }
 
       // Flush all of the completed sources after this phase of source deletion.
       for (SourceNode* source : completed_sources_wait_loop) {
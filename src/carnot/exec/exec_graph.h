@@ -28,6 +28,8 @@
 #include <utility>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
+
 #include "src/carnot/dag/dag.h"
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
@@ -209,6 +211,22 @@ class ExecutionGraph {
 
   Status ExecuteSources();
 
+  // Whether every sink fed by the source is a GRPC sink whose destination no longer needs data, in
+  // which case the source can stop.
+  bool DownstreamSinksStopped(int64_t source_id);
+
+  // Pushes the filter's predicate down into its parent, if the parent is a memory source whose
+  // only consumer is the filter.
+  Status MaybePushDownFilter(const plan::FilterOperator& filter,
+                             const std::unordered_map<int64_t, MemorySourceNode*>& memory_sources);
+
+  // Lets the memory source on the probe side of the join drop rows using the join's runtime
+  // filter, if the join is the only consumer of that source's rows. The source has to be in this
+  // fragment; a probe side fed by a GRPC source is left unfiltered.
+  Status MaybeAddRuntimeJoinFilter(
+      const plan::JoinOperator& join,
+      const std::unordered_map<int64_t, MemorySourceNode*>& memory_sources);
+
   ExecState* exec_state_;
   ObjectPool pool_{"exec_graph_pool"};
   table_store::schema::Schema* schema_;
@@ -217,6 +235,8 @@ class ExecutionGraph {
   std::vector<int64_t> sources_;
   absl::flat_hash_set<int64_t> grpc_sources_;
   absl::flat_hash_set<int64_t> grpc_sinks_;
+  // The sinks that each source feeds, computed as needed by DownstreamSinksStopped().
+  absl::flat_hash_map<int64_t, std::vector<int64_t>> source_sinks_;
   std::unordered_map<int64_t, ExecNode*> nodes_;
 
   SystemTimePoint query_start_time_;
@@ -66,12 +66,23 @@ class MultiplyUDF : public udf::ScalarUDF {
   }
 };
 
+// Counts its calls, so tests can check how often a filter predicate is evaluated.
+class CountingGreaterThanUDF : public udf::ScalarUDF {
+ public:
+  types::BoolValue Exec(udf::FunctionContext*, types::Int64Value v1, types::Int64Value v2) {
+    ++num_calls;
+    return v1.val > v2.val;
+  }
+  static inline int64_t num_calls = 0;
+};
+
 class BaseExecGraphTest : public ::testing::Test {
  protected:
   void SetUpExecState() {
     func_registry_ = std::make_unique<udf::Registry>("test_registry");
     func_registry_->RegisterOrDie<AddUDF>("add");
     func_registry_->RegisterOrDie<MultiplyUDF>("multiply");
+    func_registry_->RegisterOrDie<CountingGreaterThanUDF>("greaterThan");
 
     auto table_store = std::make_shared<table_store::TableStore>();
     exec_state_ = std::make_unique<ExecState>(func_registry_.get(), table_store,
@@ -198,6 +209,156 @@ TEST_P(ExecGraphExecuteTest, execute) {
       types::ToArrow(out_in2, arrow::default_memory_pool())));
 }
 
+constexpr char kFilteredMemorySourcePlanFragment[] = R"proto(
+  id: 1,
+  dag {
+    nodes {
+      id: 1
+      sorted_children: 2
+    }
+    nodes {
+      id: 2
+      sorted_children: 3
+      sorted_parents: 1
+    }
+    nodes {
+      id: 3
+      sorted_parents: 2
+    }
+  }
+  nodes {
+    id: 1
+    op {
+      op_type: MEMORY_SOURCE_OPERATOR
+      mem_source_op {
+        name: "numbers"
+        column_idxs: 0
+        column_types: INT64
+        column_names: "a"
+        column_idxs: 1
+        column_types: BOOLEAN
+        column_names: "b"
+        column_idxs: 2
+        column_types: FLOAT64
+        column_names: "c"
+      }
+    }
+  }
+  nodes {
+    id: 2
+    op {
+      op_type: FILTER_OPERATOR
+      filter_op {
+        expression {
+          func {
+            name: "greaterThan"
+            id: 2
+            args {
+              column {
+                node: 1
+                index: 0
+              }
+            }
+            args {
+              constant {
+                data_type: INT64
+                int64_value: 2
+              }
+            }
+            args_data_types: INT64
+            args_data_types: INT64
+          }
+        }
+        columns {
+          node: 1
+          index: 0
+        }
+        columns {
+          node: 1
+          index: 2
+        }
+      }
+    }
+  }
+  nodes {
+    id: 3
+    op {
+      op_type: MEMORY_SINK_OPERATOR
+      mem_sink_op {
+        name: "output"
+        column_types: INT64
+        column_types: FLOAT64
+        column_names: "a"
+        column_names: "c"
+      }
+    }
+  }
+)proto";
+
+TEST_F(ExecGraphTest, filter_pushed_into_memory_source) {
+  planpb::PlanFragment pf_pb;
+  ASSERT_TRUE(TextFormat::MergeFromString(kFilteredMemorySourcePlanFragment, &pf_pb));
+  auto plan_fragment = std::make_shared<plan::PlanFragment>(1);
+  ASSERT_OK(plan_fragment->Init(pf_pb));
+
+  auto plan_state = std::make_unique<plan::PlanState>(func_registry_.get());
+  table_store::schema::Relation rel(
+      {types::DataType::INT64, types::DataType::BOOLEAN, types::DataType::FLOAT64},
+      {"a", "b", "c"});
+  auto schema = std::make_shared<table_store::schema::Schema>();
+  schema->AddRelation(1, rel);
+
+  auto table = Table::Create("numbers", rel);
+  auto rb1 = RowBatch(RowDescriptor(rel.col_types()), 3);
+  std::vector<types::Int64Value> col1_in1 = {1, 2, 3};
+  std::vector<types::BoolValue> col2_in1 = {true, false, true};
+  std::vector<types::Float64Value> col3_in1 = {1.4, 6.2, 10.2};
+  EXPECT_OK(rb1.AddColumn(types::ToArrow(col1_in1, arrow::default_memory_pool())));
+  EXPECT_OK(rb1.AddColumn(types::ToArrow(col2_in1, arrow::default_memory_pool())));
+  EXPECT_OK(rb1.AddColumn(types::ToArrow(col3_in1, arrow::default_memory_pool())));
+  EXPECT_OK(table->WriteRowBatch(rb1));
+
+  auto rb2 = RowBatch(RowDescriptor(rel.col_types()), 2);
+  std::vector<types::Int64Value> col1_in2 = {4, 5};
+  std::vector<types::BoolValue> col2_in2 = {false, false};
+  std::vector<types::Float64Value> col3_in2 = {3.4, 1.2};
+  EXPECT_OK(rb2.AddColumn(types::ToArrow(col1_in2, arrow::default_memory_pool())));
+  EXPECT_OK(rb2.AddColumn(types::ToArrow(col2_in2, arrow::default_memory_pool())));
+  EXPECT_OK(rb2.AddColumn(types::ToArrow(col3_in2, arrow::default_memory_pool())));
+  EXPECT_OK(table->WriteRowBatch(rb2));
+
+  auto table_store = std::make_shared<table_store::TableStore>();
+  table_store->AddTable("numbers", table);
+  auto exec_state = std::make_unique<ExecState>(
+      func_registry_.get(), table_store, MockResultSinkStubGenerator, MockMetricsStubGenerator,
+      MockTraceStubGenerator, sole::uuid4(), nullptr);
+  EXPECT_OK(exec_state->AddScalarUDF(
+      2, "greaterThan",
+      std::vector<types::DataType>({types::DataType::INT64, types::DataType::INT64})));
+
+  CountingGreaterThanUDF::num_calls = 0;
+  ExecutionGraph e;
+  ASSERT_OK(e.Init(schema.get(), plan_state.get(), exec_state.get(), plan_fragment.get(),
+                   /* collect_exec_node_stats */ true));
+  EXPECT_OK(e.Execute());
+
+  // The source evaluates the predicate once per row and the filter only projects.
+  EXPECT_EQ(5, CountingGreaterThanUDF::num_calls);
+
+  auto output_table = exec_state->table_store()->GetTable("output");
+  table_store::Table::Cursor cursor(output_table);
+  std::vector<types::Int64Value> out_a1 = {3};
+  std::vector<types::Float64Value> out_c1 = {10.2};
+  auto out_rb1 = cursor.GetNextRowBatch({0, 1}).ConsumeValueOrDie();
+  EXPECT_TRUE(out_rb1->ColumnAt(0)->Equals(types::ToArrow(out_a1, arrow::default_memory_pool())));
+  EXPECT_TRUE(out_rb1->ColumnAt(1)->Equals(types::ToArrow(out_c1, arrow::default_memory_pool())));
+  std::vector<types::Int64Value> out_a2 = {4, 5};
+  std::vector<types::Float64Value> out_c2 = {3.4, 1.2};
+  auto out_rb2 = cursor.GetNextRowBatch({0, 1}).ConsumeValueOrDie();
+  EXPECT_TRUE(out_rb2->ColumnAt(0)->Equals(types::ToArrow(out_a2, arrow::default_memory_pool())));
+  EXPECT_TRUE(out_rb2->ColumnAt(1)->Equals(types::ToArrow(out_c2, arrow::default_memory_pool())));
+}
+
 std::vector<std::tuple<int32_t>> calls_to_execute = {
     {1},
     {2},
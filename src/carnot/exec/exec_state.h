@@ -31,6 +31,7 @@
 #include "src/carnot/carnotpb/carnot.pb.h"
 #include "src/carnot/exec/grpc_router.h"
 #include "src/carnot/exec/ml/model_pool.h"
+#include "src/carnot/exec/runtime_filter.h"
 #include "src/carnot/udf/registry.h"
 #include "src/common/base/base.h"
 #include "src/shared/metadata/metadata_state.h"
@@ -169,8 +170,14 @@ class ExecState {
   }
 
   // A node (ie. Limit) can call this method to say no more records will be processed for this
-  // source. That node is responsible for setting eos.
-  void StopSource(int64_t src_id) { source_id_to_keep_running_map_[src_id] = false; }
+  // source. That node is responsible for setting eos. If the source is a GRPC source, the agents
+  // sending data to it are told to stop.
+  void StopSource(int64_t src_id) {
+    source_id_to_keep_running_map_[src_id] = false;
+    if (grpc_router_ != nullptr) {
+      grpc_router_->StopGRPCSource(query_id_, src_id);
+    }
+  }
 
   bool keep_running() {
     DCHECK(current_source_set_);
@@ -192,6 +199,17 @@ class ExecState {
 
   GRPCRouter* grpc_router() { return grpc_router_; }
 
+  // A join node publishes the filter over its build side keys once the build side is complete.
+  void AddRuntimeJoinFilter(int64_t join_id, std::shared_ptr<const RuntimeJoinFilter> filter) {
+    runtime_join_filters_[join_id] = std::move(filter);
+  }
+
+  // Returns the runtime filter of the given join, or nullptr if it hasn't been published yet.
+  const RuntimeJoinFilter* GetRuntimeJoinFilter(int64_t join_id) const {
+    auto it = runtime_join_filters_.find(join_id);
+    return it == runtime_join_filters_.end() ? nullptr : it->second.get();
+  }
+
   void AddAuthToGRPCClientContext(grpc::ClientContext* ctx) {
     CHECK(add_auth_to_grpc_client_context_func_);
     add_auth_to_grpc_client_context_func_(ctx);
@@ -214,6 +232,7 @@ class ExecState {
   int64_t current_source_ = 0;
   bool current_source_set_ = false;
   std::map<int64_t, bool> source_id_to_keep_running_map_;
+  absl::flat_hash_map<int64_t, std::shared_ptr<const RuntimeJoinFilter>> runtime_join_filters_;
 
   std::vector<std::unique_ptr<carnotpb::ResultSinkService::StubInterface>> result_sink_stubs_pool_;
   // Mapping of remote address to stub that serves that address.
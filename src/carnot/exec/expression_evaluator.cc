@@ -153,25 +153,50 @@ std::string ScalarExpressionEvaluator::DebugString() {
 
 Status ScalarExpressionEvaluator::InitFuncsInExpression(
     ExecState* exec_state, std::shared_ptr<const plan::ScalarExpression> expr) {
-  plan::ExpressionWalker<bool> walker;
-  walker.OnScalarValue([](auto, auto) -> bool { return true; });
-  walker.OnColumn([](auto, auto) -> bool { return true; });
-  walker.OnScalarFunc([&](const plan::ScalarFunc& fn, const std::vector<bool>&) -> bool {
-    auto def = exec_state->GetScalarUDFDefinition(fn.udf_id());
-    auto udf = id_to_udf_map_[fn.udf_id()].get();
-
-    std::vector<std::shared_ptr<types::BaseValueType>> init_args;
-    for (const auto& scalar_val : fn.init_arguments()) {
-      init_args.push_back(scalar_val.ToBaseValueType());
-    }
-    PL_CHECK_OK(def->ExecInit(udf, function_ctx_, init_args));
-    return true;
+  // The walker returns the value of constant subexpressions, and nullptr for everything else.
+  using ConstValue = std::shared_ptr<types::BaseValueType>;
+  plan::ExpressionWalker<ConstValue> walker;
+  walker.OnScalarValue([](const plan::ScalarValue& val, const std::vector<ConstValue>&) {
+    return val.ToBaseValueType();
   });
+  walker.OnColumn([](auto, auto) -> ConstValue { return nullptr; });
+  walker.OnScalarFunc(
+      [&](const plan::ScalarFunc& fn, const std::vector<ConstValue>& args) -> ConstValue {
+        auto def = exec_state->GetScalarUDFDefinition(fn.udf_id());
+        auto udf = id_to_udf_map_[fn.udf_id()].get();
+
+        std::vector<std::shared_ptr<types::BaseValueType>> init_args;
+        for (const auto& scalar_val : fn.init_arguments()) {
+          init_args.push_back(scalar_val.ToBaseValueType());
+        }
+
+        bool has_const_arg =
+            std::any_of(args.begin(), args.end(), [](const auto& arg) { return arg != nullptr; });
+        if (def->has_init_const() && has_const_arg) {
+          // Specialize a dedicated instance on this call site's constants, so the per-call
+          // precomputation happens once per query instead of per row.
+          auto call_site_udf = def->Make();
+          PL_CHECK_OK(def->ExecInit(call_site_udf.get(), function_ctx_, init_args));
+          PL_CHECK_OK(def->ExecInitConst(call_site_udf.get(), function_ctx_, args));
+          call_site_udfs_[&fn] = std::move(call_site_udf);
+        } else {
+          PL_CHECK_OK(def->ExecInit(udf, function_ctx_, init_args));
+        }
+        return nullptr;
+      });
 
   PL_RETURN_IF_ERROR(walker.Walk(*expr));
   return Status::OK();
 }
 
+udf::ScalarUDF* ScalarExpressionEvaluator::GetUDF(const plan::ScalarFunc& fn) {
+  auto it = call_site_udfs_.find(&fn);
+  if (it != call_site_udfs_.end()) {
+    return it->second.get();
+  }
+  return id_to_udf_map_[fn.udf_id()].get();
+}
+
 Status VectorNativeScalarExpressionEvaluator::Open(ExecState* exec_state) {
   for (const auto& kv : exec_state->id_to_scalar_udf_map()) {
     auto udf = kv.second->Make();
@@ -188,6 +213,19 @@ Status VectorNativeScalarExpressionEvaluator::Close(ExecState*) {
   return Status();
 }
 
+namespace {
+
+// A value in an expression evaluated by the VectorNative evaluator. Columns, constants and the
+// results of UDFs with a column-at-a-time ExecBatchArrow are kept in the form they were produced
+// in, and only converted when a UDF needs the other one.
+struct VectorNativeValue {
+  const plan::ScalarValue* scalar = nullptr;
+  std::shared_ptr<arrow::Array> arrow;
+  types::SharedColumnWrapper wrapper;
+};
+
+}  // namespace
+
 StatusOr<types::SharedColumnWrapper>
 VectorNativeScalarExpressionEvaluator::EvaluateSingleExpression(
     ExecState* exec_state, const RowBatch& input, const plan::ScalarExpression& expr) {
@@ -196,48 +234,91 @@ VectorNativeScalarExpressionEvaluator::EvaluateSingleExpression(
 
   size_t num_rows = input.num_rows();
 
-  // Path for scalar funcs an their dependencies to get evaluated.
-  // The Arrow arrays are converted to type erased column wrappers
-  // and then evaluated.
-  plan::ExpressionWalker<types::SharedColumnWrapper> walker;
-  walker.OnScalarValue(
-      [&](const plan::ScalarValue& val,
-          const std::vector<types::SharedColumnWrapper>& children) -> types::SharedColumnWrapper {
-        DCHECK_EQ(children.size(), 0ULL);
-        return EvalScalarToColumnWrapper(exec_state, val, num_rows);
-      });
-
-  walker.OnColumn(
-      [&](const plan::Column& col,
-          const std::vector<types::SharedColumnWrapper>& children) -> types::SharedColumnWrapper {
-        DCHECK_EQ(children.size(), 0ULL);
-        return ColumnWrapper::FromArrow(input.ColumnAt(col.Index()));
-      });
+  auto to_wrapper = [&](const VectorNativeValue& val,
+                        types::DataType data_type) -> types::SharedColumnWrapper {
+    if (val.wrapper != nullptr) {
+      return val.wrapper;
+    }
+    if (val.scalar != nullptr) {
+      return EvalScalarToColumnWrapper(exec_state, *val.scalar, num_rows);
+    }
+    if (data_type == types::DataType::DATA_TYPE_UNKNOWN) {
+      return ColumnWrapper::FromArrow(val.arrow);
+    }
+    return ColumnWrapper::FromArrow(data_type, val.arrow);
+  };
+  auto to_arrow = [&](const VectorNativeValue& val) -> std::shared_ptr<arrow::Array> {
+    if (val.arrow != nullptr) {
+      return val.arrow;
+    }
+    if (val.scalar != nullptr) {
+      return EvalScalarToArrow(exec_state, *val.scalar, num_rows);
+    }
+    return val.wrapper->ConvertToArrow(exec_state->exec_mem_pool());
+  };
+
+  // Path for scalar funcs an their dependencies to get evaluated. UDFs with a column-at-a-time
+  // ExecBatchArrow (such as the string kernels) run on the Arrow arrays directly. For the others,
+  // the Arrow arrays are converted to type erased column wrappers and then evaluated.
+  plan::ExpressionWalker<VectorNativeValue> walker;
+  walker.OnScalarValue([&](const plan::ScalarValue& val,
+                           const std::vector<VectorNativeValue>& children) -> VectorNativeValue {
+    DCHECK_EQ(children.size(), 0ULL);
+    return {&val, nullptr, nullptr};
+  });
 
-  walker.OnScalarFunc(
-      [&](const plan::ScalarFunc& fn,
-          const std::vector<types::SharedColumnWrapper>& children) -> types::SharedColumnWrapper {
-        std::vector<types::DataType> arg_types;
-        arg_types.reserve(children.size());
-        for (const auto& child : children) {
-          arg_types.emplace_back(child->data_type());
-        }
+  walker.OnColumn([&](const plan::Column& col,
+                      const std::vector<VectorNativeValue>& children) -> VectorNativeValue {
+    DCHECK_EQ(children.size(), 0ULL);
+    return {nullptr, input.ColumnAt(col.Index()), nullptr};
+  });
 
-        auto def = exec_state->GetScalarUDFDefinition(fn.udf_id());
-        auto udf = id_to_udf_map_[fn.udf_id()].get();
+  walker.OnScalarFunc([&](const plan::ScalarFunc& fn,
+                          const std::vector<VectorNativeValue>& children) -> VectorNativeValue {
+    auto def = exec_state->GetScalarUDFDefinition(fn.udf_id());
+    auto udf = GetUDF(fn);
+    const auto& arg_types = def->exec_arguments();
+    DCHECK_EQ(children.size(), arg_types.size());
+
+    if (def->has_exec_batch_arrow()) {
+      std::vector<std::shared_ptr<arrow::Array>> arrow_children;
+      std::vector<arrow::Array*> raw_children;
+      arrow_children.reserve(children.size());
+      raw_children.reserve(children.size());
+      for (const auto& child : children) {
+        arrow_children.push_back(to_arrow(child));
+        raw_children.push_back(arrow_children.back().get());
+      }
+      auto output = MakeArrowBuilder(def->exec_return_type(), exec_state->exec_mem_pool());
+      // TODO(zasgar): need a better way to handle errors.
+      PL_CHECK_OK(def->ExecBatchArrow(udf, function_ctx_, raw_children, output.get(), num_rows));
+      std::shared_ptr<arrow::Array> output_array;
+      PL_CHECK_OK(output->Finish(&output_array));
+      return {nullptr, output_array, nullptr};
+    }
 
-        std::vector<const types::ColumnWrapper*> raw_children;
-        raw_children.reserve(children.size());
-        for (const auto& child : children) {
-          raw_children.emplace_back(child.get());
-        }
-        auto output = types::ColumnWrapper::Make(def->exec_return_type(), num_rows);
-        // TODO(zasgar): need a better way to handle errors.
-        PL_CHECK_OK(def->ExecBatch(udf, function_ctx_, raw_children, output.get(), num_rows));
-        return output;
-      });
+    std::vector<types::SharedColumnWrapper> wrapper_children;
+    std::vector<const types::ColumnWrapper*> raw_children;
+    wrapper_children.reserve(children.size());
+    raw_children.reserve(children.size());
+    for (const auto& [idx, child] : Enumerate(children)) {
+      wrapper_children.push_back(to_wrapper(child, arg_types[idx]));
+      raw_children.emplace_back(wrapper_children.back().get());
+    }
+    auto output = types::ColumnWrapper::Make(def->exec_return_type(), num_rows);
+    // TODO(zasgar): need a better way to handle errors.
+    PL_CHECK_OK(def->ExecBatch(udf, function_ctx_, raw_children, output.get(), num_rows));
+    return {nullptr, nullptr, output};
+  });
 
-  return walker.Walk(expr);
+  PL_ASSIGN_OR_RETURN(auto result, walker.Walk(expr));
+  // Only the results of UDFs are typed, columns keep the type of their Arrow array.
+  types::DataType result_type = types::DataType::DATA_TYPE_UNKNOWN;
+  if (expr.ExpressionType() == plan::Expression::kFunc) {
+    const auto& fn = static_cast<const plan::ScalarFunc&>(expr);
+    result_type = exec_state->GetScalarUDFDefinition(fn.udf_id())->exec_return_type();
+  }
+  return to_wrapper(result, result_type);
 }
 
 Status VectorNativeScalarExpressionEvaluator::EvaluateSingleExpression(
@@ -318,7 +399,7 @@ Status exec::ArrowNativeScalarExpressionEvaluator::EvaluateSingleExpression(
         }
 
         auto def = exec_state->GetScalarUDFDefinition(fn.udf_id());
-        auto udf = id_to_udf_map_[fn.udf_id()].get();
+        auto udf = GetUDF(fn);
 
         auto output = MakeArrowBuilder(def->exec_return_type(), arrow::default_memory_pool());
 
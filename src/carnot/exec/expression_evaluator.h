@@ -123,9 +123,15 @@ class ScalarExpressionEvaluator : public ExpressionEvaluator {
                                           table_store::schema::RowBatch* output) = 0;
   Status InitFuncsInExpression(ExecState* exec_state,
                                std::shared_ptr<const plan::ScalarExpression> expr);
+  // Returns the UDF instance to execute fn with.
+  udf::ScalarUDF* GetUDF(const plan::ScalarFunc& fn);
+
   plan::ConstScalarExpressionVector expressions_;
   udf::FunctionContext* function_ctx_ = nullptr;
   std::map<int64_t, std::unique_ptr<udf::ScalarUDF>> id_to_udf_map_;
+  // UDF instances specialized (with InitConst) on the constant arguments of a single call site.
+  // UDF ids are shared between call sites, so these can't live in id_to_udf_map_.
+  std::map<const plan::ScalarFunc*, std::unique_ptr<udf::ScalarUDF>> call_site_udfs_;
 };
 
 /**
@@ -19,8 +19,12 @@
 #include <arrow/array.h>
 #include <arrow/memory_pool.h>
 #include <benchmark/benchmark.h>
+#include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 
 #include <google/protobuf/text_format.h>
@@ -61,7 +65,9 @@ using px::carnot::udf::ScalarUDF;
 using px::table_store::schema::RowBatch;
 using px::table_store::schema::RowDescriptor;
 using px::types::DataType;
+using px::types::BoolValue;
 using px::types::Int64Value;
+using px::types::StringValue;
 using px::types::ToArrow;
 
 class AddUDF : public ScalarUDF {
@@ -69,6 +75,58 @@ class AddUDF : public ScalarUDF {
   Int64Value Exec(FunctionContext*, Int64Value v1, Int64Value v2) { return v1.val + v2.val; }
 };
 
+using StringSearcher = std::boyer_moore_horspool_searcher<std::string::const_iterator>;
+
+// Rebuilds the search tables for the needle on every row.
+class RowwiseContainsUDF : public ScalarUDF {
+ public:
+  BoolValue Exec(FunctionContext*, StringValue haystack, StringValue needle) {
+    StringSearcher searcher(needle.begin(), needle.end());
+    return std::search(haystack.begin(), haystack.end(), searcher) != haystack.end();
+  }
+};
+
+// Builds the search tables once per call site when the needle is a constant.
+class ConstContainsUDF : public ScalarUDF {
+ public:
+  Status InitConst(FunctionContext*, const StringValue*, const StringValue* needle) {
+    if (needle != nullptr) {
+      needle_ = *needle;
+      searcher_.emplace(needle_.begin(), needle_.end());
+    }
+    return Status::OK();
+  }
+  BoolValue Exec(FunctionContext* ctx, StringValue haystack, StringValue needle) {
+    if (!searcher_.has_value()) {
+      return RowwiseContainsUDF().Exec(ctx, haystack, needle);
+    }
+    return std::search(haystack.begin(), haystack.end(), *searcher_) != haystack.end();
+  }
+
+ private:
+  std::string needle_;
+  std::optional<StringSearcher> searcher_;
+};
+
+constexpr char kContainsConstPbtxt[] = R"(
+func {
+  name: "contains"
+  args {
+    column {
+      node: 0
+      index: 0
+    }
+  }
+  args {
+    constant {
+      data_type: STRING,
+      string_value: "needle-in-the-haystack"
+    }
+  }
+  args_data_types: STRING
+  args_data_types: STRING
+})";
+
 // NOLINTNEXTLINE : runtime/references.
 void BM_ScalarExpressionTwoCols(benchmark::State& state,
                                 const ScalarExpressionEvaluatorType& eval_type, const char* pbtxt) {
@@ -111,6 +169,49 @@ void BM_ScalarExpressionTwoCols(benchmark::State& state,
   state.SetBytesProcessed(int64_t(state.iterations()) * 2 * in1.size() * sizeof(int64_t));
 }
 
+// NOLINTNEXTLINE : runtime/references.
+template <typename TUDF, ScalarExpressionEvaluatorType TEvalType>
+void BM_ScalarExpressionContainsConst(benchmark::State& state) {
+  px::carnot::planpb::ScalarExpression se_pb;
+  size_t data_size = state.range(0);
+
+  google::protobuf::TextFormat::MergeFromString(kContainsConstPbtxt, &se_pb);
+  auto s_or_se = px::carnot::plan::ScalarExpression::FromProto(se_pb);
+  CHECK(s_or_se.ok());
+  std::shared_ptr<ScalarExpression> se = s_or_se.ConsumeValueOrDie();
+
+  auto func_registry = std::make_unique<Registry>("test_registry");
+  auto table_store = std::make_shared<px::table_store::TableStore>();
+  PL_CHECK_OK(func_registry->Register<TUDF>("contains"));
+  auto exec_state = std::make_unique<ExecState>(
+      func_registry.get(), table_store, MockResultSinkStubGenerator, MockMetricsStubGenerator,
+      MockTraceStubGenerator, sole::uuid4(), nullptr);
+  PL_CHECK_OK(exec_state->AddScalarUDF(0, "contains", {DataType::STRING, DataType::STRING}));
+
+  constexpr int kStringWidth = 64;
+  std::vector<StringValue> in1(data_size);
+  std::generate(begin(in1), end(in1), [] { return px::datagen::RandomString(kStringWidth); });
+
+  RowDescriptor rd({DataType::STRING});
+  auto input_rb = std::make_unique<RowBatch>(rd, in1.size());
+  PL_CHECK_OK(input_rb->AddColumn(ToArrow(in1, arrow::default_memory_pool())));
+
+  // NOLINTNEXTLINE : clang-analyzer-deadcode.DeadStores.
+  for (auto _ : state) {
+    RowDescriptor rd_output({DataType::BOOLEAN});
+    RowBatch output_rb(rd_output, input_rb->num_rows());
+    auto function_ctx = std::make_unique<px::carnot::udf::FunctionContext>(nullptr, nullptr);
+    auto evaluator = ScalarExpressionEvaluator::Create({se}, TEvalType, function_ctx.get());
+    PL_CHECK_OK(evaluator->Open(exec_state.get()));
+    PL_CHECK_OK(evaluator->Evaluate(exec_state.get(), *input_rb, &output_rb));
+    PL_CHECK_OK(evaluator->Close(exec_state.get()));
+
+    benchmark::DoNotOptimize(output_rb);
+    CHECK_EQ(static_cast<size_t>(output_rb.ColumnAt(0)->length()), data_size);
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * in1.size() * kStringWidth);
+}
+
 BENCHMARK_CAPTURE(BM_ScalarExpressionTwoCols, eval_col_arrow,
                   ScalarExpressionEvaluatorType::kArrowNative, kColumnReferencePbtxt)
     ->RangeMultiplier(2)
@@ -146,3 +247,20 @@ BENCHMARK_CAPTURE(BM_ScalarExpressionTwoCols, two_cols_simple_add_vector,
                   ScalarExpressionEvaluatorType::kVectorNative, kAddScalarFuncNestedPbtxt)
     ->RangeMultiplier(2)
     ->Range(1, 1 << 16);
+
+BENCHMARK_TEMPLATE(BM_ScalarExpressionContainsConst, RowwiseContainsUDF,
+                   ScalarExpressionEvaluatorType::kArrowNative)
+    ->RangeMultiplier(4)
+    ->Range(1, 1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarExpressionContainsConst, ConstContainsUDF,
+                   ScalarExpressionEvaluatorType::kArrowNative)
+    ->RangeMultiplier(4)
+    ->Range(1, 1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarExpressionContainsConst, RowwiseContainsUDF,
+                   ScalarExpressionEvaluatorType::kVectorNative)
+    ->RangeMultiplier(4)
+    ->Range(1, 1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarExpressionContainsConst, ConstContainsUDF,
+                   ScalarExpressionEvaluatorType::kVectorNative)
+    ->RangeMultiplier(4)
+    ->Range(1, 1 << 16);
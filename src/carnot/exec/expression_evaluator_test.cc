@@ -18,6 +18,8 @@
 
 #include "src/carnot/exec/expression_evaluator.h"
 
+#include <arrow/array.h>
+#include <arrow/builder.h>
 #include <arrow/memory_pool.h>
 #include <arrow/type_fwd.h>
 #include <memory>
@@ -76,6 +78,46 @@ class InitArgUDF : public udf::ScalarUDF {
   int64_t i_;
 };
 
+// Adds a constant second argument that it only learns about through InitConst.
+class ConstAddUDF : public udf::ScalarUDF {
+ public:
+  Status InitConst(FunctionContext*, const types::Int64Value* v1, const types::Int64Value* v2) {
+    if (v1 != nullptr || v2 == nullptr) {
+      return error::InvalidArgument("Expected only the second argument to be constant");
+    }
+    const_val_ = v2->val;
+    return Status::OK();
+  }
+  types::Int64Value Exec(FunctionContext*, types::Int64Value v1, types::Int64Value) {
+    return v1.val + const_val_;
+  }
+
+ private:
+  int64_t const_val_ = 0;
+};
+
+// Adds its arguments a column at a time, and counts how it was called.
+class BatchAddUDF : public udf::ScalarUDF {
+ public:
+  types::Int64Value Exec(FunctionContext*, types::Int64Value v1, types::Int64Value v2) {
+    ++exec_calls;
+    return v1.val + v2.val;
+  }
+
+  Status ExecBatchArrow(FunctionContext*, size_t count, const arrow::Int64Array* v1,
+                        const arrow::Int64Array* v2, arrow::Int64Builder* out) {
+    ++batch_calls;
+    PL_RETURN_IF_ERROR(out->Reserve(count));
+    for (size_t idx = 0; idx < count; ++idx) {
+      out->UnsafeAppend(v1->Value(idx) + v2->Value(idx));
+    }
+    return Status::OK();
+  }
+
+  static inline int exec_calls = 0;
+  static inline int batch_calls = 0;
+};
+
 std::shared_ptr<plan::ScalarExpression> AddScalarExpr() {
   planpb::ScalarExpression se_pb;
   google::protobuf::TextFormat::MergeFromString(kAddScalarFuncPbtxt, &se_pb);
@@ -116,6 +158,8 @@ class ScalarExpressionTest : public ::testing::TestWithParam<ScalarExpressionEva
 
     EXPECT_TRUE(func_registry_->Register<AddUDF>("add").ok());
     EXPECT_TRUE(func_registry_->Register<InitArgUDF>("init_arg").ok());
+    EXPECT_TRUE(func_registry_->Register<ConstAddUDF>("const_add").ok());
+    EXPECT_TRUE(func_registry_->Register<BatchAddUDF>("batch_add").ok());
     exec_state_ = std::make_unique<ExecState>(func_registry_.get(), table_store,
                                               MockResultSinkStubGenerator, MockMetricsStubGenerator,
                                               MockTraceStubGenerator, sole::uuid4(), nullptr);
@@ -123,6 +167,10 @@ class ScalarExpressionTest : public ::testing::TestWithParam<ScalarExpressionEva
         0, "add", std::vector<types::DataType>({types::DataType::INT64, types::DataType::INT64})));
     EXPECT_OK(
         exec_state_->AddScalarUDF(1, "init_arg", {types::STRING, types::INT64, types::STRING}));
+    EXPECT_OK(exec_state_->AddScalarUDF(2, "const_add", {types::INT64, types::INT64}));
+    EXPECT_OK(exec_state_->AddScalarUDF(3, "batch_add", {types::INT64, types::INT64}));
+    BatchAddUDF::exec_calls = 0;
+    BatchAddUDF::batch_calls = 0;
 
     std::vector<types::Int64Value> in1 = {1, 2, 3};
     std::vector<types::Int64Value> in2 = {3, 4, 5};
@@ -270,6 +318,99 @@ TEST_P(ScalarExpressionTest, eval_init_arg_udf) {
   EXPECT_EQ("init_arg, 1234, c", casted->GetString(2));
 }
 
+constexpr char kConstAddScalarFuncTmpl[] = R"pb(
+func {
+  name: "const_add"
+  id: 2
+  args {
+    column {
+      node: 0
+      index: 0
+    }
+  }
+  args {
+    constant {
+      data_type: INT64,
+      int64_value: $0
+    }
+  }
+  args_data_types: INT64
+  args_data_types: INT64
+}
+)pb";
+
+TEST_P(ScalarExpressionTest, eval_const_args_per_call_site) {
+  RowDescriptor rd_output({types::DataType::INT64, types::DataType::INT64});
+  RowBatch output_rb(rd_output, input_rb_->num_rows());
+
+  // Both call sites share a UDF id, but each must be specialized on its own constant.
+  auto se1 = ScalarExpressionOf(absl::Substitute(kConstAddScalarFuncTmpl, 10));
+  auto se2 = ScalarExpressionOf(absl::Substitute(kConstAddScalarFuncTmpl, 100));
+  RunEvaluator({se1, se2}, &output_rb);
+
+  auto casted1 = static_cast<arrow::Int64Array*>(output_rb.ColumnAt(0).get());
+  EXPECT_EQ(11, casted1->Value(0));
+  EXPECT_EQ(12, casted1->Value(1));
+  EXPECT_EQ(13, casted1->Value(2));
+  auto casted2 = static_cast<arrow::Int64Array*>(output_rb.ColumnAt(1).get());
+  EXPECT_EQ(101, casted2->Value(0));
+  EXPECT_EQ(102, casted2->Value(1));
+  EXPECT_EQ(103, casted2->Value(2));
+}
+
+// add(batch_add(col0, 10), col1)
+constexpr char kBatchAddNestedScalarFunc[] = R"pb(
+func {
+  name: "add"
+  id: 0
+  args {
+    func {
+      name: "batch_add"
+      id: 3
+      args {
+        column {
+          node: 0
+          index: 0
+        }
+      }
+      args {
+        constant {
+          data_type: INT64,
+          int64_value: 10
+        }
+      }
+      args_data_types: INT64
+      args_data_types: INT64
+    }
+  }
+  args {
+    column {
+      node: 0
+      index: 1
+    }
+  }
+  args_data_types: INT64
+  args_data_types: INT64
+}
+)pb";
+
+TEST_P(ScalarExpressionTest, eval_exec_batch_arrow) {
+  RowDescriptor rd_output({types::DataType::INT64});
+  RowBatch output_rb(rd_output, input_rb_->num_rows());
+
+  // Both evaluators (and so both map and filter) use the column-at-a-time path when a UDF has one,
+  // and hand its result to row-wise UDFs.
+  auto se = ScalarExpressionOf(kBatchAddNestedScalarFunc);
+  RunEvaluator({se}, &output_rb);
+
+  auto casted = static_cast<arrow::Int64Array*>(output_rb.ColumnAt(0).get());
+  EXPECT_EQ(14, casted->Value(0));
+  EXPECT_EQ(16, casted->Value(1));
+  EXPECT_EQ(18, casted->Value(2));
+  EXPECT_EQ(1, BatchAddUDF::batch_calls);
+  EXPECT_EQ(0, BatchAddUDF::exec_calls);
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
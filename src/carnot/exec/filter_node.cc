@@ -130,6 +130,17 @@ Status PredicateCopyValues<types::STRING>(const types::BoolValueColumnWrapper& p
 }
 
 Status FilterNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
+  if (predicate_applied_upstream_) {
+    // Every row already passed the predicate, so the selected columns are forwarded as is.
+    RowBatch output_rb(*output_descriptor_, rb.num_rows());
+    for (int64_t input_col_idx : plan_node_->selected_cols()) {
+      PL_RETURN_IF_ERROR(output_rb.AddColumn(rb.ColumnAt(input_col_idx)));
+    }
+    output_rb.set_eow(rb.eow());
+    output_rb.set_eos(rb.eos());
+    return SendRowBatchToChildren(exec_state, output_rb);
+  }
+
   // Current implementation does not merge across row batches, we should
   // consider this for cases where the filter has really low selectivity.
   PL_ASSIGN_OR_RETURN(auto pred_col, evaluator_->EvaluateSingleExpression(
@@ -41,6 +41,13 @@ class FilterNode : public ProcessingNode {
   FilterNode() = default;
   virtual ~FilterNode() = default;
 
+  /**
+   * Marks the predicate as already applied by the parent (see
+   * MemorySourceNode::PushDownFilterPredicate()), so that the filter only projects its input.
+   * Must be called before Open().
+   */
+  void SetPredicateAppliedUpstream() { predicate_applied_upstream_ = true; }
+
  protected:
   std::string DebugStringImpl() override;
   Status InitImpl(const plan::Operator& plan_node) override;
@@ -54,6 +61,7 @@ class FilterNode : public ProcessingNode {
   std::unique_ptr<VectorNativeScalarExpressionEvaluator> evaluator_;
   std::unique_ptr<plan::FilterOperator> plan_node_;
   std::unique_ptr<udf::FunctionContext> function_ctx_;
+  bool predicate_applied_upstream_ = false;
 };
 
 }  // namespace exec
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/fork_join_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+ForkJoinPool::ForkJoinPool(size_t num_slots) : statuses_(std::max<size_t>(num_slots, 1)) {
+  for (size_t slot = 1; slot < statuses_.size(); ++slot) {
+    threads_.emplace_back(&ForkJoinPool::WorkerLoop, this, slot);
+  }
+}
+
+ForkJoinPool::~ForkJoinPool() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void ForkJoinPool::WorkerLoop(size_t slot) {
+  uint64_t last_generation = 0;
+  while (true) {
+    const Task* task = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      work_cv_.wait(lock, [&] { return stop_ || generation_ != last_generation; });
+      if (stop_) {
+        return;
+      }
+      last_generation = generation_;
+      task = task_;
+    }
+    Status s = (*task)(slot);
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      statuses_[slot] = std::move(s);
+      if (--pending_ == 0) {
+        done_cv_.notify_one();
+      }
+    }
+  }
+}
+
+Status ForkJoinPool::Run(const Task& task) {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    task_ = &task;
+    pending_ = threads_.size();
+    ++generation_;
+  }
+  work_cv_.notify_all();
+
+  statuses_[0] = task(0);
+
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    done_cv_.wait(lock, [&] { return pending_ == 0; });
+    task_ = nullptr;
+  }
+  for (const auto& s : statuses_) {
+    PL_RETURN_IF_ERROR(s);
+  }
+  return Status::OK();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "src/common/base/base.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * ForkJoinPool runs a task over a fixed number of slots on persistent threads. Slot 0 runs on the
+ * calling thread and every other slot on its own thread, so a slot's state is only ever touched by
+ * one thread at a time. Run() returns once all slots are done.
+ */
+class ForkJoinPool : public NotCopyable {
+ public:
+  using Task = std::function<Status(size_t slot)>;
+
+  explicit ForkJoinPool(size_t num_slots);
+  ~ForkJoinPool();
+
+  size_t num_slots() const { return statuses_.size(); }
+
+  // Runs task for every slot, and returns the first error by slot order.
+  Status Run(const Task& task);
+
+ private:
+  void WorkerLoop(size_t slot);
+
+  std::mutex mu_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  const Task* task_ = nullptr;
+  // Bumped on every Run(), so workers can tell a new task from the one they already ran.
+  uint64_t generation_ = 0;
+  size_t pending_ = 0;
+  bool stop_ = false;
+
+  std::vector<Status> statuses_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
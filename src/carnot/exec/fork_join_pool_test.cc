@@ -0,0 +1,73 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/fork_join_pool.h"
+
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+TEST(ForkJoinPoolTest, runs_every_slot_each_time) {
+  ForkJoinPool pool(4);
+  ASSERT_EQ(pool.num_slots(), 4U);
+
+  std::vector<int> runs(4, 0);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(pool.Run([&](size_t slot) -> Status {
+      ++runs[slot];
+      return Status::OK();
+    }));
+  }
+  EXPECT_EQ(runs, std::vector<int>(4, 10));
+}
+
+TEST(ForkJoinPoolTest, returns_error_after_all_slots_finish) {
+  ForkJoinPool pool(3);
+  std::atomic<int> finished{0};
+  auto s = pool.Run([&](size_t slot) -> Status {
+    ++finished;
+    if (slot == 2) {
+      return error::Internal("slot $0 failed", slot);
+    }
+    return Status::OK();
+  });
+  EXPECT_NOT_OK(s);
+  EXPECT_EQ(finished, 3);
+}
+
+TEST(ForkJoinPoolTest, single_slot_runs_inline) {
+  ForkJoinPool pool(0);
+  ASSERT_EQ(pool.num_slots(), 1U);
+  int runs = 0;
+  ASSERT_OK(pool.Run([&](size_t) -> Status {
+    ++runs;
+    return Status::OK();
+  }));
+  EXPECT_EQ(runs, 1);
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
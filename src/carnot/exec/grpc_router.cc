@@ -41,6 +41,12 @@ GRPCRouter::SourceNodeTracker* GRPCRouter::GetSourceNodeTracker(QueryTracker* qu
   return &query_tracker->source_node_trackers[source_id];
 }
 
+bool GRPCRouter::SourceStopped(QueryTracker* query_tracker, int64_t source_id) {
+  auto snt = GetSourceNodeTracker(query_tracker, source_id);
+  absl::base_internal::SpinLockHolder snt_lock(&snt->node_lock);
+  return snt->stopped;
+}
+
 Status GRPCRouter::EnqueueRowBatch(QueryTracker* query_tracker,
                                    std::unique_ptr<carnotpb::TransferResultChunkRequest> req) {
   if (!req->has_query_result() || !req->query_result().has_row_batch() ||
@@ -179,6 +185,15 @@ std::vector<statuspb::Status> GRPCRouter::GetIncomingWorkerErrors(const sole::uu
     if (!result_status.ok()) {
       break;
     }
+    // If the destination no longer needs data, end the stream instead of waiting for the sink to
+    // finish it, so that the sending agent can stop producing data.
+    if (state.stream_has_query_results &&
+        SourceStopped(state.query_tracker.get(), state.source_node_id)) {
+      MarkResultStreamContextAsComplete(state.query_tracker.get(), context);
+      response->set_success(true);
+      response->set_message(kResultStreamNoLongerNeeded);
+      return ::grpc::Status::OK;
+    }
     req = std::make_unique<carnotpb::TransferResultChunkRequest>();
   }
 
@@ -285,6 +300,30 @@ Status GRPCRouter::DeleteGRPCSourceNode(sole::uuid query_id, int64_t source_id)
   return Status::OK();
 }
 
+void GRPCRouter::StopGRPCSource(sole::uuid query_id, int64_t source_id) {
+  std::shared_ptr<QueryTracker> query_tracker;
+  {
+    absl::base_internal::SpinLockHolder lock(&id_to_query_tracker_map_lock_);
+    auto it = id_to_query_tracker_map_.find(query_id);
+    if (it == id_to_query_tracker_map_.end()) {
+      return;
+    }
+    query_tracker = it->second;
+  }
+
+  SourceNodeTracker* snt;
+  {
+    absl::base_internal::SpinLockHolder lock(&query_tracker->query_lock);
+    auto it = query_tracker->source_node_trackers.find(source_id);
+    if (it == query_tracker->source_node_trackers.end()) {
+      return;
+    }
+    snt = &it->second;
+  }
+  absl::base_internal::SpinLockHolder snt_lock(&snt->node_lock);
+  snt->stopped = true;
+}
+
 void GRPCRouter::DeleteQuery(sole::uuid query_id) {
   VLOG(1) << "Deleting query ID from GRPC Router: " << query_id.str();
   std::shared_ptr<QueryTracker> query_tracker;
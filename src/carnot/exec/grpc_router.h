@@ -46,6 +46,11 @@ namespace exec {
 // Forward declaration needed to break circular dependency.
 class GRPCSourceNode;
 
+// The message of the TransferResultChunkResponse that the router ends a result stream with when
+// the destination source no longer needs any data, for example because a limit downstream of it
+// has been reached. The sending GRPCSinkNode treats this as a successful end of the stream.
+constexpr char kResultStreamNoLongerNeeded[] = "destination source no longer needs data";
+
 /**
  * GRPCRouter tracks incoming Kelvin connections and routes them to the appropriate Carnot source
  * node.
@@ -80,6 +85,15 @@ class GRPCRouter final : public carnotpb::ResultSinkService::Service {
    */
   Status DeleteGRPCSourceNode(sole::uuid query_id, int64_t source_id);
 
+  /**
+   * Marks a source node as no longer needing data, so that the result streams sending to it are
+   * ended, letting the remote agents stop producing data for it. Stopping a source that the router
+   * doesn't know about is ignored.
+   * @param query_id
+   * @param source_id
+   */
+  void StopGRPCSource(sole::uuid query_id, int64_t source_id);
+
   /**
    * @brief Get any errors that may have occured in the incoming worker nodes.
    *
@@ -116,6 +130,8 @@ class GRPCRouter final : public carnotpb::ResultSinkService::Service {
     // respectively.
     bool connection_initiated_by_sink GUARDED_BY(node_lock) = false;
     bool connection_closed_by_sink GUARDED_BY(node_lock) = false;
+    // Set when the source node no longer needs data, see StopGRPCSource().
+    bool stopped GUARDED_BY(node_lock) = false;
     std::vector<std::unique_ptr<::px::carnotpb::TransferResultChunkRequest>> response_backlog
         GUARDED_BY(node_lock);
     absl::base_internal::SpinLock node_lock;
@@ -176,6 +192,7 @@ class GRPCRouter final : public carnotpb::ResultSinkService::Service {
   void MarkResultStreamContextAsComplete(QueryTracker* query_tracker,
                                          ::grpc::ServerContext* context);
   SourceNodeTracker* GetSourceNodeTracker(QueryTracker* query_tracker, int64_t source_id);
+  bool SourceStopped(QueryTracker* query_tracker, int64_t source_id);
 
   absl::node_hash_map<sole::uuid, std::shared_ptr<QueryTracker>> id_to_query_tracker_map_
       GUARDED_BY(id_to_query_tracker_map_lock_);
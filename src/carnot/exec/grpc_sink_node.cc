@@ -18,6 +18,7 @@
 
 #include "src/carnot/exec/grpc_sink_node.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <string>
@@ -26,11 +27,25 @@
 #include <absl/strings/substitute.h>
 
 #include "src/carnot/carnotpb/carnot.pb.h"
+#include "src/carnot/exec/grpc_router.h"
 #include "src/carnot/planpb/plan.pb.h"
 #include "src/common/base/macros.h"
 #include "src/common/uuid/uuid_utils.h"
 #include "src/table_store/table_store.h"
 
+DEFINE_bool(carnot_result_streaming, gflags::BoolFromEnv("PL_CARNOT_RESULT_STREAMING", true),
+            "Whether results sent to the query broker start with small batches that double in size "
+            "on every send, so that the first rows arrive before a full batch is encoded.");
+DEFINE_int32(carnot_result_initial_batch_bytes,
+             gflags::Int32FromEnv("PL_CARNOT_RESULT_INITIAL_BATCH_BYTES", 16 * 1024),
+             "The size of the first batch sent to the query broker when result streaming is on.");
+DEFINE_bool(carnot_result_compression, gflags::BoolFromEnv("PL_CARNOT_RESULT_COMPRESSION", true),
+            "Whether result streams to the query broker are gzip compressed. The broker accepts "
+            "gzip through the encoding registered by its gRPC server.");
+DEFINE_int32(carnot_result_compression_min_bytes,
+             gflags::Int32FromEnv("PL_CARNOT_RESULT_COMPRESSION_MIN_BYTES", 8 * 1024),
+             "Result chunks smaller than this are sent uncompressed, even on compressed streams.");
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -49,26 +64,32 @@ std::string GRPCSinkNode::DebugStringImpl() {
                           plan_node_->address(), destination, input_descriptor_->DebugString());
 }
 
-StatusOr<carnotpb::TransferResultChunkRequest> RequestWithMetadata(
-    plan::GRPCSinkOperator* plan_node, ExecState* exec_state) {
-  carnotpb::TransferResultChunkRequest req;
+Status SetRequestMetadata(plan::GRPCSinkOperator* plan_node, ExecState* exec_state,
+                          carnotpb::TransferResultChunkRequest* req) {
   // Set the metadata for the RowBatch (where it should go).
-  req.set_address(plan_node->address());
+  req->set_address(plan_node->address());
 
   if (plan_node->has_grpc_source_id()) {
-    req.mutable_query_result()->set_grpc_source_id(plan_node->grpc_source_id());
+    req->mutable_query_result()->set_grpc_source_id(plan_node->grpc_source_id());
   } else if (plan_node->has_table_name()) {
-    req.mutable_query_result()->set_table_name(plan_node->table_name());
+    req->mutable_query_result()->set_table_name(plan_node->table_name());
   } else {
     return error::Internal("GRPCSink has neither source ID nor table name set.");
   }
 
-  ToProto(exec_state->query_id(), req.mutable_query_id());
+  ToProto(exec_state->query_id(), req->mutable_query_id());
+  return Status::OK();
+}
+
+StatusOr<carnotpb::TransferResultChunkRequest> RequestWithMetadata(
+    plan::GRPCSinkOperator* plan_node, ExecState* exec_state) {
+  carnotpb::TransferResultChunkRequest req;
+  PL_RETURN_IF_ERROR(SetRequestMetadata(plan_node, exec_state, &req));
   return req;
 }
 
 Status GRPCSinkNode::OptionallyCheckConnection(ExecState* exec_state) {
-  if (sent_eos_ || cancelled_) {
+  if (sent_eos_ || cancelled_ || downstream_stopped_) {
     return Status::OK();
   }
 
@@ -99,6 +120,22 @@ Status GRPCSinkNode::InitImpl(const plan::Operator& plan_node) {
   input_descriptor_ = std::make_unique<RowDescriptor>(input_descriptors_[0]);
   const auto* sink_plan_node = static_cast<const plan::GRPCSinkOperator*>(&plan_node);
   plan_node_ = std::make_unique<plan::GRPCSinkOperator>(*sink_plan_node);
+
+  // Only results bound for the query broker are streamed and compressed. Streams between Carnot
+  // instances stay on full, uncompressed batches.
+  bool to_broker = plan_node_->has_table_name();
+  next_batch_bytes_ = MaxBatchBytes();
+  if (to_broker && FLAGS_carnot_result_streaming && FLAGS_carnot_result_initial_batch_bytes > 0) {
+    next_batch_bytes_ =
+        std::min<int64_t>(next_batch_bytes_, FLAGS_carnot_result_initial_batch_bytes);
+  }
+  compress_ = to_broker && FLAGS_carnot_result_compression;
+
+  google::protobuf::ArenaOptions arena_options;
+  request_arena_block_.resize(kRequestArenaBlockSize);
+  arena_options.initial_block = request_arena_block_.data();
+  arena_options.initial_block_size = request_arena_block_.size();
+  request_arena_ = std::make_unique<google::protobuf::Arena>(arena_options);
   return Status::OK();
 }
 
@@ -120,6 +157,9 @@ Status GRPCSinkNode::StartConnectionWithRetries(ExecState* exec_state, size_t n_
   stub_ = exec_state->ResultSinkServiceStub(plan_node_->address(), plan_node_->ssl_targetname());
 
   context_ = std::make_unique<grpc::ClientContext>();
+  if (compress_) {
+    context_->set_compression_algorithm(GRPC_COMPRESS_GZIP);
+  }
   // When we are sending the results to an external service, such as the query broker,
   // add authentication to the client context.
   if (plan_node_->has_table_name()) {
@@ -153,9 +193,19 @@ Status GRPCSinkNode::CancelledByServer(ExecState* exec_state) {
       plan_node_->id(), exec_state->query_id().str(), plan_node_->address());
 }
 
+grpc::WriteOptions GRPCSinkNode::ChunkWriteOptions(int64_t chunk_bytes) const {
+  grpc::WriteOptions options;
+  if (!compress_ || chunk_bytes < FLAGS_carnot_result_compression_min_bytes) {
+    // Small chunks barely compress and are the ones that latency matters most for.
+    options.set_no_compression();
+  }
+  return options;
+}
+
 Status GRPCSinkNode::TryWriteRequest(ExecState* exec_state,
-                                     const carnotpb::TransferResultChunkRequest& req) {
-  if (writer_->Write(req)) {
+                                     const carnotpb::TransferResultChunkRequest& req,
+                                     grpc::WriteOptions options) {
+  if (writer_->Write(req, options)) {
     last_send_time_ = std::chrono::system_clock::now();
     return Status::OK();
   }
@@ -164,6 +214,14 @@ Status GRPCSinkNode::TryWriteRequest(ExecState* exec_state,
   // connection just died.
   writer_->WritesDone();
   auto s = writer_->Finish();
+  if (s.ok() && response_.success() && response_.message() == kResultStreamNoLongerNeeded) {
+    VLOG(1) << absl::Substitute(
+        "GRPCSinkNode $0 of query $1: destination $2 no longer needs data, stopping the stream",
+        plan_node_->id(), exec_state->query_id().str(), plan_node_->address());
+    downstream_stopped_ = true;
+    writer_ = nullptr;
+    return Status::OK();
+  }
   // If the Finish call was successful, then the server closed the connection and sent a response,
   // in which case we shouldn't try to reconnect. If there's an error from the server side
   // other than a RST_STREAM, we also shouldn't retry.
@@ -176,7 +234,7 @@ Status GRPCSinkNode::TryWriteRequest(ExecState* exec_state,
   PL_RETURN_IF_ERROR(StartConnection(exec_state));
 
   // Try again to write the request on the new connection.
-  if (!writer_->Write(req)) {
+  if (!writer_->Write(req, options)) {
     return CancelledByServer(exec_state);
   }
   last_send_time_ = std::chrono::system_clock::now();
@@ -200,6 +258,13 @@ Status GRPCSinkNode::CloseWriter(ExecState* exec_state) {
 }
 
 Status GRPCSinkNode::CloseImpl(ExecState* exec_state) {
+  if (downstream_stopped_) {
+    // The destination already ended the stream, so there is no writer left to close, but the
+    // rows dropped since then still belong in this node's stats.
+    stats()->AddExtraInfo("downstream_stopped", "true");
+    stats()->AddExtraMetric("rows_dropped_after_stop", rows_dropped_after_stop_);
+    return Status::OK();
+  }
   if (sent_eos_ || cancelled_) {
     return Status::OK();
   }
@@ -236,17 +301,21 @@ static inline bool GetRowSizes(const RowBatch& rb, std::vector<int64_t>* string_
 std::vector<int64_t> GRPCSinkNode::SplitBatchSizes(bool has_string_col,
                                                    const std::vector<int64_t>& string_col_row_sizes,
                                                    int64_t other_col_row_size) const {
-  int64_t desired_batch_size_bytes = static_cast<int64_t>(max_batch_size_ * batch_size_factor_);
+  int64_t desired_batch_size_bytes = MaxBatchBytes();
+  // While the stream is still growing its batches, each split batch doubles the target, the same
+  // way consecutive sends do.
+  int64_t batch_target_bytes = std::min(next_batch_bytes_, desired_batch_size_bytes);
   std::vector<int64_t> new_batches_num_rows;
-  if (has_string_col) {
+  if (has_string_col || batch_target_bytes < desired_batch_size_bytes) {
     int64_t batch_bytes = 0;
     int64_t batch_num_rows = 0;
     for (const auto& [idx, row_string_bytes] : Enumerate(string_col_row_sizes)) {
       auto row_bytes = row_string_bytes + other_col_row_size;
-      if (batch_num_rows > 0 && batch_bytes + row_bytes > desired_batch_size_bytes) {
+      if (batch_num_rows > 0 && batch_bytes + row_bytes > batch_target_bytes) {
         new_batches_num_rows.push_back(batch_num_rows);
         batch_bytes = 0;
         batch_num_rows = 0;
+        batch_target_bytes = std::min(2 * batch_target_bytes, desired_batch_size_bytes);
       }
       batch_bytes += row_bytes;
       batch_num_rows += 1;
@@ -303,20 +372,41 @@ Status GRPCSinkNode::SplitAndSendBatch(ExecState* exec_state, const RowBatch& rb
 }
 
 Status GRPCSinkNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t parent_idx) {
-  if (rb.NumBytes() > (max_batch_size_ * batch_size_factor_)) {
+  if (downstream_stopped_) {
+    rows_dropped_after_stop_ += rb.num_rows();
+    return Status::OK();
+  }
+  if (rb.NumBytes() > std::min(next_batch_bytes_, MaxBatchBytes())) {
     return SplitAndSendBatch(exec_state, rb, parent_idx);
   }
   return ConsumeNextImplNoSplit(exec_state, rb, parent_idx);
 }
 
 Status GRPCSinkNode::ConsumeNextImplNoSplit(ExecState* exec_state, const RowBatch& rb, size_t) {
-  PL_ASSIGN_OR_RETURN(auto req, RequestWithMetadata(plan_node_.get(), exec_state));
+  if (downstream_stopped_) {
+    rows_dropped_after_stop_ += rb.num_rows();
+    return Status::OK();
+  }
+  // The request lives in the reused arena block, which is released once the write returns.
+  auto* req = google::protobuf::Arena::CreateMessage<carnotpb::TransferResultChunkRequest>(
+      request_arena_.get());
+  PL_RETURN_IF_ERROR(SetRequestMetadata(plan_node_.get(), exec_state, req));
   // Serialize the RowBatch.
-  PL_RETURN_IF_ERROR(rb.ToProto(req.mutable_query_result()->mutable_row_batch()));
-
-  PL_RETURN_IF_ERROR(TryWriteRequest(exec_state, req));
+  PL_RETURN_IF_ERROR(rb.ToProto(req->mutable_query_result()->mutable_row_batch()));
+
+  int64_t chunk_bytes = rb.NumBytes();
+  auto s = TryWriteRequest(exec_state, *req, ChunkWriteOptions(chunk_bytes));
+  request_arena_->Reset();
+  PL_RETURN_IF_ERROR(s);
+  if (downstream_stopped_) {
+    // The destination ended the stream instead of taking this batch.
+    rows_dropped_after_stop_ += rb.num_rows();
+  }
+  if (rb.num_rows() > 0) {
+    next_batch_bytes_ = std::min(2 * next_batch_bytes_, MaxBatchBytes());
+  }
 
-  if (!rb.eos()) {
+  if (!rb.eos() || downstream_stopped_) {
     return Status::OK();
   }
 
@@ -24,6 +24,7 @@
 #include <string>
 #include <vector>
 
+#include <google/protobuf/arena.h>
 #include <grpcpp/grpcpp.h>
 
 #include "src/carnot/carnotpb/carnot.pb.h"
@@ -35,6 +36,11 @@
 
 #include "src/carnot/carnotpb/carnot.grpc.pb.h"
 
+DECLARE_bool(carnot_result_streaming);
+DECLARE_int32(carnot_result_initial_batch_bytes);
+DECLARE_bool(carnot_result_compression);
+DECLARE_int32(carnot_result_compression_min_bytes);
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -51,6 +57,10 @@ constexpr float kBatchSizeFactor = 0.9f;
 // Number of times to retry connecting to grpc before giving up.
 constexpr size_t kGRPCRetries = 3;
 
+// Size of the arena block that outgoing requests are built in. The block is reused for every send,
+// so serializing a batch that fits in it doesn't allocate.
+constexpr size_t kRequestArenaBlockSize = 256 * 1024;
+
 class GRPCSinkNode : public SinkNode {
  public:
   GRPCSinkNode(size_t max_batch_size, float batch_size_factor)
@@ -61,6 +71,12 @@ class GRPCSinkNode : public SinkNode {
   // Used to check the downstream connection after connection_check_timeout_ has elapsed.
   Status OptionallyCheckConnection(ExecState* exec_state);
 
+  // Whether the destination ended the stream because it no longer needs data, for example because
+  // a limit downstream of it was reached. Any further row batches are dropped.
+  bool downstream_stopped() const { return downstream_stopped_; }
+  // The number of rows dropped because the destination stopped the stream.
+  int64_t rows_dropped_after_stop() const { return rows_dropped_after_stop_; }
+
   void testing_set_connection_check_timeout(const std::chrono::milliseconds& timeout) {
     connection_check_timeout_ = timeout;
   }
@@ -83,15 +99,23 @@ class GRPCSinkNode : public SinkNode {
   std::vector<int64_t> SplitBatchSizes(bool has_string_col,
                                        const std::vector<int64_t>& string_col_row_sizes,
                                        int64_t other_col_row_size) const;
+  // The largest batch the sink sends, in bytes.
+  int64_t MaxBatchBytes() const {
+    return static_cast<int64_t>(max_batch_size_ * batch_size_factor_);
+  }
 
  private:
   Status CloseWriter(ExecState* exec_state);
   Status StartConnection(ExecState* exec_state);
   Status StartConnectionWithRetries(ExecState* exec_state, size_t n_retries);
   Status CancelledByServer(ExecState* exec_state);
-  Status TryWriteRequest(ExecState* exec_state, const carnotpb::TransferResultChunkRequest& req);
+  Status TryWriteRequest(ExecState* exec_state, const carnotpb::TransferResultChunkRequest& req,
+                         grpc::WriteOptions options = grpc::WriteOptions().set_no_compression());
+  grpc::WriteOptions ChunkWriteOptions(int64_t chunk_bytes) const;
 
   bool cancelled_ = false;
+  bool downstream_stopped_ = false;
+  int64_t rows_dropped_after_stop_ = 0;
 
   std::unique_ptr<grpc::ClientContext> context_;
   carnotpb::TransferResultChunkResponse response_;
@@ -107,6 +131,17 @@ class GRPCSinkNode : public SinkNode {
 
   size_t max_batch_size_;
   float batch_size_factor_;
+
+  // Results bound for the query broker start with small batches that double on every send up to
+  // MaxBatchBytes(), so the first rows are not held back by the encoding of a full batch. Other
+  // streams always send full batches.
+  int64_t next_batch_bytes_ = 0;
+  // Whether the stream is gzip compressed. Chunks below the configured minimum are still sent
+  // uncompressed.
+  bool compress_ = false;
+
+  std::vector<char> request_arena_block_;
+  std::unique_ptr<google::protobuf::Arena> request_arena_;
 };
 
 }  // namespace exec
@@ -350,6 +350,55 @@ TEST_F(GRPCSinkNodeTest, external_result) {
   EXPECT_TRUE(add_metadata_called_);
 }
 
+TEST_F(GRPCSinkNodeTest, external_result_batches_grow) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_carnot_result_initial_batch_bytes = 16;
+  auto op_proto = planpb::testutils::CreateTestGRPCSink2PB();
+  auto plan_node = std::make_unique<plan::GRPCSinkOperator>(1);
+  ASSERT_OK(plan_node->Init(op_proto.grpc_sink_op()));
+  RowDescriptor input_rd({types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64});
+
+  TransferResultChunkResponse resp;
+  resp.set_success(true);
+
+  std::vector<TransferResultChunkRequest> actual_protos;
+  auto writer = new grpc::testing::MockClientWriter<TransferResultChunkRequest>();
+  auto save_arg = [&](TransferResultChunkRequest req, grpc::WriteOptions) {
+    actual_protos.push_back(req);
+  };
+  // The connection request, then 6 batches for the first row batch and 1 for the second.
+  EXPECT_CALL(*writer, Write(_, _))
+      .Times(8)
+      .WillOnce(Return(true))
+      .WillRepeatedly(DoAll(Invoke(save_arg), Return(true)));
+  EXPECT_CALL(*writer, WritesDone());
+  EXPECT_CALL(*writer, Finish()).WillOnce(Return(grpc::Status::OK));
+  EXPECT_CALL(*mock_, TransferResultChunkRaw(_, _))
+      .WillOnce(DoAll(SetArgPointee<1>(resp), Return(writer)));
+
+  auto tester = exec::ExecNodeTester<GRPCSinkNode, plan::GRPCSinkOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get(), /*max_batch_size*/ 128,
+      /*batch_size_factor*/ 1.0f);
+
+  // Rows are 8 bytes, so batches of 16, 32, 64 and then 128 bytes hold 2, 4, 8 and 16 rows.
+  std::vector<types::Int64Value> data(50, 1);
+  tester.ConsumeNext(
+      RowBatchBuilder(output_rd, 50, /*eow*/ false, /*eos*/ false).AddColumn(data).get(), 5, 0);
+  // Once the batches have grown to the maximum size, later row batches aren't split further.
+  std::vector<types::Int64Value> data2(16, 1);
+  tester.ConsumeNext(
+      RowBatchBuilder(output_rd, 16, /*eow*/ true, /*eos*/ true).AddColumn(data2).get(), 5, 0);
+  tester.Close();
+
+  std::vector<int64_t> expected_num_rows = {2, 4, 8, 16, 16, 4, 16};
+  ASSERT_EQ(actual_protos.size(), expected_num_rows.size());
+  for (const auto& [idx, num_rows] : Enumerate(expected_num_rows)) {
+    EXPECT_EQ(actual_protos[idx].query_result().row_batch().num_rows(), num_rows);
+  }
+  EXPECT_TRUE(actual_protos.back().query_result().row_batch().eos());
+}
+
 TEST_F(GRPCSinkNodeTest, check_connection) {
   auto op_proto = planpb::testutils::CreateTestGRPCSink2PB();
   auto plan_node = std::make_unique<plan::GRPCSinkOperator>(1);
@@ -763,6 +812,51 @@ TEST_F(GRPCSinkNodeTest, check_connection_after_eos) {
   tester.Close();
 }
 
+TEST_F(GRPCSinkNodeTest, downstream_stopped) {
+  auto op_proto = planpb::testutils::CreateTestGRPCSink1PB();
+  auto plan_node = std::make_unique<plan::GRPCSinkOperator>(1);
+  auto s = plan_node->Init(op_proto.grpc_sink_op());
+  RowDescriptor input_rd({types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64});
+
+  // The destination ends the stream because it no longer needs data.
+  TransferResultChunkResponse resp;
+  resp.set_success(true);
+  resp.set_message(kResultStreamNoLongerNeeded);
+
+  auto writer = new grpc::testing::MockClientWriter<TransferResultChunkRequest>();
+  EXPECT_CALL(*writer, Write(_, _))
+      .Times(2)
+      .WillOnce(Return(true))    // Initiate result sink
+      .WillOnce(Return(false));  // Stream ended by the destination.
+  EXPECT_CALL(*writer, WritesDone()).Times(1).WillOnce(Return(true));
+  EXPECT_CALL(*writer, Finish()).Times(1).WillOnce(Return(grpc::Status::OK));
+
+  // The sink should not try to reconnect.
+  EXPECT_CALL(*mock_, TransferResultChunkRaw(_, _))
+      .Times(1)
+      .WillOnce(DoAll(SetArgPointee<1>(resp), Return(writer)));
+
+  auto tester = exec::ExecNodeTester<GRPCSinkNode, plan::GRPCSinkOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+  tester.node()->testing_set_connection_check_timeout(std::chrono::milliseconds(-1));
+
+  for (auto i = 1; i < 3; ++i) {
+    std::vector<types::Int64Value> data(i, i);
+    auto rb = RowBatchBuilder(output_rd, i, /*eow*/ i == 2, /*eos*/ i == 2)
+                  .AddColumn<types::Int64Value>(data)
+                  .get();
+    tester.ConsumeNext(rb, 5, 0);
+    EXPECT_TRUE(tester.node()->downstream_stopped());
+  }
+  // The batch the destination refused and the one after it are both counted as dropped.
+  EXPECT_EQ(3, tester.node()->rows_dropped_after_stop());
+
+  // Neither the connection check nor closing the node write to the ended stream.
+  EXPECT_OK(tester.node()->OptionallyCheckConnection(exec_state_.get()));
+  tester.Close();
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
@@ -0,0 +1,387 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/late_materialization.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/strings/str_join.h>
+#include <absl/strings/substitute.h>
+#include <arrow/array.h>
+#include <arrow/builder.h>
+#include <arrow/memory_pool.h>
+
+#include "src/carnot/udf/udf_wrapper.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/column_wrapper.h"
+#include "src/shared/types/type_utils.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::Table;
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+
+namespace {
+
+// The assumed average width of a string value, in lieu of any observations.
+constexpr double kEstimatedStringWidth = 64;
+// The assumed selectivity of predicates that we don't know anything about.
+constexpr double kDefaultSelectivity = 0.5;
+
+void CollectReferencedColumns(const planpb::ScalarExpression& expr, std::vector<int64_t>* cols) {
+  switch (expr.value_case()) {
+    case planpb::ScalarExpression::kColumn:
+      cols->push_back(expr.column().index());
+      return;
+    case planpb::ScalarExpression::kFunc:
+      for (const auto& arg : expr.func().args()) {
+        CollectReferencedColumns(arg, cols);
+      }
+      return;
+    default:
+      return;
+  }
+}
+
+void RemapColumns(const absl::flat_hash_map<int64_t, int64_t>& index_map,
+                  planpb::ScalarExpression* expr) {
+  switch (expr->value_case()) {
+    case planpb::ScalarExpression::kColumn:
+      expr->mutable_column()->set_index(index_map.at(expr->column().index()));
+      return;
+    case planpb::ScalarExpression::kFunc:
+      for (auto& arg : *expr->mutable_func()->mutable_args()) {
+        RemapColumns(index_map, &arg);
+      }
+      return;
+    default:
+      return;
+  }
+}
+
+template <types::DataType T>
+Status AppendSelectedValues(const arrow::Array* input, const std::vector<bool>& selected,
+                            int64_t selected_offset, arrow::ArrayBuilder* builder) {
+  auto* typed_builder =
+      static_cast<typename types::DataTypeTraits<T>::arrow_builder_type*>(builder);
+  for (int64_t idx = 0; idx < input->length(); ++idx) {
+    if (selected[selected_offset + idx]) {
+      PL_RETURN_IF_ERROR(typed_builder->Append(types::GetValueFromArrowArray<T>(input, idx)));
+    }
+  }
+  return Status::OK();
+}
+
+Status AppendSelectedValues(const arrow::Array* input, const std::vector<bool>& selected,
+                            int64_t selected_offset, arrow::ArrayBuilder* builder) {
+#define TYPE_CASE(_dt_) \
+  PL_RETURN_IF_ERROR(AppendSelectedValues<_dt_>(input, selected, selected_offset, builder));
+  PL_SWITCH_FOREACH_DATATYPE(types::ArrowToDataType(input->type_id()), TYPE_CASE);
+#undef TYPE_CASE
+  return Status::OK();
+}
+
+double BytesPerRow(const RowBatch& rb) {
+  if (rb.num_rows() == 0) {
+    return 0;
+  }
+  return static_cast<double>(rb.NumBytes()) / rb.num_rows();
+}
+
+StatusOr<std::unique_ptr<RowBatch>> FinishRowBatch(
+    const RowDescriptor& output_descriptor, int64_t num_rows,
+    std::vector<std::unique_ptr<arrow::ArrayBuilder>>* builders) {
+  auto output_rb = std::make_unique<RowBatch>(output_descriptor, num_rows);
+  for (auto& builder : *builders) {
+    std::shared_ptr<arrow::Array> output_array;
+    PL_RETURN_IF_ERROR(builder->Finish(&output_array));
+    PL_RETURN_IF_ERROR(output_rb->AddColumn(output_array));
+  }
+  return output_rb;
+}
+
+StatusOr<std::vector<std::unique_ptr<arrow::ArrayBuilder>>> MakeBuilders(
+    const RowDescriptor& output_descriptor, int64_t num_rows) {
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> builders(output_descriptor.size());
+  for (size_t i = 0; i < builders.size(); ++i) {
+    builders[i] = types::MakeArrowBuilder(output_descriptor.type(i), arrow::default_memory_pool());
+    PL_RETURN_IF_ERROR(builders[i]->Reserve(num_rows));
+  }
+  return builders;
+}
+
+}  // namespace
+
+double EstimatePredicateSelectivity(const planpb::ScalarExpression& predicate) {
+  switch (predicate.value_case()) {
+    case planpb::ScalarExpression::kConstant:
+      if (predicate.constant().data_type() == types::BOOLEAN) {
+        return predicate.constant().bool_value() ? 1.0 : 0.0;
+      }
+      return kDefaultSelectivity;
+    case planpb::ScalarExpression::kFunc:
+      break;
+    default:
+      return kDefaultSelectivity;
+  }
+
+  const auto& func = predicate.func();
+  const std::string& name = func.name();
+  if (name == "logicalAnd" || name == "logicalOr") {
+    double selectivity = name == "logicalAnd" ? 1.0 : 0.0;
+    for (const auto& arg : func.args()) {
+      double arg_selectivity = EstimatePredicateSelectivity(arg);
+      selectivity = name == "logicalAnd"
+                        ? selectivity * arg_selectivity
+                        : selectivity + arg_selectivity - selectivity * arg_selectivity;
+    }
+    return selectivity;
+  }
+  if (name == "logicalNot" && func.args_size() == 1) {
+    return 1.0 - EstimatePredicateSelectivity(func.args(0));
+  }
+  if (name == "equal") {
+    return 0.1;
+  }
+  if (name == "notEqual") {
+    return 0.9;
+  }
+  if (name == "lessThan" || name == "lessThanEqual" || name == "greaterThan" ||
+      name == "greaterThanEqual") {
+    return 1.0 / 3;
+  }
+  if (name == "contains" || name == "regex_match" || name == "match_regex") {
+    return 0.25;
+  }
+  return kDefaultSelectivity;
+}
+
+double EstimateColumnWidth(types::DataType type) {
+  if (type == types::STRING) {
+    return kEstimatedStringWidth;
+  }
+  return types::ArrowTypeToBytes(types::ToArrowType(type));
+}
+
+StatusOr<std::unique_ptr<LateMaterializer>> LateMaterializer::Create(
+    const planpb::ScalarExpression& predicate, const std::vector<int64_t>& table_cols,
+    const std::vector<types::DataType>& output_types) {
+  DCHECK_EQ(table_cols.size(), output_types.size());
+  std::vector<int64_t> referenced_cols;
+  CollectReferencedColumns(predicate, &referenced_cols);
+  std::sort(referenced_cols.begin(), referenced_cols.end());
+  referenced_cols.erase(std::unique(referenced_cols.begin(), referenced_cols.end()),
+                        referenced_cols.end());
+
+  // Late materialization only helps if there are columns left to read lazily.
+  if (referenced_cols.empty() || referenced_cols.size() >= table_cols.size()) {
+    return std::unique_ptr<LateMaterializer>(nullptr);
+  }
+
+  auto materializer = std::unique_ptr<LateMaterializer>(new LateMaterializer());
+  absl::flat_hash_map<int64_t, int64_t> index_map;
+  for (int64_t output_col = 0; output_col < static_cast<int64_t>(table_cols.size());
+       ++output_col) {
+    double width = EstimateColumnWidth(output_types[output_col]);
+    if (std::binary_search(referenced_cols.begin(), referenced_cols.end(), output_col)) {
+      index_map[output_col] = materializer->predicate_output_cols_.size();
+      materializer->predicate_output_cols_.push_back(output_col);
+      materializer->predicate_table_cols_.push_back(table_cols[output_col]);
+      materializer->predicate_types_.push_back(output_types[output_col]);
+      materializer->predicate_bytes_per_row_ += width;
+    } else {
+      materializer->remaining_output_cols_.push_back(output_col);
+      materializer->remaining_table_cols_.push_back(table_cols[output_col]);
+      materializer->remaining_bytes_per_row_ += width;
+    }
+  }
+  if (materializer->predicate_output_cols_.size() != referenced_cols.size()) {
+    return error::InvalidArgument("Predicate references columns outside of the memory source.");
+  }
+
+  materializer->table_cols_ = table_cols;
+
+  // The predicate is evaluated on row batches that only contain the predicate columns.
+  materializer->predicate_pb_ = predicate;
+  RemapColumns(index_map, &materializer->predicate_pb_);
+  PL_ASSIGN_OR_RETURN(materializer->predicate_,
+                      plan::ScalarExpression::FromProto(materializer->predicate_pb_));
+  materializer->selectivity_ = EstimatePredicateSelectivity(predicate);
+  return materializer;
+}
+
+Status LateMaterializer::Prepare(ExecState* exec_state) {
+  function_ctx_ = exec_state->CreateFunctionContext();
+  evaluator_ = std::make_unique<VectorNativeScalarExpressionEvaluator>(
+      plan::ConstScalarExpressionVector{predicate_}, function_ctx_.get());
+  return Status::OK();
+}
+
+Status LateMaterializer::Open(ExecState* exec_state) { return evaluator_->Open(exec_state); }
+
+Status LateMaterializer::Close(ExecState* exec_state) { return evaluator_->Close(exec_state); }
+
+bool LateMaterializer::Enabled() const {
+  // Both strategies read the predicate columns and copy the surviving rows into the output. Late
+  // materialization reads the remaining columns for the span from the first to the last surviving
+  // row, which is most of the batch unless the surviving rows are clustered.
+  double output_bytes = selectivity_ * (predicate_bytes_per_row_ + remaining_bytes_per_row_);
+  double eager_cost = predicate_bytes_per_row_ + remaining_bytes_per_row_ + output_bytes;
+  double late_cost =
+      predicate_bytes_per_row_ + selected_span_ * remaining_bytes_per_row_ + output_bytes;
+  return eager_cost >= kMinCostRatio * late_cost;
+}
+
+StatusOr<int64_t> LateMaterializer::Select(ExecState* exec_state, const RowBatch& predicate_rb,
+                                           std::vector<bool>* selected) {
+  int64_t num_rows = predicate_rb.num_rows();
+  PL_ASSIGN_OR_RETURN(auto pred_col,
+                      evaluator_->EvaluateSingleExpression(exec_state, predicate_rb, *predicate_));
+  DCHECK_EQ(pred_col->data_type(), types::BOOLEAN) << "Predicate expression must be a boolean";
+  const auto& pred = *static_cast<types::BoolValueColumnWrapper*>(pred_col.get());
+
+  selected->assign(num_rows, false);
+  int64_t num_selected = 0;
+  int64_t first_selected = -1;
+  int64_t last_selected = -1;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    if (udf::UnWrap(pred[i])) {
+      (*selected)[i] = true;
+      ++num_selected;
+      if (first_selected == -1) {
+        first_selected = i;
+      }
+      last_selected = i;
+    }
+  }
+
+  if (num_rows > 0) {
+    double batch_selectivity = static_cast<double>(num_selected) / num_rows;
+    selectivity_ =
+        kObservationWeight * batch_selectivity + (1 - kObservationWeight) * selectivity_;
+    double batch_span =
+        num_selected > 0 ? static_cast<double>(last_selected - first_selected + 1) / num_rows : 0;
+    selected_span_ = kObservationWeight * batch_span + (1 - kObservationWeight) * selected_span_;
+    predicate_bytes_per_row_ = kObservationWeight * BytesPerRow(predicate_rb) +
+                               (1 - kObservationWeight) * predicate_bytes_per_row_;
+  }
+  return num_selected;
+}
+
+StatusOr<std::unique_ptr<RowBatch>> LateMaterializer::GetNextRowBatch(
+    ExecState* exec_state, Table::Cursor* cursor, const RowDescriptor& output_descriptor,
+    int64_t* rows_read) {
+  if (Enabled()) {
+    return ReadLate(exec_state, cursor, output_descriptor, rows_read);
+  }
+  return ReadEager(exec_state, cursor, output_descriptor, rows_read);
+}
+
+StatusOr<std::unique_ptr<RowBatch>> LateMaterializer::ReadEager(
+    ExecState* exec_state, Table::Cursor* cursor, const RowDescriptor& output_descriptor,
+    int64_t* rows_read) {
+  PL_ASSIGN_OR_RETURN(auto rb, cursor->GetNextRowBatch(table_cols_));
+  int64_t num_rows = rb->num_rows();
+  *rows_read = num_rows;
+
+  // The predicate columns are shared with the full batch, not copied.
+  RowBatch predicate_rb(RowDescriptor(predicate_types_), num_rows);
+  for (int64_t output_col : predicate_output_cols_) {
+    PL_RETURN_IF_ERROR(predicate_rb.AddColumn(rb->ColumnAt(output_col)));
+  }
+  std::vector<bool> selected;
+  PL_ASSIGN_OR_RETURN(int64_t num_selected, Select(exec_state, predicate_rb, &selected));
+  if (num_rows > 0) {
+    remaining_bytes_per_row_ =
+        kObservationWeight * (BytesPerRow(*rb) - BytesPerRow(predicate_rb)) +
+        (1 - kObservationWeight) * remaining_bytes_per_row_;
+  }
+  rows_skipped_ += num_rows - num_selected;
+
+  PL_ASSIGN_OR_RETURN(auto builders, MakeBuilders(output_descriptor, num_selected));
+  for (size_t output_col = 0; output_col < builders.size(); ++output_col) {
+    PL_RETURN_IF_ERROR(AppendSelectedValues(rb->ColumnAt(output_col).get(), selected, 0,
+                                            builders[output_col].get()));
+  }
+  return FinishRowBatch(output_descriptor, num_selected, &builders);
+}
+
+StatusOr<std::unique_ptr<RowBatch>> LateMaterializer::ReadLate(
+    ExecState* exec_state, Table::Cursor* cursor, const RowDescriptor& output_descriptor,
+    int64_t* rows_read) {
+  PL_ASSIGN_OR_RETURN(auto predicate_rb, cursor->GetNextRowBatch(predicate_table_cols_));
+  int64_t num_rows = predicate_rb->num_rows();
+  *rows_read = num_rows;
+
+  std::vector<bool> selected;
+  PL_ASSIGN_OR_RETURN(int64_t num_selected, Select(exec_state, *predicate_rb, &selected));
+  auto first_selected = std::find(selected.begin(), selected.end(), true) - selected.begin();
+  auto last_selected = selected.rend() - std::find(selected.rbegin(), selected.rend(), true) - 1;
+
+  PL_ASSIGN_OR_RETURN(auto builders, MakeBuilders(output_descriptor, num_selected));
+
+  // Read the remaining columns, for the range of rows that passed the predicate.
+  if (num_selected > 0) {
+    std::vector<bool> present(num_rows, false);
+    PL_ASSIGN_OR_RETURN(auto remaining_rbs, cursor->ReadLastBatchRows(
+                                                first_selected, last_selected + 1,
+                                                remaining_table_cols_));
+    for (const auto& [offset, rb] : remaining_rbs) {
+      for (int64_t i = 0; i < rb->num_rows(); ++i) {
+        present[offset + i] = true;
+      }
+      for (const auto& [i, output_col] : Enumerate(remaining_output_cols_)) {
+        PL_RETURN_IF_ERROR(AppendSelectedValues(rb->ColumnAt(i).get(), selected, offset,
+                                                builders[output_col].get()));
+      }
+      remaining_bytes_per_row_ = kObservationWeight * BytesPerRow(*rb) +
+                                 (1 - kObservationWeight) * remaining_bytes_per_row_;
+    }
+
+    // Rows that were expired before the remaining columns could be read are dropped, so that all
+    // columns stay aligned.
+    for (int64_t i = 0; i < num_rows; ++i) {
+      if (selected[i] && !present[i]) {
+        selected[i] = false;
+        --num_selected;
+      }
+    }
+    for (const auto& [i, output_col] : Enumerate(predicate_output_cols_)) {
+      PL_RETURN_IF_ERROR(AppendSelectedValues(predicate_rb->ColumnAt(i).get(), selected, 0,
+                                              builders[output_col].get()));
+    }
+  }
+  rows_skipped_ += num_rows - num_selected;
+  return FinishRowBatch(output_descriptor, num_selected, &builders);
+}
+
+std::string LateMaterializer::DebugString() const {
+  return absl::Substitute(
+      "LateMaterializer<predicate_cols: [$0], selectivity: $1, selected_span: $2, "
+      "rows_skipped: $3>",
+      absl::StrJoin(predicate_output_cols_, ","), selectivity_, selected_span_, rows_skipped_);
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/carnot/exec/exec_state.h"
+#include "src/carnot/exec/expression_evaluator.h"
+#include "src/carnot/plan/scalar_expression.h"
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/types.h"
+#include "src/table_store/schema/row_batch.h"
+#include "src/table_store/table/table.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * Estimates the fraction of rows that pass the given predicate, based on the comparison and
+ * logical functions it is composed of.
+ */
+double EstimatePredicateSelectivity(const planpb::ScalarExpression& predicate);
+
+/**
+ * Estimates the number of bytes a single value of the given type takes up.
+ */
+double EstimateColumnWidth(types::DataType type);
+
+/**
+ * LateMaterializer lets a MemorySourceNode apply the predicate of the FilterNode that consumes
+ * its output, using late materialization: the columns the predicate references are read and the
+ * predicate is evaluated first, and the remaining columns are only read for the rows that pass.
+ * This avoids reading (and converting hot batches of) wide columns such as request bodies for
+ * rows that a selective filter is going to discard anyway.
+ *
+ * Whether late materialization pays off depends on the selectivity of the predicate, on how
+ * clustered the rows that pass it are, and on the widths of the columns. The remaining columns are
+ * read for the whole span between the first and the last row that passes, so scattered rows make
+ * it no cheaper than reading the batch in full. The decision starts from estimates, assumes the
+ * span is the whole batch until one is observed, and is revisited after each batch with what was
+ * actually observed. Batches that aren't worth materializing late are read in full, and then
+ * filtered.
+ *
+ * Either way, every batch it returns is already filtered, so the predicate is evaluated once and
+ * the FilterNode only has to project its output (see FilterNode::SetPredicateAppliedUpstream()).
+ */
+class LateMaterializer {
+ public:
+  /**
+   * Creates a LateMaterializer for the predicate.
+   * @param predicate The predicate, which references the columns of the memory source's output.
+   * @param table_cols The table column indices that the memory source outputs.
+   * @param output_types The types of the memory source's output columns.
+   * @return the materializer, or nullptr if late materialization doesn't apply to the predicate.
+   */
+  static StatusOr<std::unique_ptr<LateMaterializer>> Create(
+      const planpb::ScalarExpression& predicate, const std::vector<int64_t>& table_cols,
+      const std::vector<types::DataType>& output_types);
+
+  Status Prepare(ExecState* exec_state);
+  Status Open(ExecState* exec_state);
+  Status Close(ExecState* exec_state);
+
+  /**
+   * Whether the next batch should be read with late materialization, according to the cost
+   * model.
+   */
+  bool Enabled() const;
+
+  /**
+   * Reads the next batch from the cursor, and returns the rows of it that pass the predicate.
+   * If Enabled(), the non-predicate columns are only materialized for those rows.
+   * @param rows_read Set to the number of rows read from the table, before filtering.
+   */
+  StatusOr<std::unique_ptr<table_store::schema::RowBatch>> GetNextRowBatch(
+      ExecState* exec_state, table_store::Table::Cursor* cursor,
+      const table_store::schema::RowDescriptor& output_descriptor, int64_t* rows_read);
+
+  double selectivity() const { return selectivity_; }
+  double selected_span() const { return selected_span_; }
+  int64_t rows_skipped() const { return rows_skipped_; }
+  std::string DebugString() const;
+
+ private:
+  LateMaterializer() = default;
+
+  // Reads the next batch with late materialization.
+  StatusOr<std::unique_ptr<table_store::schema::RowBatch>> ReadLate(
+      ExecState* exec_state, table_store::Table::Cursor* cursor,
+      const table_store::schema::RowDescriptor& output_descriptor, int64_t* rows_read);
+  // Reads the next batch in full, then filters it.
+  StatusOr<std::unique_ptr<table_store::schema::RowBatch>> ReadEager(
+      ExecState* exec_state, table_store::Table::Cursor* cursor,
+      const table_store::schema::RowDescriptor& output_descriptor, int64_t* rows_read);
+  // Evaluates the predicate on a batch of the predicate columns, and sets selected[i] for the rows
+  // that pass it. Returns the number of rows that pass.
+  StatusOr<int64_t> Select(ExecState* exec_state,
+                           const table_store::schema::RowBatch& predicate_rb,
+                           std::vector<bool>* selected);
+
+  // The minimum ratio of the eager cost to the late materialization cost for late materialization
+  // to be used.
+  static constexpr double kMinCostRatio = 1.25;
+  // How much weight a new batch has on the observed selectivity and widths.
+  static constexpr double kObservationWeight = 0.5;
+
+  planpb::ScalarExpression predicate_pb_;
+  std::shared_ptr<const plan::ScalarExpression> predicate_;
+  std::unique_ptr<udf::FunctionContext> function_ctx_;
+  std::unique_ptr<VectorNativeScalarExpressionEvaluator> evaluator_;
+
+  // Indices (into the memory source's output) of the predicate and remaining columns.
+  std::vector<int64_t> predicate_output_cols_;
+  std::vector<int64_t> remaining_output_cols_;
+  // The table column indices of the predicate and remaining columns.
+  std::vector<int64_t> predicate_table_cols_;
+  std::vector<int64_t> remaining_table_cols_;
+  // The table column indices of all of the memory source's output columns.
+  std::vector<int64_t> table_cols_;
+  std::vector<types::DataType> predicate_types_;
+
+  double selectivity_ = 1.0;
+  // The fraction of a batch between its first and last selected rows (inclusive).
+  double selected_span_ = 1.0;
+  double predicate_bytes_per_row_ = 0;
+  double remaining_bytes_per_row_ = 0;
+  int64_t rows_skipped_ = 0;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
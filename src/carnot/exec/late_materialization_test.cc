@@ -0,0 +1,254 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/late_materialization.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/text_format.h>
+#include <gtest/gtest.h>
+#include <sole.hpp>
+
+#include "src/carnot/exec/test_utils.h"
+#include "src/carnot/planpb/test_proto.h"
+#include "src/carnot/udf/registry.h"
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::Table;
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+using udf::FunctionContext;
+
+class LateMatEqUDF : public udf::ScalarUDF {
+ public:
+  types::BoolValue Exec(FunctionContext*, types::Int64Value v1, types::Int64Value v2) {
+    return v1.val == v2.val;
+  }
+};
+
+constexpr char kEqualPbtxt[] = R"(
+func {
+  name: "equal"
+  args { column { index: 0 } }
+  args { constant { data_type: INT64 int64_value: 1 } }
+})";
+
+constexpr char kAndPbtxt[] = R"(
+func {
+  name: "logicalAnd"
+  args { func { name: "equal" } }
+  args { func { name: "lessThan" } }
+})";
+
+class LateMaterializerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    func_registry_ = std::make_unique<udf::Registry>("test_registry");
+    EXPECT_OK(func_registry_->Register<LateMatEqUDF>("eq"));
+    auto table_store = std::make_shared<table_store::TableStore>();
+    exec_state_ = std::make_unique<ExecState>(func_registry_.get(), table_store,
+                                              MockResultSinkStubGenerator, MockMetricsStubGenerator,
+                                              MockTraceStubGenerator, sole::uuid4(), nullptr);
+    EXPECT_OK(exec_state_->AddScalarUDF(
+        0, "eq", std::vector<types::DataType>({types::DataType::INT64, types::DataType::INT64})));
+
+    table_store::schema::Relation rel(
+        {types::DataType::TIME64NS, types::DataType::INT64, types::DataType::STRING},
+        {"time_", "status", "body"});
+    table_ = Table::Create("http", rel);
+
+    auto rb1 = RowBatch(RowDescriptor(rel.col_types()), 4);
+    std::vector<types::Time64NSValue> time_in1 = {1, 2, 3, 4};
+    std::vector<types::Int64Value> status_in1 = {1, 2, 1, 3};
+    std::vector<types::StringValue> body_in1 = {"a", "b", "c", "d"};
+    EXPECT_OK(rb1.AddColumn(types::ToArrow(time_in1, arrow::default_memory_pool())));
+    EXPECT_OK(rb1.AddColumn(types::ToArrow(status_in1, arrow::default_memory_pool())));
+    EXPECT_OK(rb1.AddColumn(types::ToArrow(body_in1, arrow::default_memory_pool())));
+    EXPECT_OK(table_->WriteRowBatch(rb1));
+
+    auto rb2 = RowBatch(RowDescriptor(rel.col_types()), 2);
+    std::vector<types::Time64NSValue> time_in2 = {5, 6};
+    std::vector<types::Int64Value> status_in2 = {2, 2};
+    std::vector<types::StringValue> body_in2 = {"e", "f"};
+    EXPECT_OK(rb2.AddColumn(types::ToArrow(time_in2, arrow::default_memory_pool())));
+    EXPECT_OK(rb2.AddColumn(types::ToArrow(status_in2, arrow::default_memory_pool())));
+    EXPECT_OK(rb2.AddColumn(types::ToArrow(body_in2, arrow::default_memory_pool())));
+    EXPECT_OK(table_->WriteRowBatch(rb2));
+  }
+
+  std::shared_ptr<Table> table_;
+  std::unique_ptr<ExecState> exec_state_;
+  std::unique_ptr<udf::Registry> func_registry_;
+};
+
+TEST_F(LateMaterializerTest, selectivity_estimate) {
+  planpb::ScalarExpression equal;
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(kEqualPbtxt, &equal));
+  EXPECT_DOUBLE_EQ(0.1, EstimatePredicateSelectivity(equal));
+
+  planpb::ScalarExpression logical_and;
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(kAndPbtxt, &logical_and));
+  EXPECT_DOUBLE_EQ(0.1 / 3, EstimatePredicateSelectivity(logical_and));
+}
+
+TEST_F(LateMaterializerTest, not_applicable) {
+  planpb::ScalarExpression predicate;
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(
+      planpb::testutils::kColValueScalarFuncConstPbtxt, &predicate));
+  // The predicate references every output column, so there is nothing to materialize late.
+  ASSERT_OK_AND_ASSIGN(auto materializer,
+                       LateMaterializer::Create(predicate, {1}, {types::DataType::INT64}));
+  EXPECT_EQ(nullptr, materializer);
+}
+
+TEST_F(LateMaterializerTest, filters_rows) {
+  planpb::ScalarExpression predicate;
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(
+      planpb::testutils::kEq1ScalarFuncConstPbtxt, &predicate));
+
+  // The memory source outputs (status, body).
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::STRING});
+  ASSERT_OK_AND_ASSIGN(auto materializer,
+                       LateMaterializer::Create(predicate, {1, 2}, output_rd.types()));
+  ASSERT_NE(nullptr, materializer);
+  ASSERT_OK(materializer->Prepare(exec_state_.get()));
+  ASSERT_OK(materializer->Open(exec_state_.get()));
+
+  Table::Cursor cursor(table_.get());
+  int64_t rows_read = 0;
+  ASSERT_OK_AND_ASSIGN(auto rb1, materializer->GetNextRowBatch(exec_state_.get(), &cursor,
+                                                               output_rd, &rows_read));
+  EXPECT_EQ(4, rows_read);
+  auto expected_rb = RowBatchBuilder(output_rd, 2, false, false)
+                         .AddColumn<types::Int64Value>({1, 1})
+                         .AddColumn<types::StringValue>({"a", "c"})
+                         .get();
+  ASSERT_EQ(2, rb1->num_rows());
+  for (int64_t i = 0; i < expected_rb.num_columns(); ++i) {
+    EXPECT_TRUE(rb1->ColumnAt(i)->Equals(expected_rb.ColumnAt(i)));
+  }
+
+  ASSERT_OK_AND_ASSIGN(auto rb2, materializer->GetNextRowBatch(exec_state_.get(), &cursor,
+                                                               output_rd, &rows_read));
+  EXPECT_EQ(2, rows_read);
+  EXPECT_EQ(0, rb2->num_rows());
+  EXPECT_EQ(4, materializer->rows_skipped());
+  EXPECT_TRUE(cursor.Done());
+  ASSERT_OK(materializer->Close(exec_state_.get()));
+}
+
+TEST_F(LateMaterializerTest, filters_rows_read_eagerly) {
+  planpb::ScalarExpression predicate;
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(
+      planpb::testutils::kEq1ScalarFuncConstPbtxt, &predicate));
+
+  // The memory source outputs (status, time_). Narrow remaining columns and a permissive
+  // predicate make reading the whole batch the cheaper strategy.
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::TIME64NS});
+  ASSERT_OK_AND_ASSIGN(auto materializer,
+                       LateMaterializer::Create(predicate, {1, 0}, output_rd.types()));
+  ASSERT_NE(nullptr, materializer);
+  ASSERT_OK(materializer->Prepare(exec_state_.get()));
+  ASSERT_OK(materializer->Open(exec_state_.get()));
+  EXPECT_FALSE(materializer->Enabled());
+
+  Table::Cursor cursor(table_.get());
+  int64_t rows_read = 0;
+  ASSERT_OK_AND_ASSIGN(auto rb1, materializer->GetNextRowBatch(exec_state_.get(), &cursor,
+                                                               output_rd, &rows_read));
+  EXPECT_EQ(4, rows_read);
+  auto expected_rb = RowBatchBuilder(output_rd, 2, false, false)
+                         .AddColumn<types::Int64Value>({1, 1})
+                         .AddColumn<types::Time64NSValue>({1, 3})
+                         .get();
+  ASSERT_EQ(2, rb1->num_rows());
+  for (int64_t i = 0; i < expected_rb.num_columns(); ++i) {
+    EXPECT_TRUE(rb1->ColumnAt(i)->Equals(expected_rb.ColumnAt(i)));
+  }
+  ASSERT_OK(materializer->Close(exec_state_.get()));
+}
+
+class LateMaterializerSpanTest : public LateMaterializerTest {
+ protected:
+  // Writes a batch of 10 rows with wide bodies, whose status is 1 only at the given rows.
+  std::shared_ptr<Table> MakeTable(const std::vector<int64_t>& selected_rows) {
+    table_store::schema::Relation rel({types::DataType::INT64, types::DataType::STRING},
+                                      {"status", "body"});
+    auto table = Table::Create("http", rel);
+    std::vector<types::Int64Value> status(10, 0);
+    for (int64_t row : selected_rows) {
+      status[row] = 1;
+    }
+    std::vector<types::StringValue> body(10, std::string(1000, 'x'));
+    auto rb = RowBatch(RowDescriptor(rel.col_types()), 10);
+    EXPECT_OK(rb.AddColumn(types::ToArrow(status, arrow::default_memory_pool())));
+    EXPECT_OK(rb.AddColumn(types::ToArrow(body, arrow::default_memory_pool())));
+    EXPECT_OK(table->WriteRowBatch(rb));
+    return table;
+  }
+
+  // Reads the table's only batch, and returns whether the next batch would be read late.
+  bool EnabledAfterFirstBatch(Table* table, double* selected_span) {
+    planpb::ScalarExpression predicate;
+    EXPECT_TRUE(google::protobuf::TextFormat::MergeFromString(
+        planpb::testutils::kEq1ScalarFuncConstPbtxt, &predicate));
+    RowDescriptor output_rd({types::DataType::INT64, types::DataType::STRING});
+    auto materializer = LateMaterializer::Create(predicate, {0, 1}, output_rd.types())
+                            .ConsumeValueOrDie();
+    EXPECT_OK(materializer->Prepare(exec_state_.get()));
+    EXPECT_OK(materializer->Open(exec_state_.get()));
+    // Until a span has been observed, it is assumed to cover the whole batch.
+    EXPECT_FALSE(materializer->Enabled());
+
+    Table::Cursor cursor(table);
+    int64_t rows_read = 0;
+    auto rb = materializer->GetNextRowBatch(exec_state_.get(), &cursor, output_rd, &rows_read)
+                  .ConsumeValueOrDie();
+    EXPECT_EQ(2, rb->num_rows());
+    EXPECT_OK(materializer->Close(exec_state_.get()));
+    *selected_span = materializer->selected_span();
+    return materializer->Enabled();
+  }
+};
+
+TEST_F(LateMaterializerSpanTest, clustered_rows_are_read_late) {
+  auto table = MakeTable({4, 5});
+  double selected_span = 0;
+  EXPECT_TRUE(EnabledAfterFirstBatch(table.get(), &selected_span));
+  EXPECT_DOUBLE_EQ(0.5 * 0.2 + 0.5 * 1.0, selected_span);
+}
+
+TEST_F(LateMaterializerSpanTest, scattered_rows_are_read_eagerly) {
+  // Reading the remaining columns from row 0 to row 9 costs as much as reading the whole batch.
+  auto table = MakeTable({0, 9});
+  double selected_span = 0;
+  EXPECT_FALSE(EnabledAfterFirstBatch(table.get(), &selected_span));
+  EXPECT_DOUBLE_EQ(1.0, selected_span);
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
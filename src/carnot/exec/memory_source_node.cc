@@ -21,6 +21,7 @@
 
 #include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <absl/strings/substitute.h>
@@ -49,7 +50,24 @@ Status MemorySourceNode::InitImpl(const plan::Operator& plan_node) {
   return Status::OK();
 }
 
-Status MemorySourceNode::PrepareImpl(ExecState*) { return Status::OK(); }
+StatusOr<bool> MemorySourceNode::PushDownFilterPredicate(
+    const planpb::ScalarExpression& predicate) {
+  PL_ASSIGN_OR_RETURN(late_materializer_,
+                      LateMaterializer::Create(predicate, plan_node_->Columns(),
+                                               output_descriptor_->types()));
+  return late_materializer_ != nullptr;
+}
+
+void MemorySourceNode::AddRuntimeJoinFilter(int64_t join_id, std::vector<int64_t> key_cols) {
+  runtime_join_filters_.push_back({join_id, std::move(key_cols)});
+}
+
+Status MemorySourceNode::PrepareImpl(ExecState* exec_state) {
+  if (late_materializer_ != nullptr) {
+    PL_RETURN_IF_ERROR(late_materializer_->Prepare(exec_state));
+  }
+  return Status::OK();
+}
 
 Status MemorySourceNode::OpenImpl(ExecState* exec_state) {
   table_ = exec_state->table_store()->GetTable(plan_node_->TableName(), plan_node_->Tablet());
@@ -81,15 +99,25 @@ Status MemorySourceNode::OpenImpl(ExecState* exec_state) {
   }
   cursor_ = std::make_unique<Table::Cursor>(table_, start_spec, stop_spec);
 
+  if (late_materializer_ != nullptr) {
+    PL_RETURN_IF_ERROR(late_materializer_->Open(exec_state));
+  }
   return Status::OK();
 }
 
-Status MemorySourceNode::CloseImpl(ExecState*) {
+Status MemorySourceNode::CloseImpl(ExecState* exec_state) {
   stats()->AddExtraInfo("infinite_stream", infinite_stream_ ? "true" : "false");
+  if (!runtime_join_filters_.empty()) {
+    stats()->AddExtraInfo("runtime_filtered_rows", std::to_string(runtime_filtered_rows_));
+  }
+  if (late_materializer_ != nullptr) {
+    stats()->AddExtraInfo("late_materialization", late_materializer_->DebugString());
+    PL_RETURN_IF_ERROR(late_materializer_->Close(exec_state));
+  }
   return Status::OK();
 }
 
-StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState*) {
+StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState* exec_state) {
   DCHECK(table_ != nullptr);
 
   if (!cursor_->NextBatchReady()) {
@@ -102,9 +130,27 @@ StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState*
                                   /* eos */ cursor_->Done());
   }
 
-  PL_ASSIGN_OR_RETURN(auto row_batch, cursor_->GetNextRowBatch(plan_node_->Columns()));
+  std::unique_ptr<RowBatch> row_batch;
+  // Rows read from the table, including any that the pushed down predicate dropped.
+  int64_t rows_read = 0;
+  if (late_materializer_ != nullptr) {
+    PL_ASSIGN_OR_RETURN(row_batch,
+                        late_materializer_->GetNextRowBatch(exec_state, cursor_.get(),
+                                                            *output_descriptor_, &rows_read));
+  } else {
+    PL_ASSIGN_OR_RETURN(row_batch, cursor_->GetNextRowBatch(plan_node_->Columns()));
+    rows_read = row_batch->num_rows();
+  }
+
+  for (const auto& spec : runtime_join_filters_) {
+    const auto* filter = exec_state->GetRuntimeJoinFilter(spec.join_id);
+    if (filter != nullptr) {
+      PL_ASSIGN_OR_RETURN(row_batch,
+                          filter->Apply(*row_batch, spec.key_cols, &runtime_filtered_rows_));
+    }
+  }
 
-  rows_processed_ += row_batch->num_rows();
+  rows_processed_ += rows_read;
   bytes_processed_ += row_batch->NumBytes();
 
   // If infinite stream is set, we don't send Eow or Eos. Infinite streams therefore never cause
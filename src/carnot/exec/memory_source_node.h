@@ -25,6 +25,7 @@
 
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
+#include "src/carnot/exec/late_materialization.h"
 #include "src/carnot/plan/operators.h"
 #include "src/common/base/base.h"
 #include "src/common/base/status.h"
@@ -46,6 +47,26 @@ class MemorySourceNode : public SourceNode {
 
   bool NextBatchReady() override;
 
+  /**
+   * Considers applying the predicate of the filter that consumes this source's output within the
+   * source itself, so that columns the predicate doesn't reference are only read for the rows
+   * that pass. Must be called before Prepare().
+   *
+   * If the predicate is applied, the source only outputs rows that pass it. Rows processed still
+   * counts every row read from the table, while bytes processed only counts the bytes output.
+   * @param predicate The filter's predicate, in terms of this source's output columns.
+   * @return whether the source applies the predicate.
+   */
+  StatusOr<bool> PushDownFilterPredicate(const planpb::ScalarExpression& predicate);
+
+  /**
+   * Drops the rows that can't match on the probe side of a join, once the join has published the
+   * RuntimeJoinFilter of its build side to the ExecState.
+   * @param join_id The id of the join operator.
+   * @param key_cols The indices of the join key columns in this source's output.
+   */
+  void AddRuntimeJoinFilter(int64_t join_id, std::vector<int64_t> key_cols);
+
  protected:
   std::string DebugStringImpl() override;
   Status InitImpl(const plan::Operator& plan_node) override;
@@ -65,6 +86,16 @@ class MemorySourceNode : public SourceNode {
 
   std::unique_ptr<plan::MemorySourceOperator> plan_node_;
   table_store::Table* table_ = nullptr;
+
+  // Set if a filter predicate was pushed down into this source, see PushDownFilterPredicate().
+  std::unique_ptr<LateMaterializer> late_materializer_;
+
+  struct RuntimeJoinFilterSpec {
+    int64_t join_id;
+    std::vector<int64_t> key_cols;
+  };
+  std::vector<RuntimeJoinFilterSpec> runtime_join_filters_;
+  int64_t runtime_filtered_rows_ = 0;
 };
 
 }  // namespace exec
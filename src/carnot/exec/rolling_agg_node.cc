@@ -0,0 +1,451 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/rolling_agg_node.h"
+
+#include <arrow/array.h>
+#include <algorithm>
+
+#include "src/carnot/exec/expression_evaluator.h"
+#include "src/carnot/plan/scalar_expression.h"
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+
+// Buffered argument values are folded into the bucket UDAs once they grow past this many rows.
+constexpr int64_t kRollingAggCompactionThreshold = 512;
+
+namespace {
+
+template <types::DataType DT>
+void AppendToBuilder(arrow::ArrayBuilder* builder, RowTuple* rt, size_t rt_idx) {
+  using ArrowBuilder = typename types::DataTypeTraits<DT>::arrow_builder_type;
+  using ValueType = typename types::DataTypeTraits<DT>::value_type;
+  auto status =
+      static_cast<ArrowBuilder*>(builder)->Append(udf::UnWrap(rt->GetValue<ValueType>(rt_idx)));
+  PL_DCHECK_OK(status);
+  PL_UNUSED(status);
+}
+
+}  // namespace
+
+/**
+ * SlidingWindowUDAs implementation.
+ */
+
+Status SlidingWindowUDAs::MergeInto(std::vector<UDAInfo>* dst, const std::vector<UDAInfo>& src) {
+  DCHECK_EQ(dst->size(), src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    PL_RETURN_IF_ERROR((*dst)[i].def->Merge((*dst)[i].uda.get(), src[i].uda.get(), nullptr));
+  }
+  return Status::OK();
+}
+
+Status SlidingWindowUDAs::Push(int64_t bucket_start, std::vector<UDAInfo> bucket_udas) {
+  DCHECK(back_.empty() || back_.back().start < bucket_start);
+  if (back_merged_.empty()) {
+    PL_RETURN_IF_ERROR(make_udas_(&back_merged_));
+  }
+  PL_RETURN_IF_ERROR(MergeInto(&back_merged_, bucket_udas));
+  back_.push_back(Bucket{bucket_start, std::move(bucket_udas)});
+  return Status::OK();
+}
+
+Status SlidingWindowUDAs::Flip() {
+  DCHECK(front_.empty());
+  // Walk from the newest bucket to the oldest so that each front entry can extend the suffix
+  // merge held by the entry pushed before it.
+  for (auto it = back_.rbegin(); it != back_.rend(); ++it) {
+    if (!front_.empty()) {
+      PL_RETURN_IF_ERROR(MergeInto(&it->udas, front_.back().udas));
+    }
+    front_.push_back(std::move(*it));
+  }
+  back_.clear();
+  back_merged_.clear();
+  return Status::OK();
+}
+
+Status SlidingWindowUDAs::EvictBefore(int64_t min_bucket_start) {
+  while (!empty()) {
+    if (front_.empty()) {
+      PL_RETURN_IF_ERROR(Flip());
+    }
+    if (front_.back().start >= min_bucket_start) {
+      break;
+    }
+    front_.pop_back();
+  }
+  return Status::OK();
+}
+
+Status SlidingWindowUDAs::Merged(std::vector<UDAInfo>* out) {
+  DCHECK(out->empty());
+  PL_RETURN_IF_ERROR(make_udas_(out));
+  if (!front_.empty()) {
+    PL_RETURN_IF_ERROR(MergeInto(out, front_.back().udas));
+  }
+  if (!back_.empty()) {
+    PL_RETURN_IF_ERROR(MergeInto(out, back_merged_));
+  }
+  return Status::OK();
+}
+
+/**
+ * RollingAggNode implementation.
+ */
+
+std::string RollingAggNode::DebugStringImpl() {
+  return absl::Substitute("Exec::RollingAggNode<$0>", plan_node_->DebugString());
+}
+
+Status RollingAggNode::InitImpl(const plan::Operator& plan_node) {
+  // Rolling aggregates share the AGGREGATE_OPERATOR type, so check the concrete operator.
+  const auto* rolling_plan_node = dynamic_cast<const plan::RollingAggregateOperator*>(&plan_node);
+  if (rolling_plan_node == nullptr) {
+    return error::InvalidArgument("Rolling aggregate node requires a rolling aggregate operator");
+  }
+  plan_node_ = std::make_unique<plan::RollingAggregateOperator>(*rolling_plan_node);
+
+  if (input_descriptors_.size() != 1) {
+    return error::InvalidArgument(
+        "Rolling aggregate operator expects a single input relation, got $0",
+        input_descriptors_.size());
+  }
+  input_descriptor_ = std::make_unique<RowDescriptor>(input_descriptors_[0]);
+
+  auto time_col_idx = plan_node_->time_col_idx();
+  if (time_col_idx < 0 || time_col_idx >= static_cast<int64_t>(input_descriptor_->size()) ||
+      input_descriptor_->type(time_col_idx) != types::TIME64NS) {
+    return error::InvalidArgument("Rolling time column $0 must be a TIME64NS input column",
+                                  time_col_idx);
+  }
+
+  for (const auto& value : plan_node_->values()) {
+    if (value->ExpressionType() != plan::Expression::kAgg) {
+      return error::InvalidArgument("Aggregate operator can only use aggregate expressions");
+    }
+  }
+
+  // The output is the groups, the bucket time and then the values.
+  auto groups_size = plan_node_->groups().size();
+  auto values_size = plan_node_->values().size();
+  if (groups_size + 1 + values_size != output_descriptor_->size()) {
+    return error::InvalidArgument("Output size mismatch in rolling aggregate");
+  }
+
+  for (const auto& group : plan_node_->groups()) {
+    DCHECK(group.idx < input_descriptor_->size());
+    group_data_types_.emplace_back(input_descriptor_->type(group.idx));
+  }
+  for (size_t i = 0; i < values_size; ++i) {
+    value_data_types_.emplace_back(output_descriptor_->type(groups_size + 1 + i));
+  }
+
+  return CreateColumnMapping();
+}
+
+Status RollingAggNode::PrepareImpl(ExecState* exec_state) {
+  function_ctx_ = exec_state->CreateFunctionContext();
+  return Status::OK();
+}
+
+Status RollingAggNode::OpenImpl(ExecState* exec_state) {
+  lookup_rt_ = std::make_unique<RowTuple>(&group_data_types_);
+  return ResetBuilders(exec_state);
+}
+
+Status RollingAggNode::CloseImpl(ExecState*) {
+  group_map_.clear();
+  groups_.clear();
+  lookup_rt_.reset();
+  return Status::OK();
+}
+
+Status RollingAggNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
+  auto* time_col = rb.ColumnAt(plan_node_->time_col_idx()).get();
+  for (int64_t row = 0; row < rb.num_rows(); ++row) {
+    int64_t bucket_start =
+        BucketStart(types::GetValueFromArrowArray<types::TIME64NS>(time_col, row));
+    if (!has_open_bucket_) {
+      has_open_bucket_ = true;
+      open_bucket_start_ = bucket_start;
+    } else if (bucket_start > open_bucket_start_) {
+      PL_RETURN_IF_ERROR(AdvanceTo(exec_state, bucket_start));
+    }
+
+    PL_ASSIGN_OR_RETURN(GroupState * group, FindOrCreateGroup(exec_state, rb, row));
+    group->has_rows = true;
+    for (size_t i = 0; i < stored_cols_data_types_.size(); ++i) {
+      auto* arr = rb.ColumnAt(stored_cols_to_plan_idx_[i]).get();
+#define TYPE_CASE(_dt_) \
+  types::ExtractValueToColumnWrapper<_dt_>(group->agg_cols[i].get(), arr, row);
+      PL_SWITCH_FOREACH_DATATYPE(stored_cols_data_types_[i], TYPE_CASE);
+#undef TYPE_CASE
+    }
+    if (!group->agg_cols.empty() &&
+        group->agg_cols[0]->Size() > static_cast<size_t>(kRollingAggCompactionThreshold)) {
+      PL_RETURN_IF_ERROR(UpdateGroupUDAs(exec_state, group));
+    }
+  }
+
+  if (rb.eos() && has_open_bucket_) {
+    PL_RETURN_IF_ERROR(CloseBucket(exec_state));
+    has_open_bucket_ = false;
+  }
+  if (pending_rows_ > 0 || rb.eos()) {
+    PL_RETURN_IF_ERROR(EmitRowBatch(exec_state, rb.eos()));
+  }
+  return Status::OK();
+}
+
+StatusOr<RollingAggNode::GroupState*> RollingAggNode::FindOrCreateGroup(ExecState* exec_state,
+                                                                        const RowBatch& rb,
+                                                                        int64_t row) {
+  // Without group columns every row lands in the single group.
+  bool no_groups = group_data_types_.empty();
+  if (no_groups && !groups_.empty()) {
+    return groups_.front().get();
+  }
+
+  lookup_rt_->Reset();
+  for (size_t idx = 0; idx < group_data_types_.size(); ++idx) {
+    auto* col = rb.ColumnAt(plan_node_->groups()[idx].idx).get();
+#define TYPE_CASE(_dt_) \
+  ExtractIntoRowTuple<_dt_>(lookup_rt_.get(), col, static_cast<int>(idx), static_cast<int>(row));
+    PL_SWITCH_FOREACH_DATATYPE(group_data_types_[idx], TYPE_CASE);
+#undef TYPE_CASE
+  }
+
+  if (!no_groups) {
+    auto it = group_map_.find(lookup_rt_.get());
+    if (it != group_map_.end()) {
+      return it->second;
+    }
+  }
+
+  // The lookup tuple becomes the group key, so grab a fresh one for the next lookup.
+  auto group = std::make_unique<GroupState>();
+  group->rt = std::move(lookup_rt_);
+  lookup_rt_ = std::make_unique<RowTuple>(&group_data_types_);
+  PL_RETURN_IF_ERROR(CreateUDAInfoValues(&group->udas, exec_state));
+  for (const auto& dt : stored_cols_data_types_) {
+    group->agg_cols.emplace_back(types::ColumnWrapper::Make(dt, 0));
+  }
+  group->window = std::make_unique<SlidingWindowUDAs>(
+      [this, exec_state](std::vector<UDAInfo>* udas) {
+        return CreateUDAInfoValues(udas, exec_state);
+      });
+  auto* group_ptr = group.get();
+  if (!no_groups) {
+    group_map_[group_ptr->rt.get()] = group_ptr;
+  }
+  groups_.push_back(std::move(group));
+  return group_ptr;
+}
+
+Status RollingAggNode::UpdateGroupUDAs(ExecState* exec_state, GroupState* group) {
+  if (group->agg_cols.empty()) {
+    return Status::OK();
+  }
+  size_t num_records = group->agg_cols[0]->Size();
+  for (size_t i = 0; i < plan_node_->values().size(); ++i) {
+    const auto& uda_info = group->udas[i];
+    plan::ExpressionWalker<StatusOr<types::SharedColumnWrapper>> walker;
+    walker.OnScalarValue([&](const plan::ScalarValue& scalar_val,
+                             const std::vector<StatusOr<types::SharedColumnWrapper>>& children)
+                             -> types::SharedColumnWrapper {
+      DCHECK_EQ(children.size(), 0ULL);
+      return EvalScalarToColumnWrapper(exec_state, scalar_val, num_records);
+    });
+
+    walker.OnColumn([&](const plan::Column& col,
+                        const std::vector<StatusOr<types::SharedColumnWrapper>>& children)
+                        -> types::SharedColumnWrapper {
+      DCHECK_EQ(children.size(), 0ULL);
+      return group->agg_cols[plan_cols_to_stored_map_[col.Index()]];
+    });
+
+    walker.OnAggregateExpression(
+        [&](const plan::AggregateExpression& agg,
+            const std::vector<StatusOr<types::SharedColumnWrapper>>& children)
+            -> StatusOr<types::SharedColumnWrapper> {
+          DCHECK(agg.name() == uda_info.def->name());
+          std::vector<const types::ColumnWrapper*> raw_children;
+          raw_children.reserve(children.size());
+          for (auto& child : children) {
+            PL_RETURN_IF_ERROR(child);
+            raw_children.push_back(child.ValueOrDie().get());
+          }
+          PL_RETURN_IF_ERROR(
+              uda_info.def->ExecBatchUpdate(uda_info.uda.get(), nullptr /* ctx */, raw_children));
+          return {};
+        });
+    PL_RETURN_IF_ERROR(walker.Walk(*plan_node_->values()[i]));
+  }
+
+  for (auto& col : group->agg_cols) {
+    col->Clear();
+  }
+  return Status::OK();
+}
+
+Status RollingAggNode::AdvanceTo(ExecState* exec_state, int64_t bucket_start) {
+  while (open_bucket_start_ < bucket_start) {
+    PL_RETURN_IF_ERROR(CloseBucket(exec_state));
+    // Once every window has drained, the remaining empty buckets have nothing to report.
+    open_bucket_start_ =
+        groups_.empty() ? bucket_start : open_bucket_start_ + plan_node_->step_ns();
+  }
+  return Status::OK();
+}
+
+Status RollingAggNode::CloseBucket(ExecState* exec_state) {
+  // Buckets starting before this no longer overlap the window ending with the open bucket.
+  int64_t min_bucket_start = open_bucket_start_ - plan_node_->window_ns() + plan_node_->step_ns();
+  for (const auto& group_state : groups_) {
+    auto* group = group_state.get();
+    if (group->has_rows) {
+      PL_RETURN_IF_ERROR(UpdateGroupUDAs(exec_state, group));
+
+      std::vector<UDAInfo> bucket_udas;
+      std::swap(bucket_udas, group->udas);
+      PL_RETURN_IF_ERROR(CreateUDAInfoValues(&group->udas, exec_state));
+      PL_RETURN_IF_ERROR(group->window->Push(open_bucket_start_, std::move(bucket_udas)));
+      group->has_rows = false;
+    }
+    PL_RETURN_IF_ERROR(group->window->EvictBefore(min_bucket_start));
+    if (group->window->empty()) {
+      continue;
+    }
+
+    std::vector<UDAInfo> merged;
+    PL_RETURN_IF_ERROR(group->window->Merged(&merged));
+
+    for (size_t i = 0; i < group_data_types_.size(); ++i) {
+#define TYPE_CASE(_dt_) AppendToBuilder<_dt_>(group_builders_[i].get(), group->rt.get(), i);
+      PL_SWITCH_FOREACH_DATATYPE(group_data_types_[i], TYPE_CASE);
+#undef TYPE_CASE
+    }
+    using TimeBuilder = types::DataTypeTraits<types::TIME64NS>::arrow_builder_type;
+    PL_RETURN_IF_ERROR(static_cast<TimeBuilder*>(time_builder_.get())->Append(open_bucket_start_));
+    for (size_t i = 0; i < merged.size(); ++i) {
+      PL_RETURN_IF_ERROR(merged[i].def->FinalizeArrow(merged[i].uda.get(), function_ctx_.get(),
+                                                      value_builders_[i].get()));
+    }
+    ++pending_rows_;
+  }
+  PruneDrainedGroups();
+  return Status::OK();
+}
+
+void RollingAggNode::PruneDrainedGroups() {
+  // Closing a bucket clears every group's open bucket, so a drained group holds no state.
+  for (const auto& group : groups_) {
+    if (group->window->empty()) {
+      group_map_.erase(group->rt.get());
+    }
+  }
+  groups_.erase(std::remove_if(groups_.begin(), groups_.end(),
+                               [](const std::unique_ptr<GroupState>& group) {
+                                 return group->window->empty();
+                               }),
+                groups_.end());
+}
+
+Status RollingAggNode::ResetBuilders(ExecState* exec_state) {
+  group_builders_.clear();
+  for (const auto& dt : group_data_types_) {
+    group_builders_.push_back(types::MakeArrowBuilder(dt, exec_state->exec_mem_pool()));
+  }
+  time_builder_ = types::MakeArrowBuilder(types::TIME64NS, exec_state->exec_mem_pool());
+  value_builders_.clear();
+  for (const auto& dt : value_data_types_) {
+    value_builders_.push_back(types::MakeArrowBuilder(dt, exec_state->exec_mem_pool()));
+  }
+  pending_rows_ = 0;
+  return Status::OK();
+}
+
+Status RollingAggNode::EmitRowBatch(ExecState* exec_state, bool eos) {
+  RowBatch output_rb(*output_descriptor_, pending_rows_);
+  std::shared_ptr<arrow::Array> arr;
+  for (const auto& builder : group_builders_) {
+    PL_RETURN_IF_ERROR(builder->Finish(&arr));
+    PL_RETURN_IF_ERROR(output_rb.AddColumn(arr));
+  }
+  PL_RETURN_IF_ERROR(time_builder_->Finish(&arr));
+  PL_RETURN_IF_ERROR(output_rb.AddColumn(arr));
+  for (const auto& builder : value_builders_) {
+    PL_RETURN_IF_ERROR(builder->Finish(&arr));
+    PL_RETURN_IF_ERROR(output_rb.AddColumn(arr));
+  }
+  output_rb.set_eow(eos);
+  output_rb.set_eos(eos);
+  PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, output_rb));
+  return ResetBuilders(exec_state);
+}
+
+Status RollingAggNode::CreateColumnMapping() {
+  for (const auto& expr : plan_node_->values()) {
+    plan::ExpressionWalker<int> walker;
+    walker.OnScalarValue(
+        [&](const plan::ScalarValue&, const std::vector<int>&) -> int { return 0; });
+    walker.OnColumn([&](const plan::Column& col, const std::vector<int>&) -> int {
+      auto plan_col_idx = col.Index();
+      if (plan_cols_to_stored_map_.find(plan_col_idx) == plan_cols_to_stored_map_.end()) {
+        plan_cols_to_stored_map_[plan_col_idx] = stored_cols_to_plan_idx_.size();
+        stored_cols_to_plan_idx_.emplace_back(plan_col_idx);
+        stored_cols_data_types_.emplace_back(input_descriptor_->type(plan_col_idx));
+      }
+      return 0;
+    });
+    walker.OnAggregateExpression(
+        [&](const plan::AggregateExpression&, const std::vector<int>&) -> int { return 0; });
+    PL_RETURN_IF_ERROR(walker.Walk(*expr));
+  }
+  return Status::OK();
+}
+
+Status RollingAggNode::CreateUDAInfoValues(std::vector<UDAInfo>* val, ExecState* exec_state) {
+  CHECK(val != nullptr);
+  CHECK_EQ(val->size(), 0ULL);
+  for (const auto& value : plan_node_->values()) {
+    auto def = exec_state->GetUDADefinition(value->uda_id());
+    auto uda = def->Make();
+    std::vector<std::shared_ptr<types::BaseValueType>> init_args;
+    for (const auto& arg : value->init_arguments()) {
+      init_args.push_back(arg.ToBaseValueType());
+    }
+    PL_RETURN_IF_ERROR(def->ExecInit(uda.get(), nullptr, init_args));
+    val->emplace_back(std::move(uda), def);
+  }
+  return Status::OK();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
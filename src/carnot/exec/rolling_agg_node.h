@@ -0,0 +1,169 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/builder.h>
+
+#include "src/carnot/exec/agg_node.h"
+#include "src/carnot/exec/exec_node.h"
+#include "src/carnot/exec/exec_state.h"
+#include "src/carnot/exec/row_tuple.h"
+#include "src/carnot/plan/operators.h"
+#include "src/carnot/udf/udf_definition.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/column_wrapper.h"
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * SlidingWindowUDAs holds the aggregate of a sliding window of time buckets. UDAs can merge but
+ * can't subtract, so the window is kept as two stacks: new buckets go on the back stack, which
+ * keeps a running merge of its contents, and when the oldest bucket must be evicted from an empty
+ * front stack the back stack is flipped onto it with suffix merges. Every bucket is merged a
+ * constant number of times, whatever the window length.
+ */
+class SlidingWindowUDAs {
+ public:
+  // Creates a fresh, initialized set of UDAs (one per aggregate expression) in an empty vector.
+  using UDAFactory = std::function<Status(std::vector<UDAInfo>*)>;
+
+  explicit SlidingWindowUDAs(UDAFactory make_udas) : make_udas_(std::move(make_udas)) {}
+
+  // Adds the UDAs of a closed bucket. Buckets must be pushed in increasing order of start time.
+  Status Push(int64_t bucket_start, std::vector<UDAInfo> bucket_udas);
+
+  // Drops every bucket that starts before min_bucket_start.
+  Status EvictBefore(int64_t min_bucket_start);
+
+  // Writes the merge of every bucket in the window into out, which must be empty.
+  Status Merged(std::vector<UDAInfo>* out);
+
+  size_t size() const { return front_.size() + back_.size(); }
+  bool empty() const { return size() == 0; }
+
+ private:
+  struct Bucket {
+    int64_t start;
+    std::vector<UDAInfo> udas;
+  };
+
+  Status MergeInto(std::vector<UDAInfo>* dst, const std::vector<UDAInfo>& src);
+  Status Flip();
+
+  UDAFactory make_udas_;
+  // Oldest bucket last. Each entry holds the merge of its own bucket and all newer front buckets.
+  std::vector<Bucket> front_;
+  // Buckets in arrival order, and the merge of all of them.
+  std::vector<Bucket> back_;
+  std::vector<UDAInfo> back_merged_;
+};
+
+/**
+ * RollingAggNode evaluates a RollingAggregateOperator. Input rows are expected in time order and
+ * are assigned to step sized buckets; rows that arrive for an already closed bucket are folded into
+ * the open one. When a bucket closes, each group whose trailing window still holds rows emits one
+ * row with the aggregate of that window, so a group keeps reporting for a window after its last
+ * row. Groups whose window has drained are dropped.
+ */
+class RollingAggNode : public ProcessingNode {
+ public:
+  RollingAggNode() = default;
+  virtual ~RollingAggNode() = default;
+
+ protected:
+  std::string DebugStringImpl() override;
+  Status InitImpl(const plan::Operator& plan_node) override;
+  Status PrepareImpl(ExecState* exec_state) override;
+  Status OpenImpl(ExecState* exec_state) override;
+  Status CloseImpl(ExecState* exec_state) override;
+  Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
+                         size_t parent_index) override;
+
+ private:
+  struct GroupState {
+    std::unique_ptr<RowTuple> rt;
+    // UDAs of the open bucket.
+    std::vector<UDAInfo> udas;
+    // Argument values buffered for the open bucket, by stored column.
+    std::vector<types::SharedColumnWrapper> agg_cols;
+    bool has_rows = false;
+    std::unique_ptr<SlidingWindowUDAs> window;
+  };
+
+  int64_t BucketStart(int64_t time) const {
+    int64_t step = plan_node_->step_ns();
+    return time - ((time % step) + step) % step;
+  }
+
+  Status CreateColumnMapping();
+  Status CreateUDAInfoValues(std::vector<UDAInfo>* val, ExecState* exec_state);
+  StatusOr<GroupState*> FindOrCreateGroup(ExecState* exec_state,
+                                          const table_store::schema::RowBatch& rb, int64_t row);
+  Status UpdateGroupUDAs(ExecState* exec_state, GroupState* group);
+  // Closes buckets until bucket_start is the open one. Empty buckets in between still slide the
+  // windows of the groups that have one.
+  Status AdvanceTo(ExecState* exec_state, int64_t bucket_start);
+  // Closes the open bucket and appends one output row per group with a non-empty window.
+  Status CloseBucket(ExecState* exec_state);
+  // Drops the groups whose window no longer holds any bucket.
+  void PruneDrainedGroups();
+  Status ResetBuilders(ExecState* exec_state);
+  Status EmitRowBatch(ExecState* exec_state, bool eos);
+
+  std::unique_ptr<plan::RollingAggregateOperator> plan_node_;
+  std::unique_ptr<table_store::schema::RowDescriptor> input_descriptor_;
+  std::unique_ptr<udf::FunctionContext> function_ctx_;
+
+  // Same column mapping as AggNode: the input columns referenced by the aggregate expressions are
+  // buffered per group as stored columns.
+  std::map<int64_t, int64_t> plan_cols_to_stored_map_;
+  std::vector<int64_t> stored_cols_to_plan_idx_;
+  std::vector<types::DataType> stored_cols_data_types_;
+
+  std::vector<types::DataType> group_data_types_;
+  std::vector<types::DataType> value_data_types_;
+
+  AbslRowTupleHashMap<GroupState*> group_map_;
+  // Groups in the order they were first seen, so output order is deterministic.
+  std::vector<std::unique_ptr<GroupState>> groups_;
+  std::unique_ptr<RowTuple> lookup_rt_;
+
+  bool has_open_bucket_ = false;
+  int64_t open_bucket_start_ = 0;
+
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> group_builders_;
+  std::unique_ptr<arrow::ArrayBuilder> time_builder_;
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> value_builders_;
+  int64_t pending_rows_ = 0;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
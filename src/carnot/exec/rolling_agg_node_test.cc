@@ -0,0 +1,250 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/rolling_agg_node.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <google/protobuf/text_format.h>
+#include <gtest/gtest.h>
+#include <sole.hpp>
+
+#include "src/carnot/exec/test_utils.h"
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/carnot/udf/registry.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowDescriptor;
+using types::Int64Value;
+using types::Time64NSValue;
+
+class SumUDA : public udf::UDA {
+ public:
+  void Update(udf::FunctionContext*, types::Int64Value arg) { sum_ = sum_.val + arg.val; }
+  void Merge(udf::FunctionContext*, const SumUDA& other) { sum_ = sum_.val + other.sum_.val; }
+  types::Int64Value Finalize(udf::FunctionContext*) { return sum_; }
+
+ protected:
+  types::Int64Value sum_ = 0;
+};
+
+// Max has no inverse, so it can only slide by re-merging buckets.
+class MaxUDA : public udf::UDA {
+ public:
+  void Update(udf::FunctionContext*, types::Int64Value arg) {
+    max_ = std::max(max_.val, arg.val);
+  }
+  void Merge(udf::FunctionContext*, const MaxUDA& other) {
+    max_ = std::max(max_.val, other.max_.val);
+  }
+  types::Int64Value Finalize(udf::FunctionContext*) { return max_; }
+
+ protected:
+  types::Int64Value max_ = std::numeric_limits<int64_t>::min();
+};
+
+constexpr char kRollingSingleGroupAgg[] = R"(
+groups {
+  node: 0
+  index: 1
+}
+group_names: "g1"
+values {
+  name: "sum"
+  id: 0
+  args {
+    column {
+      node: 0
+      index: 2
+    }
+  }
+}
+values {
+  name: "max"
+  id: 1
+  args {
+    column {
+      node: 0
+      index: 2
+    }
+  }
+}
+value_names: "sum"
+value_names: "max"
+)";
+
+constexpr char kRollingNoGroupAgg[] = R"(
+values {
+  name: "max"
+  id: 1
+  args {
+    column {
+      node: 0
+      index: 1
+    }
+  }
+}
+value_names: "max"
+)";
+
+std::unique_ptr<plan::RollingAggregateOperator> RollingPlanNode(const std::string& pbtxt,
+                                                                int64_t time_col_idx,
+                                                                int64_t window_ns,
+                                                                int64_t step_ns) {
+  planpb::AggregateOperator agg_pb;
+  EXPECT_TRUE(google::protobuf::TextFormat::MergeFromString(pbtxt, &agg_pb));
+  auto op = std::make_unique<plan::RollingAggregateOperator>(1);
+  EXPECT_OK(op->Init(agg_pb, time_col_idx, window_ns, step_ns));
+  return op;
+}
+
+class RollingAggNodeTest : public ::testing::Test {
+ public:
+  RollingAggNodeTest() {
+    func_registry_ = std::make_unique<udf::Registry>("test");
+    EXPECT_OK(func_registry_->Register<SumUDA>("sum"));
+    EXPECT_OK(func_registry_->Register<MaxUDA>("max"));
+
+    auto table_store = std::make_shared<table_store::TableStore>();
+    exec_state_ = std::make_unique<ExecState>(
+        func_registry_.get(), table_store, MockResultSinkStubGenerator, MockMetricsStubGenerator,
+        MockTraceStubGenerator, sole::uuid4(), nullptr);
+    EXPECT_OK(exec_state_->AddUDA(0, "sum", {types::INT64}));
+    EXPECT_OK(exec_state_->AddUDA(1, "max", {types::INT64}));
+  }
+
+ protected:
+  std::unique_ptr<ExecState> exec_state_;
+  std::unique_ptr<udf::Registry> func_registry_;
+};
+
+TEST_F(RollingAggNodeTest, single_group) {
+  auto plan_node = RollingPlanNode(kRollingSingleGroupAgg, /*time_col_idx*/ 0, /*window_ns*/ 20,
+                                   /*step_ns*/ 10);
+  RowDescriptor input_rd({types::TIME64NS, types::INT64, types::INT64});
+  RowDescriptor output_rd({types::INT64, types::TIME64NS, types::INT64, types::INT64});
+
+  auto tester = exec::ExecNodeTester<RollingAggNode, plan::RollingAggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  // Buckets: [0, 10) has g1=1 and g2=2, [10, 20) has g1=3, [20, 30) has g1=4 and g2=5.
+  // The row at t=8 arrives late and is folded into the open [10, 20) bucket. g2 has no rows in
+  // [10, 20) but its window still holds [0, 10), so it reports at 10 too.
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<Time64NSValue>({1, 5, 12, 8})
+                       .AddColumn<Int64Value>({1, 2, 1, 1})
+                       .AddColumn<Int64Value>({1, 2, 3, 6})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, false, false)
+                          .AddColumn<Int64Value>({1, 2})
+                          .AddColumn<Time64NSValue>({0, 0})
+                          .AddColumn<Int64Value>({1, 2})
+                          .AddColumn<Int64Value>({1, 2})
+                          .get())
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, true, true)
+                       .AddColumn<Time64NSValue>({25, 27})
+                       .AddColumn<Int64Value>({1, 2})
+                       .AddColumn<Int64Value>({4, 5})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 4, true, true)
+                          .AddColumn<Int64Value>({1, 2, 1, 2})
+                          .AddColumn<Time64NSValue>({10, 10, 20, 20})
+                          .AddColumn<Int64Value>({10, 2, 13, 5})
+                          .AddColumn<Int64Value>({6, 2, 6, 5})
+                          .get())
+      .Close();
+}
+
+TEST_F(RollingAggNodeTest, no_groups_evicts_expired_buckets) {
+  auto plan_node = RollingPlanNode(kRollingNoGroupAgg, /*time_col_idx*/ 0, /*window_ns*/ 30,
+                                   /*step_ns*/ 10);
+  RowDescriptor input_rd({types::TIME64NS, types::INT64});
+  RowDescriptor output_rd({types::TIME64NS, types::INT64});
+
+  auto tester = exec::ExecNodeTester<RollingAggNode, plan::RollingAggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  // The max of 9 has to leave the window once its bucket is three steps old.
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 6, true, true)
+                       .AddColumn<Time64NSValue>({1, 11, 21, 31, 41, 45})
+                       .AddColumn<Int64Value>({9, 1, 2, 3, 1, 1})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 5, true, true)
+                          .AddColumn<Time64NSValue>({0, 10, 20, 30, 40})
+                          .AddColumn<Int64Value>({9, 9, 9, 3, 3})
+                          .get())
+      .Close();
+}
+
+TEST_F(RollingAggNodeTest, idle_groups_drain) {
+  auto plan_node = RollingPlanNode(kRollingSingleGroupAgg, /*time_col_idx*/ 0, /*window_ns*/ 20,
+                                   /*step_ns*/ 10);
+  RowDescriptor input_rd({types::TIME64NS, types::INT64, types::INT64});
+  RowDescriptor output_rd({types::INT64, types::TIME64NS, types::INT64, types::INT64});
+
+  auto tester = exec::ExecNodeTester<RollingAggNode, plan::RollingAggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  // Both groups report through the empty [10, 20) bucket, then drain. g1 comes back at 50 with
+  // none of its old state.
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 3, true, true)
+                       .AddColumn<Time64NSValue>({1, 2, 51})
+                       .AddColumn<Int64Value>({1, 2, 1})
+                       .AddColumn<Int64Value>({5, 7, 1})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 5, true, true)
+                          .AddColumn<Int64Value>({1, 2, 1, 2, 1})
+                          .AddColumn<Time64NSValue>({0, 0, 10, 10, 50})
+                          .AddColumn<Int64Value>({5, 7, 5, 7, 1})
+                          .AddColumn<Int64Value>({5, 7, 5, 7, 1})
+                          .get())
+      .Close();
+}
+
+TEST_F(RollingAggNodeTest, requires_rolling_operator) {
+  planpb::AggregateOperator agg_pb;
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(kRollingNoGroupAgg, &agg_pb));
+  plan::AggregateOperator plan_node(1);
+  ASSERT_OK(plan_node.Init(agg_pb));
+
+  RollingAggNode node;
+  EXPECT_NOT_OK(node.Init(plan_node, RowDescriptor({types::TIME64NS, types::INT64}),
+                          {RowDescriptor({types::TIME64NS, types::INT64})}));
+}
+
+TEST(RollingAggregateOperatorTest, window_must_cover_a_step) {
+  plan::RollingAggregateOperator op(1);
+  EXPECT_NOT_OK(op.Init(planpb::AggregateOperator(), 0, /*window_ns*/ 5, /*step_ns*/ 10));
+  EXPECT_NOT_OK(op.Init(planpb::AggregateOperator(), 0, /*window_ns*/ 5, /*step_ns*/ 0));
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
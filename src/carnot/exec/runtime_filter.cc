@@ -0,0 +1,120 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/runtime_filter.h"
+
+#include <arrow/memory_pool.h>
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+
+namespace {
+
+std::string_view HashBytes(const size_t& hash) {
+  return std::string_view(reinterpret_cast<const char*>(&hash), sizeof(hash));
+}
+
+template <types::DataType T>
+Status CopySelectedValues(const arrow::Array* input, const std::vector<uint8_t>& selected,
+                          int64_t num_selected, RowBatch* output_rb) {
+  auto builder = types::MakeArrowBuilder(T, arrow::default_memory_pool());
+  auto* typed_builder =
+      static_cast<typename types::DataTypeTraits<T>::arrow_builder_type*>(builder.get());
+  PL_RETURN_IF_ERROR(typed_builder->Reserve(num_selected));
+  for (int64_t idx = 0; idx < input->length(); ++idx) {
+    if (selected[idx]) {
+      PL_RETURN_IF_ERROR(typed_builder->Append(types::GetValueFromArrowArray<T>(input, idx)));
+    }
+  }
+  std::shared_ptr<arrow::Array> output_array;
+  PL_RETURN_IF_ERROR(typed_builder->Finish(&output_array));
+  return output_rb->AddColumn(output_array);
+}
+
+}  // namespace
+
+StatusOr<std::unique_ptr<RuntimeJoinFilter>> RuntimeJoinFilter::Create(
+    const std::vector<types::DataType>& key_types, int64_t num_keys) {
+  PL_ASSIGN_OR_RETURN(auto bloom_filter, bloomfilter::BlockedBloomFilter::Create(
+                                             std::max<int64_t>(num_keys, 1), kErrorRate));
+  return std::unique_ptr<RuntimeJoinFilter>(
+      new RuntimeJoinFilter(key_types, std::move(bloom_filter)));
+}
+
+void RuntimeJoinFilter::Insert(const RowTuple& key) {
+  size_t hash = key.Hash();
+  bloom_filter_->Insert(HashBytes(hash));
+}
+
+bool RuntimeJoinFilter::MayContain(const RowTuple& key) const {
+  size_t hash = key.Hash();
+  return bloom_filter_->Contains(HashBytes(hash));
+}
+
+StatusOr<std::unique_ptr<RowBatch>> RuntimeJoinFilter::Apply(const RowBatch& rb,
+                                                             const std::vector<int64_t>& key_cols,
+                                                             int64_t* rows_dropped) const {
+  DCHECK_EQ(key_cols.size(), key_types_.size());
+  // Hash the keys of all of the rows, and then probe the bloom filter for them in bulk.
+  RowTuple key(&key_types_);
+  std::vector<size_t> hashes(rb.num_rows());
+  std::vector<std::string_view> hash_bytes(rb.num_rows());
+  for (int64_t row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
+    key.Reset();
+    for (size_t i = 0; i < key_cols.size(); ++i) {
+      auto* col = rb.ColumnAt(key_cols[i]).get();
+#define TYPE_CASE(_dt_) ExtractIntoRowTuple<_dt_>(&key, col, i, row_idx);
+      PL_SWITCH_FOREACH_DATATYPE(key_types_[i], TYPE_CASE);
+#undef TYPE_CASE
+    }
+    hashes[row_idx] = key.Hash();
+    hash_bytes[row_idx] = HashBytes(hashes[row_idx]);
+  }
+  std::vector<uint8_t> selected;
+  int64_t num_selected = bloom_filter_->ContainsMany(hash_bytes, &selected);
+
+  *rows_dropped += rb.num_rows() - num_selected;
+  if (num_selected == rb.num_rows()) {
+    return std::make_unique<RowBatch>(rb);
+  }
+
+  auto output_rb = std::make_unique<RowBatch>(rb.desc(), num_selected);
+  for (int64_t col_idx = 0; col_idx < rb.num_columns(); ++col_idx) {
+    auto* input = rb.ColumnAt(col_idx).get();
+#define TYPE_CASE(_dt_) \
+  PL_RETURN_IF_ERROR(CopySelectedValues<_dt_>(input, selected, num_selected, output_rb.get()));
+    PL_SWITCH_FOREACH_DATATYPE(rb.desc().type(col_idx), TYPE_CASE);
+#undef TYPE_CASE
+  }
+  output_rb->set_eow(rb.eow());
+  output_rb->set_eos(rb.eos());
+  return output_rb;
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "src/carnot/exec/row_tuple.h"
+#include "src/common/base/base.h"
+#include "src/shared/bloomfilter/bloomfilter.h"
+#include "src/shared/types/types.h"
+#include "src/table_store/schema/row_batch.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * RuntimeJoinFilter is a bloom filter over the distinct keys of the build side of a join. It is
+ * built once the build side of the join is complete, and lets the scan on the probe side of the
+ * join drop rows that can't have a match before they are sent through the rest of the plan.
+ *
+ * Keys are hashed with RowTuple::Hash, so that the filter built from the join's hash table and
+ * the lookups done from the probe side row batches agree on the representation of the keys.
+ *
+ * The filter only lives within the ExecState of a single query fragment, so it is only applied
+ * when the join and the memory source on its probe side run in the same fragment. Joins fed by
+ * GRPC sources, such as the Kelvin joins of distributed plans, are not filtered, since the filter
+ * is never shipped to the PEM fragments that scan the probe side. This is why it can use the
+ * cache-friendlier BlockedBloomFilter, which has no proto representation.
+ */
+class RuntimeJoinFilter {
+ public:
+  /**
+   * Creates an empty filter, sized for the given number of distinct keys.
+   */
+  static StatusOr<std::unique_ptr<RuntimeJoinFilter>> Create(
+      const std::vector<types::DataType>& key_types, int64_t num_keys);
+
+  void Insert(const RowTuple& key);
+  bool MayContain(const RowTuple& key) const;
+
+  /**
+   * Returns the rows of the row batch whose keys may be in the filter.
+   * @param rb The row batch to filter.
+   * @param key_cols The indices of the key columns in the row batch, in join key order.
+   * @param rows_dropped Incremented by the number of rows that were filtered out.
+   */
+  StatusOr<std::unique_ptr<table_store::schema::RowBatch>> Apply(
+      const table_store::schema::RowBatch& rb, const std::vector<int64_t>& key_cols,
+      int64_t* rows_dropped) const;
+
+  const std::vector<types::DataType>& key_types() const { return key_types_; }
+
+ private:
+  RuntimeJoinFilter(const std::vector<types::DataType>& key_types,
+                    std::unique_ptr<bloomfilter::BlockedBloomFilter> bloom_filter)
+      : key_types_(key_types), bloom_filter_(std::move(bloom_filter)) {}
+
+  // The false positive rate the filter is sized for.
+  static constexpr double kErrorRate = 0.01;
+
+  const std::vector<types::DataType> key_types_;
+  std::unique_ptr<bloomfilter::BlockedBloomFilter> bloom_filter_;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/runtime_filter.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/exec/test_utils.h"
+#include "src/common/testing/testing.h"
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowDescriptor;
+
+class RuntimeJoinFilterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(filter_, RuntimeJoinFilter::Create(key_types_, 3));
+    for (const auto& [id, name] :
+         std::vector<std::pair<int64_t, std::string>>{{1, "a"}, {2, "b"}, {3, "c"}}) {
+      RowTuple key(&key_types_);
+      key.SetValue(0, types::Int64Value(id));
+      key.SetValue(1, types::StringValue(name));
+      filter_->Insert(key);
+    }
+  }
+
+  std::vector<types::DataType> key_types_{types::DataType::INT64, types::DataType::STRING};
+  std::unique_ptr<RuntimeJoinFilter> filter_;
+};
+
+TEST_F(RuntimeJoinFilterTest, may_contain) {
+  RowTuple key(&key_types_);
+  key.SetValue(0, types::Int64Value(2));
+  key.SetValue(1, types::StringValue("b"));
+  EXPECT_TRUE(filter_->MayContain(key));
+}
+
+TEST_F(RuntimeJoinFilterTest, apply) {
+  // The key columns are in a different order than in the filter.
+  RowDescriptor rd({types::DataType::STRING, types::DataType::FLOAT64, types::DataType::INT64});
+  auto rb = RowBatchBuilder(rd, 5, /*eow*/ true, /*eos*/ true)
+                .AddColumn<types::StringValue>({"a", "b", "b", "c", "z"})
+                .AddColumn<types::Float64Value>({0.1, 0.2, 0.3, 0.4, 0.5})
+                .AddColumn<types::Int64Value>({1, 2, 3, 3, 42})
+                .get();
+
+  int64_t rows_dropped = 0;
+  ASSERT_OK_AND_ASSIGN(auto output_rb, filter_->Apply(rb, {2, 0}, &rows_dropped));
+  EXPECT_EQ(rb.num_rows(), output_rb->num_rows() + rows_dropped);
+  EXPECT_TRUE(output_rb->eow());
+  EXPECT_TRUE(output_rb->eos());
+
+  // The filter has no false negatives: all rows with a matching key are kept, in order.
+  ASSERT_GE(output_rb->num_rows(), 3);
+  std::vector<double> kept;
+  auto* vals = static_cast<arrow::DoubleArray*>(output_rb->ColumnAt(1).get());
+  for (int64_t i = 0; i < vals->length(); ++i) {
+    kept.push_back(vals->Value(i));
+  }
+  EXPECT_EQ(0.1, kept.front());
+  EXPECT_NE(kept.end(), std::find(kept.begin(), kept.end(), 0.2));
+  EXPECT_NE(kept.end(), std::find(kept.begin(), kept.end(), 0.4));
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -18,14 +18,19 @@
 
 #pragma once
 
+#include <algorithm>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include <absl/strings/str_cat.h>
 #include <rapidjson/document.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include "src/carnot/funcs/builtins/string_kernels.h"
 #include "src/carnot/udf/registry.h"
 #include "src/carnot/udf/udf.h"
 
@@ -33,11 +38,55 @@ namespace px {
 namespace carnot {
 namespace builtins {
 
+namespace internal {
+
+/**
+ * Rules out JSON strings that cannot have a member with a given (constant) key, so that they
+ * don't need to be parsed. A member name without escape sequences appears verbatim in quotes,
+ * so a string that has neither a backslash nor the quoted key can't contain the key.
+ */
+class JSONKeyFilter {
+ public:
+  explicit JSONKeyFilter(std::string_view key)
+      : quoted_key_(absl::StrCat("\"", key, "\"")),
+        matcher_(quoted_key_),
+        // Keys with characters that must be escaped never appear verbatim.
+        enabled_(std::none_of(key.begin(), key.end(), [](char c) {
+          return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+        })) {}
+
+  // The matcher points into quoted_key_.
+  JSONKeyFilter(const JSONKeyFilter&) = delete;
+  JSONKeyFilter& operator=(const JSONKeyFilter&) = delete;
+
+  bool DefinitelyMissing(std::string_view json) const {
+    return enabled_ && json.find('\\') == std::string_view::npos &&
+           matcher_.Find(json) == std::string_view::npos;
+  }
+
+ private:
+  const std::string quoted_key_;
+  const SubstringMatcher matcher_;
+  const bool enabled_;
+};
+
+}  // namespace internal
+
 // TODO(zasgar): PL-419 To have proper support for JSON we need structs and nullable types.
 // Revisit when we have them.
 class PluckUDF : public udf::ScalarUDF {
  public:
+  Status InitConst(FunctionContext*, const StringValue*, const StringValue* key) {
+    if (key != nullptr) {
+      key_filter_.emplace(*key);
+    }
+    return Status::OK();
+  }
+
   StringValue Exec(FunctionContext*, StringValue in, StringValue key) {
+    if (key_filter_.has_value() && key_filter_->DefinitelyMissing(in)) {
+      return "";
+    }
     rapidjson::Document d;
     rapidjson::ParseResult ok = d.Parse(in.data());
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
@@ -82,11 +131,24 @@ class PluckUDF : public udf::ScalarUDF {
         .Arg("key", "The key to get the value for.")
         .Returns("The value for the key as a string.");
   }
+
+ private:
+  std::optional<internal::JSONKeyFilter> key_filter_;
 };
 
 class PluckAsInt64UDF : public udf::ScalarUDF {
  public:
+  Status InitConst(FunctionContext*, const StringValue*, const StringValue* key) {
+    if (key != nullptr) {
+      key_filter_.emplace(*key);
+    }
+    return Status::OK();
+  }
+
   Int64Value Exec(FunctionContext*, StringValue in, StringValue key) {
+    if (key_filter_.has_value() && key_filter_->DefinitelyMissing(in)) {
+      return 0;
+    }
     rapidjson::Document d;
     rapidjson::ParseResult ok = d.Parse(in.data());
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
@@ -126,11 +188,24 @@ class PluckAsInt64UDF : public udf::ScalarUDF {
         .Arg("key", "The key to get the value for.")
         .Returns("The value for the key as an int.");
   }
+
+ private:
+  std::optional<internal::JSONKeyFilter> key_filter_;
 };
 
 class PluckAsFloat64UDF : public udf::ScalarUDF {
  public:
+  Status InitConst(FunctionContext*, const StringValue*, const StringValue* key) {
+    if (key != nullptr) {
+      key_filter_.emplace(*key);
+    }
+    return Status::OK();
+  }
+
   Float64Value Exec(FunctionContext*, StringValue in, StringValue key) {
+    if (key_filter_.has_value() && key_filter_->DefinitelyMissing(in)) {
+      return 0.0;
+    }
     rapidjson::Document d;
     rapidjson::ParseResult ok = d.Parse(in.data());
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
@@ -173,6 +248,9 @@ class PluckAsFloat64UDF : public udf::ScalarUDF {
         .Arg("key", "The key to get the value for.")
         .Returns("The value for the key as a float");
   }
+
+ private:
+  std::optional<internal::JSONKeyFilter> key_filter_;
 };
 
 class PluckArrayUDF : public udf::ScalarUDF {
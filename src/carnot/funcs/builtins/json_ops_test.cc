@@ -60,6 +60,25 @@ TEST(JSONOps, PluckUDF_non_object_input_return_empty) {
   udf_tester.ForInput("[\"asdad\"]", "str_key").Expect("");
 }
 
+TEST(JSONOps, PluckUDF_const_key) {
+  StringValue key = "str_plain";
+  auto udf_tester = udf::UDFTester<PluckUDF>();
+  udf_tester.InitConst(nullptr, &key);
+  udf_tester.ForInput(kTestJSONStr, key).Expect("abc");
+  udf_tester.ForInput(R"({"other": "abc"})", key).Expect("");
+  udf_tester.ForInput(R"({"other": "str_plain"})", key).Expect("");
+  // The key only matches after unescaping.
+  udf_tester.ForInput(R"({"str_pl\u0061in": "x"})", key).Expect("x");
+  udf_tester.ForInput("asdad", key).Expect("");
+}
+
+TEST(JSONOps, PluckUDF_const_key_needs_escaping) {
+  StringValue key = "a\"b";
+  auto udf_tester = udf::UDFTester<PluckUDF>();
+  udf_tester.InitConst(nullptr, &key);
+  udf_tester.ForInput(R"({"a\"b": "x"})", key).Expect("x");
+}
+
 TEST(JSONOps, PluckAsInt64UDF) {
   auto udf_tester = udf::UDFTester<PluckAsInt64UDF>();
   udf_tester.ForInput(kTestJSONStr, "str_key").Expect(0);
@@ -78,6 +97,14 @@ TEST(JSONOps, PluckAsIntUDF_non_object_input_return_empty) {
   udf_tester.ForInput("[\"asdad\"]", "int64_key").Expect(0);
 }
 
+TEST(JSONOps, PluckAsInt64UDF_const_key) {
+  StringValue key = "int64_key";
+  auto udf_tester = udf::UDFTester<PluckAsInt64UDF>();
+  udf_tester.InitConst(nullptr, &key);
+  udf_tester.ForInput(kTestJSONStr, key).Expect(34243242341);
+  udf_tester.ForInput(R"({"other": 1})", key).Expect(0);
+}
+
 TEST(JSONOps, PluckAsFloat64UDF) {
   auto udf_tester = udf::UDFTester<PluckAsFloat64UDF>();
   udf_tester.ForInput(kTestJSONStr, "str_key").Expect(0.0);
@@ -583,15 +583,24 @@ class Int64ToTimeUDF : public udf::ScalarUDF {
 template <typename TArg>
 class MeanUDA : public udf::UDA {
  public:
-  void Update(FunctionContext*, TArg arg) {
-    info_.size++;
-    info_.count += arg.val;
+  struct State {
+    uint64_t size = 0;
+    double count = 0;
+  };
+
+  static void UpdateState(State* state, TArg arg) {
+    state->size++;
+    state->count += arg.val;
   }
-  void Merge(FunctionContext*, const MeanUDA& other) {
-    info_.size += other.info_.size;
-    info_.count += other.info_.count;
+  static void MergeState(State* state, const State& other) {
+    state->size += other.size;
+    state->count += other.count;
   }
-  Float64Value Finalize(FunctionContext*) { return info_.count / info_.size; }
+  static Float64Value FinalizeState(const State& state) { return state.count / state.size; }
+
+  void Update(FunctionContext*, TArg arg) { UpdateState(&state_, arg); }
+  void Merge(FunctionContext*, const MeanUDA& other) { MergeState(&state_, other.state_); }
+  Float64Value Finalize(FunctionContext*) { return FinalizeState(state_); }
 
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::InheritTypeFromArgs<MeanUDA>::Create({types::ST_BYTES, types::ST_THROUGHPUT_PER_NS,
@@ -600,11 +609,11 @@ class MeanUDA : public udf::UDA {
   }
 
   StringValue Serialize(FunctionContext*) {
-    return StringValue(reinterpret_cast<char*>(&info_), sizeof(info_));
+    return StringValue(reinterpret_cast<char*>(&state_), sizeof(state_));
   }
 
   Status Deserialize(FunctionContext*, const StringValue& data) {
-    info_ = *reinterpret_cast<const MeanInfo*>(data.data());
+    state_ = *reinterpret_cast<const State*>(data.data());
     return Status::OK();
   }
   static udf::UDADocBuilder Doc() {
@@ -618,31 +627,33 @@ class MeanUDA : public udf::UDA {
   }
 
  protected:
-  struct MeanInfo {
-    uint64_t size = 0;
-    double count = 0;
-  };
-
-  MeanInfo info_;
+  State state_;
 };
 
 template <typename TArg, typename TAggType = TArg>
 class SumUDA : public udf::UDA {
  public:
-  void Update(FunctionContext*, TArg arg) { sum_ = sum_.val + arg.val; }
-  void Merge(FunctionContext*, const SumUDA& other) { sum_ = sum_.val + other.sum_.val; }
-  TAggType Finalize(FunctionContext*) { return sum_; }
+  struct State {
+    typename types::ValueTypeTraits<TAggType>::native_type sum = 0;
+  };
+
+  static void UpdateState(State* state, TArg arg) { state->sum += arg.val; }
+  static void MergeState(State* state, const State& other) { state->sum += other.sum; }
+  static TAggType FinalizeState(const State& state) { return state.sum; }
+
+  void Update(FunctionContext*, TArg arg) { UpdateState(&state_, arg); }
+  void Merge(FunctionContext*, const SumUDA& other) { MergeState(&state_, other.state_); }
+  TAggType Finalize(FunctionContext*) { return FinalizeState(state_); }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::InheritTypeFromArgs<SumUDA>::Create(
         {types::ST_BYTES, types::ST_THROUGHPUT_PER_NS, types::ST_THROUGHPUT_BYTES_PER_NS})};
   }
   StringValue Serialize(FunctionContext*) {
-    return StringValue(reinterpret_cast<char*>(&sum_), sizeof(sum_));
+    return StringValue(reinterpret_cast<char*>(&state_), sizeof(state_));
   }
 
   Status Deserialize(FunctionContext*, const StringValue& data) {
-    sum_ = *reinterpret_cast<const typename types::ValueTypeTraits<TAggType>::native_type*>(
-        data.data());
+    state_ = *reinterpret_cast<const State*>(data.data());
     return Status::OK();
   }
 
@@ -654,23 +665,32 @@ class SumUDA : public udf::UDA {
   }
 
  protected:
-  TAggType sum_ = 0;
+  State state_;
 };
 
 template <typename TArg>
 class MaxUDA : public udf::UDA {
  public:
-  void Update(FunctionContext*, TArg arg) {
-    if (max_.val < arg.val) {
-      max_ = arg;
+  struct State {
+    typename types::ValueTypeTraits<TArg>::native_type max =
+        std::numeric_limits<typename types::ValueTypeTraits<TArg>::native_type>::min();
+  };
+
+  static void UpdateState(State* state, TArg arg) {
+    if (state->max < arg.val) {
+      state->max = arg.val;
     }
   }
-  void Merge(FunctionContext*, const MaxUDA& other) {
-    if (other.max_.val > max_.val) {
-      max_ = other.max_;
+  static void MergeState(State* state, const State& other) {
+    if (other.max > state->max) {
+      state->max = other.max;
     }
   }
-  TArg Finalize(FunctionContext*) { return max_; }
+  static TArg FinalizeState(const State& state) { return state.max; }
+
+  void Update(FunctionContext*, TArg arg) { UpdateState(&state_, arg); }
+  void Merge(FunctionContext*, const MaxUDA& other) { MergeState(&state_, other.state_); }
+  TArg Finalize(FunctionContext*) { return FinalizeState(state_); }
 
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::InheritTypeFromArgs<MaxUDA>::Create({types::ST_BYTES, types::ST_THROUGHPUT_PER_NS,
@@ -686,33 +706,41 @@ class MaxUDA : public udf::UDA {
   }
 
   StringValue Serialize(FunctionContext*) {
-    return StringValue(reinterpret_cast<char*>(&max_), sizeof(max_));
+    return StringValue(reinterpret_cast<char*>(&state_), sizeof(state_));
   }
 
   Status Deserialize(FunctionContext*, const StringValue& data) {
-    max_ =
-        *reinterpret_cast<const typename types::ValueTypeTraits<TArg>::native_type*>(data.data());
+    state_ = *reinterpret_cast<const State*>(data.data());
     return Status::OK();
   }
 
  protected:
-  TArg max_ = std::numeric_limits<typename types::ValueTypeTraits<TArg>::native_type>::min();
+  State state_;
 };
 
 template <typename TArg>
 class MinUDA : public udf::UDA {
  public:
-  void Update(FunctionContext*, TArg arg) {
-    if (min_.val > arg.val) {
-      min_ = arg;
+  struct State {
+    typename types::ValueTypeTraits<TArg>::native_type min =
+        std::numeric_limits<typename types::ValueTypeTraits<TArg>::native_type>::max();
+  };
+
+  static void UpdateState(State* state, TArg arg) {
+    if (state->min > arg.val) {
+      state->min = arg.val;
     }
   }
-  void Merge(FunctionContext*, const MinUDA& other) {
-    if (other.min_.val < min_.val) {
-      min_ = other.min_;
+  static void MergeState(State* state, const State& other) {
+    if (other.min < state->min) {
+      state->min = other.min;
     }
   }
-  TArg Finalize(FunctionContext*) { return min_; }
+  static TArg FinalizeState(const State& state) { return state.min; }
+
+  void Update(FunctionContext*, TArg arg) { UpdateState(&state_, arg); }
+  void Merge(FunctionContext*, const MinUDA& other) { MergeState(&state_, other.state_); }
+  TArg Finalize(FunctionContext*) { return FinalizeState(state_); }
 
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::InheritTypeFromArgs<MinUDA>::Create({types::ST_BYTES, types::ST_THROUGHPUT_PER_NS,
@@ -721,12 +749,11 @@ class MinUDA : public udf::UDA {
   }
 
   StringValue Serialize(FunctionContext*) {
-    return StringValue(reinterpret_cast<char*>(&min_), sizeof(min_));
+    return StringValue(reinterpret_cast<char*>(&state_), sizeof(state_));
   }
 
   Status Deserialize(FunctionContext*, const StringValue& data) {
-    min_ =
-        *reinterpret_cast<const typename types::ValueTypeTraits<TArg>::native_type*>(data.data());
+    state_ = *reinterpret_cast<const State*>(data.data());
     return Status::OK();
   }
   static udf::UDADocBuilder Doc() {
@@ -737,22 +764,30 @@ class MinUDA : public udf::UDA {
   }
 
  protected:
-  TArg min_ = std::numeric_limits<typename types::ValueTypeTraits<TArg>::native_type>::max();
+  State state_;
 };
 
 template <typename TArg>
 class CountUDA : public udf::UDA {
  public:
-  void Update(FunctionContext*, TArg) { count_++; }
-  void Merge(FunctionContext*, const CountUDA& other) { count_ += other.count_; }
-  Int64Value Finalize(FunctionContext*) { return count_; }
+  struct State {
+    uint64_t count = 0;
+  };
+
+  static void UpdateState(State* state, TArg) { state->count++; }
+  static void MergeState(State* state, const State& other) { state->count += other.count; }
+  static Int64Value FinalizeState(const State& state) { return state.count; }
+
+  void Update(FunctionContext*, TArg arg) { UpdateState(&state_, arg); }
+  void Merge(FunctionContext*, const CountUDA& other) { MergeState(&state_, other.state_); }
+  Int64Value Finalize(FunctionContext*) { return FinalizeState(state_); }
 
   StringValue Serialize(FunctionContext*) {
-    return StringValue(reinterpret_cast<char*>(&count_), sizeof(count_));
+    return StringValue(reinterpret_cast<char*>(&state_), sizeof(state_));
   }
 
   Status Deserialize(FunctionContext*, const StringValue& data) {
-    count_ = *reinterpret_cast<const uint64_t*>(data.data());
+    state_ = *reinterpret_cast<const State*>(data.data());
     return Status::OK();
   }
 
@@ -768,7 +803,7 @@ class CountUDA : public udf::UDA {
   }
 
  protected:
-  uint64_t count_ = 0;
+  State state_;
 };
 
 void RegisterMathOpsOrDie(udf::Registry* registry);
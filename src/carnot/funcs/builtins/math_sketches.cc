@@ -18,13 +18,126 @@
 
 #include "src/carnot/funcs/builtins/math_sketches.h"
 
+#include <cmath>
+#include <cstring>
+#include <string>
+
 namespace px {
 namespace carnot {
 namespace builtins {
 
+namespace internal {
+
+namespace {
+
+constexpr uint8_t kTDigestFormatVersion = 1;
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+StatusOr<uint64_t> ExtractVarint(std::string_view* data) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (data->empty()) {
+      return error::InvalidArgument("Truncated varint in tdigest.");
+    }
+    uint8_t byte = static_cast<uint8_t>(data->front());
+    data->remove_prefix(1);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return value;
+    }
+  }
+  return error::InvalidArgument("Varint in tdigest is too long.");
+}
+
+uint64_t DoubleBits(double val) {
+  uint64_t bits;
+  std::memcpy(&bits, &val, sizeof(bits));
+  return bits;
+}
+
+double BitsToDouble(uint64_t bits) {
+  double val;
+  std::memcpy(&val, &bits, sizeof(val));
+  return val;
+}
+
+uint64_t ZigZagEncode(int64_t val) {
+  return (static_cast<uint64_t>(val) << 1) ^ static_cast<uint64_t>(val >> 63);
+}
+
+int64_t ZigZagDecode(uint64_t val) {
+  return static_cast<int64_t>(val >> 1) ^ -static_cast<int64_t>(val & 1);
+}
+
+}  // namespace
+
+std::string SerializeTDigest(tdigest::TDigest* digest) {
+  // Fold the buffered points into the (sorted) centroids.
+  digest->compress();
+  const auto& centroids = digest->processed();
+
+  std::string out;
+  // Most centroids take 6-8 bytes for the mean and 1-2 bytes for the weight.
+  out.reserve(1 + 5 + centroids.size() * 10);
+  out.push_back(static_cast<char>(kTDigestFormatVersion));
+  AppendVarint(centroids.size(), &out);
+  uint64_t prev_bits = 0;
+  for (const auto& c : centroids) {
+    uint64_t bits = DoubleBits(c.mean());
+    AppendVarint(ZigZagEncode(static_cast<int64_t>(bits - prev_bits)), &out);
+    // Weights are counts of points, so they are integral.
+    AppendVarint(static_cast<uint64_t>(std::llround(c.weight())), &out);
+    prev_bits = bits;
+  }
+  return out;
+}
+
+Status DeserializeTDigest(std::string_view data, tdigest::TDigest* digest) {
+  if (data.empty() || static_cast<uint8_t>(data.front()) != kTDigestFormatVersion) {
+    return error::InvalidArgument("Unknown tdigest format.");
+  }
+  data.remove_prefix(1);
+
+  PL_ASSIGN_OR_RETURN(uint64_t count, ExtractVarint(&data));
+  // Every centroid takes at least two bytes, which bounds the count for corrupt input.
+  if (count > data.size() / 2) {
+    return error::InvalidArgument("tdigest claims $0 centroids, but has only $1 bytes left.", count,
+                                  data.size());
+  }
+
+  uint64_t prev_bits = 0;
+  for (uint64_t i = 0; i < count; ++i) {
+    PL_ASSIGN_OR_RETURN(uint64_t delta, ExtractVarint(&data));
+    PL_ASSIGN_OR_RETURN(uint64_t weight, ExtractVarint(&data));
+    uint64_t bits = prev_bits + static_cast<uint64_t>(ZigZagDecode(delta));
+    digest->add(BitsToDouble(bits), static_cast<double>(weight));
+    prev_bits = bits;
+  }
+  if (!data.empty()) {
+    return error::InvalidArgument("tdigest has $0 trailing bytes.", data.size());
+  }
+  return Status::OK();
+}
+
+}  // namespace internal
+
 void RegisterMathSketchesOrDie(udf::Registry* registry) {
   registry->RegisterOrDie<QuantilesUDA<types::Int64Value>>("quantiles");
   registry->RegisterOrDie<QuantilesUDA<types::Float64Value>>("quantiles");
+
+  registry->RegisterOrDie<PercentileUDA<types::Int64Value, 50>>("p50");
+  registry->RegisterOrDie<PercentileUDA<types::Float64Value, 50>>("p50");
+  registry->RegisterOrDie<PercentileUDA<types::Int64Value, 90>>("p90");
+  registry->RegisterOrDie<PercentileUDA<types::Float64Value, 90>>("p90");
+  registry->RegisterOrDie<PercentileUDA<types::Int64Value, 99>>("p99");
+  registry->RegisterOrDie<PercentileUDA<types::Float64Value, 99>>("p99");
 }
 
 }  // namespace builtins
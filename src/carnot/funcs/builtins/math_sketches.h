@@ -17,10 +17,14 @@
  */
 
 #pragma once
+#include <absl/strings/substitute.h>
 #include <rapidjson/document.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <string>
+#include <string_view>
+
 #include "src/carnot/udf/registry.h"
 #include "src/shared/types/types.h"
 #include "tdigest/tdigest.h"
@@ -29,14 +33,43 @@ namespace px {
 namespace carnot {
 namespace builtins {
 
+// Compression of the tdigests behind the quantile UDAs. Partial aggregates are only merged with
+// digests of the same compression.
+constexpr double kQuantilesCompression = 1000;
+
+namespace internal {
+
+// Encodes a tdigest compactly, so that quantile aggregates can be computed partially on the
+// agents and merged later.
+//
+// Encoding: a version byte, a varint centroid count, then for every centroid (in ascending order
+// of mean) the zigzag varint delta of the bit pattern of its mean from the previous one, followed
+// by its weight as a varint. Nearby means share their high bits, so the deltas are short, and
+// unlike rounding the means, the encoding itself is exact.
+std::string SerializeTDigest(tdigest::TDigest* digest);
+
+// Adds the centroids of a digest encoded by SerializeTDigest to digest. The centroids go through
+// digest->add(), so digest may compress some of them together, and the decoded digest is only
+// approximately the one that was serialized.
+Status DeserializeTDigest(std::string_view data, tdigest::TDigest* digest);
+
+}  // namespace internal
+
 // TODO(zasgar): PL-419 Replace this when we add support for structs.
 template <typename TArg>
 class QuantilesUDA : public udf::UDA {
  public:
-  QuantilesUDA() : digest_(1000) {}
+  QuantilesUDA() : digest_(kQuantilesCompression) {}
   void Update(FunctionContext*, TArg val) { digest_.add(val.val); }
   void Merge(FunctionContext*, const QuantilesUDA& other) { digest_.merge(&other.digest_); }
 
+  StringValue Serialize(FunctionContext*) { return internal::SerializeTDigest(&digest_); }
+
+  Status Deserialize(FunctionContext*, const StringValue& data) {
+    digest_ = tdigest::TDigest(kQuantilesCompression);
+    return internal::DeserializeTDigest(data, &digest_);
+  }
+
   StringValue Finalize(FunctionContext*) {
     rapidjson::Document d;
     d.SetObject();
@@ -66,7 +99,8 @@ class QuantilesUDA : public udf::UDA {
             "[tdigest](https://github.com/tdunning/t-digest). Returns a serialized JSON object "
             "with the "
             "keys for 1%, 10%, 50%, 90%, and 99%. You can use `px.pluck_float64` to grab the "
-            "specific values from the result.")
+            "specific values from the result, or use `px.p50`, `px.p90` and `px.p99` to compute "
+            "a single percentile as a float.")
         .Example(R"doc(
         | # Calculate the quantiles.
         | df = df.agg(latency_dist=('latency_ms', px.quantiles))
@@ -81,6 +115,46 @@ class QuantilesUDA : public udf::UDA {
   tdigest::TDigest digest_;
 };
 
+// Approximates a single percentile of the aggregated data. Unlike QuantilesUDA, the result is a
+// float, so it doesn't have to be plucked out of a JSON string.
+template <typename TArg, int64_t TPercentile>
+class PercentileUDA : public udf::UDA {
+ public:
+  static_assert(TPercentile >= 0 && TPercentile <= 100, "Percentile must be in [0, 100]");
+
+  PercentileUDA() : digest_(kQuantilesCompression) {}
+  void Update(FunctionContext*, TArg val) { digest_.add(val.val); }
+  void Merge(FunctionContext*, const PercentileUDA& other) { digest_.merge(&other.digest_); }
+  Float64Value Finalize(FunctionContext*) { return digest_.quantile(TPercentile / 100.0); }
+
+  StringValue Serialize(FunctionContext*) { return internal::SerializeTDigest(&digest_); }
+
+  Status Deserialize(FunctionContext*, const StringValue& data) {
+    digest_ = tdigest::TDigest(kQuantilesCompression);
+    return internal::DeserializeTDigest(data, &digest_);
+  }
+
+  static udf::InfRuleVec SemanticInferenceRules() {
+    return {udf::ExplicitRule::Create<PercentileUDA>(types::ST_DURATION_NS,
+                                                     {types::ST_DURATION_NS})};
+  }
+
+  static udf::UDADocBuilder Doc() {
+    return udf::UDADocBuilder(
+               absl::Substitute("Approximates the $0th percentile of the aggregated data.",
+                                TPercentile))
+        .Details(
+            "Calculates the percentile with [tdigest](https://github.com/tdunning/t-digest), "
+            "like `px.quantiles`, but returns it as a float.")
+        .Example(absl::Substitute("df = df.agg(latency_p$0=('latency_ms', px.p$0))", TPercentile))
+        .Arg("val", "The data to calculate the percentile of.")
+        .Returns("The approximate percentile.");
+  }
+
+ protected:
+  tdigest::TDigest digest_;
+};
+
 void RegisterMathSketchesOrDie(udf::Registry* registry);
 
 }  // namespace builtins
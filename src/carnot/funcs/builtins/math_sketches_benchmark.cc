@@ -0,0 +1,99 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/carnot/funcs/builtins/math_sketches.h"
+#include "src/common/base/base.h"
+
+namespace px {
+namespace carnot {
+namespace builtins {
+
+constexpr int kNumAgents = 8;
+
+std::vector<std::vector<int64_t>> AgentLatencies(int64_t rows_per_agent) {
+  std::mt19937_64 rng(37);
+  std::lognormal_distribution<double> latency_dist(13, 1);
+  std::vector<std::vector<int64_t>> latencies(kNumAgents);
+  for (auto& agent : latencies) {
+    agent.reserve(rows_per_agent);
+    for (int64_t i = 0; i < rows_per_agent; ++i) {
+      agent.push_back(static_cast<int64_t>(latency_dist(rng)));
+    }
+  }
+  return latencies;
+}
+
+// Without partial aggregation: every agent ships its raw rows, and the aggregating agent builds
+// the digest from all of them.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_QuantilesRawRows(benchmark::State& state) {
+  auto latencies = AgentLatencies(state.range(0));
+
+  for (auto _ : state) {
+    QuantilesUDA<types::Int64Value> uda;
+    for (const auto& agent : latencies) {
+      for (int64_t val : agent) {
+        uda.Update(nullptr, val);
+      }
+    }
+    benchmark::DoNotOptimize(uda.Finalize(nullptr));
+  }
+  state.counters["shipped_bytes"] = kNumAgents * state.range(0) * sizeof(int64_t);
+}
+
+// With partial aggregation: every agent ships a serialized digest, and the aggregating agent only
+// merges them. Building the partial digests happens on the agents, so it is not timed.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_QuantilesPartial(benchmark::State& state) {
+  auto latencies = AgentLatencies(state.range(0));
+
+  std::vector<std::string> partials;
+  size_t shipped_bytes = 0;
+  for (const auto& agent : latencies) {
+    QuantilesUDA<types::Int64Value> partial;
+    for (int64_t val : agent) {
+      partial.Update(nullptr, val);
+    }
+    partials.push_back(partial.Serialize(nullptr));
+    shipped_bytes += partials.back().size();
+  }
+
+  for (auto _ : state) {
+    QuantilesUDA<types::Int64Value> uda;
+    for (const auto& serialized : partials) {
+      QuantilesUDA<types::Int64Value> partial;
+      PL_CHECK_OK(partial.Deserialize(nullptr, serialized));
+      uda.Merge(nullptr, partial);
+    }
+    benchmark::DoNotOptimize(uda.Finalize(nullptr));
+  }
+  state.counters["shipped_bytes"] = shipped_bytes;
+}
+
+BENCHMARK(BM_QuantilesRawRows)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_QuantilesPartial)->RangeMultiplier(10)->Range(1000, 1000000);
+
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
@@ -19,9 +19,12 @@
 #include <gtest/gtest.h>
 #include <rapidjson/document.h>
 
+#include <random>
+
 #include "src/carnot/funcs/builtins/math_sketches.h"
 #include "src/carnot/udf/test_utils.h"
 #include "src/common/base/base.h"
+#include "src/common/testing/testing.h"
 
 namespace px {
 namespace carnot {
@@ -69,6 +72,112 @@ TEST(MathSketches, quantiles_int64) {
   EXPECT_DOUBLE_EQ(d["p99"].GetDouble(), 6);
 }
 
+TEST(MathSketches, quantiles_supports_partial) {
+  EXPECT_TRUE(udf::UDATraits<QuantilesUDA<types::Int64Value>>::SupportsPartial());
+  EXPECT_TRUE(udf::UDATraits<QuantilesUDA<types::Float64Value>>::SupportsPartial());
+  EXPECT_TRUE((udf::UDATraits<PercentileUDA<types::Int64Value, 99>>::SupportsPartial()));
+}
+
+TEST(MathSketches, quantiles_serialize_round_trip) {
+  std::mt19937_64 rng(37);
+  std::lognormal_distribution<double> latency_dist(13, 1);
+
+  QuantilesUDA<types::Int64Value> uda;
+  for (int i = 0; i < 100000; ++i) {
+    uda.Update(nullptr, static_cast<int64_t>(latency_dist(rng)));
+  }
+  types::StringValue serialized = uda.Serialize(nullptr);
+
+  QuantilesUDA<types::Int64Value> other;
+  ASSERT_OK(other.Deserialize(nullptr, serialized));
+
+  rapidjson::Document expected;
+  expected.Parse(uda.Finalize(nullptr).data());
+  rapidjson::Document actual;
+  actual.Parse(other.Finalize(nullptr).data());
+  for (const char* key : {"p01", "p10", "p25", "p50", "p75", "p90", "p99"}) {
+    // Re-adding the centroids may combine a few of them, so allow for a little slack.
+    EXPECT_NEAR(actual[key].GetDouble(), expected[key].GetDouble(),
+                expected[key].GetDouble() * 0.001)
+        << key;
+  }
+}
+
+TEST(MathSketches, quantiles_serialize_is_compact) {
+  QuantilesUDA<types::Int64Value> uda;
+  for (int64_t i = 0; i < 100000; ++i) {
+    uda.Update(nullptr, 1000000 + i * 17);
+  }
+  types::StringValue serialized = uda.Serialize(nullptr);
+  // Far fewer bytes than the raw rows, and fewer than a raw (mean, weight) pair per centroid.
+  EXPECT_LT(serialized.size(), 100000 * sizeof(int64_t) / 25);
+
+  tdigest::TDigest digest(kQuantilesCompression);
+  ASSERT_OK(internal::DeserializeTDigest(serialized, &digest));
+  EXPECT_LT(serialized.size(), digest.processed().size() * 2 * sizeof(double));
+}
+
+TEST(MathSketches, quantiles_merge_partials) {
+  std::mt19937_64 rng(37);
+  std::uniform_real_distribution<double> dist(0, 1000);
+
+  // Partial aggregates from several agents, merged on a single one.
+  QuantilesUDA<types::Float64Value> merged;
+  PercentileUDA<types::Float64Value, 50> merged_p50;
+  for (int agent = 0; agent < 8; ++agent) {
+    QuantilesUDA<types::Float64Value> partial;
+    PercentileUDA<types::Float64Value, 50> partial_p50;
+    for (int i = 0; i < 10000; ++i) {
+      double val = dist(rng);
+      partial.Update(nullptr, val);
+      partial_p50.Update(nullptr, val);
+    }
+    QuantilesUDA<types::Float64Value> received;
+    ASSERT_OK(received.Deserialize(nullptr, partial.Serialize(nullptr)));
+    merged.Merge(nullptr, received);
+    PercentileUDA<types::Float64Value, 50> received_p50;
+    ASSERT_OK(received_p50.Deserialize(nullptr, partial_p50.Serialize(nullptr)));
+    merged_p50.Merge(nullptr, received_p50);
+  }
+
+  rapidjson::Document d;
+  d.Parse(merged.Finalize(nullptr).data());
+  EXPECT_NEAR(d["p10"].GetDouble(), 100, 5);
+  EXPECT_NEAR(d["p50"].GetDouble(), 500, 5);
+  EXPECT_NEAR(d["p90"].GetDouble(), 900, 5);
+  EXPECT_DOUBLE_EQ(merged_p50.Finalize(nullptr).val, d["p50"].GetDouble());
+}
+
+TEST(MathSketches, quantiles_deserialize_invalid) {
+  QuantilesUDA<types::Float64Value> uda;
+  uda.Update(nullptr, 1.0);
+  uda.Update(nullptr, 2.0);
+  std::string serialized = uda.Serialize(nullptr);
+
+  QuantilesUDA<types::Float64Value> other;
+  EXPECT_NOT_OK(other.Deserialize(nullptr, ""));
+  EXPECT_NOT_OK(other.Deserialize(nullptr, "{\"p50\": 1}"));
+  EXPECT_NOT_OK(other.Deserialize(nullptr, serialized.substr(0, serialized.size() - 1)));
+  EXPECT_NOT_OK(other.Deserialize(nullptr, serialized + "x"));
+  EXPECT_OK(other.Deserialize(nullptr, serialized));
+}
+
+TEST(MathSketches, percentile_int64) {
+  auto uda_tester = udf::UDATester<PercentileUDA<types::Int64Value, 50>>();
+  uda_tester.ForInput(1).ForInput(2).ForInput(2).ForInput(1).ForInput(1).ForInput(5).ForInput(6);
+  uda_tester.Expect(2);
+}
+
+TEST(MathSketches, percentile_float64) {
+  udf::UDATester<PercentileUDA<types::Float64Value, 99>>()
+      .ForInput(1.234)
+      .ForInput(2.442)
+      .ForInput(1.04)
+      .ForInput(5.322)
+      .ForInput(6.333)
+      .Expect(6.333);
+}
+
 }  // namespace builtins
 }  // namespace carnot
 }  // namespace px
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/funcs/builtins/string_kernels.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace px {
+namespace carnot {
+namespace builtins {
+
+#ifdef __SSE2__
+namespace {
+constexpr size_t kSSEWidth = sizeof(__m128i);
+
+inline __m128i LoadUnaligned(const char* p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+}  // namespace
+#endif
+
+size_t SubstringMatcher::Find(std::string_view haystack) const {
+  const size_t n = needle_.size();
+  if (n == 0) {
+    return 0;
+  }
+  if (haystack.size() < n) {
+    return std::string_view::npos;
+  }
+  if (n == 1) {
+    const void* p = memchr(haystack.data(), needle_[0], haystack.size());
+    return p == nullptr ? std::string_view::npos
+                        : static_cast<const char*>(p) - haystack.data();
+  }
+
+  const char* h = haystack.data();
+  // The last position at which a match can start.
+  const size_t last_start = haystack.size() - n;
+  size_t i = 0;
+
+#ifdef __SSE2__
+  // Compare the first and the last needle character against 16 candidate positions at once, and
+  // only run a full comparison on positions where both match. This rejects almost every
+  // position for typical needles with two vector compares.
+  const __m128i first = _mm_set1_epi8(needle_.front());
+  const __m128i last = _mm_set1_epi8(needle_.back());
+  for (; i + kSSEWidth <= last_start + 1; i += kSSEWidth) {
+    const __m128i eq_first = _mm_cmpeq_epi8(first, LoadUnaligned(h + i));
+    const __m128i eq_last = _mm_cmpeq_epi8(last, LoadUnaligned(h + i + n - 1));
+    uint32_t mask = _mm_movemask_epi8(_mm_and_si128(eq_first, eq_last));
+    while (mask != 0) {
+      const size_t pos = i + __builtin_ctz(mask);
+      if (memcmp(h + pos + 1, needle_.data() + 1, n - 2) == 0) {
+        return pos;
+      }
+      mask &= mask - 1;
+    }
+  }
+#endif
+
+  for (; i <= last_start; ++i) {
+    if (h[i] == needle_.front() && memcmp(h + i + 1, needle_.data() + 1, n - 1) == 0) {
+      return i;
+    }
+  }
+  return std::string_view::npos;
+}
+
+namespace {
+
+// Flips the case bit of every byte of in[0, n) that lies in [lo, hi] and writes it to out.
+inline void FlipAsciiCaseInRange(const char* in, size_t n, char* out, char lo, char hi) {
+  constexpr char kCaseBit = 0x20;
+  size_t i = 0;
+#ifdef __SSE2__
+  // Signed compares are fine here: bytes >= 0x80 are negative and never fall into an ASCII range.
+  const __m128i below = _mm_set1_epi8(lo - 1);
+  const __m128i above = _mm_set1_epi8(hi + 1);
+  const __m128i case_bit = _mm_set1_epi8(kCaseBit);
+  for (; i + kSSEWidth <= n; i += kSSEWidth) {
+    const __m128i v = LoadUnaligned(in + i);
+    const __m128i in_range = _mm_and_si128(_mm_cmpgt_epi8(v, below), _mm_cmplt_epi8(v, above));
+    const __m128i res = _mm_xor_si128(v, _mm_and_si128(in_range, case_bit));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), res);
+  }
+#endif
+  for (; i < n; ++i) {
+    const char c = in[i];
+    out[i] = (c >= lo && c <= hi) ? (c ^ kCaseBit) : c;
+  }
+}
+
+constexpr std::array<int8_t, 256> MakeHexDigitTable() {
+  std::array<int8_t, 256> table{};
+  for (size_t i = 0; i < table.size(); ++i) {
+    table[i] = -1;
+  }
+  for (int i = 0; i < 10; ++i) {
+    table['0' + i] = i;
+  }
+  for (int i = 0; i < 6; ++i) {
+    table['a' + i] = 10 + i;
+    table['A' + i] = 10 + i;
+  }
+  return table;
+}
+
+constexpr std::array<int8_t, 256> kHexDigitValue = MakeHexDigitTable();
+constexpr char kUpperHexDigits[] = "0123456789ABCDEF";
+
+}  // namespace
+
+void AsciiToLower(const char* in, size_t n, char* out) {
+  FlipAsciiCaseInRange(in, n, out, 'A', 'Z');
+}
+
+void AsciiToUpper(const char* in, size_t n, char* out) {
+  FlipAsciiCaseInRange(in, n, out, 'a', 'z');
+}
+
+void BytesToEscapedHex(std::string_view in, char* out) {
+  for (char c : in) {
+    const auto b = static_cast<uint8_t>(c);
+    out[0] = '\\';
+    out[1] = 'x';
+    out[2] = kUpperHexDigits[b >> 4];
+    out[3] = kUpperHexDigits[b & 0xf];
+    out += kEscapedHexSizePerByte;
+  }
+}
+
+bool StrictHexToBytes(std::string_view in, std::string* out) {
+  if (in.size() % 2 != 0) {
+    return false;
+  }
+  const size_t start = out->size();
+  out->resize(start + in.size() / 2);
+  char* dst = out->data() + start;
+  for (size_t i = 0; i < in.size(); i += 2) {
+    const int8_t hi = kHexDigitValue[static_cast<uint8_t>(in[i])];
+    const int8_t lo = kHexDigitValue[static_cast<uint8_t>(in[i + 1])];
+    if ((hi | lo) < 0) {
+      out->resize(start);
+      return false;
+    }
+    *dst++ = static_cast<char>((hi << 4) | lo);
+  }
+  return true;
+}
+
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace px {
+namespace carnot {
+namespace builtins {
+
+/**
+ * Column-at-a-time helpers for the string UDFs. These operate on raw character ranges so that the
+ * batch paths of the UDFs can run over Arrow string buffers without materializing a std::string
+ * per row. Every kernel produces exactly the same result as the corresponding row-wise Exec.
+ */
+
+/**
+ * SubstringMatcher searches haystacks for a fixed needle. The needle is captured once so that a
+ * batch with a constant needle (the common case, e.g. px.contains(df.svc, 'kelvin')) only pays the
+ * setup cost when the needle actually changes.
+ *
+ * The needle is not copied; the caller must keep it alive while the matcher is in use.
+ */
+class SubstringMatcher {
+ public:
+  explicit SubstringMatcher(std::string_view needle = {}) : needle_(needle) {}
+
+  std::string_view needle() const { return needle_; }
+
+  /**
+   * Returns the position of the first occurrence of the needle in haystack, or
+   * std::string_view::npos if it does not occur. Matches std::string_view::find.
+   */
+  size_t Find(std::string_view haystack) const;
+
+ private:
+  std::string_view needle_;
+};
+
+/**
+ * Writes the ASCII lowercase/uppercase version of in[0, n) to out[0, n). Bytes outside of the
+ * ASCII letter ranges are copied as-is. in and out may alias.
+ */
+void AsciiToLower(const char* in, size_t n, char* out);
+void AsciiToUpper(const char* in, size_t n, char* out);
+
+// Number of output characters BytesToEscapedHex writes per input byte ("\xAB").
+constexpr size_t kEscapedHexSizePerByte = 4;
+
+/**
+ * Writes in as escaped hex ("\x64\x65") to out, which must have room for
+ * in.size() * kEscapedHexSizePerByte characters. Matches BytesToString<bytes_format::Hex>.
+ */
+void BytesToEscapedHex(std::string_view in, char* out);
+
+/**
+ * Decodes a string of hex digit pairs into bytes, appending them to out.
+ * Returns false, without modifying out, if in is not strictly made of pairs of hex digits;
+ * callers fall back to AsciiHexToBytes in that case to keep its more lenient parsing rules.
+ */
+bool StrictHexToBytes(std::string_view in, std::string* out);
+
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
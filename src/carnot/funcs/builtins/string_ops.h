@@ -18,23 +18,128 @@
 
 #pragma once
 
+#include <absl/strings/ascii.h>
 #include <absl/strings/strip.h>
+#include <arrow/array.h>
+#include <arrow/builder.h>
 #include <algorithm>
+#include <optional>
 #include <string>
+#include <string_view>
+#include "src/carnot/funcs/builtins/string_kernels.h"
 #include "src/carnot/udf/registry.h"
 #include "src/common/base/utils.h"
+#include "src/shared/types/arrow_adapter.h"
 #include "src/shared/types/types.h"
 
 namespace px {
 namespace carnot {
 namespace builtins {
 
+namespace internal {
+
+inline std::string_view StringAt(const arrow::StringArray* arr, size_t idx) {
+  return types::GetStringViewFromArrowArray(arr, idx);
+}
+
+/**
+ * Runs fn(in_data, out_data) once over the contiguous value buffer of the first count strings of
+ * in, where fn writes TSizePerByte output characters for every input byte, and then appends the
+ * per-row slices of the output to out. This lets byte-wise transforms (case conversion, hex
+ * encoding) run over the whole column instead of allocating and converting one string per row.
+ */
+template <size_t TSizePerByte, typename TFn>
+Status TransformStringData(size_t count, const arrow::StringArray* in, arrow::StringBuilder* out,
+                           TFn fn) {
+  PL_RETURN_IF_ERROR(out->Reserve(count));
+  if (count == 0) {
+    return Status::OK();
+  }
+  const int64_t begin = in->value_offset(0);
+  const int64_t size = in->value_offset(count) - begin;
+  std::string buf(size * TSizePerByte, '\0');
+  fn(std::string_view(reinterpret_cast<const char*>(in->value_data()->data()) + begin, size),
+     buf.data());
+
+  PL_RETURN_IF_ERROR(out->ReserveData(buf.size()));
+  for (size_t idx = 0; idx < count; ++idx) {
+    out->UnsafeAppend(buf.data() + (in->value_offset(idx) - begin) * TSizePerByte,
+                      static_cast<int32_t>(in->value_length(idx) * TSizePerByte));
+  }
+  return Status::OK();
+}
+
+/**
+ * Appends fn(s) for every string s of in to out, for functions that return a view into s
+ * (e.g. trimming), so no intermediate strings are created.
+ */
+template <typename TFn>
+Status AppendStringViews(size_t count, const arrow::StringArray* in, arrow::StringBuilder* out,
+                         TFn fn) {
+  PL_RETURN_IF_ERROR(out->Reserve(count));
+  if (count == 0) {
+    return Status::OK();
+  }
+  PL_RETURN_IF_ERROR(out->ReserveData(in->value_offset(count) - in->value_offset(0)));
+  for (size_t idx = 0; idx < count; ++idx) {
+    std::string_view res = fn(idx, StringAt(in, idx));
+    out->UnsafeAppend(res.data(), static_cast<int32_t>(res.size()));
+  }
+  return Status::OK();
+}
+
+/**
+ * Appends fn(position of needles[i] in haystacks[i]) to out for every row. Uses const_matcher
+ * when the needle is a constant of the query, and otherwise only rebuilds the matcher when the
+ * needle changes from one row to the next.
+ */
+template <typename TBuilder, typename TFn>
+Status SearchStrings(size_t count, const arrow::StringArray* haystacks,
+                     const arrow::StringArray* needles,
+                     const std::optional<SubstringMatcher>& const_matcher, TBuilder* out, TFn fn) {
+  PL_RETURN_IF_ERROR(out->Reserve(count));
+  if (const_matcher.has_value()) {
+    for (size_t idx = 0; idx < count; ++idx) {
+      out->UnsafeAppend(fn(const_matcher->Find(StringAt(haystacks, idx))));
+    }
+    return Status::OK();
+  }
+  SubstringMatcher matcher;
+  for (size_t idx = 0; idx < count; ++idx) {
+    std::string_view needle = StringAt(needles, idx);
+    if (needle != matcher.needle()) {
+      matcher = SubstringMatcher(needle);
+    }
+    out->UnsafeAppend(fn(matcher.Find(StringAt(haystacks, idx))));
+  }
+  return Status::OK();
+}
+
+}  // namespace internal
+
 class ContainsUDF : public udf::ScalarUDF {
  public:
+  Status InitConst(FunctionContext*, const StringValue*, const StringValue* b2) {
+    if (b2 != nullptr) {
+      const_needle_ = *b2;
+      const_matcher_.emplace(const_needle_);
+    }
+    return Status::OK();
+  }
+
   BoolValue Exec(FunctionContext*, StringValue b1, StringValue b2) {
+    if (const_matcher_.has_value()) {
+      return const_matcher_->Find(b1) != std::string_view::npos;
+    }
     return absl::StrContains(b1, b2);
   }
 
+  Status ExecBatchArrow(FunctionContext*, size_t count, const arrow::StringArray* b1,
+                        const arrow::StringArray* b2, arrow::BooleanBuilder* out) {
+    return internal::SearchStrings(count, b1, b2, const_matcher_, out,
+                                   [](size_t pos) { return pos != std::string_view::npos; });
+  }
+
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Returns whether the first string contains the second string.")
         .Example("matching_df = matching_df[px.contains(matching_df.svc_names, 'my_svc')]")
@@ -42,6 +147,10 @@ class ContainsUDF : public udf::ScalarUDF {
         .Arg("arg2", "The string that should be contained in the first string.")
         .Returns("A boolean of whether the first string contains the second string.");
   }
+
+ private:
+  std::string const_needle_;
+  std::optional<SubstringMatcher> const_matcher_;
 };
 
 class LengthUDF : public udf::ScalarUDF {
@@ -59,10 +168,28 @@ class LengthUDF : public udf::ScalarUDF {
 
 class FindUDF : public udf::ScalarUDF {
  public:
+  Status InitConst(FunctionContext*, const StringValue*, const StringValue* substr) {
+    if (substr != nullptr) {
+      const_substr_ = *substr;
+      const_matcher_.emplace(const_substr_);
+    }
+    return Status::OK();
+  }
+
   Int64Value Exec(FunctionContext*, StringValue src, StringValue substr) {
+    if (const_matcher_.has_value()) {
+      return const_matcher_->Find(src);
+    }
     return src.find(substr);
   }
 
+  Status ExecBatchArrow(FunctionContext*, size_t count, const arrow::StringArray* src,
+                        const arrow::StringArray* substr, arrow::Int64Builder* out) {
+    // npos maps to -1, as in Exec.
+    return internal::SearchStrings(count, src, substr, const_matcher_, out,
+                                   [](size_t pos) { return static_cast<int64_t>(pos); });
+  }
+
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Find the index of the first occurrence of the substring.")
         .Details(
@@ -74,6 +201,10 @@ class FindUDF : public udf::ScalarUDF {
         .Arg("arg2", "The substring to find.")
         .Returns("The index of the first occurence of the substring. -1 if no match is found.");
   }
+
+ private:
+  std::string const_substr_;
+  std::optional<SubstringMatcher> const_matcher_;
 };
 
 class SubstringUDF : public udf::ScalarUDF {
@@ -108,6 +239,13 @@ class ToLowerUDF : public udf::ScalarUDF {
     transform(b1.begin(), b1.end(), b1.begin(), ::tolower);
     return b1;
   }
+
+  Status ExecBatchArrow(FunctionContext*, size_t count, const arrow::StringArray* b1,
+                        arrow::StringBuilder* out) {
+    return internal::TransformStringData<1>(count, b1, out, [](std::string_view in, char* res) {
+      AsciiToLower(in.data(), in.size(), res);
+    });
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
                "Transforms all uppercase ascii characters in the string to lowercase.")
@@ -125,6 +263,13 @@ class ToUpperUDF : public udf::ScalarUDF {
     transform(b1.begin(), b1.end(), b1.begin(), ::toupper);
     return b1;
   }
+
+  Status ExecBatchArrow(FunctionContext*, size_t count, const arrow::StringArray* b1,
+                        arrow::StringBuilder* out) {
+    return internal::TransformStringData<1>(count, b1, out, [](std::string_view in, char* res) {
+      AsciiToUpper(in.data(), in.size(), res);
+    });
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
                "Transforms all lowercase ascii characters in the string to uppercase.")
@@ -143,6 +288,12 @@ class TrimUDF : public udf::ScalarUDF {
     absl::StripAsciiWhitespace(&val);
     return val;
   }
+
+  Status ExecBatchArrow(FunctionContext*, size_t count, const arrow::StringArray* s,
+                        arrow::StringBuilder* out) {
+    return internal::AppendStringViews(
+        count, s, out, [](size_t, std::string_view v) { return absl::StripAsciiWhitespace(v); });
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
                "Trim ascii whitespace from before and after the string content.")
@@ -162,6 +313,13 @@ class StripPrefixUDF : public udf::ScalarUDF {
   StringValue Exec(FunctionContext*, StringValue prefix, StringValue s) {
     return StringValue(absl::StripPrefix(s, prefix));
   }
+
+  Status ExecBatchArrow(FunctionContext*, size_t count, const arrow::StringArray* prefix,
+                        const arrow::StringArray* s, arrow::StringBuilder* out) {
+    return internal::AppendStringViews(count, s, out, [prefix](size_t idx, std::string_view v) {
+      return absl::StripPrefix(v, internal::StringAt(prefix, idx));
+    });
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Strips the specified prefix from the string.")
         .Details(
@@ -187,6 +345,28 @@ class HexToASCII : public udf::ScalarUDF {
     return "";
   }
 
+  Status ExecBatchArrow(FunctionContext* ctx, size_t count, const arrow::StringArray* h,
+                        arrow::StringBuilder* out) {
+    PL_RETURN_IF_ERROR(out->Reserve(count));
+    if (count == 0) {
+      return Status::OK();
+    }
+    // Every (valid) output is half the size of its input, invalid inputs produce "".
+    PL_RETURN_IF_ERROR(out->ReserveData((h->value_offset(count) - h->value_offset(0)) / 2));
+    std::string buf;
+    for (size_t idx = 0; idx < count; ++idx) {
+      std::string_view in = internal::StringAt(h, idx);
+      buf.clear();
+      if (!StrictHexToBytes(in, &buf)) {
+        // AsciiHexToBytes accepts a few more forms (e.g. " f"), so defer to it when the fast path
+        // does not apply.
+        buf = Exec(ctx, std::string(in));
+      }
+      out->UnsafeAppend(buf.data(), static_cast<int32_t>(buf.size()));
+    }
+    return Status::OK();
+  }
+
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Convert an input hex sequence in ASCII to bytes.")
         .Details(
@@ -203,6 +383,12 @@ class BytesToHex : public udf::ScalarUDF {
  public:
   StringValue Exec(FunctionContext*, StringValue h) { return BytesToString<bytes_format::Hex>(h); }
 
+  Status ExecBatchArrow(FunctionContext*, size_t count, const arrow::StringArray* h,
+                        arrow::StringBuilder* out) {
+    return internal::TransformStringData<kEscapedHexSizePerByte>(count, h, out,
+                                                                 &BytesToEscapedHex);
+  }
+
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Convert an input bytes in hex string.")
         .Details("This function converts an input bytes sequence in hex string.")
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/carnot/funcs/builtins/string_ops.h"
+#include "src/carnot/udf/udf_wrapper.h"
+#include "src/common/base/base.h"
+#include "src/common/datagen/datagen.h"
+#include "src/shared/types/arrow_adapter.h"
+
+namespace px {
+namespace carnot {
+namespace builtins {
+
+using px::datagen::RandomString;
+
+constexpr int kStringWidth = 32;
+
+std::shared_ptr<arrow::Array> RandomStrings(size_t size, int width) {
+  std::vector<types::StringValue> data(size);
+  std::generate(begin(data), end(data), [=] { return RandomString(width); });
+  return types::ToArrow(data, arrow::default_memory_pool());
+}
+
+std::shared_ptr<arrow::Array> ConstantStrings(size_t size, const std::string& val) {
+  return types::ToArrow(std::vector<types::StringValue>(size, val), arrow::default_memory_pool());
+}
+
+// Runs TUDF over inputs, either row by row through Exec (range(1) == 0) or through its
+// column-at-a-time ExecBatchArrow (range(1) == 1).
+template <typename TUDF>
+void RunStringUDF(benchmark::State& state, const std::vector<arrow::Array*>& inputs) {
+  constexpr types::DataType return_type = udf::ScalarUDFTraits<TUDF>::ReturnType();
+  constexpr size_t kNumArgs = udf::ScalarUDFTraits<TUDF>::ExecArguments().size();
+  using TBuilder = typename types::DataTypeTraits<return_type>::arrow_builder_type;
+  const size_t size = state.range(0);
+  const bool use_batch = state.range(1) != 0;
+
+  TUDF u;
+  std::shared_ptr<arrow::Array> out;
+  // NOLINTNEXTLINE : clang-analyzer-deadcode.DeadStores.
+  for (auto _ : state) {
+    auto output_builder = std::make_shared<TBuilder>();
+    if (use_batch) {
+      PL_CHECK_OK(udf::ScalarUDFWrapper<TUDF>::ExecBatchArrow(&u, nullptr, inputs,
+                                                              output_builder.get(), size));
+    } else {
+      PL_CHECK_OK(udf::ExecWrapperArrow(&u, nullptr, size, output_builder.get(), inputs,
+                                        std::make_index_sequence<kNumArgs>{}));
+    }
+    CHECK(output_builder->Finish(&out).ok());
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * kStringWidth * size);
+}
+
+// px.contains(df.col, 'literal'): the needle is a broadcast constant.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ContainsConstant(benchmark::State& state) {
+  auto haystacks = RandomStrings(state.range(0), kStringWidth);
+  auto needles = ConstantStrings(state.range(0), "pixie");
+  RunStringUDF<ContainsUDF>(state, {haystacks.get(), needles.get()});
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_FindConstant(benchmark::State& state) {
+  auto haystacks = RandomStrings(state.range(0), kStringWidth);
+  auto needles = ConstantStrings(state.range(0), "xyz");
+  RunStringUDF<FindUDF>(state, {haystacks.get(), needles.get()});
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ToLower(benchmark::State& state) {
+  auto in = RandomStrings(state.range(0), kStringWidth);
+  RunStringUDF<ToLowerUDF>(state, {in.get()});
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ToUpper(benchmark::State& state) {
+  auto in = RandomStrings(state.range(0), kStringWidth);
+  RunStringUDF<ToUpperUDF>(state, {in.get()});
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_BytesToHex(benchmark::State& state) {
+  auto in = RandomStrings(state.range(0), kStringWidth);
+  RunStringUDF<BytesToHex>(state, {in.get()});
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_HexToASCII(benchmark::State& state) {
+  std::vector<types::StringValue> data(state.range(0));
+  std::generate(begin(data), end(data), [] {
+    return BytesToString<bytes_format::HexCompact>(RandomString(kStringWidth / 2));
+  });
+  auto in = types::ToArrow(data, arrow::default_memory_pool());
+  RunStringUDF<HexToASCII>(state, {in.get()});
+}
+
+// The second argument selects the row-wise Exec path (0) or the ExecBatchArrow path (1).
+BENCHMARK(BM_ContainsConstant)->ArgsProduct({{1 << 6, 1 << 10, 1 << 14}, {0, 1}});
+BENCHMARK(BM_FindConstant)->ArgsProduct({{1 << 6, 1 << 10, 1 << 14}, {0, 1}});
+BENCHMARK(BM_ToLower)->ArgsProduct({{1 << 6, 1 << 10, 1 << 14}, {0, 1}});
+BENCHMARK(BM_ToUpper)->ArgsProduct({{1 << 6, 1 << 10, 1 << 14}, {0, 1}});
+BENCHMARK(BM_BytesToHex)->ArgsProduct({{1 << 6, 1 << 10, 1 << 14}, {0, 1}});
+BENCHMARK(BM_HexToASCII)->ArgsProduct({{1 << 6, 1 << 10, 1 << 14}, {0, 1}});
+
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
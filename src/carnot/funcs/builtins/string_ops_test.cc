@@ -17,24 +17,97 @@
  */
 
 #include <gtest/gtest.h>
+#include <memory>
 #include <numeric>
+#include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "src/carnot/funcs/builtins/string_ops.h"
 #include "src/carnot/udf/test_utils.h"
+#include "src/carnot/udf/udf_wrapper.h"
 #include "src/common/base/base.h"
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
 
 namespace px {
 namespace carnot {
 namespace builtins {
 
+using StringColumn = std::vector<types::StringValue>;
+
+template <typename TUDF, size_t... I>
+auto ExecRow(TUDF* udf, const std::vector<StringColumn>& cols, size_t row,
+             std::index_sequence<I...>) {
+  return udf->Exec(nullptr, cols[I][row]...);
+}
+
+// Runs the column-at-a-time ExecBatchArrow of TUDF over cols and checks that every row matches
+// what Exec returns for it. If const_args is set, the UDF is specialized on them with InitConst
+// first (the corresponding columns must hold the same value in every row).
+template <typename TUDF, size_t TNumArgs>
+void ExpectBatchMatchesExec(
+    const std::vector<StringColumn>& cols,
+    const std::vector<std::shared_ptr<types::BaseValueType>>& const_args = {}) {
+  static_assert(udf::ScalarUDFTraits<TUDF>::HasExecBatchArrow());
+  constexpr types::DataType return_type = udf::ScalarUDFTraits<TUDF>::ReturnType();
+  ASSERT_EQ(TNumArgs, cols.size());
+  const size_t count = cols[0].size();
+
+  std::vector<std::shared_ptr<arrow::Array>> arrays;
+  std::vector<arrow::Array*> inputs;
+  for (const auto& col : cols) {
+    arrays.push_back(types::ToArrow(col, arrow::default_memory_pool()));
+    inputs.push_back(arrays.back().get());
+  }
+
+  TUDF udf;
+  if (!const_args.empty()) {
+    ASSERT_OK(udf::ScalarUDFWrapper<TUDF>::ExecInitConst(&udf, nullptr, const_args));
+  }
+  auto builder = types::MakeArrowBuilder(return_type, arrow::default_memory_pool());
+  ASSERT_OK(udf::ScalarUDFWrapper<TUDF>::ExecBatchArrow(&udf, nullptr, inputs, builder.get(),
+                                                        count));
+  std::shared_ptr<arrow::Array> res;
+  ASSERT_TRUE(builder->Finish(&res).ok());
+  ASSERT_EQ(count, res->length());
+
+  for (size_t row = 0; row < count; ++row) {
+    auto expected = ExecRow(&udf, cols, row, std::make_index_sequence<TNumArgs>{});
+    EXPECT_EQ(udf::UnWrap(expected), types::GetValueFromArrowArray<return_type>(res.get(), row))
+        << "row " << row;
+  }
+}
+
+// A mix of empty, short, long (> 16 byte) and non-ascii strings.
+const StringColumn kHaystacks = {
+    "",
+    "a",
+    "pixie",
+    "pIXiE",
+    "  sock-shop/carts \t",
+    "sock-shop/carts",
+    "px-sock-shop/front-end-7d8f9c-xk2ls",
+    "a much longer string that spans several vector widths, with MiXeD case and a needle",
+    "\xc3\xa9t\xc3\xa9 \x80\xff",
+    "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab",
+};
+
 TEST(StringOps, basic_string_contains_test) {
   auto udf_tester = udf::UDFTester<ContainsUDF>();
   udf_tester.ForInput("apple", "pl").Expect(true);
   udf_tester.ForInput("apple", "z").Expect(false);
 }
 
+TEST(StringOps, string_contains_const_needle) {
+  types::StringValue needle = "pl";
+  auto udf_tester = udf::UDFTester<ContainsUDF>();
+  udf_tester.InitConst(nullptr, &needle);
+  udf_tester.ForInput("apple", needle).Expect(true);
+  udf_tester.ForInput("apricot", needle).Expect(false);
+}
+
 TEST(StringOps, basic_string_length_test) {
   auto udf_tester = udf::UDFTester<LengthUDF>();
   udf_tester.ForInput("").Expect(0);
@@ -47,6 +120,14 @@ TEST(StringOps, basic_string_find_test) {
   udf_tester.ForInput("pixielabs", "hello").Expect(-1);
 }
 
+TEST(StringOps, string_find_const_substr) {
+  types::StringValue substr = "xie";
+  auto udf_tester = udf::UDFTester<FindUDF>();
+  udf_tester.InitConst(nullptr, &substr);
+  udf_tester.ForInput("pixielabs", substr).Expect(2);
+  udf_tester.ForInput("pixelabs", substr).Expect(-1);
+}
+
 TEST(StringOps, basic_string_substr_test) {
   auto udf_tester = udf::UDFTester<SubstringUDF>();
   udf_tester.ForInput("pixielabs", 3, 4).Expect("iela");
@@ -112,6 +193,52 @@ TEST(StringOps, StringToInt) {
   udf_tester.ForInput("+1111111", -1).Expect(1111111);
 }
 
+TEST(StringOps, contains_and_find_batch) {
+  const std::vector<std::string> needles = {"", "a", "ab", "sock-shop/", "needle", "xk2ls", "zz"};
+  for (const auto& needle : needles) {
+    // Constant needle, as produced by a literal argument.
+    StringColumn needle_col(kHaystacks.size(), needle);
+    ExpectBatchMatchesExec<ContainsUDF, 2>({kHaystacks, needle_col});
+    ExpectBatchMatchesExec<FindUDF, 2>({kHaystacks, needle_col});
+
+    // Same, with the needle known to be constant up front.
+    std::vector<std::shared_ptr<types::BaseValueType>> const_args = {
+        nullptr, std::make_shared<types::StringValue>(needle)};
+    ExpectBatchMatchesExec<ContainsUDF, 2>({kHaystacks, needle_col}, const_args);
+    ExpectBatchMatchesExec<FindUDF, 2>({kHaystacks, needle_col}, const_args);
+  }
+  // Needle that changes from row to row.
+  StringColumn varying_needles(kHaystacks.rbegin(), kHaystacks.rend());
+  ExpectBatchMatchesExec<ContainsUDF, 2>({kHaystacks, varying_needles});
+  ExpectBatchMatchesExec<FindUDF, 2>({kHaystacks, varying_needles});
+}
+
+TEST(StringOps, case_conversion_batch) {
+  ExpectBatchMatchesExec<ToLowerUDF, 1>({kHaystacks});
+  ExpectBatchMatchesExec<ToUpperUDF, 1>({kHaystacks});
+  ExpectBatchMatchesExec<ToLowerUDF, 1>({StringColumn{}});
+}
+
+TEST(StringOps, trim_and_strip_prefix_batch) {
+  ExpectBatchMatchesExec<TrimUDF, 1>({kHaystacks});
+  StringColumn prefixes(kHaystacks.size(), "sock-shop/");
+  prefixes[1] = "a";
+  ExpectBatchMatchesExec<StripPrefixUDF, 2>({prefixes, kHaystacks});
+}
+
+TEST(StringOps, hex_batch) {
+  ExpectBatchMatchesExec<BytesToHex, 1>({kHaystacks});
+  ExpectBatchMatchesExec<HexToASCII, 1>({{
+      "",
+      "333",
+      "6869",
+      "6a4F",
+      "zz",
+      " f",
+      "36623330303663622d393632612d343030302d616235652d333636383564616634383030",
+  }});
+}
+
 TEST(StringOps, IntToString) {
   auto udf_tester = udf::UDFTester<IntToStringUDF>();
   udf_tester.ForInput(1234).Expect("1234");
@@ -18,12 +18,17 @@
 
 #include "src/carnot/funcs/protocols/protocol_ops.h"
 
+#include <string>
+#include <vector>
+
 #include "src/carnot/funcs/protocols/http.h"
 #include "src/carnot/funcs/protocols/kafka.h"
 #include "src/carnot/funcs/protocols/mysql.h"
 #include "src/carnot/funcs/protocols/protocols.h"
 #include "src/carnot/udf/registry.h"
 #include "src/common/base/base.h"
+#include "src/shared/protocols/raw_payload.h"
+#include "src/shared/protocols/redis/format.h"
 
 namespace px {
 namespace carnot {
@@ -39,6 +44,7 @@ void RegisterProtocolOpsOrDie(px::carnot::udf::Registry* registry) {
   registry->RegisterOrDie<HTTPRespMessageUDF>("http_resp_message");
   registry->RegisterOrDie<KafkaAPIKeyNameUDF>("kafka_api_key_name");
   registry->RegisterOrDie<MySQLCommandNameUDF>("mysql_command_name");
+  registry->RegisterOrDie<RedisRenderPayloadUDF>("redis_render_payload");
 }
 
 types::StringValue ProtocolNameUDF::Exec(FunctionContext*, Int64Value protocol) {
@@ -57,6 +63,21 @@ types::StringValue MySQLCommandNameUDF::Exec(FunctionContext*, Int64Value api_ke
   return mysql::CommandName(api_key.val);
 }
 
+types::StringValue RedisRenderPayloadUDF::Exec(FunctionContext*, StringValue payload,
+                                                BoolValue raw) {
+  if (!raw.val) {
+    return payload;
+  }
+  auto elements_or = px::protocols::DecodeRawPayload(payload);
+  if (!elements_or.ok()) {
+    return payload;
+  }
+  std::vector<std::string> elements(elements_or.ValueOrDie().begin(),
+                                    elements_or.ValueOrDie().end());
+  std::string_view command;
+  return px::protocols::redis::FormatArrayPayloads(VectorView<std::string>(elements), &command);
+}
+
 }  // namespace protocols
 }  // namespace funcs
 }  // namespace carnot
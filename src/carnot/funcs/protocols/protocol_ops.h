@@ -80,6 +80,25 @@ class MySQLCommandNameUDF : public px::carnot::udf::ScalarUDF {
   }
 };
 
+class RedisRenderPayloadUDF : public px::carnot::udf::ScalarUDF {
+ public:
+  StringValue Exec(FunctionContext*, StringValue payload, BoolValue raw);
+
+  static udf::ScalarUDFDocBuilder Doc() {
+    return udf::ScalarUDFDocBuilder("Render a Redis payload that was stored in raw form.")
+        .Details(
+            "When PL_STIRLING_REDIS_DEFER_PAYLOAD_RENDERING is enabled in the PEM, Redis array "
+            "payloads are stored in a compact raw encoding instead of being rendered during "
+            "ingest, and flagged in the req_args_raw and resp_raw columns of redis_events. This "
+            "UDF renders a raw payload exactly as it would have been rendered during ingest. "
+            "Payloads that are not flagged as raw are returned unchanged.")
+        .Arg("payload", "The req_args or resp column of the redis_events table.")
+        .Arg("raw", "The matching req_args_raw or resp_raw column.")
+        .Example("df.req_args = px.redis_render_payload(df.req_args, df.req_args_raw)")
+        .Returns("The rendered payload.");
+  }
+};
+
 void RegisterProtocolOpsOrDie(px::carnot::udf::Registry* registry);
 
 }  // namespace protocols
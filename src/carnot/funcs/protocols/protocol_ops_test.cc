@@ -18,9 +18,13 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 #include "src/carnot/funcs/protocols/protocol_ops.h"
 #include "src/carnot/udf/test_utils.h"
 #include "src/common/base/base.h"
+#include "src/shared/protocols/raw_payload.h"
 
 namespace px {
 namespace carnot {
@@ -55,6 +59,24 @@ TEST(ProtocolOps, MySQLCommandNameUDF) {
   udf_tester.ForInput(9999).Expect("9999");
 }
 
+TEST(ProtocolOps, RedisRenderPayloadUDF) {
+  auto udf_tester = udf::UDFTester<RedisRenderPayloadUDF>();
+  // Raw payloads render as they would have during ingest: known commands as per-command JSON
+  // objects, anything else as a JSON array.
+  std::vector<std::string> set = {"SET", "foo", "bar"};
+  udf_tester.ForInput(px::protocols::EncodeRawPayload(set), true)
+      .Expect(R"({"key":"foo","value":"bar","options":[]})");
+  std::vector<std::string> lpush = {"LPUSH", "foo", "bar0", "bar1"};
+  udf_tester.ForInput(px::protocols::EncodeRawPayload(lpush), true)
+      .Expect(R"({"key":"foo","element":["bar0","bar1"]})");
+  std::vector<std::string> pub_msg = {"message", "foo", "test"};
+  udf_tester.ForInput(px::protocols::EncodeRawPayload(pub_msg), true)
+      .Expect(R"(["message","foo","test"])");
+  // Payloads that aren't flagged as raw are returned as is.
+  udf_tester.ForInput(R"({"key":"foo"})", false).Expect(R"({"key":"foo"})");
+  udf_tester.ForInput("", false).Expect("");
+}
+
 }  // namespace protocols
 }  // namespace funcs
 }  // namespace carnot
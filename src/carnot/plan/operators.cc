@@ -263,6 +263,60 @@ StatusOr<table_store::schema::Relation> AggregateOperator::OutputRelation(
   return output_relation;
 }
 
+/**
+ * Rolling Aggregate Operator Implementation.
+ */
+
+std::string RollingAggregateOperator::DebugString() const {
+  return absl::Substitute("Op:RollingAggregate(time_col=$0, window_ns=$1, step_ns=$2, $3)",
+                          time_col_idx_, window_ns_, step_ns_, AggregateOperator::DebugString());
+}
+
+Status RollingAggregateOperator::Init(const planpb::AggregateOperator& pb, int64_t time_col_idx,
+                                      int64_t window_ns, int64_t step_ns) {
+  if (step_ns <= 0) {
+    return error::InvalidArgument("Rolling step must be positive, got $0", step_ns);
+  }
+  if (window_ns < step_ns) {
+    return error::InvalidArgument("Rolling window ($0) must be at least one step ($1)", window_ns,
+                                  step_ns);
+  }
+  if (pb.partial_agg() && !pb.finalize_results()) {
+    return error::InvalidArgument("Rolling aggregates don't support partial aggregation");
+  }
+  time_col_idx_ = time_col_idx;
+  window_ns_ = window_ns;
+  step_ns_ = step_ns;
+  return AggregateOperator::Init(pb);
+}
+
+StatusOr<table_store::schema::Relation> RollingAggregateOperator::OutputRelation(
+    const table_store::schema::Schema& schema, const PlanState& state,
+    const std::vector<int64_t>& input_ids) const {
+  PL_ASSIGN_OR_RETURN(auto agg_relation,
+                      AggregateOperator::OutputRelation(schema, state, input_ids));
+  PL_ASSIGN_OR_RETURN(const auto& input_relation, schema.GetRelation(input_ids[0]));
+  if (time_col_idx_ < 0 || time_col_idx_ >= static_cast<int64_t>(input_relation.NumColumns()) ||
+      input_relation.GetColumnType(static_cast<size_t>(time_col_idx_)) != types::TIME64NS) {
+    return error::InvalidArgument("Rolling time column $0 must be a TIME64NS input column",
+                                  time_col_idx_);
+  }
+
+  // The bucket time sits between the groups and the values.
+  table_store::schema::Relation output_relation;
+  size_t num_groups = groups().size();
+  for (size_t i = 0; i < agg_relation.NumColumns(); ++i) {
+    if (i == num_groups) {
+      output_relation.AddColumn(types::TIME64NS, "time_");
+    }
+    output_relation.AddColumn(agg_relation.GetColumnType(i), agg_relation.GetColumnName(i));
+  }
+  if (num_groups == agg_relation.NumColumns()) {
+    output_relation.AddColumn(types::TIME64NS, "time_");
+  }
+  return output_relation;
+}
+
 /**
  * Memory Sink Operator Implementation.
  */
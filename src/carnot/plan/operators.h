@@ -144,6 +144,8 @@ class AggregateOperator : public Operator {
   const std::vector<GroupInfo>& groups() const { return groups_; }
   const std::vector<std::shared_ptr<AggregateExpression>>& values() const { return values_; }
   bool windowed() const { return pb_.windowed(); }
+  bool partial_agg() const { return pb_.partial_agg(); }
+  bool finalize_results() const { return pb_.finalize_results(); }
 
  private:
   std::vector<std::shared_ptr<AggregateExpression>> values_;
@@ -151,6 +153,38 @@ class AggregateOperator : public Operator {
   planpb::AggregateOperator pb_;
 };
 
+/**
+ * RollingAggregateOperator aggregates over a sliding time window instead of over a tumbling
+ * window or the whole stream. The time column is cut into buckets of `step_ns`, and whenever a
+ * bucket closes each group with rows in the trailing `window_ns` emits one row holding their
+ * aggregate. The output relation is the groups, then the bucket start time as `time_`,
+ * then the values.
+ *
+ * TODO(philkuz): plan.proto has no rolling operator yet, so this isn't produced by the planner and
+ * RollingIR still lowers to a map + groupby.
+ */
+class RollingAggregateOperator : public AggregateOperator {
+ public:
+  explicit RollingAggregateOperator(int64_t id) : AggregateOperator(id) {}
+  ~RollingAggregateOperator() override = default;
+
+  StatusOr<table_store::schema::Relation> OutputRelation(
+      const table_store::schema::Schema& schema, const PlanState& state,
+      const std::vector<int64_t>& input_ids) const override;
+  Status Init(const planpb::AggregateOperator& pb, int64_t time_col_idx, int64_t window_ns,
+              int64_t step_ns);
+  std::string DebugString() const override;
+
+  int64_t time_col_idx() const { return time_col_idx_; }
+  int64_t window_ns() const { return window_ns_; }
+  int64_t step_ns() const { return step_ns_; }
+
+ private:
+  int64_t time_col_idx_ = 0;
+  int64_t window_ns_ = 0;
+  int64_t step_ns_ = 0;
+};
+
 class MemorySinkOperator : public Operator {
  public:
   explicit MemorySinkOperator(int64_t id) : Operator(id, planpb::MEMORY_SINK_OPERATOR) {}
@@ -232,6 +266,7 @@ class FilterOperator : public Operator {
   std::vector<int64_t> selected_cols() { return selected_cols_; }
 
   const std::shared_ptr<const ScalarExpression>& expression() const { return expression_; }
+  const planpb::FilterOperator& pb() const { return pb_; }
 
  private:
   std::shared_ptr<const ScalarExpression> expression_;
@@ -34,6 +34,11 @@
 #include "src/common/uuid/uuid.h"
 #include "src/shared/upid/upid.h"
 
+DEFINE_bool(planner_partial_agg, gflags::BoolFromEnv("PL_PLANNER_PARTIAL_AGG", false),
+            "Whether aggregates whose UDAs support partial aggregation run partially on the "
+            "agents and are merged on Kelvin. Agents that predate the split aggregate support in "
+            "the exec engine reject such plans, so only enable this once every agent has it.");
+
 namespace px {
 namespace carnot {
 namespace planner {
@@ -237,9 +242,8 @@ StatusOr<SchemaToAgentsMap> LoadSchemaMap(
 }
 
 StatusOr<std::unique_ptr<DistributedPlan>> CoordinatorImpl::CoordinateImpl(const IR* logical_plan) {
-  // TODO(zasgar) set support_partial_agg to true to enable partial aggs.
   PL_ASSIGN_OR_RETURN(std::unique_ptr<Splitter> splitter,
-                      Splitter::Create(compiler_state_, /* support_partial_agg */ false));
+                      Splitter::Create(compiler_state_, FLAGS_planner_partial_agg));
   PL_ASSIGN_OR_RETURN(std::unique_ptr<BlockingSplitPlan> split_plan,
                       splitter->SplitKelvinAndAgents(logical_plan));
   auto distributed_plan = std::make_unique<DistributedPlan>();
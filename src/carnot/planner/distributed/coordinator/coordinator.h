@@ -26,6 +26,9 @@
 #include "src/carnot/planner/distributed/distributed_plan/distributed_plan.h"
 #include "src/carnot/planner/ir/ir.h"
 #include "src/carnot/planner/ir/pattern_match.h"
+#include "src/common/base/base.h"
+
+DECLARE_bool(planner_partial_agg);
 
 namespace px {
 namespace carnot {
@@ -27,7 +27,9 @@
 
 #include "src/api/proto/uuidpb/uuid.pb.h"
 #include "src/carnot/planner/compiler/test_utils.h"
+#include "src/carnot/planner/distributed/coordinator/coordinator.h"
 #include "src/carnot/planner/distributed/distributed_planner.h"
+#include "src/carnot/planner/ir/blocking_agg_ir.h"
 #include "src/carnot/planner/ir/ir.h"
 #include "src/carnot/planner/logical_planner.h"
 #include "src/carnot/planner/rules/rules.h"
@@ -489,6 +491,59 @@ TEST_F(LogicalPlannerTest, partial_agg) {
   EXPECT_OK(plan->ToProto());
 }
 
+constexpr char kQuantilesAgg[] = R"pxl(
+import px
+df = px.DataFrame(table='http_events', start_time='-120s')
+df.service = df.ctx['service']
+df = df.groupby('service').agg(latency=('resp_latency_ns', px.quantiles))
+px.display(df)
+)pxl";
+TEST_F(LogicalPlannerTest, partial_quantiles_agg) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_planner_partial_agg = true;
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto plan_or_s =
+      planner->Plan(testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema),
+                    MakeQueryRequest(kQuantilesAgg));
+  ASSERT_OK(plan_or_s);
+  auto plan = plan_or_s.ConsumeValueOrDie();
+
+  // The PEMs serialize their partial digests, which Kelvin merges and finalizes.
+  for (const auto& id : plan->dag().TopologicalSort()) {
+    auto carnot = plan->Get(id);
+    auto aggs = carnot->plan()->FindNodesOfType(IRNodeType::kBlockingAgg);
+    ASSERT_EQ(1, aggs.size());
+    auto agg = static_cast<BlockingAggIR*>(aggs[0]);
+    bool is_kelvin = carnot->carnot_info().accepts_remote_sources();
+    EXPECT_EQ(!is_kelvin, agg->partial_agg());
+    EXPECT_EQ(is_kelvin, agg->finalize_results());
+  }
+  EXPECT_OK(plan->ToProto());
+}
+
+TEST_F(LogicalPlannerTest, partial_agg_disabled_by_default) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto plan_or_s =
+      planner->Plan(testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema),
+                    MakeQueryRequest(kQuantilesAgg));
+  ASSERT_OK(plan_or_s);
+  auto plan = plan_or_s.ConsumeValueOrDie();
+
+  // Without the flag, the aggregate runs in full on Kelvin.
+  for (const auto& id : plan->dag().TopologicalSort()) {
+    auto carnot = plan->Get(id);
+    auto aggs = carnot->plan()->FindNodesOfType(IRNodeType::kBlockingAgg);
+    if (!carnot->carnot_info().accepts_remote_sources()) {
+      EXPECT_EQ(0, aggs.size());
+      continue;
+    }
+    ASSERT_EQ(1, aggs.size());
+    auto agg = static_cast<BlockingAggIR*>(aggs[0]);
+    EXPECT_TRUE(agg->partial_agg());
+    EXPECT_TRUE(agg->finalize_results());
+  }
+}
+
 constexpr char kPemOnlyLimit[] = R"pxl(
 import px
 df = px.DataFrame(table='http_events')
@@ -83,6 +83,15 @@ class UDFTester {
     return *this;
   }
 
+  /*
+   * Calls InitConst with pointers to the constant Exec arguments (nullptr for the others).
+   */
+  template <typename... Args>
+  UDFTester& InitConst(Args... args) {
+    EXPECT_OK(udf_.InitConst(function_ctx_.get(), args...));
+    return *this;
+  }
+
   /*
    * Execute the UDF on the given arguments and store the result to be checked by Expect.
    * Arguments must be of a type that can usually be passed into the UDF's Exec function,
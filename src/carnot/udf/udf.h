@@ -25,6 +25,7 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -74,6 +75,20 @@ class AnyUDA : public BaseFunc {
  *      Status Init(FunctionContext *ctx, UDFValue... init_args) {}
  *  This function is called once during initialization of each instance (many instances
  *  may exists in a given query). The arguments are as provided by the query.
+ *
+ * It can _optionally_ implement:
+ *      Status InitConst(FunctionContext *ctx, const UDFValue*... exec_args) {}
+ *  This function is called once per call site, after Init, with a pointer to the value of each
+ *  Exec argument that is a constant in the query and nullptr for the others. Exec is still called
+ *  with all arguments, but may use state precomputed here for the constant ones. Call sites with
+ *  constant arguments get their own instance when this function exists.
+ *
+ * It can also _optionally_ implement a column-at-a-time version of Exec:
+ *      Status ExecBatchArrow(FunctionContext *ctx, size_t count, const ArrowArray*... args,
+ *                            ArrowBuilder* out) {}
+ *  where ArrowArray/ArrowBuilder are the arrow types of the Exec arguments/return value. When
+ *  present it is used instead of Exec for batches of arrow arrays, and must produce exactly the
+ *  same values as calling Exec on every row.
  */
 class ScalarUDF : public AnyUDF {
  public:
@@ -99,6 +114,15 @@ class ScalarUDF : public AnyUDF {
  *     StringValue Serialize(FunctionContext*) {}
  *     Status DeSerialize(FunctionContext*, const StringValue& data) {}
  *
+ * UDAs whose aggregate is a small fixed-size value can expose it as an inline state so the
+ * executor stores it directly in the aggregation table instead of allocating a UDA per group:
+ *     using State = ...;  // Trivially copyable; a value-initialized State is the empty aggregate.
+ *     static void UpdateState(State* state, Args...) {}
+ *     static void MergeState(State* state, const State& other) {}
+ *     static ReturnValue FinalizeState(const State& state) {}
+ * The member Update/Merge/Finalize functions must behave identically, typically by delegating
+ * to the static ones. Inline state is not supported for UDAs with an Init function.
+ *
  * All argument types must me valid UDFValueTypes.
  */
 class UDA : public AnyUDA {
@@ -167,6 +191,25 @@ struct has_udf_executor_fn<T, std::void_t<decltype(&T::Executor)>> : std::true_t
       "If an executor function exists, it must have the form: UDFSourceExecutor Executor()");
 };
 
+// SFINAE test for InitConst fn.
+template <typename T, typename = void>
+struct has_udf_init_const_fn : std::false_type {};
+
+template <typename T>
+struct has_udf_init_const_fn<T, std::void_t<decltype(&T::InitConst)>> : std::true_type {
+  static_assert(IsValidInitFn(&T::InitConst),
+                "If an InitConst function exists, it must have the form: "
+                "Status InitConst(FunctionContext*, const UDFValue*...)");
+};
+
+// SFINAE test for a column-at-a-time ExecBatchArrow fn.
+template <typename T, typename = void>
+struct has_udf_exec_batch_arrow_fn : std::false_type {};
+
+template <typename T>
+struct has_udf_exec_batch_arrow_fn<T, std::void_t<decltype(&T::ExecBatchArrow)>>
+    : std::true_type {};
+
 template <typename T, typename = void>
 struct check_executor_fn {};
 
@@ -223,11 +266,22 @@ class ScalarUDFTraits {
    */
   static constexpr bool HasInit() { return has_udf_init_fn<T>::value; }
 
+  /**
+   * Checks if the UDF has an InitConst function.
+   * @return true if it has an InitConst function.
+   */
+  static constexpr bool HasInitConst() { return has_udf_init_const_fn<T>::value; }
+
   /**
    * Returns the executor type of this UDF.
    */
   static constexpr bool HasExecutor() { return has_udf_executor_fn<T>::value; }
 
+  /**
+   * Checks if the UDF has a column-at-a-time ExecBatchArrow function.
+   */
+  static constexpr bool HasExecBatchArrow() { return has_udf_exec_batch_arrow_fn<T>::value; }
+
   template <typename Q = T, std::enable_if_t<ScalarUDFTraits<Q>::HasInit(), void>* = nullptr>
   static constexpr auto InitArguments() {
     return GetArgumentTypesHelper(&Q::Init);
@@ -343,6 +397,20 @@ struct has_uda_deserialize_fn<T, std::void_t<decltype(&T::Deserialize)>> : std::
                 "Deserialize(FunctionContext*, const StringValue&)");
 };
 
+// SFINAE test for an inline (fixed-size) UDA state.
+template <typename T, typename = void>
+struct has_uda_inline_state : std::false_type {};
+
+template <typename T>
+struct has_uda_inline_state<T, std::void_t<typename T::State, decltype(&T::UpdateState),
+                                           decltype(&T::MergeState), decltype(&T::FinalizeState)>>
+    : std::true_type {
+  static_assert(std::is_trivially_copyable_v<typename T::State> &&
+                    std::is_default_constructible_v<typename T::State>,
+                "An inline UDA State must be trivially copyable and default constructible");
+  static_assert(!has_udf_init_fn<T>::value, "UDAs with an Init fn cannot use an inline State");
+};
+
 /**
  * ScalarUDFTraits allows access to compile time traits of a given UDA.
  * @tparam T A class that derives from UDA.
@@ -368,6 +436,12 @@ class UDATraits {
     return has_uda_serialize_fn<T>() && has_uda_deserialize_fn<T>();
   }
 
+  /**
+   * Checks if the UDA exposes a fixed-size State that can be stored inline by the executor.
+   * @return true if it has an inline State.
+   */
+  static constexpr bool HasInlineState() { return has_uda_inline_state<T>::value; }
+
   template <typename Q = T, std::enable_if_t<UDATraits<Q>::HasInit(), void>* = nullptr>
   static constexpr auto InitArguments() {
     return GetArgumentTypesHelper(&Q::Init);
@@ -96,6 +96,9 @@ class ScalarUDFDefinition : public UDFDefinition {
     exec_wrapper_fn_ = ScalarUDFWrapper<TUDF>::ExecBatch;
     exec_wrapper_arrow_fn_ = ScalarUDFWrapper<TUDF>::ExecBatchArrow;
     init_wrapper_fn_ = ScalarUDFWrapper<TUDF>::ExecInit;
+    init_const_wrapper_fn_ = ScalarUDFWrapper<TUDF>::ExecInitConst;
+    has_init_const_ = ScalarUDFTraits<TUDF>::HasInitConst();
+    has_exec_batch_arrow_ = ScalarUDFTraits<TUDF>::HasExecBatchArrow();
 
     auto init_arguments_array = ScalarUDFTraits<TUDF>::InitArguments();
     init_arguments_ = {begin(init_arguments_array), end(init_arguments_array)};
@@ -136,6 +139,22 @@ class ScalarUDFDefinition : public UDFDefinition {
     return init_wrapper_fn_(udf, ctx, inputs);
   }
 
+  Status ExecInitConst(ScalarUDF* udf, FunctionContext* ctx,
+                       const std::vector<std::shared_ptr<types::BaseValueType>>& const_args) {
+    return init_const_wrapper_fn_(udf, ctx, const_args);
+  }
+
+  /**
+   * Whether the UDF specializes on constant Exec arguments (has an InitConst function).
+   */
+  bool has_init_const() const { return has_init_const_; }
+
+  /**
+   * Whether the UDF has its own column-at-a-time ExecBatchArrow, rather than one that calls Exec
+   * per row.
+   */
+  bool has_exec_batch_arrow() const { return has_exec_batch_arrow_; }
+
   /**
    * Access internal variable exec_return_type.
    * @return the stored return types of the exec function.
@@ -169,6 +188,12 @@ class ScalarUDFDefinition : public UDFDefinition {
   std::function<Status(ScalarUDF* udf, FunctionContext* ctx,
                        const std::vector<std::shared_ptr<types::BaseValueType>>& inputs)>
       init_wrapper_fn_;
+
+  std::function<Status(ScalarUDF* udf, FunctionContext* ctx,
+                       const std::vector<std::shared_ptr<types::BaseValueType>>& const_args)>
+      init_const_wrapper_fn_;
+  bool has_init_const_ = false;
+  bool has_exec_batch_arrow_ = false;
 };
 
 /**
@@ -205,10 +230,22 @@ class UDADefinition : public UDFDefinition {
                                update_arguments_.end());
 
     merge_fn_ = UDAWrapper<T>::Merge;
+    serialize_fn_ = UDAWrapper<T>::Serialize;
+    deserialize_fn_ = UDAWrapper<T>::Deserialize;
     finalize_arrow_fn_ = UDAWrapper<T>::FinalizeArrow;
     finalize_value_fn = UDAWrapper<T>::FinalizeValue;
 
     supports_partial_ = UDAWrapper<T>::SupportsPartial;
+
+    if constexpr (UDATraits<T>::HasInlineState()) {
+      has_inline_state_ = true;
+      state_size_ = sizeof(typename T::State);
+      state_alignment_ = alignof(typename T::State);
+      init_state_fn_ = UDAWrapper<T>::InitState;
+      exec_batch_update_state_fn_ = UDAWrapper<T>::ExecBatchUpdateState;
+      merge_state_fn_ = UDAWrapper<T>::MergeState;
+      finalize_state_arrow_fn_ = UDAWrapper<T>::FinalizeStateArrow;
+    }
     return Status::OK();
   }
 
@@ -239,6 +276,16 @@ class UDADefinition : public UDFDefinition {
   }
 
   Status Merge(UDA* uda1, UDA* uda2, FunctionContext* ctx) { return merge_fn_(uda1, uda2, ctx); }
+  /**
+   * Serialize and Deserialize move the partial state of a UDA between the two halves of a split
+   * aggregate. They are only valid when supports_partial() is true.
+   */
+  Status Serialize(UDA* uda, FunctionContext* ctx, std::string* output) {
+    return serialize_fn_(uda, ctx, output);
+  }
+  Status Deserialize(UDA* uda, FunctionContext* ctx, const types::StringValue& data) {
+    return deserialize_fn_(uda, ctx, data);
+  }
   Status FinalizeValue(UDA* uda, FunctionContext* ctx, types::BaseValueType* output) {
     return finalize_value_fn(uda, ctx, output);
   }
@@ -246,6 +293,24 @@ class UDADefinition : public UDFDefinition {
     return finalize_arrow_fn_(uda, ctx, output);
   }
 
+  /**
+   * Whether the UDA keeps a fixed-size State that can be stored inline by the caller. The
+   * *State functions below are only valid when this is true.
+   */
+  bool has_inline_state() const { return has_inline_state_; }
+  size_t state_size() const { return state_size_; }
+  size_t state_alignment() const { return state_alignment_; }
+
+  void InitState(char* state) { init_state_fn_(state); }
+  Status ExecBatchUpdateState(char* const* states, size_t state_offset,
+                              const std::vector<const arrow::Array*>& inputs) {
+    return exec_batch_update_state_fn_(states, state_offset, inputs);
+  }
+  void MergeState(char* dst, const char* src) { merge_state_fn_(dst, src); }
+  Status FinalizeStateArrow(const char* state, arrow::ArrayBuilder* output) {
+    return finalize_state_arrow_fn_(state, output);
+  }
+
  private:
   std::vector<types::DataType> init_arguments_;
   std::vector<types::DataType> update_arguments_;
@@ -267,9 +332,22 @@ class UDADefinition : public UDFDefinition {
   std::function<Status(UDA* uda, FunctionContext* ctx, types::BaseValueType* output)>
       finalize_value_fn;
   std::function<Status(UDA* uda1, UDA* uda2, FunctionContext* ctx)> merge_fn_;
+  std::function<Status(UDA* uda, FunctionContext* ctx, std::string* output)> serialize_fn_;
+  std::function<Status(UDA* uda, FunctionContext* ctx, const types::StringValue& data)>
+      deserialize_fn_;
   std::function<Status(UDA* uda, FunctionContext* ctx,
                        const std::vector<std::shared_ptr<types::BaseValueType>>& inputs)>
       init_wrapper_fn_;
+
+  bool has_inline_state_ = false;
+  size_t state_size_ = 0;
+  size_t state_alignment_ = 0;
+  std::function<void(char* state)> init_state_fn_;
+  std::function<Status(char* const* states, size_t state_offset,
+                       const std::vector<const arrow::Array*>& inputs)>
+      exec_batch_update_state_fn_;
+  std::function<void(char* dst, const char* src)> merge_state_fn_;
+  std::function<Status(const char* state, arrow::ArrayBuilder* output)> finalize_state_arrow_fn_;
 };
 
 class UDTFDefinition : public UDFDefinition {
@@ -136,6 +136,50 @@ TEST(UDFDefinition, arrow_write) {
   EXPECT_EQ(6, resArr->Value(1));
 }
 
+class BatchAddUDF : public ScalarUDF {
+ public:
+  types::Int64Value Exec(FunctionContext*, types::Int64Value v1, types::Int64Value v2) {
+    return v1.val + v2.val;
+  }
+
+  Status ExecBatchArrow(FunctionContext*, size_t count, const arrow::Int64Array* v1,
+                        const arrow::Int64Array* v2, arrow::Int64Builder* out) {
+    ++batch_calls;
+    PL_RETURN_IF_ERROR(out->Reserve(count));
+    for (size_t idx = 0; idx < count; ++idx) {
+      out->UnsafeAppend(v1->Value(idx) + v2->Value(idx));
+    }
+    return Status::OK();
+  }
+
+  int batch_calls = 0;
+};
+
+TEST(UDFDefinition, arrow_write_uses_exec_batch_arrow) {
+  static_assert(ScalarUDFTraits<BatchAddUDF>::HasExecBatchArrow());
+  static_assert(!ScalarUDFTraits<AddUDF>::HasExecBatchArrow());
+
+  auto ctx = FunctionContext(nullptr, nullptr);
+  std::vector<types::Int64Value> v1 = {1, 2, 3};
+  std::vector<types::Int64Value> v2 = {3, 4, 5};
+
+  auto v1a = ToArrow(v1, arrow::default_memory_pool());
+  auto v2a = ToArrow(v2, arrow::default_memory_pool());
+
+  auto output_builder = std::make_shared<arrow::Int64Builder>();
+  auto u = std::make_shared<BatchAddUDF>();
+  EXPECT_OK(ScalarUDFWrapper<BatchAddUDF>::ExecBatchArrow(u.get(), &ctx, {v1a.get(), v2a.get()},
+                                                          output_builder.get(), 3));
+  EXPECT_EQ(1, u->batch_calls);
+
+  std::shared_ptr<arrow::Array> res;
+  EXPECT_TRUE(output_builder->Finish(&res).ok());
+  auto* resArr = static_cast<arrow::Int64Array*>(res.get());
+  EXPECT_EQ(4, resArr->Value(0));
+  EXPECT_EQ(6, resArr->Value(1));
+  EXPECT_EQ(8, resArr->Value(2));
+}
+
 TEST(UDFDefinition, init_args) {
   auto ctx = FunctionContext(nullptr, nullptr);
   ScalarUDFDefinition def("initargudf");
@@ -174,6 +218,31 @@ class MinSumUDA : public udf::UDA {
   types::Int64Value sum_ = 0;
 };
 
+// MinSumUDA with its sum kept in an inline state.
+class InlineMinSumUDA : public udf::UDA {
+ public:
+  struct State {
+    int64_t sum = 0;
+  };
+
+  static void UpdateState(State* state, types::Int64Value arg1, types::Int64Value arg2) {
+    state->sum += std::min(arg1.val, arg2.val);
+  }
+  static void MergeState(State* state, const State& other) { state->sum += other.sum; }
+  static types::Int64Value FinalizeState(const State& state) { return state.sum; }
+
+  void Update(udf::FunctionContext*, types::Int64Value arg1, types::Int64Value arg2) {
+    UpdateState(&state_, arg1, arg2);
+  }
+  void Merge(udf::FunctionContext*, const InlineMinSumUDA& other) {
+    MergeState(&state_, other.state_);
+  }
+  types::Int64Value Finalize(udf::FunctionContext*) { return FinalizeState(state_); }
+
+ protected:
+  State state_;
+};
+
 class InitArgUDA : public udf::UDA {
  public:
   Status Init(udf::FunctionContext*, types::Int64Value i, types::StringValue str,
@@ -253,6 +322,47 @@ TEST(UDADefinition, arrow_output) {
   EXPECT_EQ(5, casted->Value(0));
 }
 
+TEST(UDADefinition, inline_state) {
+  UDADefinition def("minsum");
+  EXPECT_OK(def.Init<MinSumUDA>());
+  EXPECT_FALSE(def.has_inline_state());
+
+  UDADefinition inline_def("minsum");
+  EXPECT_OK(inline_def.Init<InlineMinSumUDA>());
+  ASSERT_TRUE(inline_def.has_inline_state());
+  EXPECT_EQ(sizeof(int64_t), inline_def.state_size());
+
+  // Two states laid out back to back, with rows scattered between them.
+  alignas(int64_t) char buffer[2 * sizeof(int64_t)];
+  char* s1 = buffer;
+  char* s2 = buffer + inline_def.state_size();
+  inline_def.InitState(s1);
+  inline_def.InitState(s2);
+
+  arrow::Int64Builder b1;
+  arrow::Int64Builder b2;
+  ASSERT_TRUE(b1.AppendValues({1, 2, 3, 4}).ok());
+  ASSERT_TRUE(b2.AppendValues({5, 1, 3, 1}).ok());
+  std::shared_ptr<arrow::Array> a1;
+  std::shared_ptr<arrow::Array> a2;
+  ASSERT_TRUE(b1.Finish(&a1).ok());
+  ASSERT_TRUE(b2.Finish(&a2).ok());
+
+  std::vector<char*> states = {s1, s2, s1, s2};
+  EXPECT_OK(inline_def.ExecBatchUpdateState(states.data(), 0, {a1.get(), a2.get()}));
+  inline_def.MergeState(s1, s2);
+
+  arrow::Int64Builder output_builder;
+  EXPECT_OK(inline_def.FinalizeStateArrow(s1, &output_builder));
+  EXPECT_OK(inline_def.FinalizeStateArrow(s2, &output_builder));
+  std::shared_ptr<arrow::Array> res;
+  ASSERT_TRUE(output_builder.Finish(&res).ok());
+  auto casted = static_cast<arrow::Int64Array*>(res.get());
+  // s1 sees rows 0 and 2 (1 + 3) and then merges s2, which sees rows 1 and 3 (1 + 1).
+  EXPECT_EQ(6, casted->Value(0));
+  EXPECT_EQ(2, casted->Value(1));
+}
+
 TEST(UDADefinition, init_args) {
   auto ctx = FunctionContext(nullptr, nullptr);
   UDADefinition def("initarguda");
@@ -157,6 +157,31 @@ TEST(UDA, valid_uda) {
               ElementsAre(types::DataType::INT64, types::DataType::FLOAT64));
 }
 
+class UDAWithInlineState : UDA {
+ public:
+  struct State {
+    int64_t count = 0;
+  };
+  static void UpdateState(State* state, types::Int64Value) { state->count++; }
+  static void MergeState(State* state, const State& other) { state->count += other.count; }
+  static types::Int64Value FinalizeState(const State& state) { return state.count; }
+
+  void Update(FunctionContext*, types::Int64Value arg) { UpdateState(&state_, arg); }
+  void Merge(FunctionContext*, const UDAWithInlineState& other) {
+    MergeState(&state_, other.state_);
+  }
+  types::Int64Value Finalize(FunctionContext*) { return FinalizeState(state_); }
+
+ private:
+  State state_;
+};
+
+TEST(UDA, inline_state) {
+  EXPECT_FALSE(UDATraits<UDA1>::HasInlineState());
+  EXPECT_FALSE(UDATraits<UDA1WithInit>::HasInlineState());
+  EXPECT_TRUE(UDATraits<UDAWithInlineState>::HasInlineState());
+}
+
 class UDAWithBadSerDes : UDA {
  public:
   Status Init(FunctionContext*) { return Status::OK(); }
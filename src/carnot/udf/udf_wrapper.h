@@ -21,6 +21,7 @@
 #include <arrow/array.h>
 
 #include <memory>
+#include <new>
 #include <string>
 #include <vector>
 
@@ -76,6 +77,15 @@ Status InitWrapper(TUDF* udf, FunctionContext* ctx,
   return udf->Init(ctx, *CastToUDFValueType<init_argument_types[I]>(args[I].get())...);
 }
 
+template <typename TUDF, std::size_t... I>
+Status InitConstWrapper(TUDF* udf, FunctionContext* ctx,
+                        const std::vector<std::shared_ptr<types::BaseValueType>>& const_args,
+                        std::index_sequence<I...>) {
+  [[maybe_unused]] constexpr auto exec_argument_types = ScalarUDFTraits<TUDF>::ExecArguments();
+  return udf->InitConst(ctx,
+                        CastToUDFValueType<exec_argument_types[I]>(const_args[I].get())...);
+}
+
 template <typename TUDA, std::size_t... I>
 Status UDAInitWrapper(TUDA* udf, FunctionContext* ctx,
                       const std::vector<std::shared_ptr<types::BaseValueType>>& args,
@@ -132,6 +142,22 @@ Status ExecWrapperArrow(TUDF* udf, FunctionContext* ctx, size_t count, TOutput*
   return Status::OK();
 }
 
+/**
+ * This is the inner wrapper for UDFs that provide their own column-at-a-time ExecBatchArrow.
+ * It only casts the inputs and output to their concrete arrow types.
+ */
+template <typename TUDF, typename TOutput, std::size_t... I>
+Status ExecBatchWrapperArrow(TUDF* udf, FunctionContext* ctx, size_t count, TOutput* out,
+                             const std::vector<arrow::Array*>& args, std::index_sequence<I...>) {
+  [[maybe_unused]] static constexpr auto exec_argument_types =
+      ScalarUDFTraits<TUDF>::ExecArguments();
+  return udf->ExecBatchArrow(
+      ctx, count,
+      static_cast<const typename types::DataTypeTraits<exec_argument_types[I]>::arrow_array_type*>(
+          args[I])...,
+      out);
+}
+
 /**
  * Checks types between column wrapper and array of types::UDFDataTypes.
  * @return true if all types match.
@@ -200,10 +226,16 @@ struct ScalarUDFWrapper {
     // The outer wrapper just casts the output type and UDF type. We then pass in
     // the inputs with a sequence based on the number of arguments to iterate through and
     // cast the inputs.
-    return ExecWrapperArrow<TUDF>(
-        static_cast<TUDF*>(udf), ctx, count,
-        static_cast<typename types::DataTypeTraits<return_type>::arrow_builder_type*>(output),
-        inputs, std::make_index_sequence<exec_argument_types.size()>{});
+    auto* typed_output =
+        static_cast<typename types::DataTypeTraits<return_type>::arrow_builder_type*>(output);
+    if constexpr (ScalarUDFTraits<TUDF>::HasExecBatchArrow()) {
+      return ExecBatchWrapperArrow<TUDF>(static_cast<TUDF*>(udf), ctx, count, typed_output,
+                                         inputs,
+                                         std::make_index_sequence<exec_argument_types.size()>{});
+    } else {
+      return ExecWrapperArrow<TUDF>(static_cast<TUDF*>(udf), ctx, count, typed_output, inputs,
+                                    std::make_index_sequence<exec_argument_types.size()>{});
+    }
   }
 
   /**
@@ -278,6 +310,25 @@ struct ScalarUDFWrapper {
                          const std::vector<std::shared_ptr<types::BaseValueType>>& inputs) {
     return ExecInitImpl(udf, ctx, inputs);
   }
+
+  /**
+   * Calls the InitConst function of the UDF, if it has one.
+   * @param const_args One entry per Exec argument: the constant value of the argument, or nullptr
+   * if it is not a constant.
+   * @return Status from the udf's InitConst function.
+   */
+  static Status ExecInitConst(
+      ScalarUDF* udf, FunctionContext* ctx,
+      const std::vector<std::shared_ptr<types::BaseValueType>>& const_args) {
+    if constexpr (ScalarUDFTraits<TUDF>::HasInitConst()) {
+      constexpr auto exec_argument_types = ScalarUDFTraits<TUDF>::ExecArguments();
+      DCHECK_EQ(const_args.size(), exec_argument_types.size());
+      return InitConstWrapper<TUDF>(static_cast<TUDF*>(udf), ctx, const_args,
+                                    std::make_index_sequence<exec_argument_types.size()>{});
+    } else {
+      return Status::OK();
+    }
+  }
 };
 
 /**
@@ -309,6 +360,24 @@ Status UpdateWrapperArrow(TUDA* uda, FunctionContext* ctx, size_t count,
   return Status::OK();
 }
 
+/**
+ * Performs an update of inline UDA states from a batch of records (arrow). Row idx updates the
+ * state at states[idx] + state_offset, so rows belonging to different groups are scattered into
+ * their own states in a single pass.
+ */
+template <typename TUDA, std::size_t... I>
+Status UpdateStateWrapperArrow(char* const* states, size_t state_offset, size_t count,
+                               const std::vector<const arrow::Array*>& args,
+                               std::index_sequence<I...>) {
+  constexpr auto update_argument_types = UDATraits<TUDA>::UpdateArgumentTypes();
+  using State = typename TUDA::State;
+  for (size_t idx = 0; idx < count; ++idx) {
+    TUDA::UpdateState(reinterpret_cast<State*>(states[idx] + state_offset),
+                      types::GetValueFromArrowArray<update_argument_types[I]>(args[I], idx)...);
+  }
+  return Status::OK();
+}
+
 /**
  * Provides a set of static methods that wrap UDAs and allow vectorized execution (for update).
  * @tparam TUDA The UDA class.
@@ -405,6 +474,38 @@ struct UDAWrapper {
     return Status::OK();
   }
 
+  /**
+   * Serializes the partial state of the UDA into output, so that it can be merged by another
+   * instance after going through Deserialize.
+   * @return Status of Serialize, an error if the UDA doesn't support partial aggregates.
+   */
+  static Status Serialize(UDA* uda, FunctionContext* ctx, std::string* output) {
+    if constexpr (SupportsPartial) {
+      *output = static_cast<TUDA*>(uda)->Serialize(ctx);
+      return Status::OK();
+    } else {
+      PL_UNUSED(uda);
+      PL_UNUSED(ctx);
+      PL_UNUSED(output);
+      return error::Unimplemented("UDA does not support partial aggregates");
+    }
+  }
+
+  /**
+   * Restores the partial state of the UDA from data produced by Serialize.
+   * @return Status of Deserialize, an error if the UDA doesn't support partial aggregates.
+   */
+  static Status Deserialize(UDA* uda, FunctionContext* ctx, const types::StringValue& data) {
+    if constexpr (SupportsPartial) {
+      return static_cast<TUDA*>(uda)->Deserialize(ctx, data);
+    } else {
+      PL_UNUSED(uda);
+      PL_UNUSED(ctx);
+      PL_UNUSED(data);
+      return error::Unimplemented("UDA does not support partial aggregates");
+    }
+  }
+
   /**
    * Finalize the UDA into an arrow builder. The arrow builder needs to be correct type
    * for the finalize return type.
@@ -435,6 +536,48 @@ struct UDAWrapper {
     *casted_output = casted_uda->Finalize(ctx);
     return Status::OK();
   }
+
+  /**
+   * The functions below operate on the UDA's inline State and may only be used when
+   * UDATraits<TUDA>::HasInlineState() is true. States are passed as raw pointers into memory
+   * owned by the executor, which must be sized and aligned for TUDA::State.
+   */
+  static void InitState(char* state) { new (state) typename TUDA::State(); }
+
+  /**
+   * Perform a batch update of inline states, where row i updates states[i] + state_offset.
+   * @return Status of update.
+   */
+  static Status ExecBatchUpdateState(char* const* states, size_t state_offset,
+                                     const std::vector<const arrow::Array*>& inputs) {
+    constexpr auto update_argument_types = UDATraits<TUDA>::UpdateArgumentTypes();
+    DCHECK(inputs.size() == update_argument_types.size());
+
+    size_t num_records = inputs[0]->length();
+    return UpdateStateWrapperArrow<TUDA>(states, state_offset, num_records, inputs,
+                                         std::make_index_sequence<update_argument_types.size()>{});
+  }
+
+  /**
+   * Merges the inline state src into dst.
+   */
+  static void MergeState(char* dst, const char* src) {
+    using State = typename TUDA::State;
+    TUDA::MergeState(reinterpret_cast<State*>(dst), *reinterpret_cast<const State*>(src));
+  }
+
+  /**
+   * Finalize an inline state into an arrow builder of the finalize return type.
+   * @return Status of the finalize.
+   */
+  static Status FinalizeStateArrow(const char* state, arrow::ArrayBuilder* output) {
+    DCHECK(output != nullptr);
+    auto* casted_builder =
+        static_cast<typename types::DataTypeTraits<return_type>::arrow_builder_type*>(output);
+    const auto& casted_state = *reinterpret_cast<const typename TUDA::State*>(state);
+    PL_RETURN_IF_ERROR(casted_builder->Append(UnWrap(TUDA::FinalizeState(casted_state))));
+    return Status::OK();
+  }
 };
 
 /**
@@ -473,20 +616,26 @@ struct UDTFWrapper {
       return false;
     }
 
-    // Reserve the output.
-    for (auto* out : *outputs) {
-      CHECK(out->Reserve(max_gen_records).ok());
-    }
-
     auto* u = static_cast<TUDTF*>(udtf);
-    int count = 0;
-    bool more = true;
-    RecordWriterProxy<TUDTF> rw(outputs);
-    while (count < max_gen_records && more) {
-      more = u->NextRecord(ctx, &rw);
-      ++count;
+    if constexpr (UDTFTraits<TUDTF>::HasNextBatchFn()) {
+      // Columnar UDTFs size the output builders themselves as they append.
+      ColumnWriterProxy<TUDTF> cw(outputs);
+      return u->NextBatch(ctx, max_gen_records, &cw);
+    } else {
+      // Reserve the output.
+      for (auto* out : *outputs) {
+        CHECK(out->Reserve(max_gen_records).ok());
+      }
+
+      int count = 0;
+      bool more = true;
+      RecordWriterProxy<TUDTF> rw(outputs);
+      while (count < max_gen_records && more) {
+        more = u->NextRecord(ctx, &rw);
+        ++count;
+      }
+      return more;
     }
-    return more;
   }
 
  private:
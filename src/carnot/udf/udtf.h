@@ -18,12 +18,15 @@
 
 #pragma once
 
+#include <iterator>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "src/carnot/udf/base.h"
 #include "src/carnot/udfspb/udfs.pb.h"
+#include "src/shared/types/arrow_adapter.h"
 
 namespace px {
 namespace carnot {
@@ -48,6 +51,24 @@ template <>
 struct DefaultValueTraits<types::STRING> {
   using value_view_type = std::string_view;
 };
+
+// Returns true if all output columns have the same length.
+inline bool OutputColsHaveSameLength(const std::vector<arrow::ArrayBuilder*>& outputs) {
+  if (outputs.size() == 0) {
+    return true;
+  }
+
+  int64_t s = outputs[0]->length();
+  for (const auto& [idx, col] : Enumerate(outputs)) {
+    if (col->length() != s) {
+      LOG(ERROR) << absl::Substitute(
+          "Column at idx=$0 has wrong number of records. Expected=$1, got=$2", idx, col->length(),
+          s);
+      return false;
+    }
+  }
+  return true;
+}
 }  // namespace internal
 
 /**
@@ -254,6 +275,12 @@ class UDTFTraits {
    */
   static constexpr bool HasNextRecordFn() { return NextRecordFnHelper<TUDTF>::value; }
 
+  /**
+   * Checks to see if NextBatch() exists.
+   * @return
+   */
+  static constexpr bool HasNextBatchFn() { return NextBatchFnHelper<TUDTF>::value; }
+
   template <typename Q = TUDTF, std::enable_if_t<UDTFTraits<Q>::HasInitArgsFn(), void>* = nullptr>
   static constexpr auto InitArguments() {
     return Q::InitArgs();
@@ -373,6 +400,14 @@ class UDTFTraits {
   struct NextRecordFnHelper<
       T, std::void_t<decltype (&T::NextRecord)(FunctionContext*, typename T::RecordWriter*)>>
       : std::true_type {};
+
+  template <typename T, typename = void>
+  struct NextBatchFnHelper : std::false_type {};
+
+  template <typename T>
+  struct NextBatchFnHelper<
+      T, std::void_t<decltype (&T::NextBatch)(FunctionContext*, int, typename T::ColumnWriter*)>>
+      : std::true_type {};
 };
 
 /**
@@ -388,7 +423,7 @@ class RecordWriterProxy final {
 
   ~RecordWriterProxy() {
     // Check that all cols have the same length.
-    CHECK(CheckCols());
+    CHECK(internal::OutputColsHaveSameLength(*outputs_));
   }
 
   /**
@@ -437,22 +472,92 @@ class RecordWriterProxy final {
       builder->UnsafeAppend(v.val);
     }
   }
-  // Returns true if all cols have the same length.
-  bool CheckCols() {
-    if (outputs_->size() == 0) {
-      return true;
+
+  std::vector<arrow::ArrayBuilder*>* outputs_;
+};
+
+/**
+ * ColumnWriterProxy is used to write the output of UDTFs that produce a batch of records at a time
+ * (see NextBatch below). Each call appends a run of values, or a whole pre-built arrow array, to a
+ * single output column, so builders are grown once per call rather than once per value.
+ * @tparam TUDTF The UDTF class.
+ */
+template <typename TUDTF>
+class ColumnWriterProxy final {
+ public:
+  explicit ColumnWriterProxy(std::vector<arrow::ArrayBuilder*>* outputs) : outputs_(outputs) {
+    CHECK(outputs != nullptr);
+  }
+
+  ~ColumnWriterProxy() {
+    // Check that all cols have the same length.
+    CHECK(internal::OutputColsHaveSameLength(*outputs_));
+  }
+
+  /**
+   * Append the values in [begin, end) to the given column index. The values must be convertible
+   * to the UDF value type of the column (or to std::string_view for string columns).
+   */
+  template <size_t idx, typename TIter>
+  void AppendValues(TIter begin, TIter end) {
+    auto* builder = Builder<idx>();
+    PL_CHECK_OK(builder->Reserve(std::distance(begin, end)));
+    // PL_CARNOT_UPDATE_FOR_NEW_TYPES.
+    if constexpr (ColType(idx) == types::DataType::STRING) {
+      int64_t total_size = 0;
+      for (auto it = begin; it != end; ++it) {
+        total_size += std::string_view(*it).size();
+      }
+      PL_CHECK_OK(builder->ReserveData(total_size));
+      for (auto it = begin; it != end; ++it) {
+        std::string_view v(*it);
+        builder->UnsafeAppend(v.data(), static_cast<int32_t>(v.size()));
+      }
+    } else {
+      using value_type = typename types::DataTypeTraits<ColType(idx)>::value_type;
+      for (auto it = begin; it != end; ++it) {
+        builder->UnsafeAppend(value_type(*it).val);
+      }
     }
+  }
 
-    int64_t s = (*outputs_)[0]->length();
-    for (const auto& [idx, col] : Enumerate(*outputs_)) {
-      if (col->length() != s) {
-        LOG(ERROR) << absl::Substitute(
-            "Column at idx=$0 has wrong number of records. Expected=$1, got=$2", idx, col->length(),
-            s);
-        return false;
+  /**
+   * Append all values of a pre-built arrow array to the given column index. The array must have
+   * the arrow type of the column and contain no nulls.
+   */
+  template <size_t idx>
+  void AppendArray(const arrow::Array& arr) {
+    auto* builder = Builder<idx>();
+    DCHECK(arr.type_id() == builder->type()->id());
+    DCHECK_EQ(arr.null_count(), 0);
+    PL_CHECK_OK(builder->Reserve(arr.length()));
+    // PL_CARNOT_UPDATE_FOR_NEW_TYPES.
+    if constexpr (ColType(idx) == types::DataType::STRING) {
+      const auto& str_arr = static_cast<const arrow::StringArray&>(arr);
+      PL_CHECK_OK(builder->ReserveData(str_arr.value_offset(str_arr.length()) -
+                                       str_arr.value_offset(0)));
+      for (int64_t i = 0; i < str_arr.length(); ++i) {
+        auto v = str_arr.GetView(i);
+        builder->UnsafeAppend(v.data(), static_cast<int32_t>(v.size()));
+      }
+    } else {
+      for (int64_t i = 0; i < arr.length(); ++i) {
+        builder->UnsafeAppend(types::GetValueFromArrowArray<ColType(idx)>(&arr, i));
       }
     }
-    return true;
+  }
+
+ private:
+  static constexpr types::DataType ColType(size_t idx) {
+    return UDTFTraits<TUDTF>::OutputRelationTypes()[idx];
+  }
+
+  template <size_t idx>
+  auto* Builder() {
+    DCHECK(idx < outputs_->size());
+    DCHECK(ToArrowType(ColType(idx)) == (*outputs_)[idx]->type()->id());
+    return static_cast<typename types::DataTypeTraits<ColType(idx)>::arrow_builder_type*>(
+        (*outputs_)[idx]);
   }
 
   std::vector<arrow::ArrayBuilder*>* outputs_;
@@ -483,10 +588,13 @@ struct UDTFChecker {
   // Check that Executor exists and returns the executor type.
   static_assert(TR::HasExecutorFn(), "UDTF must have an Executor() func");
   static_assert(TR::HasCorrectExectorFnReturnType(), "Executor() must return UDTFSourceExecutor");
-  // Check that NextRecord exists and is well formed.
-  static_assert(
-      TR::HasNextRecordFn(),
-      "UDTF must have NextRecord func of form NextRecord(FunctionContext, RecordWriterProxy*)");
+  // Check that exactly one of NextRecord and NextBatch exists and is well formed.
+  static_assert(TR::HasNextRecordFn() || TR::HasNextBatchFn(),
+                "UDTF must have NextRecord func of form NextRecord(FunctionContext, "
+                "RecordWriterProxy*) or NextBatch func of form NextBatch(FunctionContext, int, "
+                "ColumnWriterProxy*)");
+  static_assert(!(TR::HasNextRecordFn() && TR::HasNextBatchFn()),
+                "UDTF must not have both NextRecord and NextBatch funcs");
 };
 
 /**
@@ -531,12 +639,23 @@ struct UDTFChecker {
  *     int64_t count_ = 0;
  *   }
  *
+ * UDTFs that already hold their output in bulk can instead define NextBatch, which writes up to
+ * max_records records a column at a time and returns whether there are more records:
+ *
+ *     bool NextBatch(FunctionContext *, int max_records, ColumnWriter *cw) {
+ *       size_t n = std::min<size_t>(max_records, strs_.size() - idx_);
+ *       cw->AppendValues<IndexOf("out")>(strs_.begin() + idx_, strs_.begin() + idx_ + n);
+ *       idx_ += n;
+ *       return idx_ < strs_.size();
+ *     }
+ *
  * @tparam Derived The name of the derived class.
  */
 template <typename Derived>
 class UDTF : public AnyUDTF {
  public:
   using RecordWriter = RecordWriterProxy<Derived>;
+  using ColumnWriter = ColumnWriterProxy<Derived>;
   using Checker = UDTFChecker<Derived>;
   using UDTFArg = udf::UDTFArg;
   using ColInfo = udf::ColInfo;
@@ -18,6 +18,7 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <iostream>
 #include <type_traits>
 
@@ -222,6 +223,123 @@ TEST(BasicUDTFTwoColBadDeathTest, record_writer_should_catch_bad_append) {
   EXPECT_DEATH(wrapper.ExecBatchUpdate(u.get(), nullptr, 100, &outs), ".*wrong number.*");
 }
 
+class BatchUDTFTwoCol : public UDTF<BatchUDTFTwoCol> {
+ public:
+  static constexpr auto Executor() { return udfspb::UDTFSourceExecutor::UDTF_ALL_AGENTS; }
+
+  static constexpr auto OutputRelation() {
+    return MakeArray(
+        ColInfo("out_str", types::DataType::STRING, types::PatternType::GENERAL, "string result"),
+        ColInfo("int_val", types::DataType::INT64, types::PatternType::GENERAL, "int result"));
+  }
+
+  Status Init(FunctionContext*) {
+    for (int64_t i = 0; i < 5; ++i) {
+      strs_.push_back("abc " + std::to_string(i));
+      ints_.push_back(i);
+    }
+    return Status::OK();
+  }
+
+  bool NextBatch(FunctionContext*, int max_records, ColumnWriter* cw) {
+    size_t n = std::min<size_t>(max_records, strs_.size() - idx_);
+    cw->AppendValues<IndexOf("out_str")>(strs_.begin() + idx_, strs_.begin() + idx_ + n);
+    cw->AppendValues<IndexOf("int_val")>(ints_.begin() + idx_, ints_.begin() + idx_ + n);
+    idx_ += n;
+    return idx_ < strs_.size();
+  }
+
+ private:
+  size_t idx_ = 0;
+  std::vector<std::string> strs_;
+  std::vector<int64_t> ints_;
+};
+
+TEST(BatchUDTFTwoCol, streams_in_chunks) {
+  using TR = UDTFTraits<BatchUDTFTwoCol>;
+  constexpr BatchUDTFTwoCol::Checker check;
+  PL_UNUSED(check);
+
+  EXPECT_FALSE(TR::HasNextRecordFn());
+  EXPECT_TRUE(TR::HasNextBatchFn());
+
+  UDTFWrapper<BatchUDTFTwoCol> wrapper;
+  auto u = wrapper.Make();
+  ASSERT_NE(u, nullptr);
+  EXPECT_OK(wrapper.Init(u.get(), nullptr, {}));
+
+  arrow::StringBuilder string_builder(0);
+  arrow::Int64Builder int64_builder(0);
+  std::vector<arrow::ArrayBuilder*> outs{&string_builder, &int64_builder};
+
+  EXPECT_TRUE(wrapper.ExecBatchUpdate(u.get(), nullptr, 3, &outs));
+  EXPECT_EQ(string_builder.length(), 3);
+  EXPECT_EQ(int64_builder.length(), 3);
+
+  EXPECT_FALSE(wrapper.ExecBatchUpdate(u.get(), nullptr, 3, &outs));
+
+  std::shared_ptr<arrow::StringArray> str_out;
+  EXPECT_TRUE(string_builder.Finish(&str_out).ok());
+  std::shared_ptr<arrow::Int64Array> int_out;
+  EXPECT_TRUE(int64_builder.Finish(&int_out).ok());
+
+  ASSERT_EQ(str_out->length(), 5);
+  ASSERT_EQ(int_out->length(), 5);
+  for (int64_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(str_out->GetString(i), "abc " + std::to_string(i));
+    EXPECT_EQ(int_out->Value(i), i);
+  }
+}
+
+class ArrayUDTFTwoCol : public UDTF<ArrayUDTFTwoCol> {
+ public:
+  static constexpr auto Executor() { return udfspb::UDTFSourceExecutor::UDTF_ALL_AGENTS; }
+
+  static constexpr auto OutputRelation() {
+    return MakeArray(
+        ColInfo("out_str", types::DataType::STRING, types::PatternType::GENERAL, "string result"),
+        ColInfo("time_", types::DataType::TIME64NS, types::PatternType::GENERAL, "time result"));
+  }
+
+  bool NextBatch(FunctionContext*, int, ColumnWriter* cw) {
+    auto strs = types::ToArrow(std::vector<types::StringValue>{"a", "bc", "def"},
+                               arrow::default_memory_pool());
+    auto times = types::ToArrow(std::vector<types::Time64NSValue>{1, 2, 3},
+                                arrow::default_memory_pool());
+    // Sliced arrays are appended starting from their offset.
+    cw->AppendArray<IndexOf("out_str")>(*strs->Slice(1));
+    cw->AppendArray<IndexOf("time_")>(*times->Slice(1));
+    return false;
+  }
+};
+
+TEST(ArrayUDTFTwoCol, appends_arrays) {
+  constexpr ArrayUDTFTwoCol::Checker check;
+  PL_UNUSED(check);
+
+  UDTFWrapper<ArrayUDTFTwoCol> wrapper;
+  auto u = wrapper.Make();
+  ASSERT_NE(u, nullptr);
+
+  arrow::StringBuilder string_builder(0);
+  arrow::Time64Builder time_builder(arrow::time64(arrow::TimeUnit::NANO), 0);
+  std::vector<arrow::ArrayBuilder*> outs{&string_builder, &time_builder};
+
+  EXPECT_FALSE(wrapper.ExecBatchUpdate(u.get(), nullptr, 100, &outs));
+
+  std::shared_ptr<arrow::StringArray> str_out;
+  EXPECT_TRUE(string_builder.Finish(&str_out).ok());
+  std::shared_ptr<arrow::Time64Array> time_out;
+  EXPECT_TRUE(time_builder.Finish(&time_out).ok());
+
+  ASSERT_EQ(str_out->length(), 2);
+  EXPECT_EQ(str_out->GetString(0), "bc");
+  EXPECT_EQ(str_out->GetString(1), "def");
+  ASSERT_EQ(time_out->length(), 2);
+  EXPECT_EQ(time_out->Value(0), 2);
+  EXPECT_EQ(time_out->Value(1), 3);
+}
+
 class ValidOneColUDTFEmptyInit : public UDTF<ValidOneColUDTFEmptyInit> {
  public:
   static constexpr auto Executor() { return udfspb::UDTFSourceExecutor::UDTF_ALL_AGENTS; }
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace px {
+
+/**
+ * BranchlessLowerBound is std::lower_bound over a sorted sequence of `n` elements, where element
+ * `i` is read through `get(i)`. It returns the index of the first element that is not less than
+ * `val`, or `n` if there is none.
+ *
+ * The loop runs a fixed ceil(log2(n)) iterations, and the only data dependent step selects the
+ * next base with a conditional move rather than a branch. Time columns are searched for values
+ * that are effectively random with respect to the data, which makes the branches of a classic
+ * binary search mispredict about half the time.
+ */
+template <typename TGetFn, typename TValue>
+size_t BranchlessLowerBound(size_t n, TGetFn get, const TValue& val) {
+  if (n == 0) {
+    return 0;
+  }
+  size_t base = 0;
+  while (n > 1) {
+    size_t half = n / 2;
+    base = (get(base + half) < val) ? base + half : base;
+    n -= half;
+  }
+  return base + static_cast<size_t>(get(base) < val);
+}
+
+/**
+ * BranchlessUpperBound is the std::upper_bound counterpart of BranchlessLowerBound. It returns the
+ * index of the first element that is greater than `val`, or `n` if there is none.
+ */
+template <typename TGetFn, typename TValue>
+size_t BranchlessUpperBound(size_t n, TGetFn get, const TValue& val) {
+  if (n == 0) {
+    return 0;
+  }
+  size_t base = 0;
+  while (n > 1) {
+    size_t half = n / 2;
+    base = !(val < get(base + half)) ? base + half : base;
+    n -= half;
+  }
+  return base + static_cast<size_t>(!(val < get(base)));
+}
+
+}  // namespace px
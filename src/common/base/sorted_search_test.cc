@@ -0,0 +1,72 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "src/common/base/sorted_search.h"
+
+namespace px {
+
+TEST(BranchlessSearchTest, Basic) {
+  std::vector<int> data = {1, 3, 3, 3, 5, 8};
+  auto get = [&data](size_t i) { return data[i]; };
+
+  EXPECT_EQ(BranchlessLowerBound(data.size(), get, 0), 0);
+  EXPECT_EQ(BranchlessLowerBound(data.size(), get, 1), 0);
+  EXPECT_EQ(BranchlessLowerBound(data.size(), get, 3), 1);
+  EXPECT_EQ(BranchlessLowerBound(data.size(), get, 4), 4);
+  EXPECT_EQ(BranchlessLowerBound(data.size(), get, 8), 5);
+  EXPECT_EQ(BranchlessLowerBound(data.size(), get, 9), 6);
+
+  EXPECT_EQ(BranchlessUpperBound(data.size(), get, 0), 0);
+  EXPECT_EQ(BranchlessUpperBound(data.size(), get, 1), 1);
+  EXPECT_EQ(BranchlessUpperBound(data.size(), get, 3), 4);
+  EXPECT_EQ(BranchlessUpperBound(data.size(), get, 4), 4);
+  EXPECT_EQ(BranchlessUpperBound(data.size(), get, 8), 6);
+  EXPECT_EQ(BranchlessUpperBound(data.size(), get, 9), 6);
+
+  EXPECT_EQ(BranchlessLowerBound(0, get, 3), 0);
+  EXPECT_EQ(BranchlessUpperBound(0, get, 3), 0);
+}
+
+TEST(BranchlessSearchTest, MatchesStd) {
+  std::default_random_engine rng(37);
+  std::uniform_int_distribution<int> val_dist(0, 50);
+
+  for (size_t n = 0; n < 70; ++n) {
+    std::vector<int> data(n);
+    for (auto& x : data) {
+      x = val_dist(rng);
+    }
+    std::sort(data.begin(), data.end());
+    auto get = [&data](size_t i) { return data[i]; };
+
+    for (int val = -1; val <= 51; ++val) {
+      size_t expected_lower = std::lower_bound(data.begin(), data.end(), val) - data.begin();
+      size_t expected_upper = std::upper_bound(data.begin(), data.end(), val) - data.begin();
+      EXPECT_EQ(BranchlessLowerBound(n, get, val), expected_lower) << n << " " << val;
+      EXPECT_EQ(BranchlessUpperBound(n, get, val), expected_upper) << n << " " << val;
+    }
+  }
+}
+
+}  // namespace px
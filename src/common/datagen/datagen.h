@@ -143,6 +143,9 @@ class IntGenerator {
 
   virtual int Generate() = 0;
 
+  // Re-seeds the generator, to make the generated sequence reproducible across runs.
+  void Seed(uint32_t seed) { mersenne_engine.seed(seed); }
+
  protected:
   std::random_device rnd_device_;
   std::mt19937 mersenne_engine{rnd_device_()};  // Generates random integers
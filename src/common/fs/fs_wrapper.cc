@@ -130,6 +130,16 @@ Status Remove(const std::filesystem::path& path) {
   return error::InvalidArgument("Could not delete $0 [ec=$1]", path.string(), ec.message());
 }
 
+Status Rename(const std::filesystem::path& from, const std::filesystem::path& to) {
+  std::error_code ec;
+  std::filesystem::rename(from, to, ec);
+  if (ec) {
+    return error::System("Could not rename $0 to $1. Message: $2", from.string(), to.string(),
+                         ec.message());
+  }
+  return Status::OK();
+}
+
 Status RemoveAll(const std::filesystem::path& path) {
   std::error_code ec;
   // Apparently, remove_all() uses -1 but in an unsigned type to indicate an error.
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "src/common/metrics/histogram.h"
+
+namespace px {
+namespace metrics {
+
+std::vector<double> ExponentialBuckets(double start, double factor, int count) {
+  std::vector<double> buckets;
+  buckets.reserve(count);
+  double boundary = start;
+  for (int i = 0; i < count; ++i) {
+    buckets.push_back(boundary);
+    boundary *= factor;
+  }
+  return buckets;
+}
+
+const std::vector<double>& DefaultLatencyBuckets() {
+  static const std::vector<double> kBuckets = ExponentialBuckets(1e-6, 2, 25);
+  return kBuckets;
+}
+
+ShardedHistogram::ShardedHistogram(std::vector<double> bucket_boundaries)
+    : bucket_boundaries_(std::move(bucket_boundaries)), shards_(new Shard[kNumShards]) {
+  for (size_t i = 0; i < kNumShards; ++i) {
+    shards_[i].counts.reset(new std::atomic<uint64_t>[bucket_boundaries_.size() + 1]);
+    for (size_t j = 0; j <= bucket_boundaries_.size(); ++j) {
+      shards_[i].counts[j].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+size_t ShardedHistogram::ThreadShardIndex() {
+  static std::atomic<size_t> next_shard{0};
+  thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+  return shard;
+}
+
+void ShardedHistogram::Observe(double value) {
+  // Buckets are inclusive of their upper bound, so find the first boundary >= value.
+  size_t bucket = std::lower_bound(bucket_boundaries_.begin(), bucket_boundaries_.end(), value) -
+                  bucket_boundaries_.begin();
+
+  Shard& shard = shards_[ThreadShardIndex()];
+  shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+
+  // A shard is only shared if there are more threads than shards, so this rarely loops.
+  double sum = shard.sum.load(std::memory_order_relaxed);
+  while (!shard.sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+  }
+}
+
+prometheus::ClientMetric ShardedHistogram::Collect() const {
+  std::vector<uint64_t> counts(bucket_boundaries_.size() + 1, 0);
+  double sum = 0;
+  for (size_t i = 0; i < kNumShards; ++i) {
+    for (size_t j = 0; j < counts.size(); ++j) {
+      counts[j] += shards_[i].counts[j].load(std::memory_order_relaxed);
+    }
+    sum += shards_[i].sum.load(std::memory_order_relaxed);
+  }
+
+  prometheus::ClientMetric metric;
+  uint64_t cumulative_count = 0;
+  for (size_t j = 0; j < counts.size(); ++j) {
+    cumulative_count += counts[j];
+    prometheus::ClientMetric::Bucket bucket;
+    bucket.cumulative_count = cumulative_count;
+    bucket.upper_bound = j < bucket_boundaries_.size() ? bucket_boundaries_[j]
+                                                       : std::numeric_limits<double>::infinity();
+    metric.histogram.bucket.push_back(std::move(bucket));
+  }
+  metric.histogram.sample_count = cumulative_count;
+  metric.histogram.sample_sum = sum;
+  return metric;
+}
+
+void ShardedHistogram::Reset() {
+  for (size_t i = 0; i < kNumShards; ++i) {
+    for (size_t j = 0; j <= bucket_boundaries_.size(); ++j) {
+      shards_[i].counts[j].store(0, std::memory_order_relaxed);
+    }
+    shards_[i].sum.store(0.0, std::memory_order_relaxed);
+  }
+}
+
+HistogramFamily::HistogramFamily(std::string name, std::string help,
+                                 std::vector<double> bucket_boundaries)
+    : name_(std::move(name)),
+      help_(std::move(help)),
+      bucket_boundaries_(std::move(bucket_boundaries)) {}
+
+ShardedHistogram& HistogramFamily::Add(const std::map<std::string, std::string>& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& histogram = histograms_[labels];
+  if (histogram == nullptr) {
+    histogram = std::make_unique<ShardedHistogram>(bucket_boundaries_);
+  }
+  return *histogram;
+}
+
+std::vector<prometheus::MetricFamily> HistogramFamily::Collect() const {
+  prometheus::MetricFamily family;
+  family.name = name_;
+  family.help = help_;
+  family.type = prometheus::MetricType::Histogram;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& [labels, histogram] : histograms_) {
+    prometheus::ClientMetric metric = histogram->Collect();
+    for (const auto& [label_name, label_value] : labels) {
+      metric.label.push_back(prometheus::ClientMetric::Label{label_name, label_value});
+    }
+    family.metric.push_back(std::move(metric));
+  }
+  return {std::move(family)};
+}
+
+void HistogramFamily::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& [labels, histogram] : histograms_) {
+    histogram->Reset();
+  }
+}
+
+}  // namespace metrics
+}  // namespace px
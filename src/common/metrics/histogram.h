@@ -0,0 +1,153 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <prometheus/client_metric.h>
+#include <prometheus/collectable.h>
+#include <prometheus/metric_family.h>
+
+namespace px {
+namespace metrics {
+
+/**
+ * Returns `count` bucket boundaries, where the first boundary is `start` and each subsequent
+ * boundary is `factor` times larger than the previous one.
+ */
+std::vector<double> ExponentialBuckets(double start, double factor, int count);
+
+/**
+ * The default bucket boundaries for latency histograms, in seconds.
+ * Ranges from 1us to ~16s, doubling at each step.
+ */
+const std::vector<double>& DefaultLatencyBuckets();
+
+/**
+ * A histogram meant for use on hot paths.
+ *
+ * Unlike prometheus::Histogram, Observe() neither takes a lock nor contends on a shared cache
+ * line. Each thread records into one of a fixed set of cache-line aligned shards using relaxed
+ * atomics, and the shards are only merged when the histogram is collected. Threads are assigned to
+ * shards round-robin, so shards are effectively per-thread as long as there are fewer threads
+ * observing the histogram than there are shards.
+ */
+class ShardedHistogram {
+ public:
+  explicit ShardedHistogram(std::vector<double> bucket_boundaries);
+
+  /**
+   * Records a single observation.
+   */
+  void Observe(double value);
+
+  /**
+   * Merges all the shards into a single prometheus histogram metric.
+   * The buckets in the result are cumulative, and include the implicit +Inf bucket.
+   */
+  prometheus::ClientMetric Collect() const;
+
+  /**
+   * Clears all the observations. Observations concurrent with the reset may or may not be kept.
+   */
+  void Reset();
+
+  const std::vector<double>& bucket_boundaries() const { return bucket_boundaries_; }
+
+ private:
+  static constexpr size_t kNumShards = 16;
+
+  struct alignas(64) Shard {
+    // One count per bucket boundary, plus one for the +Inf bucket.
+    std::unique_ptr<std::atomic<uint64_t>[]> counts;
+    std::atomic<double> sum{0.0};
+  };
+
+  static size_t ThreadShardIndex();
+
+  const std::vector<double> bucket_boundaries_;
+  std::unique_ptr<Shard[]> shards_;
+};
+
+/**
+ * A family of ShardedHistograms that share a name, help message and bucket boundaries, and are
+ * distinguished by their labels. Analogous to prometheus::Family<prometheus::Histogram>.
+ */
+class HistogramFamily : public prometheus::Collectable {
+ public:
+  HistogramFamily(std::string name, std::string help, std::vector<double> bucket_boundaries);
+
+  /**
+   * Returns the histogram with the given labels, creating it if it doesn't exist yet.
+   * The returned reference remains valid for the lifetime of the family, so callers on hot paths
+   * should look up their histogram once and hold on to it.
+   */
+  ShardedHistogram& Add(const std::map<std::string, std::string>& labels);
+
+  std::vector<prometheus::MetricFamily> Collect() const override;
+
+  /**
+   * Clears the observations of all the histograms in the family. The histograms themselves are
+   * kept, so references returned by Add() remain valid.
+   */
+  void Reset();
+
+  const std::string& name() const { return name_; }
+
+ private:
+  const std::string name_;
+  const std::string help_;
+  const std::vector<double> bucket_boundaries_;
+
+  mutable std::mutex mutex_;
+  std::map<std::map<std::string, std::string>, std::unique_ptr<ShardedHistogram>> histograms_;
+};
+
+/**
+ * Records the time elapsed between construction and destruction, in seconds, into a histogram.
+ */
+class ScopedHistogramTimer {
+ public:
+  explicit ScopedHistogramTimer(ShardedHistogram* histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedHistogramTimer() {
+    if (histogram_ == nullptr) {
+      return;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+    histogram_->Observe(elapsed.count());
+  }
+
+  ScopedHistogramTimer(const ScopedHistogramTimer&) = delete;
+  ScopedHistogramTimer& operator=(const ScopedHistogramTimer&) = delete;
+
+ private:
+  ShardedHistogram* histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace metrics
+}  // namespace px
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "src/common/metrics/histogram.h"
+#include "src/common/metrics/metrics.h"
+
+namespace px {
+namespace metrics {
+
+TEST(ExponentialBucketsTest, Basic) {
+  EXPECT_THAT(ExponentialBuckets(1, 2, 4), ::testing::ElementsAre(1, 2, 4, 8));
+}
+
+TEST(ShardedHistogramTest, CumulativeBuckets) {
+  ShardedHistogram histogram({1, 10, 100});
+  histogram.Observe(0.5);
+  histogram.Observe(1);
+  histogram.Observe(5);
+  histogram.Observe(50);
+  histogram.Observe(500);
+
+  prometheus::ClientMetric metric = histogram.Collect();
+  EXPECT_EQ(metric.histogram.sample_count, 5);
+  EXPECT_DOUBLE_EQ(metric.histogram.sample_sum, 556.5);
+  ASSERT_EQ(metric.histogram.bucket.size(), 4);
+  EXPECT_EQ(metric.histogram.bucket[0].cumulative_count, 2);
+  EXPECT_EQ(metric.histogram.bucket[1].cumulative_count, 3);
+  EXPECT_EQ(metric.histogram.bucket[2].cumulative_count, 4);
+  EXPECT_EQ(metric.histogram.bucket[3].cumulative_count, 5);
+  EXPECT_EQ(metric.histogram.bucket[3].upper_bound, std::numeric_limits<double>::infinity());
+}
+
+TEST(ShardedHistogramTest, ConcurrentObservations) {
+  constexpr int kNumThreads = 32;
+  constexpr int kObservationsPerThread = 1000;
+
+  ShardedHistogram histogram({1, 10});
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&histogram]() {
+      for (int j = 0; j < kObservationsPerThread; ++j) {
+        histogram.Observe(2);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  prometheus::ClientMetric metric = histogram.Collect();
+  EXPECT_EQ(metric.histogram.sample_count, kNumThreads * kObservationsPerThread);
+  EXPECT_DOUBLE_EQ(metric.histogram.sample_sum, 2.0 * kNumThreads * kObservationsPerThread);
+  EXPECT_EQ(metric.histogram.bucket[0].cumulative_count, 0);
+  EXPECT_EQ(metric.histogram.bucket[1].cumulative_count, kNumThreads * kObservationsPerThread);
+}
+
+TEST(HistogramFamilyTest, CollectedWithRegistry) {
+  TestOnlyResetMetricsRegistry();
+
+  auto& family = GetOrCreateHistogramFamily("test_latency", "help", {1, 2});
+  EXPECT_EQ(&family, &GetOrCreateHistogramFamily("test_latency", "help", {1, 2}));
+
+  auto& a = family.Add({{"name", "a"}});
+  EXPECT_EQ(&a, &family.Add({{"name", "a"}}));
+  family.Add({{"name", "b"}}).Observe(1.5);
+  a.Observe(0.5);
+
+  // Families outlive registry resets, so other tests' (empty) families may be collected too.
+  std::vector<prometheus::MetricFamily> metrics = CollectMetrics();
+  auto it = std::find_if(metrics.begin(), metrics.end(),
+                         [](const auto& family) { return family.name == "test_latency"; });
+  ASSERT_NE(it, metrics.end());
+  EXPECT_EQ(it->type, prometheus::MetricType::Histogram);
+  ASSERT_EQ(it->metric.size(), 2);
+  EXPECT_EQ(it->metric[0].label[0].value, "a");
+  EXPECT_EQ(it->metric[0].histogram.bucket[0].cumulative_count, 1);
+  EXPECT_EQ(it->metric[1].label[0].value, "b");
+  EXPECT_EQ(it->metric[1].histogram.bucket[0].cumulative_count, 0);
+  EXPECT_EQ(it->metric[1].histogram.bucket[1].cumulative_count, 1);
+}
+
+TEST(HistogramFamilyTest, ReferencesSurviveRegistryReset) {
+  TestOnlyResetMetricsRegistry();
+
+  auto& histogram =
+      GetOrCreateHistogramFamily("test_reset_latency", "help", {1, 2}).Add({{"name", "a"}});
+  histogram.Observe(0.5);
+
+  TestOnlyResetMetricsRegistry();
+  // The histogram is still alive and collected, but its observations are gone.
+  histogram.Observe(1.5);
+  EXPECT_EQ(&histogram,
+            &GetOrCreateHistogramFamily("test_reset_latency", "help", {1, 2}).Add({{"name", "a"}}));
+  prometheus::ClientMetric metric = histogram.Collect();
+  EXPECT_EQ(metric.histogram.sample_count, 1);
+  EXPECT_DOUBLE_EQ(metric.histogram.sample_sum, 1.5);
+}
+
+TEST(HistogramFamilyTest, CollectedWithTheirOwnRegistry) {
+  TestOnlyResetMetricsRegistry();
+
+  prometheus::Registry registry;
+  GetOrCreateHistogramFamily(&registry, "test_local_latency", "help", {1, 2})
+      .Add({{"name", "a"}})
+      .Observe(0.5);
+
+  std::vector<prometheus::MetricFamily> local_metrics = CollectMetrics(&registry);
+  ASSERT_EQ(local_metrics.size(), 1);
+  EXPECT_EQ(local_metrics[0].name, "test_local_latency");
+  for (const auto& family : CollectMetrics()) {
+    EXPECT_NE(family.name, "test_local_latency");
+  }
+}
+
+}  // namespace metrics
+}  // namespace px
@@ -15,16 +15,42 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <prometheus/registry.h>
 
 #include "src/common/metrics/metrics.h"
 
 namespace {
+using HistogramFamilies = std::map<std::string, std::unique_ptr<px::metrics::HistogramFamily>>;
+
 std::unique_ptr<prometheus::Registry> g_registry_instance;
 
-void ResetMetricsRegistry() { g_registry_instance = std::make_unique<prometheus::Registry>(); }
+std::mutex g_histogram_families_lock;
+// Histogram families, by the registry they live alongside.
+std::map<const prometheus::Registry*, HistogramFamilies> g_histogram_families;
+
+void ResetMetricsRegistry() {
+  std::unique_ptr<prometheus::Registry> old_registry = std::move(g_registry_instance);
+  g_registry_instance = std::make_unique<prometheus::Registry>();
+
+  // Keep the families of the old registry, as their histograms may still be referenced, and carry
+  // them over to the new one with their observations cleared.
+  std::lock_guard<std::mutex> lock(g_histogram_families_lock);
+  auto node = g_histogram_families.extract(old_registry.get());
+  if (!node.empty()) {
+    for (auto& [name, family] : node.mapped()) {
+      family->Reset();
+    }
+    node.key() = g_registry_instance.get();
+    g_histogram_families.insert(std::move(node));
+  }
+}
 }  // namespace
 
 prometheus::Registry& GetMetricsRegistry() {
@@ -34,4 +60,40 @@ prometheus::Registry& GetMetricsRegistry() {
   return *g_registry_instance;
 }
 
+px::metrics::HistogramFamily& GetOrCreateHistogramFamily(
+    prometheus::Registry* registry, const std::string& name, const std::string& help_message,
+    const std::vector<double>& bucket_boundaries) {
+  std::lock_guard<std::mutex> lock(g_histogram_families_lock);
+  auto& family = g_histogram_families[registry][name];
+  if (family == nullptr) {
+    family = std::make_unique<px::metrics::HistogramFamily>(name, help_message, bucket_boundaries);
+  }
+  return *family;
+}
+
+px::metrics::HistogramFamily& GetOrCreateHistogramFamily(
+    const std::string& name, const std::string& help_message,
+    const std::vector<double>& bucket_boundaries) {
+  return GetOrCreateHistogramFamily(&GetMetricsRegistry(), name, help_message, bucket_boundaries);
+}
+
+std::vector<prometheus::MetricFamily> CollectMetrics(prometheus::Registry* registry) {
+  std::vector<prometheus::MetricFamily> metrics = registry->Collect();
+  std::lock_guard<std::mutex> lock(g_histogram_families_lock);
+  auto it = g_histogram_families.find(registry);
+  if (it == g_histogram_families.end()) {
+    return metrics;
+  }
+  for (const auto& [name, family] : it->second) {
+    for (auto& metric_family : family->Collect()) {
+      metrics.push_back(std::move(metric_family));
+    }
+  }
+  return metrics;
+}
+
+std::vector<prometheus::MetricFamily> CollectMetrics() {
+  return CollectMetrics(&GetMetricsRegistry());
+}
+
 void TestOnlyResetMetricsRegistry() { ResetMetricsRegistry(); }
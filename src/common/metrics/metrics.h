@@ -19,14 +19,38 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <prometheus/counter.h>
+#include <prometheus/metric_family.h>
 #include <prometheus/registry.h>
 
+#include "src/common/metrics/histogram.h"
+
 // Returns the global metrics registry;
 prometheus::Registry& GetMetricsRegistry();
 
+// Returns the histogram family with the specified name that lives alongside the given registry,
+// creating it with the specified help message and bucket boundaries if it doesn't exist yet.
+// Families are never destroyed, so references to them and their histograms remain valid.
+px::metrics::HistogramFamily& GetOrCreateHistogramFamily(
+    prometheus::Registry* registry, const std::string& name, const std::string& help_message,
+    const std::vector<double>& bucket_boundaries = px::metrics::DefaultLatencyBuckets());
+
+// Same as above, for the global registry.
+px::metrics::HistogramFamily& GetOrCreateHistogramFamily(
+    const std::string& name, const std::string& help_message,
+    const std::vector<double>& bucket_boundaries = px::metrics::DefaultLatencyBuckets());
+
+// Collects the metrics of the given registry and of the histogram families alongside it.
+std::vector<prometheus::MetricFamily> CollectMetrics(prometheus::Registry* registry);
+
+// Same as above, for the global registry.
+std::vector<prometheus::MetricFamily> CollectMetrics();
+
 // Resets the Metrics registry, removing all of its contained metrics.
+// Histogram families are kept, since components hold references to their histograms, but their
+// observations are cleared.
 // This function should only be called by testing code.
 void TestOnlyResetMetricsRegistry();
 
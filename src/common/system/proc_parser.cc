@@ -16,6 +16,10 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <dirent.h>
+#include <limits.h>
+#include <unistd.h>
+
 #include <fstream>
 #include <limits>
 #include <string>
@@ -650,6 +654,48 @@ Status ProcParser::ReadProcPIDFDLink(int32_t pid, int32_t fd, std::string* out)
   return Status::OK();
 }
 
+Status ProcParser::ReadProcPIDFDLinks(int32_t pid,
+                                      absl::flat_hash_map<int32_t, std::string>* out) const {
+  std::string dir_path = absl::Substitute("$0/$1/fd", proc_base_path_, pid);
+  DIR* dir = opendir(dir_path.c_str());
+  if (dir == nullptr) {
+    return error::Internal("Could not open $0 [errno=$1]", dir_path, errno);
+  }
+  DEFER(closedir(dir));
+
+  // Resolve the links relative to the directory, to avoid a path lookup per FD.
+  const int dir_fd = dirfd(dir);
+  char buf[PATH_MAX];
+
+  out->clear();
+  while (true) {
+    // readdir() only reports errors through errno.
+    errno = 0;
+    struct dirent* entry = readdir(dir);
+    if (entry == nullptr) {
+      if (errno != 0) {
+        return error::Internal("Could not read $0 [errno=$1]", dir_path, errno);
+      }
+      break;
+    }
+
+    int32_t fd;
+    if (!absl::SimpleAtoi(entry->d_name, &fd)) {
+      // Skip "." and "..".
+      continue;
+    }
+
+    ssize_t len = readlinkat(dir_fd, entry->d_name, buf, sizeof(buf));
+    if (len < 0) {
+      // The FD was closed after the directory was read.
+      continue;
+    }
+    out->emplace(fd, std::string(buf, len));
+  }
+
+  return Status::OK();
+}
+
 std::string_view LineWithPrefix(std::string_view content, std::string_view prefix) {
   const std::vector<std::string_view> lines = absl::StrSplit(content, "\n");
   for (const auto& line : lines) {
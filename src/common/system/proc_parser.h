@@ -295,6 +295,17 @@ class ProcParser {
    */
   Status ReadProcPIDFDLink(int32_t pid, int32_t fd, std::string* out) const;
 
+  /**
+   * Reads all /proc/<pid>/fd/<fd> file descriptor links of a process, in a single pass over the
+   * directory. This is much cheaper than calling ReadProcPIDFDLink() for each FD of a process
+   * with many FDs. FDs that are closed while being read are skipped.
+   *
+   * @param pid is the pid for which we want the FD links.
+   * @param out A valid pointer to an output map of FD to FD link.
+   * @return Status of the parsing.
+   */
+  Status ReadProcPIDFDLinks(int32_t pid, absl::flat_hash_map<int32_t, std::string>* out) const;
+
   /**
    * UIDs associated with a process.
    */
@@ -37,6 +37,7 @@ using ::testing::Contains;
 using ::testing::ElementsAre;
 using ::testing::IsEmpty;
 using ::testing::MatchesRegex;
+using ::testing::Pair;
 using ::testing::Return;
 using ::testing::ReturnArg;
 using ::testing::ReturnRef;
@@ -285,6 +286,13 @@ TEST_F(ProcParserTest, read_proc_fd_link) {
 
   s = parser_->ReadProcPIDFDLink(123, 3, &out);
   EXPECT_NOT_OK(s);
+
+  absl::flat_hash_map<int32_t, std::string> links;
+  ASSERT_OK(parser_->ReadProcPIDFDLinks(123, &links));
+  EXPECT_THAT(links, UnorderedElementsAre(Pair(0, "/dev/null"), Pair(1, "/foobar"),
+                                          Pair(2, "socket:[12345]")));
+
+  EXPECT_NOT_OK(parser_->ReadProcPIDFDLinks(111, &links));
 }
 
 TEST_F(ProcParserTest, ReadUIDs) {
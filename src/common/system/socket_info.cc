@@ -78,13 +78,13 @@ NetlinkSocketProber::~NetlinkSocketProber() {
 }
 
 template <typename TDiagReqType>
-Status NetlinkSocketProber::SendDiagReq(const TDiagReqType& msg_req) {
+Status NetlinkSocketProber::SendDiagReq(const TDiagReqType& msg_req, bool dump) {
   ssize_t msg_len = sizeof(struct nlmsghdr) + sizeof(TDiagReqType);
 
   struct nlmsghdr msg_header = {};
   msg_header.nlmsg_len = msg_len;
   msg_header.nlmsg_type = SOCK_DIAG_BY_FAMILY;
-  msg_header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  msg_header.nlmsg_flags = dump ? (NLM_F_REQUEST | NLM_F_DUMP) : NLM_F_REQUEST;
 
   struct iovec iov[2];
   iov[0].iov_base = &msg_header;
@@ -116,8 +116,9 @@ Status NetlinkSocketProber::SendDiagReq(const TDiagReqType& msg_req) {
 
 namespace {
 
+template <typename TSocketInfoMap>
 Status ProcessDiagMsg(const struct inet_diag_msg& diag_msg, unsigned int len,
-                      std::map<int, SocketInfo>* socket_info_entries) {
+                      TSocketInfoMap* socket_info_entries) {
   if (len < NLMSG_LENGTH(sizeof(diag_msg))) {
     return error::Internal("Not enough bytes");
   }
@@ -159,8 +160,9 @@ Status ProcessDiagMsg(const struct inet_diag_msg& diag_msg, unsigned int len,
   return Status::OK();
 }
 
+template <typename TSocketInfoMap>
 Status ProcessDiagMsg(const struct unix_diag_msg& diag_msg, unsigned int len,
-                      std::map<int, SocketInfo>* socket_info_entries) {
+                      TSocketInfoMap* socket_info_entries) {
   if (len < NLMSG_LENGTH(sizeof(diag_msg))) {
     return error::Internal("Not enough bytes");
   }
@@ -210,8 +212,8 @@ Status ProcessDiagMsg(const struct unix_diag_msg& diag_msg, unsigned int len,
 
 }  // namespace
 
-template <typename TDiagMsgType>
-Status NetlinkSocketProber::RecvDiagResp(std::map<int, SocketInfo>* socket_info_entries) {
+template <typename TDiagMsgType, typename TSocketInfoMap>
+Status NetlinkSocketProber::RecvDiagResp(TSocketInfoMap* socket_info_entries, bool dump) {
   static constexpr int kBufSize = 8192;
   uint8_t buf[kBufSize];
 
@@ -231,7 +233,15 @@ Status NetlinkSocketProber::RecvDiagResp(std::map<int, SocketInfo>* socket_info_
       }
 
       if (msg_header->nlmsg_type == NLMSG_ERROR) {
-        return error::Internal("Netlink error");
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+        const auto* err = reinterpret_cast<const struct nlmsgerr*>(NLMSG_DATA(msg_header));
+#pragma GCC diagnostic pop
+        if (err->error == -ENOENT) {
+          // Reported by exact requests for a socket that does not exist.
+          return error::NotFound("No such socket");
+        }
+        return error::Internal("Netlink error [errno=$0]", -err->error);
       }
 
       if (msg_header->nlmsg_type != SOCK_DIAG_BY_FAMILY) {
@@ -243,6 +253,12 @@ Status NetlinkSocketProber::RecvDiagResp(std::map<int, SocketInfo>* socket_info_
       TDiagMsgType* diag_msg = reinterpret_cast<TDiagMsgType*>(NLMSG_DATA(msg_header));
 #pragma GCC diagnostic pop
       PL_RETURN_IF_ERROR(ProcessDiagMsg(*diag_msg, msg_header->nlmsg_len, socket_info_entries));
+
+      // An exact request is answered with a single message, and no NLMSG_DONE.
+      if (!dump) {
+        done = true;
+        break;
+      }
     }
   }
 
@@ -250,7 +266,8 @@ Status NetlinkSocketProber::RecvDiagResp(std::map<int, SocketInfo>* socket_info_
 }
 
 namespace {
-void ClassifySocketRoles(std::map<int, SocketInfo>* socket_info_entries) {
+template <typename TSocketInfoMap>
+void ClassifySocketRoles(TSocketInfoMap* socket_info_entries) {
   absl::flat_hash_set<SockAddrIPv4, SockAddrIPv4HashFn, SockAddrIPv4EqFn> ipv4_listening_sockets;
   absl::flat_hash_set<SockAddrIPv6, SockAddrIPv6HashFn, SockAddrIPv6EqFn> ipv6_listening_sockets;
 
@@ -302,8 +319,8 @@ void ClassifySocketRoles(std::map<int, SocketInfo>* socket_info_entries) {
 }
 }  // namespace
 
-Status NetlinkSocketProber::InetConnections(std::map<int, SocketInfo>* socket_info_entries,
-                                            int conn_states) {
+template <typename TSocketInfoMap>
+Status NetlinkSocketProber::InetConnections(TSocketInfoMap* socket_info_entries, int conn_states) {
   struct inet_diag_req_v2 msg_req = {};
   msg_req.sdiag_protocol = IPPROTO_TCP;
   msg_req.idiag_states = conn_states;
@@ -326,8 +343,8 @@ Status NetlinkSocketProber::InetConnections(std::map<int, SocketInfo>* socket_in
   return Status::OK();
 }
 
-Status NetlinkSocketProber::UnixConnections(std::map<int, SocketInfo>* socket_info_entries,
-                                            int conn_states) {
+template <typename TSocketInfoMap>
+Status NetlinkSocketProber::UnixConnections(TSocketInfoMap* socket_info_entries, int conn_states) {
   struct unix_diag_req msg_req = {};
   msg_req.sdiag_family = AF_UNIX;
   msg_req.udiag_states = conn_states;
@@ -338,6 +355,43 @@ Status NetlinkSocketProber::UnixConnections(std::map<int, SocketInfo>* socket_in
   return Status::OK();
 }
 
+template Status NetlinkSocketProber::InetConnections(std::map<int, SocketInfo>* socket_info_entries,
+                                                     int conn_states);
+template Status NetlinkSocketProber::InetConnections(SocketInfoMap* socket_info_entries,
+                                                     int conn_states);
+template Status NetlinkSocketProber::UnixConnections(std::map<int, SocketInfo>* socket_info_entries,
+                                                     int conn_states);
+template Status NetlinkSocketProber::UnixConnections(SocketInfoMap* socket_info_entries,
+                                                     int conn_states);
+
+StatusOr<SocketInfo> NetlinkSocketProber::UnixConnection(uint32_t inode_num, int conn_states) {
+  struct unix_diag_req msg_req = {};
+  msg_req.sdiag_family = AF_UNIX;
+  msg_req.udiag_states = conn_states;
+  msg_req.udiag_ino = inode_num;
+  msg_req.udiag_show = UDIAG_SHOW_PEER;
+  // Exact requests must either carry the cookie of the socket, or opt out of the cookie check.
+  msg_req.udiag_cookie[0] = INET_DIAG_NOCOOKIE;
+  msg_req.udiag_cookie[1] = INET_DIAG_NOCOOKIE;
+
+  SocketInfoMap socket_info_entries;
+  PL_RETURN_IF_ERROR(SendDiagReq(msg_req, /* dump */ false));
+  PL_RETURN_IF_ERROR(RecvDiagResp<struct unix_diag_msg>(&socket_info_entries, /* dump */ false));
+
+  auto iter = socket_info_entries.find(inode_num);
+  if (iter == socket_info_entries.end()) {
+    return error::NotFound("No Unix domain socket with inode $0", inode_num);
+  }
+
+  // Unlike dumps, the kernel ignores udiag_states for exact requests.
+  if ((conn_states & (1 << static_cast<int>(iter->second.state))) == 0) {
+    return error::NotFound("Unix domain socket with inode $0 is in state $1", inode_num,
+                           magic_enum::enum_name(iter->second.state));
+  }
+
+  return iter->second;
+}
+
 //-----------------------------------------------------------------------------
 // PIDsByNetNamespace
 //-----------------------------------------------------------------------------
@@ -468,51 +522,98 @@ StatusOr<std::unique_ptr<SocketInfoManager>> SocketInfoManager::Create(
   return socket_info_db_ptr;
 }
 
-StatusOr<std::map<int, SocketInfo>*> SocketInfoManager::GetNamespaceConns(uint32_t pid) {
-  PL_ASSIGN_OR_RETURN(uint32_t net_ns, NetNamespace(cfg_proc_path_, pid));
+StatusOr<SocketInfoManager::NamespaceConns*> SocketInfoManager::GetNamespace(uint32_t pid,
+                                                                               uint32_t* net_ns) {
+  PL_ASSIGN_OR_RETURN(*net_ns, NetNamespace(cfg_proc_path_, pid));
 
-  // Step 1: Get the map of connections for this network namespace.
-  // Create the map if it doesn't already exist.
-  std::map<int, SocketInfo>* namespace_conns;
+  NamespaceConns* namespace_conns = &connections_[*net_ns];
+  namespace_conns->access_generation = generation_;
+  return namespace_conns;
+}
 
-  auto ns_iter = connections_.find(net_ns);
-  if (ns_iter != connections_.end()) {
-    // Found a map of connections for this network namespace, so use it.
-    namespace_conns = &ns_iter->second;
-  } else {
-    // No map of connections for this network namespace, so use a socker prober to populate one.
-    PL_ASSIGN_OR_RETURN(NetlinkSocketProber * socket_prober,
-                        socket_probers_->GetOrCreateSocketProber(net_ns, {static_cast<int>(pid)}));
-    DCHECK(socket_prober != nullptr);
+void SocketInfoManager::DumpInetConns(uint32_t net_ns, NetlinkSocketProber* socket_prober,
+                                      NamespaceConns* namespace_conns) {
+  if (namespace_conns->inet_dump_generation == generation_) {
+    return;
+  }
+  namespace_conns->inet_dump_generation = generation_;
+
+  // A dump is a complete view of the IPv4/IPv6 connections of the namespace, so drop the cached
+  // entries to forget closed connections. Unix domain sockets are also dropped, since they are
+  // cheap to look up again.
+  namespace_conns->conns.clear();
+  namespace_conns->unix_dump_generation = -1;
+
+  Status s = socket_prober->InetConnections(&namespace_conns->conns, cfg_conn_states_);
+  LOG_IF(ERROR, !s.ok()) << absl::Substitute("Failed to probe InetConnections [net_ns=$0 msg=$1]",
+                                             net_ns, s.msg());
+  ++num_socket_prober_calls_;
+}
 
-    ns_iter = connections_.insert(ns_iter, {net_ns, {}});
-    namespace_conns = &ns_iter->second;
+void SocketInfoManager::DumpUnixConns(uint32_t net_ns, NetlinkSocketProber* socket_prober,
+                                      NamespaceConns* namespace_conns) {
+  if (namespace_conns->unix_dump_generation == generation_) {
+    return;
+  }
+  namespace_conns->unix_dump_generation = generation_;
 
-    Status s;
+  // Unix domain sockets found by earlier exact lookups would otherwise clobber the dump.
+  absl::erase_if(namespace_conns->conns,
+                 [](const auto& entry) { return entry.second.family == AF_UNIX; });
 
-    s = socket_prober->InetConnections(namespace_conns, cfg_conn_states_);
-    LOG_IF(ERROR, !s.ok()) << absl::Substitute("Failed to probe InetConnections [net_ns=$0 msg=$1]",
-                                               net_ns, s.msg());
+  Status s = socket_prober->UnixConnections(&namespace_conns->conns, cfg_conn_states_);
+  LOG_IF(ERROR, !s.ok()) << absl::Substitute("Failed to probe UnixConnections [net_ns=$0 msg=$1]",
+                                             net_ns, s.msg());
+  ++num_socket_prober_calls_;
+}
 
-    s = socket_prober->UnixConnections(namespace_conns, cfg_conn_states_);
-    LOG_IF(ERROR, !s.ok()) << absl::Substitute("Failed to probe UnixConnections [net_ns=$0 msg=$1]",
-                                               net_ns, s.msg());
+StatusOr<SocketInfoMap*> SocketInfoManager::GetNamespaceConns(uint32_t pid) {
+  uint32_t net_ns;
+  PL_ASSIGN_OR_RETURN(NamespaceConns * namespace_conns, GetNamespace(pid, &net_ns));
+  PL_ASSIGN_OR_RETURN(NetlinkSocketProber * socket_prober,
+                      socket_probers_->GetOrCreateSocketProber(net_ns, {static_cast<int>(pid)}));
+  DCHECK(socket_prober != nullptr);
 
-    ++num_socket_prober_calls_;
-  }
+  DumpInetConns(net_ns, socket_prober, namespace_conns);
+  DumpUnixConns(net_ns, socket_prober, namespace_conns);
 
-  return namespace_conns;
+  return &namespace_conns->conns;
 }
 
 StatusOr<SocketInfo*> SocketInfoManager::Lookup(uint32_t pid, uint32_t inode_num) {
-  // Step 1: Get the map of connections for this network namespace.
-  // Create the map if it doesn't already exist.
-  std::map<int, SocketInfo>* namespace_conns;
-  PL_ASSIGN_OR_RETURN(namespace_conns, GetNamespaceConns(pid));
-
-  // Step 2: Lookup the inode.
-  auto iter = namespace_conns->find(inode_num);
-  if (iter == namespace_conns->end()) {
+  // Step 1: Get the cached connections for this network namespace.
+  uint32_t net_ns;
+  PL_ASSIGN_OR_RETURN(NamespaceConns * namespace_conns, GetNamespace(pid, &net_ns));
+  SocketInfoMap& conns = namespace_conns->conns;
+
+  auto iter = conns.find(inode_num);
+  if (iter != conns.end()) {
+    return &iter->second;
+  }
+
+  // Step 2: On a miss, ask the kernel.
+  PL_ASSIGN_OR_RETURN(NetlinkSocketProber * socket_prober,
+                      socket_probers_->GetOrCreateSocketProber(net_ns, {static_cast<int>(pid)}));
+  DCHECK(socket_prober != nullptr);
+
+  // Step 2a: Unix domain sockets can be looked up by inode directly.
+  StatusOr<SocketInfo> unix_socket_info =
+      socket_prober->UnixConnection(inode_num, cfg_conn_states_);
+  ++num_socket_prober_calls_;
+  if (unix_socket_info.ok()) {
+    iter = conns.insert({inode_num, unix_socket_info.ConsumeValueOrDie()}).first;
+    return &iter->second;
+  }
+  LOG_IF(ERROR, !error::IsNotFound(unix_socket_info.status()))
+      << absl::Substitute("Failed to probe UnixConnection [net_ns=$0 msg=$1]", net_ns,
+                          unix_socket_info.msg());
+
+  // Step 2b: The IPv4/IPv6 diag interface cannot filter by inode, so refresh the dump of the
+  // namespace, at most once per generation.
+  DumpInetConns(net_ns, socket_prober, namespace_conns);
+
+  iter = conns.find(inode_num);
+  if (iter == conns.end()) {
     return error::NotFound(
         "Likely not a TCP/Unix connection (might be some other socket type). Alternatively, might "
         "be looking in the wrong net namespace, which can happen if the target PID has connections "
@@ -524,7 +625,13 @@ StatusOr<SocketInfo*> SocketInfoManager::Lookup(uint32_t pid, uint32_t inode_num
 
 void SocketInfoManager::Flush() {
   socket_probers_->Update();
-  connections_.clear();
+
+  // Drop the namespaces that were not accessed during the last generation.
+  absl::erase_if(connections_, [this](const auto& entry) {
+    return entry.second.access_generation < generation_;
+  });
+
+  ++generation_;
   num_socket_prober_calls_ = 0;
 }
 
@@ -27,6 +27,8 @@
 #include <utility>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
+
 #include "src/common/fs/fs_wrapper.h"
 #include "src/common/fs/inode_utils.h"
 
@@ -83,6 +85,9 @@ struct SocketInfo {
   ClientServerRole role = ClientServerRole::kUnknown;
 };
 
+// Map of socket inode number to socket information.
+using SocketInfoMap = absl::flat_hash_map<int, SocketInfo>;
+
 /**
  * The NetlinkSocketProber class uses NetLink to probe the Linux kernel about active connections.
  */
@@ -114,7 +119,8 @@ class NetlinkSocketProber {
    *
    * @return error if connection information could not be obtained from kernel.
    */
-  Status InetConnections(std::map<int, SocketInfo>* socket_info_entries,
+  template <typename TSocketInfoMap>
+  Status InetConnections(TSocketInfoMap* socket_info_entries,
                          int conn_states = kTCPEstablishedState);
 
   /**
@@ -126,19 +132,35 @@ class NetlinkSocketProber {
    *
    * @return error if connection information could not be obtained from kernel.
    */
-  Status UnixConnections(std::map<int, SocketInfo>* socket_info_entries,
+  template <typename TSocketInfoMap>
+  Status UnixConnections(TSocketInfoMap* socket_info_entries,
                          int conn_states = kTCPEstablishedState);
 
+  /**
+   * Finds a single Unix domain socket by its inode number. Unlike UnixConnections(), this sends an
+   * exact request for the inode, so the cost does not depend on the number of sockets in the
+   * network namespace.
+   *
+   * @param inode_num The inode number of the socket.
+   * @param conn_states bit vector of connection states to accept.
+   *
+   * @return the socket information, NotFound if there is no such Unix domain socket in the
+   * namespace or it is not in one of conn_states, or error if the kernel could not be queried.
+   */
+  StatusOr<SocketInfo> UnixConnection(uint32_t inode_num, int conn_states = kTCPEstablishedState);
+
  private:
   NetlinkSocketProber() = default;
 
   Status Connect();
 
+  // If dump is false, the request is for a single socket identified by the request.
   template <typename TDiagReqType>
-  Status SendDiagReq(const TDiagReqType& msg_req);
+  Status SendDiagReq(const TDiagReqType& msg_req, bool dump = true);
 
-  template <typename TDiagMsgType>
-  Status RecvDiagResp(std::map<int, SocketInfo>* socket_info_entries);
+  // If dump is false, returns after the first socket, instead of waiting for the end of a dump.
+  template <typename TDiagMsgType, typename TSocketInfoMap>
+  Status RecvDiagResp(TSocketInfoMap* socket_info_entries, bool dump = true);
 
   int fd_ = -1;
 };
@@ -247,13 +269,16 @@ class SocketProberManager {
  *
  * There is a primary Lookup interface to query for information on a socket, by inode number.
  *
- * SocketInfoManager manages its cache at the network namespace level. If a query is made to a new
- * network namespace, the information is gathered and then cached. Future queries will operate off
- * that snapshot of the known connections, for efficiency.
- *
- * Note that no attempt is made to check if new connections have been created after the snapshot is
- * established. This responsibility is on the user, who must explicitly call Flush(), so that new
- * connections can be discovered.
+ * SocketInfoManager manages its cache at the network namespace level, and the cache persists
+ * across calls to Flush(). This is safe because the endpoints of a socket never change while its
+ * inode number is in use. Flush() starts a new generation, which bounds how often the kernel is
+ * queried:
+ *  - A lookup that misses the cache first tries an exact request for a Unix domain socket with
+ *    that inode number, which is cheap regardless of the number of sockets.
+ *  - Otherwise, the IPv4/IPv6 connections of the namespace are dumped, replacing the cached
+ *    entries of the namespace. This happens at most once per namespace per generation, so all
+ *    lookups that miss within a generation share a single dump.
+ * Namespaces that were not accessed during the last generation are dropped on Flush().
  */
 class SocketInfoManager {
  public:
@@ -269,13 +294,14 @@ class SocketInfoManager {
       std::filesystem::path proc_path, int conn_states = kTCPEstablishedState);
 
   /**
-   * Return all socket info for a given network namespace.
+   * Return all socket info for a given network namespace. This always dumps all sockets of the
+   * namespace once per generation, so it should be avoided on hot paths.
    *
    * @param pid The PID used to determine the network namespace.
    * @return A map with inode number as key, and socket information as value. Returns error if
    * information could not be queried.
    */
-  StatusOr<std::map<int, system::SocketInfo>*> GetNamespaceConns(uint32_t pid);
+  StatusOr<SocketInfoMap*> GetNamespaceConns(uint32_t pid);
 
   /**
    * Search for the socket info of a given inode number.
@@ -283,12 +309,13 @@ class SocketInfoManager {
    * @param pid The PID owning the connection. Used to determine the network namespace.
    * @param inode_num The inode number of the local socket.
    * @return Information for socket, including remote endpoint information. Returns error if
-   * information could not be queried.
+   * information could not be queried. The pointer is only valid until the next call to this
+   * SocketInfoManager.
    */
   StatusOr<SocketInfo*> Lookup(uint32_t pid, uint32_t inode_num);
 
   /**
-   * Flushes the cache so new connections can be discovered.
+   * Starts a new generation, so that connections created since the last dump can be discovered.
    */
   void Flush();
 
@@ -303,6 +330,21 @@ class SocketInfoManager {
   SocketInfoManager(std::filesystem::path proc_path, int conn_states)
       : cfg_proc_path_(proc_path), cfg_conn_states_(conn_states) {}
 
+  struct NamespaceConns {
+    SocketInfoMap conns;
+    // The generation in which the IPv4/IPv6 and Unix domain sockets were last dumped.
+    int64_t inet_dump_generation = -1;
+    int64_t unix_dump_generation = -1;
+    // The generation in which this namespace was last accessed.
+    int64_t access_generation = -1;
+  };
+
+  StatusOr<NamespaceConns*> GetNamespace(uint32_t pid, uint32_t* net_ns);
+  void DumpInetConns(uint32_t net_ns, NetlinkSocketProber* socket_prober,
+                     NamespaceConns* namespace_conns);
+  void DumpUnixConns(uint32_t net_ns, NetlinkSocketProber* socket_prober,
+                     NamespaceConns* namespace_conns);
+
   const std::filesystem::path cfg_proc_path_;
 
   // The connection states that are considered this SocketInfoManager.
@@ -310,9 +352,11 @@ class SocketInfoManager {
   // See connection states at the top of this file.
   const int cfg_conn_states_;
 
-  // Two-level to socket information:
-  // First key is namespace inode; second key is socket inode.
-  std::map<int, std::map<int, SocketInfo>> connections_;
+  // Socket information, keyed by network namespace inode.
+  absl::flat_hash_map<uint32_t, NamespaceConns> connections_;
+
+  // Incremented by every call to Flush().
+  int64_t generation_ = 0;
 
   // Portal through which new connection information is gathered,
   // and populated into connections_.
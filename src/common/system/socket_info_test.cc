@@ -143,6 +143,28 @@ TEST(NetlinkSocketProberTest, EstablishedUnixConnection) {
   EXPECT_THAT(socket_info_entries, Contains(HasLocalUnixEndpoint(client_socket_id)));
   EXPECT_THAT(socket_info_entries, Contains(HasLocalUnixEndpoint(server_socket_id)));
 
+  // Exact lookups by inode should agree with the dump.
+  ASSERT_OK_AND_ASSIGN(uint32_t client_inode,
+                       fs::ExtractInodeNum(fs::kSocketInodePrefix, client_socket_id));
+  ASSERT_OK_AND_ASSIGN(uint32_t server_inode,
+                       fs::ExtractInodeNum(fs::kSocketInodePrefix, server_socket_id));
+  ASSERT_OK_AND_ASSIGN(SocketInfo client_info, socket_prober->UnixConnection(client_inode));
+  EXPECT_EQ(client_info.family, AF_UNIX);
+  EXPECT_EQ(client_info.local_port, client_inode);
+  EXPECT_EQ(client_info.remote_port, server_inode);
+  EXPECT_EQ(client_info.state, TCPConnState::kEstablished);
+
+  // 3 is very unlikely to be used as an inode number.
+  EXPECT_TRUE(error::IsNotFound(socket_prober->UnixConnection(3).status()));
+
+  // The listening socket is not in the established state.
+  std::string listen_socket_id;
+  ASSERT_OK(proc_parser->ReadProcPIDFDLink(getpid(), server_listen_fd, &listen_socket_id));
+  ASSERT_OK_AND_ASSIGN(uint32_t listen_inode,
+                       fs::ExtractInodeNum(fs::kSocketInodePrefix, listen_socket_id));
+  EXPECT_TRUE(error::IsNotFound(socket_prober->UnixConnection(listen_inode).status()));
+  EXPECT_OK(socket_prober->UnixConnection(listen_inode, kTCPListeningState));
+
   close(client_fd);
   close(server_accept_fd);
   close(server_listen_fd);
@@ -110,7 +110,7 @@ int main(int argc, char** argv) {
   if (fd == -1) {
     std::cout << absl::Substitute("Querying network namespace of pid=$0 (all connections):", pid)
               << std::endl;
-    std::map<int, SocketInfo>* namespace_conns;
+    SocketInfoMap* namespace_conns;
     PL_ASSIGN_OR_EXIT(namespace_conns, socket_info_db->GetNamespaceConns(pid));
 
     int i = 0;
@@ -17,6 +17,7 @@
  */
 
 #include <zlib.h>
+#include <algorithm>
 #include <string>
 
 #include "src/common/base/base.h"
@@ -60,5 +61,125 @@ StatusOr<std::string> Inflate(std::string_view in, size_t output_block_size) {
   return out;
 }
 
+namespace {
+
+int WindowBits(CompressionFormat format) {
+  switch (format) {
+    case CompressionFormat::kGzip:
+      return MAX_WBITS + 16;
+    case CompressionFormat::kZlib:
+      return MAX_WBITS;
+    case CompressionFormat::kRawDeflate:
+      return -MAX_WBITS;
+  }
+  return MAX_WBITS + 16;
+}
+
+const char* ErrorMsg(const z_stream& zs) { return zs.msg != nullptr ? zs.msg : "unknown error"; }
+
+// Owns a z_stream for inflating, which is initialized on first use and reset afterwards.
+class ReusableInflateStream {
+ public:
+  ~ReusableInflateStream() {
+    if (initialized_) {
+      inflateEnd(&zs_);
+    }
+  }
+
+  StatusOr<z_stream*> Reset(int window_bits) {
+    if (!initialized_) {
+      if (inflateInit2(&zs_, window_bits) != Z_OK) {
+        return error::Internal("inflateInit2 failed while decompressing.");
+      }
+      initialized_ = true;
+    } else if (inflateReset2(&zs_, window_bits) != Z_OK) {
+      return error::Internal("inflateReset2 failed while decompressing.");
+    }
+    return &zs_;
+  }
+
+ private:
+  z_stream zs_ = {};
+  bool initialized_ = false;
+};
+
+}  // namespace
+
+StatusOr<BoundedInflateResult> InflateBounded(std::string_view in, size_t max_output_bytes,
+                                              CompressionFormat format) {
+  constexpr size_t kOutputBlockSize = 16384;
+
+  thread_local ReusableInflateStream stream;
+  PL_ASSIGN_OR_RETURN(z_stream * zs, stream.Reset(WindowBits(format)));
+
+  zs->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+  zs->avail_in = in.size();
+
+  BoundedInflateResult result;
+  std::string& out = result.data;
+
+  int ret = Z_OK;
+  while (zs->total_out < max_output_bytes) {
+    if (out.size() == zs->total_out) {
+      out.resize(std::min(max_output_bytes, out.size() + kOutputBlockSize));
+    }
+    zs->next_out = reinterpret_cast<Bytef*>(out.data() + zs->total_out);
+    zs->avail_out = out.size() - zs->total_out;
+
+    ret = inflate(zs, Z_NO_FLUSH);
+    if (ret != Z_OK) {
+      break;
+    }
+  }
+  out.resize(zs->total_out);
+
+  switch (ret) {
+    case Z_STREAM_END:
+      break;
+    case Z_OK:
+      // Stopped at the output budget.
+      result.truncated = true;
+      break;
+    case Z_BUF_ERROR:
+      // No progress was possible. This is only expected if all of the input was consumed.
+      if (zs->avail_in != 0) {
+        return error::Internal("Exception during zlib decompression: $0", ErrorMsg(*zs));
+      }
+      result.truncated = true;
+      break;
+    default:
+      return error::Internal("Exception during zlib decompression: $0", ErrorMsg(*zs));
+  }
+
+  return result;
+}
+
+StatusOr<std::string> Deflate(std::string_view in, CompressionFormat format) {
+  z_stream zs = {};
+
+  constexpr int kMemLevel = 8;
+  if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, WindowBits(format), kMemLevel,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    return error::Internal("deflateInit2 failed while compressing.");
+  }
+
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+  zs.avail_in = in.size();
+
+  std::string out(deflateBound(&zs, in.size()), '\0');
+  zs.next_out = reinterpret_cast<Bytef*>(out.data());
+  zs.avail_out = out.size();
+
+  int ret = deflate(&zs, Z_FINISH);
+  out.resize(zs.total_out);
+
+  deflateEnd(&zs);
+
+  if (ret != Z_STREAM_END) {
+    return error::Internal("Exception during zlib compression: $0", ErrorMsg(zs));
+  }
+  return out;
+}
+
 }  // namespace zlib
 }  // namespace px
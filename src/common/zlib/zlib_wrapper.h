@@ -19,6 +19,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "src/common/base/statusor.h"
 
@@ -35,5 +36,45 @@ namespace zlib {
  */
 StatusOr<std::string> Inflate(std::string_view in, size_t output_block_size = 16384);
 
+enum class CompressionFormat {
+  // gzip wrapper (RFC 1952), as used by Content-Encoding: gzip.
+  kGzip,
+  // zlib wrapper (RFC 1950), as specified for Content-Encoding: deflate.
+  kZlib,
+  // Raw deflate stream (RFC 1951), which some servers send for Content-Encoding: deflate.
+  kRawDeflate,
+};
+
+struct BoundedInflateResult {
+  std::string data;
+  // True if decompression stopped at the output budget, or if the input ended before the end of
+  // the compressed stream (e.g. because the body was truncated when it was captured).
+  bool truncated = false;
+};
+
+/**
+ * @brief Inflates at most max_output_bytes of a compressed buffer.
+ *
+ * Unlike Inflate(), decompression stops as soon as max_output_bytes have been produced, so callers
+ * that only keep a prefix of the content never pay for inflating the rest. Input that ends before
+ * the end of the compressed stream is not an error; the bytes decoded so far are returned.
+ *
+ * The underlying z_stream is kept per thread and reset between calls, instead of having zlib
+ * allocate and free its state and window on every call.
+ *
+ * @param in A view into the compressed buffer.
+ * @param max_output_bytes The maximum number of decompressed bytes to return.
+ * @param format The format of the compressed buffer.
+ * @return Status or the decompressed prefix of the content.
+ */
+StatusOr<BoundedInflateResult> InflateBounded(std::string_view in, size_t max_output_bytes,
+                                              CompressionFormat format = CompressionFormat::kGzip);
+
+/**
+ * @brief Compresses a buffer. Mainly used to produce input for tests and benchmarks.
+ */
+StatusOr<std::string> Deflate(std::string_view in,
+                              CompressionFormat format = CompressionFormat::kGzip);
+
 }  // namespace zlib
 }  // namespace px
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <string>
+
+#include "src/common/base/base.h"
+#include "src/common/zlib/zlib_wrapper.h"
+
+namespace px {
+namespace zlib {
+
+// Returns a JSON array of objects, roughly resembling an API response body.
+std::string MakeJSONPayload(int num_items) {
+  std::string out = "[";
+  for (int i = 0; i < num_items; ++i) {
+    absl::StrAppend(&out, i == 0 ? "" : ",", R"({"id":)", i,
+                    R"(,"name":"service-)", i % 17, R"(","status":"RUNNING","labels":{"app":")",
+                    "frontend-", i % 5, R"(","tier":"web"},"restarts":)", i % 3, "}");
+  }
+  out.append("]");
+  return out;
+}
+
+// Decompresses the whole body, then keeps only the prefix that fits in the table column.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_InflateFullThenTruncate(benchmark::State& state) {
+  constexpr size_t kMaxBodyBytes = 1024;
+  std::string compressed = Deflate(MakeJSONPayload(state.range(0))).ConsumeValueOrDie();
+
+  for (auto _ : state) {
+    std::string body = Inflate(compressed).ConsumeValueOrDie();
+    body.resize(std::min(body.size(), kMaxBodyBytes));
+    benchmark::DoNotOptimize(body);
+  }
+  state.counters["compressed_bytes"] = compressed.size();
+  state.SetBytesProcessed(state.iterations() * compressed.size());
+}
+
+// Decompresses only the prefix that fits in the table column.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_InflateBounded(benchmark::State& state) {
+  constexpr size_t kMaxBodyBytes = 1024;
+  std::string compressed = Deflate(MakeJSONPayload(state.range(0))).ConsumeValueOrDie();
+
+  for (auto _ : state) {
+    BoundedInflateResult result = InflateBounded(compressed, kMaxBodyBytes).ConsumeValueOrDie();
+    benchmark::DoNotOptimize(result);
+  }
+  state.counters["compressed_bytes"] = compressed.size();
+  state.SetBytesProcessed(state.iterations() * compressed.size());
+}
+
+// Number of items in the payload. 10000 items is a ~1MB response, ~40KB when gzipped.
+BENCHMARK(BM_InflateFullThenTruncate)->Arg(10)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_InflateBounded)->Arg(10)->Arg(1000)->Arg(10000);
+
+}  // namespace zlib
+}  // namespace px
@@ -46,4 +46,53 @@ TEST_F(ZlibTest, inflate_test) {
   EXPECT_OK_AND_EQ(result, GetExpectedResult());
 }
 
+TEST_F(ZlibTest, inflate_bounded_complete) {
+  ASSERT_OK_AND_ASSIGN(zlib::BoundedInflateResult result,
+                       zlib::InflateBounded(GetCompressedString(), 1024));
+  EXPECT_EQ(result.data, GetExpectedResult());
+  EXPECT_FALSE(result.truncated);
+}
+
+TEST_F(ZlibTest, inflate_bounded_stops_at_budget) {
+  std::string content;
+  for (int i = 0; i < 10000; ++i) {
+    absl::StrAppend(&content, R"({"id":)", i, R"(,"name":"item"},)");
+  }
+
+  for (auto format : {zlib::CompressionFormat::kGzip, zlib::CompressionFormat::kZlib,
+                      zlib::CompressionFormat::kRawDeflate}) {
+    ASSERT_OK_AND_ASSIGN(std::string compressed, zlib::Deflate(content, format));
+    ASSERT_OK_AND_ASSIGN(zlib::BoundedInflateResult result,
+                         zlib::InflateBounded(compressed, 100, format));
+    EXPECT_EQ(result.data, content.substr(0, 100));
+    EXPECT_TRUE(result.truncated);
+
+    // The reused stream must not leak state from the previous call.
+    ASSERT_OK_AND_ASSIGN(result, zlib::InflateBounded(compressed, content.size() + 1, format));
+    EXPECT_EQ(result.data, content);
+    EXPECT_FALSE(result.truncated);
+  }
+}
+
+TEST_F(ZlibTest, inflate_bounded_truncated_input) {
+  std::string content;
+  for (int i = 0; i < 1000; ++i) {
+    absl::StrAppend(&content, i, ",");
+  }
+  ASSERT_OK_AND_ASSIGN(std::string compressed, zlib::Deflate(content));
+
+  ASSERT_OK_AND_ASSIGN(zlib::BoundedInflateResult result,
+                       zlib::InflateBounded(compressed.substr(0, compressed.size() / 2), 4096));
+  EXPECT_TRUE(result.truncated);
+  EXPECT_EQ(result.data, content.substr(0, result.data.size()));
+}
+
+TEST_F(ZlibTest, inflate_bounded_invalid_input) {
+  EXPECT_NOT_OK(zlib::InflateBounded("not compressed", 1024));
+  // A zlib stream is not a valid gzip stream.
+  ASSERT_OK_AND_ASSIGN(std::string compressed,
+                       zlib::Deflate("abc", zlib::CompressionFormat::kZlib));
+  EXPECT_NOT_OK(zlib::InflateBounded(compressed, 1024, zlib::CompressionFormat::kGzip));
+}
+
 }  // namespace px
@@ -17,6 +17,7 @@
  */
 
 #include <math.h>
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -31,6 +32,22 @@ PL_SUPPRESS_WARNINGS_END()
 namespace px {
 namespace bloomfilter {
 
+namespace {
+
+// The number of items that ContainsMany hashes before probing the filter for them. Hashing a
+// chunk of items up front lets the loads of the probes be issued together, instead of each one
+// waiting on the previous item's hash.
+constexpr size_t kProbeChunkSize = 64;
+
+// Computes the bits per entry and number of hashes that meet the error rate.
+// From Wikipedia: https://en.wikipedia.org/wiki/Bloom_filter
+// bits per entry = ln(error_rate)/ln(2)^2, num hashes = ln(2) * bits per entry.
+double BitsPerEntry(double error_rate) {
+  return -(std::log(error_rate) / std::pow(std::log(2), 2));
+}
+
+}  // namespace
+
 StatusOr<std::unique_ptr<XXHash64BloomFilter>> XXHash64BloomFilter::Create(int64_t max_entries,
                                                                            double error_rate) {
   if (error_rate <= 0.0 || error_rate >= 1.0) {
@@ -42,13 +59,10 @@ StatusOr<std::unique_ptr<XXHash64BloomFilter>> XXHash64BloomFilter::Create(int64
                            max_entries);
   }
 
-  // From Wikipedia: https://en.wikipedia.org/wiki/Bloom_filter
-  // bits per entry = ln(error_rate)/ln(2)^2
-  double bpe = -(std::log(error_rate) / std::pow(std::log(2), 2));
+  double bpe = BitsPerEntry(error_rate);
   int64_t num_bits = static_cast<int64_t>(std::ceil(max_entries * bpe));
   int64_t num_bytes = (num_bits / 8) + ((num_bits % 8) ? 1 : 0);
 
-  // num hashes = ln(2) * bpe
   int32_t num_hashes = static_cast<int32_t>(std::ceil(std::log(2) * bpe));
 
   return std::unique_ptr<XXHash64BloomFilter>(new XXHash64BloomFilter(num_bytes, num_hashes));
@@ -69,7 +83,7 @@ StatusOr<std::unique_ptr<XXHash64BloomFilter>> XXHash64BloomFilter::FromProto(
   return std::unique_ptr<XXHash64BloomFilter>(new XXHash64BloomFilter(data, pb.num_hashes()));
 }
 
-XXHash64BloomFilterPB XXHash64BloomFilter::ToProto() {
+XXHash64BloomFilterPB XXHash64BloomFilter::ToProto() const {
   XXHash64BloomFilterPB output;
   output.set_num_hashes(num_hashes_);
   std::string bytes_str{buffer_.begin(), buffer_.end()};
@@ -116,5 +130,121 @@ bool XXHash64BloomFilter::Contains(std::string_view item) const {
   return true;
 }
 
+int64_t XXHash64BloomFilter::ContainsMany(absl::Span<const std::string_view> items,
+                                          std::vector<uint8_t>* results) const {
+  results->resize(items.size());
+  uint64_t num_bits = buffer_.size() << 3;
+  uint64_t a[kProbeChunkSize];
+  uint64_t b[kProbeChunkSize];
+  int64_t num_contained = 0;
+
+  for (size_t start = 0; start < items.size(); start += kProbeChunkSize) {
+    size_t chunk_size = std::min(kProbeChunkSize, items.size() - start);
+    for (size_t i = 0; i < chunk_size; ++i) {
+      const auto& item = items[start + i];
+      a[i] = XXH64(item.data(), item.size(), seed_);
+      b[i] = XXH64(item.data(), item.size(), a[i]);
+      __builtin_prefetch(&buffer_[(a[i] % num_bits) >> 3]);
+    }
+    for (size_t i = 0; i < chunk_size; ++i) {
+      bool contained = true;
+      for (auto h = 0; h < num_hashes_ && contained; ++h) {
+        absl::uint128 x = a[i] + h * b[i];
+        contained = HasBitSet(static_cast<int>(x % num_bits));
+      }
+      (*results)[start + i] = contained;
+      num_contained += contained;
+    }
+  }
+  return num_contained;
+}
+
+StatusOr<std::unique_ptr<BlockedBloomFilter>> BlockedBloomFilter::Create(int64_t max_entries,
+                                                                         double error_rate) {
+  if (error_rate <= 0.0 || error_rate >= 1.0) {
+    return error::Internal(
+        "Bloom filter error rate must be greater than 0 and less than 1, received %e", error_rate);
+  }
+  if (max_entries <= 0) {
+    return error::Internal("Bloom filter must have a maximum of at least 1 entry, received %d",
+                           max_entries);
+  }
+
+  double bpe = BitsPerEntry(error_rate);
+  int64_t num_bits = static_cast<int64_t>(std::ceil(max_entries * bpe));
+  int64_t num_blocks = (num_bits + kBitsPerBlock - 1) / kBitsPerBlock;
+  int32_t num_hashes = static_cast<int32_t>(std::ceil(std::log(2) * bpe));
+
+  return std::unique_ptr<BlockedBloomFilter>(new BlockedBloomFilter(num_blocks, num_hashes));
+}
+
+uint64_t BlockedBloomFilter::Hash(std::string_view item) const {
+  return XXH64(item.data(), item.size(), seed_);
+}
+
+size_t BlockedBloomFilter::BlockIndex(uint64_t hash) const {
+  // Maps the hash onto [0, num_blocks) without a division.
+  return static_cast<size_t>((absl::uint128(hash) * blocks_.size()) >> 64);
+}
+
+void BlockedBloomFilter::Mask(uint64_t hash, uint64_t mask[kWordsPerBlock]) const {
+  // BlockIndex uses the high bits of the hash, so remix it before deriving the bits in the block.
+  uint64_t mixed = hash * 0x9e3779b97f4a7c15ULL;
+  uint32_t a = static_cast<uint32_t>(mixed >> 32);
+  uint32_t b = static_cast<uint32_t>(mixed) | 1;
+  for (int w = 0; w < kWordsPerBlock; ++w) {
+    mask[w] = 0;
+  }
+  for (int i = 0; i < num_hashes_; ++i) {
+    uint32_t bit = (a + i * b) & (kBitsPerBlock - 1);
+    mask[bit >> 6] |= uint64_t{1} << (bit & 63);
+  }
+}
+
+bool BlockedBloomFilter::BlockContains(uint64_t hash) const {
+  uint64_t mask[kWordsPerBlock];
+  Mask(hash, mask);
+  const Block& block = blocks_[BlockIndex(hash)];
+  // Branchless over the words of the block, so that the comparison is vectorized.
+  uint64_t missing = 0;
+  for (int w = 0; w < kWordsPerBlock; ++w) {
+    missing |= mask[w] & ~block.words[w];
+  }
+  return missing == 0;
+}
+
+void BlockedBloomFilter::Insert(std::string_view item) {
+  uint64_t hash = Hash(item);
+  uint64_t mask[kWordsPerBlock];
+  Mask(hash, mask);
+  Block& block = blocks_[BlockIndex(hash)];
+  for (int w = 0; w < kWordsPerBlock; ++w) {
+    block.words[w] |= mask[w];
+  }
+}
+
+bool BlockedBloomFilter::Contains(std::string_view item) const { return BlockContains(Hash(item)); }
+
+int64_t BlockedBloomFilter::ContainsMany(absl::Span<const std::string_view> items,
+                                         std::vector<uint8_t>* results) const {
+  results->resize(items.size());
+  uint64_t hashes[kProbeChunkSize];
+  int64_t num_contained = 0;
+
+  for (size_t start = 0; start < items.size(); start += kProbeChunkSize) {
+    size_t chunk_size = std::min(kProbeChunkSize, items.size() - start);
+    for (size_t i = 0; i < chunk_size; ++i) {
+      hashes[i] = Hash(items[start + i]);
+      __builtin_prefetch(&blocks_[BlockIndex(hashes[i])]);
+    }
+    for (size_t i = 0; i < chunk_size; ++i) {
+      bool contained = BlockContains(hashes[i]);
+      (*results)[start + i] = contained;
+      num_contained += contained;
+    }
+  }
+  return num_contained;
+}
+
 }  // namespace bloomfilter
 }  // namespace px
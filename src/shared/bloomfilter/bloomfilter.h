@@ -21,8 +21,11 @@
 #include <math.h>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include <absl/types/span.h>
+
 #include "src/common/base/base.h"
 #include "src/shared/bloomfilterpb/bloomfilter.pb.h"
 
@@ -40,7 +43,7 @@ class XXHash64BloomFilter {
   static StatusOr<std::unique_ptr<XXHash64BloomFilter>> Create(int64_t max_entries,
                                                                double error_rate);
   static StatusOr<std::unique_ptr<XXHash64BloomFilter>> FromProto(const XXHash64BloomFilterPB& pb);
-  XXHash64BloomFilterPB ToProto();
+  XXHash64BloomFilterPB ToProto() const;
 
   /**
    * Insert inserts an item into the bloom filter.
@@ -55,6 +58,17 @@ class XXHash64BloomFilter {
   bool Contains(std::string_view item) const;
   bool Contains(const std::string& item) const { return Contains(std::string_view(item)); }
 
+  /**
+   * ContainsMany checks for the presence of each of the items, hashing them all before probing
+   * the filter.
+   * @param items The items to check.
+   * @param results Resized to the number of items, and set to 1 for each item that may be present
+   * and 0 for those that are not.
+   * @return the number of items that may be present.
+   */
+  int64_t ContainsMany(absl::Span<const std::string_view> items,
+                       std::vector<uint8_t>* results) const;
+
   /**
    * Get the buffer size in bytes of the bloom filter.
    */
@@ -81,5 +95,59 @@ class XXHash64BloomFilter {
   const uint64_t seed_ = 3091990;
 };
 
+/**
+ * BlockedBloomFilter is a cache-line-blocked bloom filter: each item hashes to a single 64 byte
+ * block, and all of its bits are set within that block. A lookup therefore touches one cache line
+ * instead of num_hashes scattered ones, and checks all of the bits with a fixed-width mask
+ * comparison over the block's words, which the compiler vectorizes.
+ *
+ * This comes at the cost of a slightly higher false positive rate than XXHash64BloomFilter for the
+ * same size. The layout is not compatible with XXHash64BloomFilter, so this filter is meant for
+ * use within a process (for example for scan-time pruning), and has no proto representation.
+ */
+class BlockedBloomFilter {
+ public:
+  /**
+   * Create creates a bloom filter which is sized to meet the criteria for maximum number of
+   * entries and the false positive error rate.
+   */
+  static StatusOr<std::unique_ptr<BlockedBloomFilter>> Create(int64_t max_entries,
+                                                              double error_rate);
+
+  void Insert(std::string_view item);
+  bool Contains(std::string_view item) const;
+
+  /**
+   * ContainsMany checks for the presence of each of the items, see
+   * XXHash64BloomFilter::ContainsMany.
+   */
+  int64_t ContainsMany(absl::Span<const std::string_view> items,
+                       std::vector<uint8_t>* results) const;
+
+  size_t buffer_size_bytes() const { return blocks_.size() * sizeof(Block); }
+  int num_hashes() const { return num_hashes_; }
+
+ private:
+  static constexpr int kWordsPerBlock = 8;
+  static constexpr int kBitsPerBlock = kWordsPerBlock * 64;
+
+  struct alignas(64) Block {
+    uint64_t words[kWordsPerBlock] = {};
+  };
+
+  BlockedBloomFilter(int64_t num_blocks, int num_hashes)
+      : num_hashes_(num_hashes), blocks_(num_blocks) {}
+
+  uint64_t Hash(std::string_view item) const;
+  size_t BlockIndex(uint64_t hash) const;
+  // Computes the bits of the hash within its block.
+  void Mask(uint64_t hash, uint64_t mask[kWordsPerBlock]) const;
+  bool BlockContains(uint64_t hash) const;
+
+  const int num_hashes_;
+  std::vector<Block> blocks_;
+  const uint64_t seed_ = 3091990;
+};
+
 }  // namespace bloomfilter
 }  // namespace px
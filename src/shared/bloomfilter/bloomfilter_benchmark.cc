@@ -21,6 +21,7 @@
 #include <absl/container/flat_hash_map.h>
 #include <map>
 #include <random>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -37,17 +38,24 @@ class BloomFilterBenchmark : public benchmark::Fixture {
     auto strlen = state.range(2);
     insert_bf_ = XXHash64BloomFilter::Create(num_items * 2, error_rate).ConsumeValueOrDie();
     lookup_bf_ = XXHash64BloomFilter::Create(num_items * 2, error_rate).ConsumeValueOrDie();
+    blocked_insert_bf_ = BlockedBloomFilter::Create(num_items * 2, error_rate).ConsumeValueOrDie();
+    blocked_lookup_bf_ = BlockedBloomFilter::Create(num_items * 2, error_rate).ConsumeValueOrDie();
     random_strs_.reserve(num_items);
     for (auto i = 0; i < num_items; ++i) {
       random_strs_.push_back(datagen::RandomString(strlen));
       lookup_bf_->Insert(random_strs_[i]);
+      blocked_lookup_bf_->Insert(random_strs_[i]);
     }
+    random_str_views_.assign(random_strs_.begin(), random_strs_.end());
   }
 
  protected:
   std::vector<std::string> random_strs_;
   std::unique_ptr<XXHash64BloomFilter> insert_bf_;
   std::unique_ptr<XXHash64BloomFilter> lookup_bf_;
+  std::vector<std::string_view> random_str_views_;
+  std::unique_ptr<BlockedBloomFilter> blocked_insert_bf_;
+  std::unique_ptr<BlockedBloomFilter> blocked_lookup_bf_;
 };
 
 // NOLINTNEXTLINE : runtime/references.
@@ -74,10 +82,62 @@ BENCHMARK_DEFINE_F(BloomFilterBenchmark, LookupTest)(benchmark::State& state) {
   state.SetItemsProcessed(state.iterations() * random_strs_.size());
 }
 
+// NOLINTNEXTLINE : runtime/references.
+BENCHMARK_DEFINE_F(BloomFilterBenchmark, LookupManyTest)(benchmark::State& state) {
+  std::vector<uint8_t> results;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lookup_bf_->ContainsMany(random_str_views_, &results));
+  }
+  state.SetBytesProcessed(state.iterations() * random_strs_.size() * random_strs_[0].size());
+  state.SetItemsProcessed(state.iterations() * random_strs_.size());
+}
+
+// NOLINTNEXTLINE : runtime/references.
+BENCHMARK_DEFINE_F(BloomFilterBenchmark, BlockedInsertTest)(benchmark::State& state) {
+  for (auto _ : state) {
+    for (const auto& random_str : random_strs_) {
+      blocked_insert_bf_->Insert(random_str);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * random_strs_.size() * random_strs_[0].size());
+  state.SetItemsProcessed(state.iterations() * random_strs_.size());
+}
+
+// NOLINTNEXTLINE : runtime/references.
+BENCHMARK_DEFINE_F(BloomFilterBenchmark, BlockedLookupTest)(benchmark::State& state) {
+  bool result = false;
+  for (auto _ : state) {
+    for (const auto& random_str : random_strs_) {
+      result = blocked_lookup_bf_->Contains(random_str);
+    }
+  }
+  PL_UNUSED(result);
+  state.SetBytesProcessed(state.iterations() * random_strs_.size() * random_strs_[0].size());
+  state.SetItemsProcessed(state.iterations() * random_strs_.size());
+}
+
+// NOLINTNEXTLINE : runtime/references.
+BENCHMARK_DEFINE_F(BloomFilterBenchmark, BlockedLookupManyTest)(benchmark::State& state) {
+  std::vector<uint8_t> results;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(blocked_lookup_bf_->ContainsMany(random_str_views_, &results));
+  }
+  state.SetBytesProcessed(state.iterations() * random_strs_.size() * random_strs_[0].size());
+  state.SetItemsProcessed(state.iterations() * random_strs_.size());
+}
+
 BENCHMARK_REGISTER_F(BloomFilterBenchmark, InsertTest)
     ->Ranges({{1 << 10, 1 << 20}, {10, 100000}, {8, 256}});
 BENCHMARK_REGISTER_F(BloomFilterBenchmark, LookupTest)
     ->Ranges({{1 << 10, 1 << 20}, {10, 100000}, {8, 256}});
+BENCHMARK_REGISTER_F(BloomFilterBenchmark, LookupManyTest)
+    ->Ranges({{1 << 10, 1 << 20}, {10, 100000}, {8, 256}});
+BENCHMARK_REGISTER_F(BloomFilterBenchmark, BlockedInsertTest)
+    ->Ranges({{1 << 10, 1 << 20}, {10, 100000}, {8, 256}});
+BENCHMARK_REGISTER_F(BloomFilterBenchmark, BlockedLookupTest)
+    ->Ranges({{1 << 10, 1 << 20}, {10, 100000}, {8, 256}});
+BENCHMARK_REGISTER_F(BloomFilterBenchmark, BlockedLookupManyTest)
+    ->Ranges({{1 << 10, 1 << 20}, {10, 100000}, {8, 256}});
 
 }  // namespace bloomfilter
 }  // namespace px
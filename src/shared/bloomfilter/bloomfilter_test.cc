@@ -18,6 +18,12 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <absl/strings/str_cat.h>
+
 #include "src/shared/bloomfilter/bloomfilter.h"
 
 namespace px {
@@ -113,5 +119,73 @@ TEST(XXHash64BloomFilter, test_create_from_proto) {
   }
 }
 
+TEST(XXHash64BloomFilter, test_contains_many) {
+  auto bf = XXHash64BloomFilter::Create(1000, 0.01).ConsumeValueOrDie();
+  std::vector<std::string> items;
+  for (auto i = 0; i < 1000; ++i) {
+    items.push_back(absl::StrCat("item", i));
+  }
+  for (auto i = 0; i < 500; ++i) {
+    bf->Insert(items[i]);
+  }
+
+  std::vector<std::string_view> views(items.begin(), items.end());
+  std::vector<uint8_t> results;
+  int64_t num_contained = bf->ContainsMany(views, &results);
+  ASSERT_EQ(results.size(), items.size());
+  int64_t expected_contained = 0;
+  for (size_t i = 0; i < items.size(); ++i) {
+    EXPECT_EQ(results[i], bf->Contains(items[i]));
+    expected_contained += results[i];
+  }
+  EXPECT_EQ(num_contained, expected_contained);
+}
+
+TEST(BlockedBloomFilter, test_create) {
+  auto bf = BlockedBloomFilter::Create(100000, 0.01).ConsumeValueOrDie();
+  EXPECT_EQ(bf->num_hashes(), 7);
+  // Rounded up to whole 64 byte blocks.
+  EXPECT_EQ(bf->buffer_size_bytes(), 1873 * 64);
+
+  EXPECT_FALSE(BlockedBloomFilter::Create(0, 0.01).ok());
+  EXPECT_FALSE(BlockedBloomFilter::Create(10, 1.0).ok());
+}
+
+TEST(BlockedBloomFilter, test_insert_contains) {
+  auto bf = BlockedBloomFilter::Create(10, 0.01).ConsumeValueOrDie();
+  EXPECT_FALSE(bf->Contains("foo"));
+  EXPECT_FALSE(bf->Contains("bar"));
+  bf->Insert("foo");
+  bf->Insert("bar");
+  EXPECT_TRUE(bf->Contains("foo"));
+  EXPECT_TRUE(bf->Contains("bar"));
+  EXPECT_FALSE(bf->Contains(""));
+}
+
+TEST(BlockedBloomFilter, test_contains_many) {
+  auto bf = BlockedBloomFilter::Create(1000, 0.01).ConsumeValueOrDie();
+  std::vector<std::string> items;
+  for (auto i = 0; i < 10000; ++i) {
+    items.push_back(absl::StrCat("item", i));
+  }
+  for (auto i = 0; i < 1000; ++i) {
+    bf->Insert(items[i]);
+  }
+
+  std::vector<std::string_view> views(items.begin(), items.end());
+  std::vector<uint8_t> results;
+  int64_t num_contained = bf->ContainsMany(views, &results);
+  ASSERT_EQ(results.size(), items.size());
+  for (size_t i = 0; i < items.size(); ++i) {
+    EXPECT_EQ(results[i], bf->Contains(items[i]));
+    if (i < 1000) {
+      // No false negatives.
+      EXPECT_TRUE(results[i]);
+    }
+  }
+  // The false positive rate of a blocked filter is a bit higher than what it was sized for.
+  EXPECT_LT(num_contained - 1000, 0.03 * 9000);
+}
+
 }  // namespace bloomfilter
 }  // namespace px
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/shared/protocols/raw_payload.h"
+
+namespace px {
+namespace protocols {
+
+namespace {
+
+StatusOr<uint64_t> ExtractVarint(std::string_view* buf) {
+  constexpr int kMaxVarintBytes = 10;
+  uint64_t value = 0;
+  for (int i = 0; i < kMaxVarintBytes && i < static_cast<int>(buf->size()); ++i) {
+    auto byte = static_cast<uint8_t>((*buf)[i]);
+    value |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+    if ((byte & 0x80) == 0) {
+      buf->remove_prefix(i + 1);
+      return value;
+    }
+  }
+  return error::InvalidArgument("Truncated or oversized varint in raw payload.");
+}
+
+}  // namespace
+
+StatusOr<std::vector<std::string_view>> DecodeRawPayload(std::string_view payload) {
+  PL_ASSIGN_OR_RETURN(uint64_t count, ExtractVarint(&payload));
+  // Every element takes at least one byte, which bounds the reservation below for corrupt input.
+  if (count > payload.size()) {
+    return error::InvalidArgument("Raw payload claims $0 elements, but has only $1 bytes left.",
+                                  count, payload.size());
+  }
+
+  std::vector<std::string_view> elements;
+  elements.reserve(count);
+  for (uint64_t i = 0; i < count; ++i) {
+    PL_ASSIGN_OR_RETURN(uint64_t len, ExtractVarint(&payload));
+    if (len > payload.size()) {
+      return error::InvalidArgument("Raw payload element $0 has length $1, but only $2 bytes left.",
+                                    i, len, payload.size());
+    }
+    elements.push_back(payload.substr(0, len));
+    payload.remove_prefix(len);
+  }
+  if (!payload.empty()) {
+    return error::InvalidArgument("Raw payload has $0 trailing bytes.", payload.size());
+  }
+  return elements;
+}
+
+}  // namespace protocols
+}  // namespace px
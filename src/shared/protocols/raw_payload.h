@@ -0,0 +1,81 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "src/common/base/base.h"
+
+namespace px {
+namespace protocols {
+
+// Protocol payloads that are lists of values (e.g. the arguments of a Redis command) are costly to
+// render into JSON during ingest, yet most records expire before they are ever queried. When
+// deferred rendering is enabled, the tracer stores such payloads in the compact encoding below
+// instead, and the protocol's render UDF renders them at query time. The encoding carries no
+// marker of its own: tables flag raw payloads in a separate column.
+//
+// Encoding: a varint element count, then each element as a varint byte length followed by the
+// element bytes.
+
+namespace internal {
+
+inline void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+}  // namespace internal
+
+/**
+ * Encodes the elements into a raw payload.
+ *
+ * @tparam TContainer Any container of string-like elements, e.g. std::vector<std::string> or
+ * VectorView<std::string>.
+ */
+template <typename TContainer>
+std::string EncodeRawPayload(const TContainer& elements) {
+  // Assume short elements, whose lengths fit in a single varint byte.
+  size_t size = 1;
+  for (const auto& e : elements) {
+    size += e.size() + 1;
+  }
+
+  std::string out;
+  out.reserve(size);
+  internal::AppendVarint(elements.size(), &out);
+  for (const auto& e : elements) {
+    internal::AppendVarint(e.size(), &out);
+    out.append(e);
+  }
+  return out;
+}
+
+/**
+ * Decodes the elements of a raw payload. The returned views point into the payload.
+ */
+StatusOr<std::vector<std::string_view>> DecodeRawPayload(std::string_view payload);
+
+}  // namespace protocols
+}  // namespace px
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/shared/protocols/raw_payload.h"
+
+#include <string>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace protocols {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+std::string Encode(const std::vector<std::string>& elements) { return EncodeRawPayload(elements); }
+
+TEST(RawPayloadTest, EncodeDecodeRoundTrip) {
+  std::string long_elem(300, 'x');
+  std::string binary_elem("a\0b\r\n", 5);
+  std::string payload = Encode({"SET", "", long_elem, binary_elem});
+  ASSERT_OK_AND_ASSIGN(std::vector<std::string_view> elements, DecodeRawPayload(payload));
+  EXPECT_THAT(elements, ElementsAre("SET", "", long_elem, binary_elem));
+}
+
+TEST(RawPayloadTest, EmptyPayload) {
+  std::string payload = Encode({});
+  ASSERT_OK_AND_ASSIGN(std::vector<std::string_view> elements, DecodeRawPayload(payload));
+  EXPECT_THAT(elements, IsEmpty());
+}
+
+TEST(RawPayloadTest, DecodeRejectsMalformedInput) {
+  std::string payload = Encode({"foo", "bar"});
+
+  EXPECT_NOT_OK(DecodeRawPayload("foo"));
+  // Truncated element.
+  EXPECT_NOT_OK(DecodeRawPayload(std::string_view(payload).substr(0, payload.size() - 1)));
+  // Trailing bytes.
+  EXPECT_NOT_OK(DecodeRawPayload(payload + "x"));
+  // Element count larger than the remaining bytes.
+  EXPECT_NOT_OK(DecodeRawPayload("\x7f"));
+  // Empty input has no element count.
+  EXPECT_NOT_OK(DecodeRawPayload(""));
+}
+
+}  // namespace protocols
+}  // namespace px
@@ -16,7 +16,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
-#include "src/stirling/source_connectors/socket_tracer/protocols/redis/cmd_args.h"
+#include "src/shared/protocols/redis/cmd_args.h"
 
 #include <utility>
 
@@ -25,7 +25,6 @@
 #include "src/common/json/json.h"
 
 namespace px {
-namespace stirling {
 namespace protocols {
 namespace redis {
 
@@ -520,5 +519,4 @@ std::optional<const CmdArgs*> GetCmdAndArgs(VectorView<std::string>* payloads) {
 
 }  // namespace redis
 }  // namespace protocols
-}  // namespace stirling
 }  // namespace px
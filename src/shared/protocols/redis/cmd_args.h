@@ -26,7 +26,6 @@
 #include "src/common/base/base.h"
 
 namespace px {
-namespace stirling {
 namespace protocols {
 namespace redis {
 
@@ -85,5 +84,4 @@ std::optional<const CmdArgs*> GetCmdAndArgs(VectorView<std::string>* payloads);
 
 }  // namespace redis
 }  // namespace protocols
-}  // namespace stirling
 }  // namespace px
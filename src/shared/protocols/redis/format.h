@@ -0,0 +1,42 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "src/common/base/base.h"
+
+namespace px {
+namespace protocols {
+namespace redis {
+
+/**
+ * Formats the payloads of a Redis array message. If the array starts with a known command, the
+ * command is written to `command` and its arguments are formatted as a JSON object according to
+ * the command's argument descriptions. Otherwise the payloads are formatted as a JSON array.
+ *
+ * Stirling uses this to render array messages during ingest, and Carnot to render the raw payloads
+ * that Stirling deferred, so that both produce exactly the same output.
+ */
+std::string FormatArrayPayloads(VectorView<std::string> payloads_view, std::string_view* command);
+
+}  // namespace redis
+}  // namespace protocols
+}  // namespace px
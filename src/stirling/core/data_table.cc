@@ -33,7 +33,13 @@ namespace stirling {
 using types::ColumnWrapper;
 using types::DataType;
 
-DataTable::DataTable(uint64_t id, const DataTableSchema& schema) : id_(id), table_schema_(schema) {}
+DataTable::DataTable(uint64_t id, const DataTableSchema& schema)
+    : id_(id),
+      table_schema_(schema),
+      consume_records_latency_(
+          GetOrCreateHistogramFamily("stirling_consume_records_latency_seconds",
+                                     "Latency of sorting and splitting a data table's records")
+              .Add({{"name", std::string(schema.name())}})) {}
 
 void DataTable::InitBuffers(types::ColumnWrapperRecordBatch* record_batch_ptr) {
   DCHECK(record_batch_ptr != nullptr);
@@ -60,6 +66,7 @@ Tablet* DataTable::GetTablet(types::TabletIDView tablet_id) {
 }
 
 std::vector<TaggedRecordBatch> DataTable::ConsumeRecords() {
+  px::metrics::ScopedHistogramTimer timer(&consume_records_latency_);
   std::vector<TaggedRecordBatch> tablets_out;
   absl::flat_hash_map<types::TabletID, Tablet> carryover_tablets;
   uint64_t next_start_time = start_time_;
@@ -28,6 +28,7 @@
 
 #include "src/common/base/base.h"
 #include "src/common/base/mixins.h"
+#include "src/common/metrics/metrics.h"
 #include "src/stirling/core/types.h"
 
 namespace px {
@@ -287,6 +288,8 @@ class DataTable : public NotCopyable {
   // Used particularly by the socket tracer which receives asynchronous
   // events from BPF.
   std::optional<uint64_t> cutoff_time_;
+
+  px::metrics::ShardedHistogram& consume_records_latency_;
 };
 
 }  // namespace stirling
@@ -50,6 +50,7 @@ void SourceConnector::TransferData(ConnectorContext* ctx,
   DCHECK(ctx != nullptr);
   DCHECK_EQ(data_tables.size(), table_schemas().size())
       << "DataTable objects must all be specified.";
+  px::metrics::ScopedHistogramTimer timer(&transfer_data_latency_);
   TransferDataImpl(ctx, data_tables);
   sampling_freq_mgr_.Reset();
 }
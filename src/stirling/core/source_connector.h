@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "src/common/base/base.h"
+#include "src/common/metrics/metrics.h"
 #include "src/common/system/system.h"
 #include "src/shared/types/types.h"
 #include "src/stirling/core/connector_context.h"
@@ -120,7 +121,12 @@ class SourceConnector : public NotCopyable {
  protected:
   explicit SourceConnector(std::string_view source_name,
                            const ArrayView<DataTableSchema>& table_schemas)
-      : source_name_(source_name), table_schemas_(table_schemas) {}
+      : source_name_(source_name),
+        table_schemas_(table_schemas),
+        transfer_data_latency_(
+            GetOrCreateHistogramFamily("stirling_transfer_data_latency_seconds",
+                                       "Latency of a source connector's TransferData call")
+                .Add({{"name", source_name_}})) {}
 
   virtual Status InitImpl() = 0;
 
@@ -158,6 +164,8 @@ class SourceConnector : public NotCopyable {
 
   const std::string source_name_;
   const ArrayView<DataTableSchema> table_schemas_;
+
+  px::metrics::ShardedHistogram& transfer_data_latency_;
 };
 
 }  // namespace stirling
@@ -224,6 +224,8 @@ Status DynamicBPFTraceConnector::InitImpl() {
   auto callback_fn = absl::bind_front(&DynamicBPFTraceConnector::HandleEvent, this);
   output_fields_ = bpftrace_->OutputFields();
   PL_RETURN_IF_ERROR(CheckOutputFields(output_fields_, table_schema_->Get().elements()));
+  PL_ASSIGN_OR_RETURN(decode_ops_,
+                      CompileDecodeOps(output_fields_, table_schema_->Get().elements()));
   PL_RETURN_IF_ERROR(bpftrace_->Deploy(callback_fn));
   return Status::OK();
 }
@@ -265,118 +267,169 @@ std::string ResolveInet(int af, const uint8_t* inet) {
 
 }  // namespace
 
-void DynamicBPFTraceConnector::HandleEvent(uint8_t* data) {
-  DataTable::DynamicRecordBuilder r(data_table_);
+StatusOr<std::vector<DynamicBPFTraceConnector::FieldDecodeOp>>
+DynamicBPFTraceConnector::CompileDecodeOps(const std::vector<bpftrace::Field>& fields,
+                                           const ArrayView<DataElement>& elements) {
+  using Kind = FieldDecodeOp::Kind;
+
+  std::vector<FieldDecodeOp> ops;
+  ops.reserve(fields.size());
 
-  const auto& columns = table_schema_->Get().elements();
+  for (size_t i = 0; i < fields.size(); ++i) {
+    const auto& field = fields[i];
 
-  int col = 0;
-  for (size_t i = 0; i < output_fields_.size(); ++i) {
-    const auto& field = output_fields_[i];
-    const auto& column = columns[i];
+    FieldDecodeOp op;
+    op.offset = field.offset;
+    op.size = field.type.size();
 
     switch (field.type.type) {
       case bpftrace::Type::integer:
-
-#define APPEND_INTEGER(int_type, expr)                             \
-  {                                                                \
-    auto val = *reinterpret_cast<int_type*>(expr);                 \
-    if (column.type() == types::DataType::TIME64NS) {              \
-      r.Append(col, types::Time64NSValue(ConvertToRealTime(val))); \
-    } else {                                                       \
-      r.Append(col, types::Int64Value(val));                       \
-    }                                                              \
-  }
-
+        if (elements[i].type() == types::DataType::TIME64NS) {
+          op.kind = Kind::kTime;
+          break;
+        }
         switch (field.type.size()) {
           case 8:
-            APPEND_INTEGER(uint64_t, data + field.offset);
+            op.kind = Kind::kUInt64;
             break;
           case 4:
-            APPEND_INTEGER(uint32_t, data + field.offset);
+            op.kind = Kind::kUInt32;
             break;
           case 2:
-            APPEND_INTEGER(uint16_t, data + field.offset);
+            op.kind = Kind::kUInt16;
             break;
           case 1:
-            APPEND_INTEGER(uint8_t, data + field.offset);
+            op.kind = Kind::kUInt8;
             break;
           default:
-            LOG(DFATAL) << absl::Substitute(
-                "[DataTable: $0, col: $1] Invalid integer size: $2. Table is now inconsistent. "
-                "This is a critical error.",
-                name_, col, field.type.size());
-            break;
+            return error::Internal("Perf event on column $0 contains invalid integer size: $1.", i,
+                                   field.type.size());
         }
         break;
-#undef APPEND_INTEGER
-      case bpftrace::Type::string: {
-        auto p = reinterpret_cast<char*>(data + field.offset);
-        r.Append(col, types::StringValue(std::string(p, strnlen(p, field.type.size()))));
+      case bpftrace::Type::string:
+        op.kind = Kind::kString;
+        break;
+      case bpftrace::Type::inet:
+        op.kind = Kind::kInet;
+        break;
+      case bpftrace::Type::usym:
+        op.kind = Kind::kUsym;
+        break;
+      case bpftrace::Type::ksym:
+        op.kind = Kind::kKsym;
+        break;
+      case bpftrace::Type::username:
+        op.kind = Kind::kUsername;
+        break;
+      case bpftrace::Type::probe:
+        op.kind = Kind::kProbe;
+        break;
+      case bpftrace::Type::kstack:
+        op.kind = Kind::kKstack;
+        op.stack_type = &field.type.stack_type;
+        break;
+      case bpftrace::Type::ustack:
+        op.kind = Kind::kUstack;
+        op.stack_type = &field.type.stack_type;
+        break;
+      case bpftrace::Type::timestamp:
+        op.kind = Kind::kTimestamp;
+        break;
+      case bpftrace::Type::pointer:
+        op.kind = Kind::kPointer;
+        break;
+      default:
+        return error::Internal("Column $0 has invalid argument type $1.", i,
+                               magic_enum::enum_name(field.type.type));
+    }
+
+    ops.push_back(op);
+  }
+
+  return ops;
+}
+
+void DynamicBPFTraceConnector::HandleEvent(uint8_t* data) {
+  using Kind = FieldDecodeOp::Kind;
+
+  DataTable::DynamicRecordBuilder r(data_table_);
+
+  for (size_t col = 0; col < decode_ops_.size(); ++col) {
+    const FieldDecodeOp& op = decode_ops_[col];
+    uint8_t* ptr = data + op.offset;
+
+    switch (op.kind) {
+      case Kind::kUInt64:
+        r.Append(col, types::Int64Value(*reinterpret_cast<uint64_t*>(ptr)));
+        break;
+      case Kind::kUInt32:
+        r.Append(col, types::Int64Value(*reinterpret_cast<uint32_t*>(ptr)));
+        break;
+      case Kind::kUInt16:
+        r.Append(col, types::Int64Value(*reinterpret_cast<uint16_t*>(ptr)));
+        break;
+      case Kind::kUInt8:
+        r.Append(col, types::Int64Value(*reinterpret_cast<uint8_t*>(ptr)));
+        break;
+      case Kind::kTime: {
+        uint64_t val = 0;
+        // Integer sizes are validated at compile time, and the data is little-endian.
+        memcpy(&val, ptr, op.size);
+        r.Append(col, types::Time64NSValue(ConvertToRealTime(val)));
+        break;
+      }
+      case Kind::kString: {
+        auto p = reinterpret_cast<char*>(ptr);
+        r.Append(col, types::StringValue(std::string(p, strnlen(p, op.size))));
         break;
       }
-      case bpftrace::Type::inet: {
-        int64_t af = *reinterpret_cast<int64_t*>(data + field.offset);
-        uint8_t* inet = reinterpret_cast<uint8_t*>(data + field.offset + 8);
+      case Kind::kInet: {
+        int64_t af = *reinterpret_cast<int64_t*>(ptr);
+        uint8_t* inet = ptr + 8;
         r.Append(col, types::StringValue(ResolveInet(af, inet)));
         break;
       }
-      case bpftrace::Type::usym: {
-        uint64_t addr = *reinterpret_cast<uint64_t*>(data + field.offset);
-        uint64_t pid = *reinterpret_cast<uint64_t*>(data + field.offset + 8);
+      case Kind::kUsym: {
+        uint64_t addr = *reinterpret_cast<uint64_t*>(ptr);
+        uint64_t pid = *reinterpret_cast<uint64_t*>(ptr + 8);
         r.Append(col, types::StringValue(bpftrace_->mutable_bpftrace()->resolve_usym(addr, pid)));
         break;
       }
-      case bpftrace::Type::ksym: {
-        uint64_t addr = *reinterpret_cast<uint64_t*>(data + field.offset);
+      case Kind::kKsym: {
+        uint64_t addr = *reinterpret_cast<uint64_t*>(ptr);
         r.Append(col, types::StringValue(bpftrace_->mutable_bpftrace()->resolve_ksym(addr)));
         break;
       }
-      case bpftrace::Type::username: {
-        uint64_t addr = *reinterpret_cast<uint64_t*>(data + field.offset);
+      case Kind::kUsername: {
+        uint64_t addr = *reinterpret_cast<uint64_t*>(ptr);
         r.Append(col, types::StringValue(bpftrace_->mutable_bpftrace()->resolve_uid(addr)));
         break;
       }
-      case bpftrace::Type::probe: {
-        uint64_t probe_id = *reinterpret_cast<uint64_t*>(data + field.offset);
+      case Kind::kProbe: {
+        uint64_t probe_id = *reinterpret_cast<uint64_t*>(ptr);
         r.Append(col, types::StringValue(bpftrace_->mutable_bpftrace()->resolve_probe(probe_id)));
         break;
       }
-      case bpftrace::Type::kstack: {
-        uint64_t stackidpid = *reinterpret_cast<uint64_t*>(data + field.offset);
-        bool ustack = false;
-        auto& stack_type = field.type.stack_type;
+      case Kind::kKstack:
+      case Kind::kUstack: {
+        uint64_t stackidpid = *reinterpret_cast<uint64_t*>(ptr);
+        bool ustack = op.kind == Kind::kUstack;
         r.Append(col, types::StringValue(bpftrace_->mutable_bpftrace()->get_stack(
-                          stackidpid, ustack, stack_type)));
+                          stackidpid, ustack, *op.stack_type)));
         break;
       }
-      case bpftrace::Type::ustack: {
-        uint64_t stackidpid = *reinterpret_cast<uint64_t*>(data + field.offset);
-        bool ustack = true;
-        auto& stack_type = field.type.stack_type;
-        r.Append(col, types::StringValue(bpftrace_->mutable_bpftrace()->get_stack(
-                          stackidpid, ustack, stack_type)));
-        break;
-      }
-      case bpftrace::Type::timestamp: {
-        auto x = reinterpret_cast<bpftrace::AsyncEvent::Strftime*>(data + field.offset);
+      case Kind::kTimestamp: {
+        auto x = reinterpret_cast<bpftrace::AsyncEvent::Strftime*>(ptr);
         r.Append(col, types::StringValue(bpftrace_->mutable_bpftrace()->resolve_timestamp(
                           x->strftime_id, x->nsecs_since_boot)));
         break;
       }
-      case bpftrace::Type::pointer: {
-        uint64_t p = *reinterpret_cast<uint64_t*>(data + field.offset);
+      case Kind::kPointer: {
+        uint64_t p = *reinterpret_cast<uint64_t*>(ptr);
         r.Append(col, types::Int64Value(p));
         break;
       }
-      default:
-        LOG(DFATAL) << absl::Substitute(
-            "[DataTable: $0, col: $1] Invalid argument type $2. Table is now inconsistent. This is "
-            "a critical error.",
-            name_, col, magic_enum::enum_name(field.type.type));
     }
-
-    ++col;
   }
 }
 
@@ -50,6 +50,39 @@ class DynamicBPFTraceConnector : public SourceConnector {
   void TransferDataImpl(ConnectorContext* ctx, const std::vector<DataTable*>& data_tables) override;
 
  private:
+  // A per-field decode op, resolved once from the bpftrace output fields and the table schema,
+  // so that HandleEvent does not re-inspect the field and column types of every event.
+  struct FieldDecodeOp {
+    enum class Kind : uint8_t {
+      kUInt8,
+      kUInt16,
+      kUInt32,
+      kUInt64,
+      // An integer holding a monotonic timestamp, converted to real time.
+      kTime,
+      kString,
+      kInet,
+      kUsym,
+      kKsym,
+      kUsername,
+      kProbe,
+      kKstack,
+      kUstack,
+      kTimestamp,
+      kPointer,
+    };
+
+    Kind kind;
+    uint32_t offset;
+    // The size of the field in the event, in bytes.
+    uint32_t size;
+    // The stack type; only used by kKstack and kUstack.
+    const bpftrace::StackType* stack_type = nullptr;
+  };
+
+  static StatusOr<std::vector<FieldDecodeOp>> CompileDecodeOps(
+      const std::vector<bpftrace::Field>& fields, const ArrayView<DataElement>& elements);
+
   void HandleEvent(uint8_t* data);
 
   std::string name_;
@@ -59,6 +92,9 @@ class DynamicBPFTraceConnector : public SourceConnector {
   // The types according to the BPFTrace printf format.
   std::vector<bpftrace::Field> output_fields_;
 
+  // One op per output field, compiled from output_fields_ at init time.
+  std::vector<FieldDecodeOp> decode_ops_;
+
   // Used by HandleEvent so that when a callback is triggered, HandleEvent knows the context.
   DataTable* data_table_ = nullptr;
 };
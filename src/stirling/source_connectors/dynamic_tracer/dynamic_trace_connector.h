@@ -28,6 +28,7 @@
 #include "src/stirling/bpf_tools/bcc_wrapper.h"
 #include "src/stirling/core/source_connector.h"
 #include "src/stirling/source_connectors/dynamic_tracer/dynamic_tracing/dynamic_tracer.h"
+#include "src/stirling/source_connectors/dynamic_tracer/struct_decode_plan.h"
 
 namespace px {
 namespace stirling {
@@ -50,10 +51,11 @@ class DynamicTraceConnector : public SourceConnector, public bpf_tools::BCCWrapp
   //               since the ArrayView creation only works for a single schema.
   //               Consider how to expand to multiple tables if/when needed.
   DynamicTraceConnector(std::string_view name, std::unique_ptr<DynamicDataTableSchema> table_schema,
-                        dynamic_tracing::BCCProgram bcc_program)
+                        dynamic_tracing::BCCProgram bcc_program, StructDecodePlan decode_plan)
       : SourceConnector(name, ArrayView<DataTableSchema>(&table_schema->Get(), 1)),
         table_schema_(std::move(table_schema)),
-        bcc_program_(std::move(bcc_program)) {}
+        bcc_program_(std::move(bcc_program)),
+        decode_plan_(std::move(decode_plan)) {}
 
   Status InitImpl() override;
 
@@ -62,15 +64,15 @@ class DynamicTraceConnector : public SourceConnector, public bpf_tools::BCCWrapp
   Status StopImpl() override { return Status::OK(); }
 
  private:
-  Status AppendRecord(const ::px::stirling::dynamic_tracing::ir::physical::Struct& st,
-                      uint32_t asid, std::string_view buf, DataTable* data_table);
-
   // Describes the output table column types.
   std::unique_ptr<DynamicDataTableSchema> table_schema_;
 
   // The actual dynamic trace program.
   dynamic_tracing::BCCProgram bcc_program_;
 
+  // Decodes the perf buffer records of the output struct; compiled once from bcc_program_.
+  StructDecodePlan decode_plan_;
+
   // A buffer to hold raw data items from the perf buffer.
   std::deque<std::string> data_items_;
 };
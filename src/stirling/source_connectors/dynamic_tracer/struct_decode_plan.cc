@@ -0,0 +1,367 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/dynamic_tracer/struct_decode_plan.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "src/shared/upid/upid.h"
+#include "src/stirling/source_connectors/dynamic_tracer/dynamic_tracing/types.h"
+
+namespace px {
+namespace stirling {
+
+using ::google::protobuf::RepeatedPtrField;
+
+using ::px::stirling::dynamic_tracing::ir::physical::Field;
+using ::px::stirling::dynamic_tracing::ir::physical::Struct;
+using ::px::stirling::dynamic_tracing::ir::physical::StructSpec;
+using ::px::stirling::dynamic_tracing::ir::shared::ScalarType;
+using ::px::utils::MemCpy;
+
+using OpCode = StructDecodePlan::OpCode;
+
+namespace {
+
+// NOTE: These must match the blob types generated by GenBlobType() in code_gen.cc:
+// strings and byte arrays are {uint64_t len; char buf[]; uint8_t truncated;}, and struct blobs
+// are {uint64_t len; int8_t decoder_idx; uint8_t buf[];}.
+//
+// TODO(oazizi): Find a better way to keep these in sync.
+constexpr size_t kMaxStringLen = dynamic_tracing::kStructStringSize - sizeof(size_t) - 1;
+constexpr size_t kMaxByteArrayLen = dynamic_tracing::kStructByteArraySize - sizeof(size_t) - 1;
+constexpr size_t kMaxBlobLen = dynamic_tracing::kStructBlobSize - sizeof(size_t) - sizeof(int8_t);
+
+// The op and the number of bytes a value of a ScalarType occupies in the perf buffer record.
+struct ScalarLayout {
+  OpCode code;
+  size_t size;
+};
+
+template <typename TNativeType>
+constexpr ScalarLayout IntLayout() {
+  static_assert(std::is_integral_v<TNativeType>);
+  constexpr size_t kSize = sizeof(TNativeType);
+  static_assert(kSize == 1 || kSize == 2 || kSize == 4 || kSize == 8);
+  if constexpr (std::is_signed_v<TNativeType>) {
+    constexpr OpCode kCodes[] = {OpCode::kInt8, OpCode::kInt16, OpCode::kInt32, OpCode::kInt64};
+    return {kCodes[kSize == 1 ? 0 : kSize == 2 ? 1 : kSize == 4 ? 2 : 3], kSize};
+  } else {
+    constexpr OpCode kCodes[] = {OpCode::kUInt8, OpCode::kUInt16, OpCode::kUInt32,
+                                 OpCode::kUInt64};
+    return {kCodes[kSize == 1 ? 0 : kSize == 2 ? 1 : kSize == 4 ? 2 : 3], kSize};
+  }
+}
+
+StatusOr<ScalarLayout> ResolveScalar(ScalarType type) {
+  switch (type) {
+    case ScalarType::BOOL:
+      return ScalarLayout{OpCode::kBool, sizeof(bool)};
+    case ScalarType::INT:
+      return IntLayout<int>();
+    case ScalarType::INT8:
+      return IntLayout<int8_t>();
+    case ScalarType::INT16:
+      return IntLayout<int16_t>();
+    case ScalarType::INT32:
+      return IntLayout<int32_t>();
+    case ScalarType::INT64:
+      return IntLayout<int64_t>();
+    case ScalarType::UINT:
+      return IntLayout<unsigned int>();
+    case ScalarType::UINT8:
+      return IntLayout<uint8_t>();
+    case ScalarType::UINT16:
+      return IntLayout<uint16_t>();
+    case ScalarType::UINT32:
+      return IntLayout<uint32_t>();
+    case ScalarType::UINT64:
+      return IntLayout<uint64_t>();
+    case ScalarType::SHORT:
+      // NOLINTNEXTLINE(runtime/int)
+      return IntLayout<short>();
+    case ScalarType::USHORT:
+      // NOLINTNEXTLINE(runtime/int)
+      return IntLayout<unsigned short>();
+    case ScalarType::LONG:
+      // NOLINTNEXTLINE(runtime/int)
+      return IntLayout<long>();
+    case ScalarType::ULONG:
+      // NOLINTNEXTLINE(runtime/int)
+      return IntLayout<unsigned long>();
+    case ScalarType::LONGLONG:
+      // NOLINTNEXTLINE(runtime/int)
+      return IntLayout<long long>();
+    case ScalarType::ULONGLONG:
+      // NOLINTNEXTLINE(runtime/int)
+      return IntLayout<unsigned long long>();
+    case ScalarType::CHAR:
+      return IntLayout<char>();
+    case ScalarType::UCHAR:
+      return IntLayout<unsigned char>();
+    case ScalarType::FLOAT:
+      return ScalarLayout{OpCode::kFloat, sizeof(float)};
+    case ScalarType::DOUBLE:
+      return ScalarLayout{OpCode::kDouble, sizeof(double)};
+    case ScalarType::VOID_POINTER:
+      return IntLayout<uint64_t>();
+    case ScalarType::STRING:
+      return ScalarLayout{OpCode::kString, dynamic_tracing::kStructStringSize};
+    case ScalarType::BYTE_ARRAY:
+      return ScalarLayout{OpCode::kByteArray, dynamic_tracing::kStructByteArraySize};
+    case ScalarType::STRUCT_BLOB:
+      return ScalarLayout{OpCode::kStructBlob, dynamic_tracing::kStructBlobSize};
+    case ScalarType::UNKNOWN:
+      return error::Internal("Unknown scalar type should not be used.");
+    default:
+      return error::Internal("Unhandled type=$0", type);
+  }
+}
+
+StatusOr<StructDecodePlan::BlobPlan> CompileBlobPlan(
+    const RepeatedPtrField<StructSpec>& struct_specs) {
+  StructDecodePlan::BlobPlan blob_plan;
+  blob_plan.reserve(struct_specs.size());
+
+  for (const auto& struct_spec : struct_specs) {
+    std::vector<StructDecodePlan::BlobEntry> entries;
+    entries.reserve(struct_spec.entries_size());
+
+    for (const auto& entry : struct_spec.entries()) {
+      PL_ASSIGN_OR_RETURN(ScalarLayout layout, ResolveScalar(entry.type()));
+      if (layout.code == OpCode::kString || layout.code == OpCode::kByteArray ||
+          layout.code == OpCode::kStructBlob) {
+        return error::Internal("Unhandled type=$0 in struct blob at path $1", entry.type(),
+                               entry.path());
+      }
+      if (entry.offset() < 0) {
+        return error::Internal("Negative offset $0 in struct blob at path $1", entry.offset(),
+                               entry.path());
+      }
+
+      rapidjson::Pointer path(entry.path().c_str());
+      if (!path.IsValid()) {
+        return error::Internal("Invalid JSON pointer path $0 in struct blob", entry.path());
+      }
+      entries.push_back(StructDecodePlan::BlobEntry{
+          layout.code, static_cast<uint32_t>(entry.offset()), static_cast<uint32_t>(layout.size),
+          std::move(path)});
+    }
+
+    blob_plan.push_back(std::move(entries));
+  }
+
+  return blob_plan;
+}
+
+}  // namespace
+
+StatusOr<StructDecodePlan> StructDecodePlan::Compile(const Struct& st) {
+  StructDecodePlan plan;
+
+  uint32_t offset = 0;
+  uint32_t col_idx = 0;
+  for (int i = 0; i < st.fields_size(); ++i) {
+    const Field& field = st.fields(i);
+
+    if (field.name() == "time_") {
+      plan.ops_.push_back(Op{OpCode::kTime, offset, col_idx++});
+      offset += sizeof(uint64_t);
+    } else if ((field.name() == "tgid_") && (i + 1 < st.fields_size()) &&
+               (st.fields(i + 1).name() == "tgid_start_time_")) {
+      // If we see "tgid_" and "tgid_start_time_" back-to-back, then we automatically create UPID.
+      plan.ops_.push_back(Op{OpCode::kUPID, offset, col_idx++});
+      offset += sizeof(uint32_t) + sizeof(uint64_t);
+
+      // Consume the extra tgid_start_time_ column.
+      ++i;
+    } else {
+      PL_ASSIGN_OR_RETURN(ScalarLayout layout, ResolveScalar(field.type()));
+      Op op{layout.code, offset, col_idx++};
+      if (layout.code == OpCode::kStructBlob) {
+        PL_ASSIGN_OR_RETURN(BlobPlan blob_plan, CompileBlobPlan(field.blob_decoders()));
+        op.blob_idx = plan.blob_plans_.size();
+        plan.blob_plans_.push_back(std::move(blob_plan));
+      }
+      plan.ops_.push_back(op);
+      offset += layout.size;
+    }
+  }
+  plan.record_size_ = offset;
+
+  return plan;
+}
+
+std::string StructDecodePlan::DecodeStructBlob(const BlobPlan& blob_plan,
+                                               std::string_view buf) const {
+  size_t len = std::min(MemCpy<size_t>(buf.data()), kMaxBlobLen);
+  int8_t idx = MemCpy<int8_t>(buf.data() + sizeof(size_t));
+  std::string_view bytes = buf.substr(sizeof(size_t) + sizeof(int8_t), len);
+
+  if (idx < 0 || static_cast<size_t>(idx) >= blob_plan.size()) {
+    // BPF could not figure out the correct index to the implementation type of an interface.
+    // This can happen if the implementation type was not support yet. Examples include pointer
+    // types, and base/native types.
+    //
+    // TODO(yzhao): Change to output the literal interface struct in this case. Such that we could
+    // remove this special case.
+    LOG_IF(DFATAL, idx >= 0) << absl::Substitute("Invalid struct blob decoder index $0", idx);
+    return absl::Substitute(R"({"bytes": "$0"})", BytesToString<bytes_format::Hex>(bytes));
+  }
+
+  rapidjson::Document d;
+  d.SetObject();
+  for (const BlobEntry& entry : blob_plan[idx]) {
+    if (entry.offset + entry.size > bytes.size()) {
+      // The member lies outside of the bytes that were actually captured.
+      continue;
+    }
+    const char* ptr = bytes.data() + entry.offset;
+
+#define SET_JSON(native_type)                  \
+  entry.path.Set(d, MemCpy<native_type>(ptr)); \
+  break;
+
+    switch (entry.code) {
+      case OpCode::kBool:
+        SET_JSON(bool);
+      case OpCode::kInt8:
+        SET_JSON(int8_t);
+      case OpCode::kInt16:
+        SET_JSON(int16_t);
+      case OpCode::kInt32:
+        SET_JSON(int32_t);
+      case OpCode::kInt64:
+        SET_JSON(int64_t);
+      case OpCode::kUInt8:
+        SET_JSON(uint8_t);
+      case OpCode::kUInt16:
+        SET_JSON(uint16_t);
+      case OpCode::kUInt32:
+        SET_JSON(uint32_t);
+      case OpCode::kUInt64:
+        SET_JSON(uint64_t);
+      case OpCode::kFloat:
+        SET_JSON(float);
+      case OpCode::kDouble:
+        SET_JSON(double);
+      default:
+        LOG(DFATAL) << absl::Substitute("Unexpected blob op=$0", magic_enum::enum_name(entry.code));
+    }
+#undef SET_JSON
+  }
+
+  rapidjson::StringBuffer sb;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+  d.Accept(writer);
+  return std::string(sb.GetString(), sb.GetSize());
+}
+
+Status StructDecodePlan::Decode(std::string_view buf, uint32_t asid,
+                                const system::Config& sysconfig, DataTable* data_table) const {
+  // Checking the size once up-front lets every op read at its fixed offset without bounds checks,
+  // and guarantees that a record is never partially appended.
+  if (buf.size() < record_size_) {
+    return error::ResourceUnavailable("Insufficient number of bytes: expected $0, got $1.",
+                                      record_size_, buf.size());
+  }
+
+  DataTable::DynamicRecordBuilder r(data_table);
+
+  for (const Op& op : ops_) {
+    const char* ptr = buf.data() + op.offset;
+
+#define APPEND_SCALAR(native_type, column_type)                \
+  r.Append(op.col_idx, column_type(MemCpy<native_type>(ptr))); \
+  break;
+
+    switch (op.code) {
+      case OpCode::kBool:
+        APPEND_SCALAR(bool, types::BoolValue);
+      case OpCode::kInt8:
+        APPEND_SCALAR(int8_t, types::Int64Value);
+      case OpCode::kInt16:
+        APPEND_SCALAR(int16_t, types::Int64Value);
+      case OpCode::kInt32:
+        APPEND_SCALAR(int32_t, types::Int64Value);
+      case OpCode::kInt64:
+        APPEND_SCALAR(int64_t, types::Int64Value);
+      case OpCode::kUInt8:
+        APPEND_SCALAR(uint8_t, types::Int64Value);
+      case OpCode::kUInt16:
+        APPEND_SCALAR(uint16_t, types::Int64Value);
+      case OpCode::kUInt32:
+        APPEND_SCALAR(uint32_t, types::Int64Value);
+      case OpCode::kUInt64:
+        APPEND_SCALAR(uint64_t, types::Int64Value);
+      case OpCode::kFloat:
+        APPEND_SCALAR(float, types::Float64Value);
+      case OpCode::kDouble:
+        APPEND_SCALAR(double, types::Float64Value);
+      case OpCode::kTime: {
+        int64_t time = sysconfig.ConvertToRealTime(MemCpy<uint64_t>(ptr));
+        r.Append(op.col_idx, types::Time64NSValue(time));
+        break;
+      }
+      case OpCode::kUPID: {
+        auto tgid = MemCpy<uint32_t>(ptr);
+        auto tgid_start_time = MemCpy<uint64_t>(ptr + sizeof(uint32_t));
+        md::UPID upid(asid, tgid, tgid_start_time);
+        r.Append(op.col_idx, types::UInt128Value(upid.value()));
+        break;
+      }
+      case OpCode::kString: {
+        size_t len = std::min(MemCpy<size_t>(ptr), kMaxStringLen);
+        std::string s(ptr + sizeof(size_t), len);
+        if (MemCpy<uint8_t>(ptr + dynamic_tracing::kStructStringSize - 1)) {
+          absl::StrAppend(&s, "<truncated>");
+        }
+        r.Append(op.col_idx, types::StringValue(std::move(s)));
+        break;
+      }
+      case OpCode::kByteArray: {
+        size_t len = std::min(MemCpy<size_t>(ptr), kMaxByteArrayLen);
+        std::string s =
+            BytesToString<bytes_format::HexCompact>(std::string_view(ptr + sizeof(size_t), len));
+        if (MemCpy<uint8_t>(ptr + dynamic_tracing::kStructByteArraySize - 1)) {
+          absl::StrAppend(&s, "<truncated>");
+        }
+        r.Append(op.col_idx, types::StringValue(std::move(s)));
+        break;
+      }
+      case OpCode::kStructBlob: {
+        std::string_view blob(ptr, dynamic_tracing::kStructBlobSize);
+        std::string json = DecodeStructBlob(blob_plans_[op.blob_idx], blob);
+        r.Append(op.col_idx, types::StringValue(std::move(json)));
+        break;
+      }
+    }
+#undef APPEND_SCALAR
+  }
+
+  return Status::OK();
+}
+
+}  // namespace stirling
+}  // namespace px
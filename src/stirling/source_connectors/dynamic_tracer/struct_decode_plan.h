@@ -0,0 +1,112 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <rapidjson/pointer.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/common/system/config.h"
+#include "src/stirling/core/data_table.h"
+#include "src/stirling/source_connectors/dynamic_tracer/dynamic_tracing/ir/physicalpb/physical.pb.h"
+
+namespace px {
+namespace stirling {
+
+/**
+ * A StructDecodePlan is the pre-compiled form of a dynamic tracepoint's output struct.
+ *
+ * The output struct is resolved once into a flat list of typed ops, each with the precomputed
+ * byte offset of its field inside the perf buffer record, and the output column it writes.
+ * Decoding a record is then a single pass over the ops, without any per-event inspection of
+ * the IR protobufs (field names, scalar types, blob decoders).
+ */
+class StructDecodePlan {
+ public:
+  enum class OpCode : uint8_t {
+    kBool,
+    kInt8,
+    kInt16,
+    kInt32,
+    kInt64,
+    kUInt8,
+    kUInt16,
+    kUInt32,
+    kUInt64,
+    kFloat,
+    kDouble,
+    // A monotonic uint64_t timestamp, converted to real time.
+    kTime,
+    // A uint32_t tgid, immediately followed by a uint64_t tgid start time.
+    kUPID,
+    kString,
+    kByteArray,
+    kStructBlob,
+  };
+
+  struct Op {
+    OpCode code;
+    uint32_t offset;
+    uint32_t col_idx;
+    // Index into blob_plans_, only used by kStructBlob.
+    uint32_t blob_idx = 0;
+  };
+
+  // A single base-type member of a struct blob, rendered into the JSON output under path.
+  struct BlobEntry {
+    OpCode code;
+    uint32_t offset;
+    uint32_t size;
+    rapidjson::Pointer path;
+  };
+
+  // The decoders of one STRUCT_BLOB field; one entry list per candidate StructSpec.
+  using BlobPlan = std::vector<std::vector<BlobEntry>>;
+
+  /**
+   * Compiles the decode plan for records laid out according to the output struct.
+   */
+  static StatusOr<StructDecodePlan> Compile(
+      const ::px::stirling::dynamic_tracing::ir::physical::Struct& st);
+
+  /**
+   * Decodes one perf buffer record and appends it to the data table.
+   * The record is rejected as a whole, before any column is appended, if it is too short.
+   */
+  Status Decode(std::string_view buf, uint32_t asid, const system::Config& sysconfig,
+                DataTable* data_table) const;
+
+  const std::vector<Op>& ops() const { return ops_; }
+
+  // The number of bytes a record must have to be decoded by this plan.
+  size_t record_size() const { return record_size_; }
+
+ private:
+  std::string DecodeStructBlob(const BlobPlan& blob_plan, std::string_view buf) const;
+
+  std::vector<Op> ops_;
+  std::vector<BlobPlan> blob_plans_;
+  size_t record_size_ = 0;
+};
+
+}  // namespace stirling
+}  // namespace px
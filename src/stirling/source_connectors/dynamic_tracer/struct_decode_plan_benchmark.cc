@@ -0,0 +1,122 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "src/common/base/base.h"
+#include "src/stirling/source_connectors/dynamic_tracer/dynamic_trace_connector.h"
+#include "src/stirling/source_connectors/dynamic_tracer/struct_decode_plan.h"
+
+using ::px::stirling::ConvertFields;
+using ::px::stirling::DataTable;
+using ::px::stirling::DynamicDataTableSchema;
+using ::px::stirling::StructDecodePlan;
+using ::px::stirling::dynamic_tracing::ir::physical::Struct;
+
+// A typical uprobe output: upid, timestamp and a handful of scalar arguments.
+constexpr std::string_view kScalarStruct = R"(
+    name: "out_table_value_t"
+    fields { name: "tgid_" type: INT32 }
+    fields { name: "tgid_start_time_" type: UINT64 }
+    fields { name: "time_" type: UINT64 }
+    fields { name: "goid_" type: INT64 }
+    fields { name: "arg0" type: INT }
+    fields { name: "arg1" type: BOOL }
+    fields { name: "arg2" type: UINT16 }
+    fields { name: "arg3" type: DOUBLE }
+    fields { name: "retval" type: LONG }
+)";
+
+// Same as above, with a string argument and a struct argument rendered to JSON.
+constexpr std::string_view kMixedStruct = R"(
+    name: "out_table_value_t"
+    fields { name: "tgid_" type: INT32 }
+    fields { name: "tgid_start_time_" type: UINT64 }
+    fields { name: "time_" type: UINT64 }
+    fields { name: "goid_" type: INT64 }
+    fields { name: "arg0" type: STRING }
+    fields {
+      name: "arg1"
+      type: STRUCT_BLOB
+      blob_decoders {
+        entries { offset: 0 size: 4 type: INT32 path: "/X" }
+        entries { offset: 4 size: 8 type: INT64 path: "/Y/A" }
+        entries { offset: 12 size: 8 type: DOUBLE path: "/Y/B" }
+        entries { offset: 20 size: 1 type: BOOL path: "/Z" }
+      }
+    }
+    fields { name: "retval" type: LONG }
+)";
+
+// The number of records appended to the data table before it is drained.
+constexpr int kBatchSize = 1024;
+
+// NOLINTNEXTLINE(runtime/references)
+static void BM_struct_decode(benchmark::State& state, std::string_view output_struct_pbtxt) {
+  Struct output_struct;
+  CHECK(google::protobuf::TextFormat::ParseFromString(std::string(output_struct_pbtxt),
+                                                      &output_struct));
+  std::unique_ptr<DynamicDataTableSchema> table_schema =
+      DynamicDataTableSchema::Create("out_table", "", ConvertFields(output_struct.fields()));
+  DataTable data_table(/*id*/ 0, table_schema->Get());
+  const px::system::Config& sysconfig = px::system::Config::GetInstance();
+
+  StructDecodePlan plan = StructDecodePlan::Compile(output_struct).ConsumeValueOrDie();
+
+  // Fill in plausible lengths and decoder indexes; the payload bytes themselves are arbitrary.
+  std::string buf(plan.record_size(), 'x');
+  for (const auto& op : plan.ops()) {
+    if (op.code == StructDecodePlan::OpCode::kString) {
+      uint64_t len = 16;
+      memcpy(buf.data() + op.offset, &len, sizeof(len));
+      buf[op.offset + px::stirling::dynamic_tracing::kStructStringSize - 1] = 0;
+    } else if (op.code == StructDecodePlan::OpCode::kStructBlob) {
+      uint64_t len = 21;
+      memcpy(buf.data() + op.offset, &len, sizeof(len));
+      buf[op.offset + sizeof(len)] = 0;
+    }
+  }
+
+  int n = 0;
+  for (auto _ : state) {
+    PL_CHECK_OK(plan.Decode(buf, /*asid*/ 1, sysconfig, &data_table));
+    if (++n == kBatchSize) {
+      state.PauseTiming();
+      benchmark::DoNotOptimize(data_table.ConsumeRecords());
+      n = 0;
+      state.ResumeTiming();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// NOLINTNEXTLINE(runtime/references)
+static void BM_struct_decode_plan_compile(benchmark::State& state) {
+  Struct output_struct;
+  CHECK(google::protobuf::TextFormat::ParseFromString(std::string(kMixedStruct), &output_struct));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(StructDecodePlan::Compile(output_struct));
+  }
+}
+
+BENCHMARK_CAPTURE(BM_struct_decode, scalars, kScalarStruct);
+BENCHMARK_CAPTURE(BM_struct_decode, string_and_blob, kMixedStruct);
+BENCHMARK(BM_struct_decode_plan_compile);
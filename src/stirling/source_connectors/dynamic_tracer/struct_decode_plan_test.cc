@@ -0,0 +1,188 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/dynamic_tracer/struct_decode_plan.h"
+
+#include <string>
+
+#include "src/common/testing/testing.h"
+#include "src/shared/upid/upid.h"
+#include "src/stirling/source_connectors/dynamic_tracer/dynamic_trace_connector.h"
+#include "src/stirling/source_connectors/dynamic_tracer/dynamic_tracing/types.h"
+
+namespace px {
+namespace stirling {
+
+using ::px::stirling::dynamic_tracing::ir::physical::Struct;
+
+using OpCode = StructDecodePlan::OpCode;
+
+constexpr std::string_view kOutputStruct = R"(
+    name: "out_table_value_t"
+    fields {
+      name: "tgid_"
+      type: INT32
+    }
+    fields {
+      name: "tgid_start_time_"
+      type: UINT64
+    }
+    fields {
+      name: "arg0"
+      type: INT16
+    }
+    fields {
+      name: "arg1"
+      type: BOOL
+    }
+    fields {
+      name: "arg2"
+      type: DOUBLE
+    }
+    fields {
+      name: "arg3"
+      type: STRING
+    }
+    fields {
+      name: "arg4"
+      type: STRUCT_BLOB
+      blob_decoders {
+        entries {
+          offset: 0
+          size: 4
+          type: INT32
+          path: "/a"
+        }
+        entries {
+          offset: 4
+          size: 8
+          type: UINT64
+          path: "/b/c"
+        }
+      }
+    }
+)";
+
+class StructDecodePlanTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(std::string(kOutputStruct),
+                                                              &output_struct_));
+    table_schema_ = DynamicDataTableSchema::Create("out_table", "",
+                                                   ConvertFields(output_struct_.fields()));
+    data_table_ = std::make_unique<DataTable>(/*id*/ 0, table_schema_->Get());
+  }
+
+  template <typename T>
+  static void Write(std::string* buf, size_t offset, T val) {
+    memcpy(buf->data() + offset, &val, sizeof(val));
+  }
+
+  Struct output_struct_;
+  std::unique_ptr<DynamicDataTableSchema> table_schema_;
+  std::unique_ptr<DataTable> data_table_;
+};
+
+TEST_F(StructDecodePlanTest, Compile) {
+  ASSERT_OK_AND_ASSIGN(StructDecodePlan plan, StructDecodePlan::Compile(output_struct_));
+
+  ASSERT_EQ(plan.ops().size(), 6);
+  EXPECT_EQ(plan.ops()[0].code, OpCode::kUPID);
+  EXPECT_EQ(plan.ops()[1].code, OpCode::kInt16);
+  EXPECT_EQ(plan.ops()[2].code, OpCode::kBool);
+  EXPECT_EQ(plan.ops()[3].code, OpCode::kDouble);
+  EXPECT_EQ(plan.ops()[4].code, OpCode::kString);
+  EXPECT_EQ(plan.ops()[5].code, OpCode::kStructBlob);
+
+  // The output struct is packed.
+  EXPECT_EQ(plan.ops()[0].offset, 0);
+  EXPECT_EQ(plan.ops()[1].offset, 12);
+  EXPECT_EQ(plan.ops()[2].offset, 14);
+  EXPECT_EQ(plan.ops()[3].offset, 15);
+  EXPECT_EQ(plan.ops()[4].offset, 23);
+  EXPECT_EQ(plan.ops()[5].offset, 23 + dynamic_tracing::kStructStringSize);
+  EXPECT_EQ(plan.record_size(),
+            23 + dynamic_tracing::kStructStringSize + dynamic_tracing::kStructBlobSize);
+
+  for (size_t i = 0; i < plan.ops().size(); ++i) {
+    EXPECT_EQ(plan.ops()[i].col_idx, i);
+  }
+}
+
+TEST_F(StructDecodePlanTest, Decode) {
+  ASSERT_OK_AND_ASSIGN(StructDecodePlan plan, StructDecodePlan::Compile(output_struct_));
+
+  std::string buf(plan.record_size(), '\0');
+  Write<uint32_t>(&buf, 0, 123);
+  Write<uint64_t>(&buf, 4, 456);
+  Write<int16_t>(&buf, 12, -7);
+  Write<bool>(&buf, 14, true);
+  Write<double>(&buf, 15, 1.5);
+
+  const size_t str_offset = plan.ops()[4].offset;
+  Write<uint64_t>(&buf, str_offset, 5);
+  buf.replace(str_offset + 8, 5, "hello");
+  Write<uint8_t>(&buf, str_offset + dynamic_tracing::kStructStringSize - 1, 1);
+
+  const size_t blob_offset = plan.ops()[5].offset;
+  Write<uint64_t>(&buf, blob_offset, 12);
+  Write<int8_t>(&buf, blob_offset + 8, 0);
+  Write<int32_t>(&buf, blob_offset + 9, -1);
+  Write<uint64_t>(&buf, blob_offset + 13, 42);
+
+  constexpr uint32_t kASID = 7;
+  ASSERT_OK(plan.Decode(buf, kASID, system::Config::GetInstance(), data_table_.get()));
+
+  std::vector<TaggedRecordBatch> tablets = data_table_->ConsumeRecords();
+  ASSERT_EQ(tablets.size(), 1);
+  types::ColumnWrapperRecordBatch& rb = tablets[0].records;
+  ASSERT_EQ(rb.size(), 6);
+  ASSERT_EQ(rb[0]->Size(), 1);
+
+  EXPECT_EQ(rb[0]->Get<types::UInt128Value>(0), md::UPID(kASID, 123, 456).value());
+  EXPECT_EQ(rb[1]->Get<types::Int64Value>(0), -7);
+  EXPECT_EQ(rb[2]->Get<types::BoolValue>(0), true);
+  EXPECT_EQ(rb[3]->Get<types::Float64Value>(0), 1.5);
+  EXPECT_EQ(rb[4]->Get<types::StringValue>(0), "hello<truncated>");
+  EXPECT_EQ(rb[5]->Get<types::StringValue>(0), R"({"a":-1,"b":{"c":42}})");
+}
+
+TEST_F(StructDecodePlanTest, DecodeRejectsShortRecord) {
+  ASSERT_OK_AND_ASSIGN(StructDecodePlan plan, StructDecodePlan::Compile(output_struct_));
+
+  std::string buf(plan.record_size() - 1, '\0');
+  EXPECT_NOT_OK(plan.Decode(buf, /*asid*/ 0, system::Config::GetInstance(), data_table_.get()));
+
+  // Nothing was appended.
+  std::vector<TaggedRecordBatch> tablets = data_table_->ConsumeRecords();
+  for (const auto& tablet : tablets) {
+    EXPECT_EQ(tablet.records[0]->Size(), 0);
+  }
+}
+
+TEST(StructDecodePlanCompileTest, UnknownType) {
+  Struct output_struct;
+  auto* field = output_struct.add_fields();
+  field->set_name("arg0");
+  field->set_type(dynamic_tracing::ir::shared::ScalarType::UNKNOWN);
+
+  EXPECT_NOT_OK(StructDecodePlan::Compile(output_struct));
+}
+
+}  // namespace stirling
+}  // namespace px
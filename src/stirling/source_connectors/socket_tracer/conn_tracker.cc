@@ -39,6 +39,7 @@
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/go_grpc_types.hpp"
 #include "src/stirling/source_connectors/socket_tracer/conn_stats.h"
 #include "src/stirling/source_connectors/socket_tracer/conn_trackers_manager.h"
+#include "src/stirling/source_connectors/socket_tracer/metrics.h"
 #include "src/stirling/utils/enum_map.h"
 
 DEFINE_bool(treat_loopback_as_in_cluster, true,
@@ -748,7 +749,7 @@ void ConnTracker::UpdateDataStats(const SocketDataEvent& event) {
 
 void ConnTracker::IterationPreTick(
     const std::chrono::time_point<std::chrono::steady_clock>& iteration_time,
-    const std::vector<CIDRBlock>& cluster_cidrs, system::ProcParser* proc_parser,
+    const std::vector<CIDRBlock>& cluster_cidrs, FDTableManager* fd_table_mgr,
     system::SocketInfoManager* socket_info_mgr) {
   set_current_time(iteration_time);
 
@@ -764,7 +765,7 @@ void ConnTracker::IterationPreTick(
   // If remote_addr is missing, it means the connect/accept was not traced.
   // Attempt to infer the connection information, to populate remote_addr.
   if (open_info_.remote_addr.family == SockAddrFamily::kUnspecified && socket_info_mgr != nullptr) {
-    InferConnInfo(proc_parser, socket_info_mgr);
+    InferConnInfo(fd_table_mgr, socket_info_mgr);
 
     // TODO(oazizi): If connection resolves to SockAddr type "Other",
     //               we should mark the state in BPF to Other too, so BPF stops tracing.
@@ -806,6 +807,13 @@ void ConnTracker::IterationPostTick() {
                              magic_enum::enum_name(protocol())));
   }
 
+  if (state() != State::kDisabled &&
+      (send_data().ParseBudgetExhausted() || recv_data().ParseBudgetExhausted())) {
+    SocketTracerMetrics::GetProtocolMetrics(protocol()).parse_budget_exhausted_conns.Increment();
+    Disable(absl::Substitute("Parsing the connection as protocol $0 exhausted its budget",
+                             magic_enum::enum_name(protocol())));
+  }
+
   if (StitchFailureRate() > kStitchFailureRateThreshold) {
     Disable(absl::Substitute("Connection does not appear to produce valid records of protocol $0",
                              magic_enum::enum_name(protocol())));
@@ -905,9 +913,9 @@ endpoint_role_t TranslateRole(system::ClientServerRole role) {
 
 }  // namespace
 
-void ConnTracker::InferConnInfo(system::ProcParser* proc_parser,
+void ConnTracker::InferConnInfo(FDTableManager* fd_table_mgr,
                                 system::SocketInfoManager* socket_info_mgr) {
-  DCHECK(proc_parser != nullptr);
+  DCHECK(fd_table_mgr != nullptr);
   DCHECK(socket_info_mgr != nullptr);
 
   if (conn_resolution_failed_) {
@@ -919,7 +927,7 @@ void ConnTracker::InferConnInfo(system::ProcParser* proc_parser,
   }
 
   if (conn_resolver_ == nullptr) {
-    conn_resolver_ = std::make_unique<FDResolver>(proc_parser, conn_id_.upid.pid, conn_id_.fd);
+    conn_resolver_ = std::make_unique<FDResolver>(fd_table_mgr, conn_id_.upid, conn_id_.fd);
     bool success = conn_resolver_->Setup();
     if (!success) {
       conn_resolver_.reset();
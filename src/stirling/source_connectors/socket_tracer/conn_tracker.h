@@ -241,10 +241,10 @@ class ConnTracker : NotCopyMoveable {
    *
    * Intended for cases where the accept/connect was not traced.
    *
-   * @param proc_parser Pointer to a proc_parser for access to /proc filesystem.
+   * @param fd_table_mgr Pointer to a FDTableManager for access to /proc/<pid>/fd.
    * @param connections A map of inodes to endpoint information.
    */
-  void InferConnInfo(system::ProcParser* proc_parser, system::SocketInfoManager* socket_info_mgr);
+  void InferConnInfo(FDTableManager* fd_table_mgr, system::SocketInfoManager* socket_info_mgr);
 
   /**
    * Processes the connection tracker, parsing raw events into frames,
@@ -448,12 +448,11 @@ class ConnTracker : NotCopyMoveable {
    * connection tracker.
    * Should be called once per sampling, before ProcessToRecords().
    *
-   * @param proc_parser Pointer to a proc_parser for access to /proc filesystem.
+   * @param fd_table_mgr Pointer to a FDTableManager for access to /proc/<pid>/fd.
    * @param connections A map of inodes to endpoint information.
    */
   void IterationPreTick(const std::chrono::time_point<std::chrono::steady_clock>& iteration_time,
-                        const std::vector<CIDRBlock>& cluster_cidrs,
-                        system::ProcParser* proc_parser,
+                        const std::vector<CIDRBlock>& cluster_cidrs, FDTableManager* fd_table_mgr,
                         system::SocketInfoManager* socket_info_mgr);
 
   /**
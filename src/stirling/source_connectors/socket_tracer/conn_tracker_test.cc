@@ -503,7 +503,7 @@ TEST_F(ConnTrackerTest, DisabledForIntraClusterRemoteEndpoint) {
   tracker.AddControlEvent(conn);
   tracker.SetProtocol(kProtocolHTTP, "testing");
   tracker.SetRole(kRoleClient, "testing");
-  tracker.IterationPreTick(now(), {cidr}, /*proc_parser*/ nullptr, /*connections*/ nullptr);
+  tracker.IterationPreTick(now(), {cidr}, /*fd_table_mgr*/ nullptr, /*connections*/ nullptr);
   EXPECT_EQ(tracker.state(), ConnTracker::State::kDisabled);
   EXPECT_EQ(std::string(tracker.disable_reason()),
             std::string("No client-side tracing: Remote endpoint is inside the cluster."));
@@ -522,7 +522,7 @@ TEST_F(ConnTrackerTest, DisabledForLocalhostRemoteEndpoint) {
   tracker.AddControlEvent(conn);
   tracker.SetProtocol(kProtocolHTTP, "testing");
   tracker.SetRole(kRoleClient, "testing");
-  tracker.IterationPreTick(now(), {cidr}, /*proc_parser*/ nullptr, /*connections*/ nullptr);
+  tracker.IterationPreTick(now(), {cidr}, /*fd_table_mgr*/ nullptr, /*connections*/ nullptr);
   EXPECT_EQ(tracker.state(), ConnTracker::State::kDisabled);
   EXPECT_EQ(std::string(tracker.disable_reason()),
             std::string("No client-side tracing: Remote endpoint is inside the cluster."));
@@ -537,7 +537,7 @@ TEST_F(ConnTrackerTest, TrackerCollectingForClientSideTracingWithNoCIDR) {
   tracker.AddControlEvent(conn);
   tracker.SetProtocol(kProtocolHTTP, "testing");
   tracker.SetRole(kRoleClient, "testing");
-  tracker.IterationPreTick(now(), /*cluster_cidrs*/ {}, /*proc_parser*/ nullptr,
+  tracker.IterationPreTick(now(), /*cluster_cidrs*/ {}, /*fd_table_mgr*/ nullptr,
                            /*connections*/ nullptr);
   EXPECT_EQ(tracker.state(), ConnTracker::State::kCollecting);
 }
@@ -552,7 +552,7 @@ TEST_F(ConnTrackerTest, DisabledForUnixDomainSockets) {
 
   ConnTracker tracker;
   tracker.AddControlEvent(conn);
-  tracker.IterationPreTick(now(), {cidr}, /*proc_parser*/ nullptr, /*connections*/ nullptr);
+  tracker.IterationPreTick(now(), {cidr}, /*fd_table_mgr*/ nullptr, /*connections*/ nullptr);
   EXPECT_EQ(tracker.state(), ConnTracker::State::kDisabled);
   EXPECT_EQ(std::string(tracker.disable_reason()), "Unhandled socket address family");
 }
@@ -568,7 +568,7 @@ TEST_F(ConnTrackerTest, DisabledForOtherSockAddrFamily) {
 
   ConnTracker tracker;
   tracker.AddControlEvent(conn);
-  tracker.IterationPreTick(now(), {cidr}, /*proc_parser*/ nullptr, /*connections*/ nullptr);
+  tracker.IterationPreTick(now(), {cidr}, /*fd_table_mgr*/ nullptr, /*connections*/ nullptr);
   EXPECT_EQ(tracker.state(), ConnTracker::State::kDisabled);
   EXPECT_EQ(std::string(tracker.disable_reason()), "Unhandled socket address family");
 }
@@ -587,7 +587,7 @@ TEST_F(ConnTrackerTest, DisabledAfterMapping) {
     tracker.AddControlEvent(conn);
     tracker.SetProtocol(kProtocolHTTP, "testing");
     tracker.SetRole(kRoleClient, "testing");
-    tracker.IterationPreTick(now(), {cidr}, /*proc_parser*/ nullptr, /*connections*/ nullptr);
+    tracker.IterationPreTick(now(), {cidr}, /*fd_table_mgr*/ nullptr, /*connections*/ nullptr);
     EXPECT_EQ(ConnTracker::State::kDisabled, tracker.state());
     EXPECT_EQ(std::string(tracker.disable_reason()),
               std::string("No client-side tracing: Remote endpoint is inside the cluster."));
@@ -603,7 +603,7 @@ TEST_F(ConnTrackerTest, DisabledAfterMapping) {
     tracker.AddControlEvent(conn);
     tracker.SetProtocol(kProtocolHTTP, "testing");
     tracker.SetRole(kRoleClient, "testing");
-    tracker.IterationPreTick(now(), {cidr}, /*proc_parser*/ nullptr, /*connections*/ nullptr);
+    tracker.IterationPreTick(now(), {cidr}, /*fd_table_mgr*/ nullptr, /*connections*/ nullptr);
     EXPECT_EQ(ConnTracker::State::kDisabled, tracker.state());
     EXPECT_EQ(std::string(tracker.disable_reason()),
               std::string("No client-side tracing: Remote endpoint is inside the cluster."));
@@ -623,7 +623,7 @@ TEST_F(ConnTrackerTest, DisabledForNonTrackedUPID) {
   tracker.AddControlEvent(conn);
   tracker.SetProtocol(kProtocolHTTP, "testing");
   tracker.SetRole(kRoleClient, "testing");
-  tracker.IterationPreTick(now() + std::chrono::seconds(30), {cidr}, /*proc_parser*/ nullptr,
+  tracker.IterationPreTick(now() + std::chrono::seconds(30), {cidr}, /*fd_table_mgr*/ nullptr,
                            /*connections*/ nullptr);
   EXPECT_EQ(tracker.state(), ConnTracker::State::kDisabled);
   EXPECT_EQ(std::string(tracker.disable_reason()), std::string("Not a tracked process."));
@@ -17,6 +17,9 @@
  */
 
 #include <gflags/gflags.h>
+
+#include <algorithm>
+#include <chrono>
 #include <utility>
 
 #include "src/stirling/source_connectors/socket_tracer/data_stream.h"
@@ -43,6 +46,26 @@ DEFINE_uint32(
     "The duration, in seconds, after which the buffer will be cleared if there is no progress in "
     "the parser.");
 
+DEFINE_uint32(stirling_conn_parse_backoff_threshold,
+              gflags::Uint32FromEnv("PL_STIRLING_CONN_PARSE_BACKOFF_THRESHOLD", 4),
+              "The number of consecutive parse attempts that hit invalid data, or had to resync, "
+              "without a parsed frame, after which the parsing of a data stream is backed off "
+              "exponentially. Attempts that only need more data don't count.");
+DEFINE_uint32(stirling_conn_parse_backoff_max_skips,
+              gflags::Uint32FromEnv("PL_STIRLING_CONN_PARSE_BACKOFF_MAX_SKIPS", 16),
+              "The maximum number of iterations to skip parsing a data stream during backoff. "
+              "Set to 0 to disable the backoff.");
+DEFINE_uint64(
+    stirling_conn_parse_wasted_bytes_budget,
+    gflags::Uint64FromEnv("PL_STIRLING_CONN_PARSE_WASTED_BYTES_BUDGET", 256 * 1024 * 1024),
+    "The number of bytes of a data stream the parser may find invalid or resync over without "
+    "producing a frame, before its connection is disabled. Set to 0 for no limit.");
+DEFINE_uint32(stirling_conn_parse_wasted_cpu_budget_ms,
+              gflags::Uint32FromEnv("PL_STIRLING_CONN_PARSE_WASTED_CPU_BUDGET_MS", 1000),
+              "The parsing time, in milliseconds, a data stream may spend on invalid or resync "
+              "parses without producing a frame, before its connection is disabled. "
+              "Set to 0 for no limit.");
+
 namespace px {
 namespace stirling {
 
@@ -76,6 +99,13 @@ void DataStream::ProcessBytesToFrames(message_type_t type, TStateType* state) {
   // TODO(oazizi): Convert to ECHECK once we have more confidence.
   LOG_IF(WARNING, IsEOS()) << "DataStream reaches EOS, no more data to process.";
 
+  // Back off from a stream that keeps failing to parse. Its data is kept, so nothing is lost if
+  // it becomes parseable. A closed connection gets a final attempt.
+  if (parse_backoff_skips_ > 0 && !conn_closed()) {
+    --parse_backoff_skips_;
+    return;
+  }
+
   const size_t orig_pos = data_buffer_.position();
 
   // A description of some key variables in this function:
@@ -108,13 +138,40 @@ void DataStream::ProcessBytesToFrames(message_type_t type, TStateType* state) {
   parse_result.end_position = 0;
 
   size_t frame_bytes = 0;
+  size_t num_frames = 0;
+  // Whether any attempt hit invalid data or resynced, and was charged to the parse budget.
+  bool charged_parse = false;
 
   while (keep_processing && !data_buffer_.empty()) {
     size_t contiguous_bytes = data_buffer_.Head().size();
+    size_t head_pos = data_buffer_.position();
+    bool resync = IsSyncRequired();
 
     // Now parse the raw data.
-    parse_result =
-        protocols::ParseFrames(type, &data_buffer_, &typed_messages, IsSyncRequired(), state);
+    auto parse_start = std::chrono::steady_clock::now();
+    parse_result = protocols::ParseFrames(type, &data_buffer_, &typed_messages, resync, state);
+    auto parse_time = std::chrono::steady_clock::now() - parse_start;
+
+    if (parse_result.frame_positions.empty()) {
+      auto& metrics = SocketTracerMetrics::GetProtocolMetrics(protocol_);
+      metrics.parse_wasted_attempts.Increment();
+
+      // A frame that is split across events needs more data, which is no reason to give up on
+      // the stream. Only invalid data, or data that had to be resynced over, is charged to the
+      // budget. Bytes that are submitted again on later attempts are only charged once.
+      if (parse_result.state == ParseState::kInvalid || parse_result.invalid_frames > 0 ||
+          resync) {
+        size_t head_end_pos = head_pos + contiguous_bytes;
+        size_t charge_start_pos = std::max(head_pos, wasted_parse_end_pos_);
+        size_t new_bytes = head_end_pos > charge_start_pos ? head_end_pos - charge_start_pos : 0;
+        wasted_parse_end_pos_ = std::max(wasted_parse_end_pos_, head_end_pos);
+
+        wasted_parse_bytes_ += new_bytes;
+        wasted_parse_time_ += parse_time;
+        metrics.parse_wasted_bytes.Increment(new_bytes);
+        charged_parse = true;
+      }
+    }
     if (contiguous_bytes != data_buffer_.size()) {
       // We weren't able to submit all bytes, which means we ran into a missing event.
       // We don't expect missing events to arrive in the future, so just cut our losses.
@@ -139,6 +196,24 @@ void DataStream::ProcessBytesToFrames(message_type_t type, TStateType* state) {
     stat_raw_data_gaps_ += keep_processing;
 
     frame_bytes += parse_result.frame_bytes;
+    num_frames += parse_result.frame_positions.size();
+  }
+
+  if (num_frames > 0) {
+    consecutive_wasted_parses_ = 0;
+    wasted_parse_bytes_ = 0;
+    wasted_parse_time_ = std::chrono::nanoseconds{0};
+  } else if (charged_parse) {
+    // Skip 1, 2, 4, ... calls once the threshold is reached, up to the max skips. Like the budget,
+    // the backoff ignores attempts that only need more data, so that large or split messages are
+    // never delayed.
+    ++consecutive_wasted_parses_;
+    int excess = consecutive_wasted_parses_ -
+                 static_cast<int>(FLAGS_stirling_conn_parse_backoff_threshold);
+    if (excess >= 0) {
+      parse_backoff_skips_ = std::min<uint64_t>(uint64_t{1} << std::min(excess, 31),
+                                                FLAGS_stirling_conn_parse_backoff_max_skips);
+    }
   }
 
   // Check to see if we are blocked on parsing.
@@ -204,6 +279,7 @@ template void DataStream::ProcessBytesToFrames<protocols::nats::Message, protoco
 
 void DataStream::Reset() {
   data_buffer_.Reset();
+  wasted_parse_end_pos_ = 0;
   has_new_events_ = false;
   UpdateLastProgressTime();
 
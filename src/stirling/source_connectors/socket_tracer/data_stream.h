@@ -35,6 +35,11 @@ DECLARE_uint32(datastream_buffer_allow_before_gap_size);
 DECLARE_uint32(buffer_resync_duration_secs);
 DECLARE_uint32(buffer_expiration_duration_secs);
 
+DECLARE_uint32(stirling_conn_parse_backoff_threshold);
+DECLARE_uint32(stirling_conn_parse_backoff_max_skips);
+DECLARE_uint64(stirling_conn_parse_wasted_bytes_budget);
+DECLARE_uint32(stirling_conn_parse_wasted_cpu_budget_ms);
+
 namespace px {
 namespace stirling {
 
@@ -179,6 +184,24 @@ class DataStream : NotCopyMoveable {
     return 1.0 * stat_invalid_frames_ / total_attempts;
   }
 
+  /**
+   * Whether parsing has wasted too many resources since the last parsed frame.
+   *
+   * Calls to ParseFrames() that produce no frame because the data is invalid, or because the
+   * parser had to resync, are considered wasted. The bytes they were given, each counted once,
+   * and the CPU time they took count against the budget. Frames that merely need more data are
+   * not charged.
+   * Streams that exhaust the budget are unlikely to ever be parseable as their protocol.
+   */
+  bool ParseBudgetExhausted() const {
+    const uint64_t kBytesBudget = FLAGS_stirling_conn_parse_wasted_bytes_budget;
+    const auto kCPUBudget =
+        std::chrono::milliseconds(FLAGS_stirling_conn_parse_wasted_cpu_budget_ms);
+
+    return (kBytesBudget != 0 && wasted_parse_bytes_ > kBytesBudget) ||
+           (kCPUBudget.count() != 0 && wasted_parse_time_ > kCPUBudget);
+  }
+
   /**
    * Checks if the DataStream is at end-of-stream (EOS), which means that we
    * should stop processing the data on the stream, even if more exists.
@@ -307,6 +330,19 @@ class DataStream : NotCopyMoveable {
   int stat_invalid_frames_ = 0;
   int stat_raw_data_gaps_ = 0;
 
+  // Resources spent on ParseFrames() calls that hit invalid data or resynced without producing
+  // frames, since the last parsed frame.
+  int consecutive_wasted_parses_ = 0;
+  uint64_t wasted_parse_bytes_ = 0;
+  std::chrono::nanoseconds wasted_parse_time_{0};
+  // The end position of the bytes charged to wasted_parse_bytes_ so far, so that bytes submitted
+  // again on later attempts are not charged twice.
+  size_t wasted_parse_end_pos_ = 0;
+
+  // The number of upcoming calls to ProcessBytesToFrames() to skip, as a backoff from wasted
+  // parses.
+  uint32_t parse_backoff_skips_ = 0;
+
   // A copy of the parse state from the last call to ProcessToRecords().
   ParseState last_parse_state_ = ParseState::kInvalid;
 
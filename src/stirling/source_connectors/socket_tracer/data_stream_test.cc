@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <random>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -466,5 +467,135 @@ TEST_F(DataStreamTest, ResyncCausesDuplicateEventBug) {
   EXPECT_EQ(requests[2].req_path, "/bar.html");
 }
 
+TEST_F(DataStreamTest, ParseBackoff) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_stirling_conn_parse_backoff_threshold = 2;
+  FLAGS_stirling_conn_parse_backoff_max_skips = 4;
+
+  protocols::http::StateWrapper state{};
+  const auto& metrics = SocketTracerMetrics::GetProtocolMetrics(kProtocolHTTP);
+
+  DataStream stream;
+  stream.set_protocol(kProtocolHTTP);
+
+  // Feed invalid data, so that no attempt produces a frame.
+  const std::string kGarbage(12, '\x01');
+  for (int i = 0; i < 4; ++i) {
+    stream.AddData(event_gen_.InitSendEvent<kProtocolHTTP>(kGarbage));
+    stream.ProcessBytesToFrames<http::Message>(message_type_t::kRequest, &state);
+  }
+
+  // The second wasted attempt reached the threshold, so the third call was skipped.
+  EXPECT_EQ(metrics.parse_wasted_attempts.Value(), 3);
+
+  // The third wasted attempt doubled the backoff, so the data is only parsed on the third call.
+  stream.AddData(event_gen_.InitSendEvent<kProtocolHTTP>(kHTTPReq0));
+  stream.ProcessBytesToFrames<http::Message>(message_type_t::kRequest, &state);
+  EXPECT_THAT(stream.Frames<http::Message>(), IsEmpty());
+  stream.ProcessBytesToFrames<http::Message>(message_type_t::kRequest, &state);
+  EXPECT_THAT(stream.Frames<http::Message>(), IsEmpty());
+  stream.ProcessBytesToFrames<http::Message>(message_type_t::kRequest, &state);
+  ASSERT_THAT(stream.Frames<http::Message>(), SizeIs(1));
+  EXPECT_EQ(stream.Frames<http::Message>()[0].req_path, "/index.html");
+
+  EXPECT_EQ(metrics.parse_wasted_attempts.Value(), 3);
+}
+
+TEST_F(DataStreamTest, ParseBackoffIgnoresSplitMessages) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_stirling_conn_parse_backoff_threshold = 1;
+  FLAGS_stirling_conn_parse_backoff_max_skips = 4;
+
+  protocols::http::StateWrapper state{};
+
+  DataStream stream;
+  stream.set_protocol(kProtocolHTTP);
+
+  // Feed a request one byte at a time. Every attempt but the last only needs more data, which is
+  // no reason to back off, so the request is parsed as soon as its last byte arrives.
+  for (size_t i = 0; i < kHTTPReq0.size(); ++i) {
+    EXPECT_THAT(stream.Frames<http::Message>(), IsEmpty());
+    stream.AddData(event_gen_.InitSendEvent<kProtocolHTTP>(kHTTPReq0.substr(i, 1)));
+    stream.ProcessBytesToFrames<http::Message>(message_type_t::kRequest, &state);
+  }
+  ASSERT_THAT(stream.Frames<http::Message>(), SizeIs(1));
+  EXPECT_EQ(stream.Frames<http::Message>()[0].req_path, "/index.html");
+  EXPECT_EQ(0, SocketTracerMetrics::GetProtocolMetrics(kProtocolHTTP).data_loss_bytes.Value());
+}
+
+TEST_F(DataStreamTest, ParseBudget) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_stirling_conn_parse_backoff_max_skips = 0;
+  FLAGS_stirling_conn_parse_wasted_bytes_budget = 20;
+
+  protocols::http::StateWrapper state{};
+  const auto& metrics = SocketTracerMetrics::GetProtocolMetrics(kProtocolHTTP);
+
+  DataStream stream;
+  stream.set_protocol(kProtocolHTTP);
+
+  // A valid request split across many events only needs more data. It is not charged, even though
+  // far more bytes than the budget are submitted to the parser before it completes.
+  constexpr size_t kChunkSize = 8;
+  size_t pos = 0;
+  for (; pos + kChunkSize < kHTTPReq0.size(); pos += kChunkSize) {
+    stream.AddData(event_gen_.InitSendEvent<kProtocolHTTP>(kHTTPReq0.substr(pos, kChunkSize)));
+    stream.ProcessBytesToFrames<http::Message>(message_type_t::kRequest, &state);
+    EXPECT_FALSE(stream.ParseBudgetExhausted());
+  }
+  stream.AddData(event_gen_.InitSendEvent<kProtocolHTTP>(kHTTPReq0.substr(pos)));
+  stream.ProcessBytesToFrames<http::Message>(message_type_t::kRequest, &state);
+  EXPECT_THAT(stream.Frames<http::Message>(), SizeIs(1));
+  EXPECT_FALSE(stream.ParseBudgetExhausted());
+  EXPECT_EQ(metrics.parse_wasted_bytes.Value(), 0);
+
+  // Invalid data is charged.
+  const std::string kGarbage(12, '\x01');
+  stream.AddData(event_gen_.InitSendEvent<kProtocolHTTP>(kGarbage));
+  stream.ProcessBytesToFrames<http::Message>(message_type_t::kRequest, &state);
+  EXPECT_FALSE(stream.ParseBudgetExhausted());
+  EXPECT_EQ(metrics.parse_wasted_bytes.Value(), 12);
+
+  stream.AddData(event_gen_.InitSendEvent<kProtocolHTTP>(kGarbage));
+  stream.ProcessBytesToFrames<http::Message>(message_type_t::kRequest, &state);
+  EXPECT_TRUE(stream.ParseBudgetExhausted());
+  EXPECT_EQ(metrics.parse_wasted_bytes.Value(), 24);
+
+  // A parsed frame restores the budget.
+  stream.AddData(event_gen_.InitSendEvent<kProtocolHTTP>(kHTTPReq0));
+  stream.ProcessBytesToFrames<http::Message>(message_type_t::kRequest, &state);
+  EXPECT_THAT(stream.Frames<http::Message>(), SizeIs(2));
+  EXPECT_FALSE(stream.ParseBudgetExhausted());
+}
+
+TEST_F(DataStreamTest, ParseBudgetChargesResyncedBytesOnce) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_stirling_conn_parse_backoff_max_skips = 0;
+
+  protocols::http::StateWrapper state{};
+  const auto& metrics = SocketTracerMetrics::GetProtocolMetrics(kProtocolHTTP);
+
+  DataStream stream;
+  stream.set_protocol(kProtocolHTTP);
+  stream.set_current_time(now());
+
+  stream.AddData(event_gen_.InitSendEvent<kProtocolHTTP>(kHTTPReq0.substr(0, 12)));
+  stream.ProcessBytesToFrames<http::Message>(message_type_t::kRequest, &state);
+  EXPECT_EQ(metrics.parse_wasted_bytes.Value(), 0);
+
+  // The stream makes no progress, so the parser is asked to resync, and the bytes are charged.
+  stream.set_current_time(now() + std::chrono::seconds(FLAGS_buffer_resync_duration_secs));
+  stream.ProcessBytesToFrames<http::Message>(message_type_t::kRequest, &state);
+  EXPECT_EQ(metrics.parse_wasted_bytes.Value(), 12);
+
+  // The same bytes are resubmitted on every resync attempt, but are only charged once.
+  stream.ProcessBytesToFrames<http::Message>(message_type_t::kRequest, &state);
+  EXPECT_EQ(metrics.parse_wasted_bytes.Value(), 12);
+
+  stream.AddData(event_gen_.InitSendEvent<kProtocolHTTP>(kHTTPReq0.substr(12, 8)));
+  stream.ProcessBytesToFrames<http::Message>(message_type_t::kRequest, &state);
+  EXPECT_EQ(metrics.parse_wasted_bytes.Value(), 20);
+}
+
 }  // namespace stirling
 }  // namespace px
@@ -18,6 +18,11 @@
 
 #include "src/stirling/source_connectors/socket_tracer/fd_resolver.h"
 
+#include <poll.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <chrono>
 
 #include "src/common/base/base.h"
@@ -26,8 +31,129 @@
 namespace px {
 namespace stirling {
 
-FDResolver::FDResolver(system::ProcParser* proc_parser, int pid, int fd)
-    : proc_parser_(proc_parser), pid_(pid), fd_(fd) {}
+//-----------------------------------------------------------------------------
+// FDTableManager
+//-----------------------------------------------------------------------------
+
+namespace {
+
+// Returns a pidfd for the process, or -1 if pidfds are not supported (Linux < 5.3).
+int OpenPIDFD(int pid) {
+#ifdef SYS_pidfd_open
+  return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+  PL_UNUSED(pid);
+  return -1;
+#endif
+}
+
+// A pidfd becomes readable once the process has exited.
+bool PIDFDExited(int pidfd) {
+  struct pollfd poll_fd = {.fd = pidfd, .events = POLLIN, .revents = 0};
+  return poll(&poll_fd, 1, /* timeout */ 0) > 0;
+}
+
+}  // namespace
+
+FDTableManager::FDTable::~FDTable() {
+  if (pidfd >= 0) {
+    close(pidfd);
+  }
+}
+
+Status FDTableManager::Pin(const struct upid_t& upid, FDTable* table) {
+  // Open the pidfd before checking the start time of the process, so that the pidfd is known to
+  // refer to the process of the UPID, and not to a process that reused its PID.
+  table->pidfd = OpenPIDFD(upid.pid);
+
+  PL_ASSIGN_OR_RETURN(int64_t start_time_ticks, proc_parser_->GetPIDStartTimeTicks(upid.pid));
+  if (static_cast<uint64_t>(start_time_ticks) != upid.start_time_ticks) {
+    return error::NotFound("Process $0 has exited, and its PID was reused.", upid.pid);
+  }
+  return Status::OK();
+}
+
+Status FDTableManager::CheckNotExited(const struct upid_t& upid, FDTable* table) {
+  // Without a pidfd, the start time check in Pin() is the only protection against PID reuse.
+  if (table->pidfd >= 0 && PIDFDExited(table->pidfd)) {
+    // The FDs that were read may belong to a new process that reused the PID.
+    table->process_status = error::NotFound("Process $0 has exited.", upid.pid);
+  }
+  return table->process_status;
+}
+
+Status FDTableManager::Snapshot(const struct upid_t& upid, FDTable* table) {
+  table->start_time = std::chrono::steady_clock::now();
+  Status s = proc_parser_->ReadProcPIDFDLinks(upid.pid, &table->links);
+  table->end_time = std::chrono::steady_clock::now();
+  if (s.ok()) {
+    s = CheckNotExited(upid, table);
+  }
+  if (!s.ok()) {
+    table->links.clear();
+  }
+  return s;
+}
+
+StatusOr<FDTableManager::FDLink> FDTableManager::ReadFDLink(const struct upid_t& upid, int fd) {
+  std::unique_ptr<FDTable>& table = fd_tables_[upid];
+  if (table == nullptr) {
+    table = std::make_unique<FDTable>();
+    table->process_status = Pin(upid, table.get());
+  }
+
+  if (table->access_generation != generation_) {
+    table->prev_num_reads = (table->access_generation == generation_ - 1) ? table->num_reads : 0;
+    table->num_reads = 0;
+    table->access_generation = generation_;
+  }
+  ++table->num_reads;
+
+  // Failures are remembered while the table is accessed, so that the FDs of a process that is
+  // gone do not cause repeated attempts.
+  PL_RETURN_IF_ERROR(table->process_status);
+
+  // Snapshot the FD table once enough of its FDs are read, either in this generation or in the
+  // previous one. Failed snapshots are also remembered for the generation.
+  if (table->snapshot_generation != generation_ &&
+      std::max(table->num_reads, table->prev_num_reads) >= kMinFDsPerSnapshot) {
+    table->snapshot_status = Snapshot(upid, table.get());
+    table->snapshot_generation = generation_;
+  }
+
+  if (table->snapshot_generation == generation_) {
+    PL_RETURN_IF_ERROR(table->snapshot_status);
+    auto iter = table->links.find(fd);
+    if (iter != table->links.end()) {
+      return FDLink{iter->second, table->start_time, table->end_time};
+    }
+  }
+
+  // Read the link directly, either because too few FDs of the process are read to make a snapshot
+  // worthwhile, or because the FD was opened after the snapshot was taken.
+  FDLink fd_link;
+  fd_link.start_time = std::chrono::steady_clock::now();
+  PL_RETURN_IF_ERROR(proc_parser_->ReadProcPIDFDLink(upid.pid, fd, &fd_link.link));
+  fd_link.end_time = std::chrono::steady_clock::now();
+  PL_RETURN_IF_ERROR(CheckNotExited(upid, table.get()));
+  return fd_link;
+}
+
+void FDTableManager::Flush() {
+  // Drop the tables that were not accessed during the last generation.
+  absl::erase_if(fd_tables_, [this](const auto& entry) {
+    return entry.second->access_generation < generation_;
+  });
+
+  ++generation_;
+}
+
+//-----------------------------------------------------------------------------
+// FDResolver
+//-----------------------------------------------------------------------------
+
+FDResolver::FDResolver(FDTableManager* fd_table_mgr, const struct upid_t& upid, int fd)
+    : fd_table_mgr_(fd_table_mgr), upid_(upid), fd_(fd) {}
 
 bool FDResolver::Setup() {
   // Record some information about the FD.
@@ -36,17 +162,19 @@ bool FDResolver::Setup() {
   // the hope is that we can recover the socket information on the next iteration,
   // if the connection appears to be stable.
 
-  Status s = proc_parser_->ReadProcPIDFDLink(pid_, fd_, &fd_link_);
-  if (!s.ok()) {
-    VLOG(2) << absl::Substitute("Can't set-up connection inference [msg=$0].", s.msg());
+  StatusOr<FDTableManager::FDLink> fd_link_or = fd_table_mgr_->ReadFDLink(upid_, fd_);
+  if (!fd_link_or.ok()) {
+    VLOG(2) << absl::Substitute("Can't set-up connection inference [msg=$0].", fd_link_or.msg());
     active_ = false;
     return false;
   }
+  FDTableManager::FDLink fd_link = fd_link_or.ConsumeValueOrDie();
+  fd_link_ = std::move(fd_link.link);
 
   VLOG(2) << absl::Substitute("Set-up connection inference: $0", fd_link_);
-  // Record the time slightly after recording the FD, so we have a more conservative
+  // Use a time after recording the FD, so we have a more conservative
   // time window. We don't want false positives.
-  first_timestamp_ = std::chrono::steady_clock::now();
+  first_timestamp_ = fd_link.end_time;
   active_ = true;
   return true;
 }
@@ -55,27 +183,24 @@ bool FDResolver::Update() {
   ECHECK(active_) << "FDResolver must be in active state.";
   ECHECK(!fd_link_.empty()) << "Candidate FD link should not be empty";
 
-  // Record the timestamp. Must be done before reading /proc,
-  // to avoid a race where we find the /proc FD entry, then the FD closes, then we grab the
-  // timestamp. This would result in having an incorrect window of time during which the FD was
-  // valid.
-  std::chrono::time_point<std::chrono::steady_clock> timestamp = std::chrono::steady_clock::now();
-
-  std::string current_fd_link;
-  Status s = proc_parser_->ReadProcPIDFDLink(pid_, fd_, &current_fd_link);
-  if (!s.ok()) {
+  StatusOr<FDTableManager::FDLink> fd_link_or = fd_table_mgr_->ReadFDLink(upid_, fd_);
+  if (!fd_link_or.ok()) {
     VLOG(2) << "Can't infer remote endpoint. FD is not accessible.";
     active_ = false;
     return false;
   }
+  const FDTableManager::FDLink& current_fd_link = fd_link_or.ValueOrDie();
 
-  if (current_fd_link != fd_link_) {
+  if (current_fd_link.link != fd_link_) {
     VLOG(2) << "Can't infer remote endpoint. FD link has changed, implying connection has closed.";
     active_ = false;
     return false;
   }
 
-  last_timestamp_ = std::move(timestamp);
+  // Use the time before reading /proc, to avoid a race where we find the /proc FD entry, then the
+  // FD closes, then we grab the timestamp. This would result in having an incorrect window of time
+  // during which the FD was valid.
+  last_timestamp_ = current_fd_link.start_time;
   return true;
 }
 
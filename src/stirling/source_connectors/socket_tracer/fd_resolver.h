@@ -18,12 +18,15 @@
 
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
+
 #include "src/common/system/proc_parser.h"
 #include "src/common/system/socket_info.h"
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/socket_trace.hpp"
@@ -31,6 +34,90 @@
 namespace px {
 namespace stirling {
 
+/**
+ * FDTableManager provides the FD links of processes, as found in /proc/<pid>/fd.
+ *
+ * A process whose FDs are read by several trackers in a generation gets its whole FD table read
+ * in one pass, and that snapshot is shared by the trackers for the rest of the generation.
+ * Processes with only a few tracked FDs have their links read one at a time, since a snapshot
+ * also reads the links of all their untracked FDs. A generation normally corresponds to one
+ * iteration of the socket tracer, and is advanced by Flush().
+ *
+ * Tables are keyed by UPID, so a process that reuses the PID of an exited process gets a table
+ * of its own. When supported by the kernel, a pidfd is held for each process, so that reads which
+ * race with the exit of the process and the reuse of its PID are detected.
+ */
+class FDTableManager {
+ public:
+  struct FDLink {
+    std::string link;
+
+    // The link was observed at some time between these two times.
+    std::chrono::time_point<std::chrono::steady_clock> start_time;
+    std::chrono::time_point<std::chrono::steady_clock> end_time;
+  };
+
+  // The number of FDs of a process that must be read in a generation before its FD table is read
+  // in a single snapshot.
+  static constexpr int kMinFDsPerSnapshot = 4;
+
+  /**
+   * @param proc_parser Pointer to a /proc parser which is used to read the FD info.
+   */
+  explicit FDTableManager(system::ProcParser* proc_parser) : proc_parser_(proc_parser) {}
+
+  /**
+   * Returns the link of the FD of the process.
+   * Reads within the same generation are served from a shared snapshot once the process has
+   * enough FDs being read, see kMinFDsPerSnapshot.
+   */
+  StatusOr<FDLink> ReadFDLink(const struct upid_t& upid, int fd);
+
+  /**
+   * Starts a new generation, so that FD tables are read again on their next access.
+   * FD tables that were not accessed during the last generation are dropped.
+   */
+  void Flush();
+
+ private:
+  struct FDTable {
+    FDTable() = default;
+    FDTable(const FDTable&) = delete;
+    FDTable& operator=(const FDTable&) = delete;
+    ~FDTable();
+
+    // Not OK once the process is known to have exited, or to not be the process of the UPID.
+    Status process_status;
+    // A pidfd of the process, or -1 if pidfds are not supported.
+    int pidfd = -1;
+
+    absl::flat_hash_map<int32_t, std::string> links;
+    std::chrono::time_point<std::chrono::steady_clock> start_time;
+    std::chrono::time_point<std::chrono::steady_clock> end_time;
+
+    // The generation in which links was last read, and the result of that read.
+    int64_t snapshot_generation = -1;
+    Status snapshot_status;
+
+    // The generation in which this table was last accessed.
+    int64_t access_generation = -1;
+    // The number of reads during the generation of the last access, and during the one before.
+    int num_reads = 0;
+    int prev_num_reads = 0;
+  };
+
+  Status Pin(const struct upid_t& upid, FDTable* table);
+  Status CheckNotExited(const struct upid_t& upid, FDTable* table);
+  Status Snapshot(const struct upid_t& upid, FDTable* table);
+
+  system::ProcParser* proc_parser_;
+
+  absl::flat_hash_map<struct upid_t, std::unique_ptr<FDTable>> fd_tables_;
+
+  // Incremented by every call to Flush().
+  int64_t generation_ = 0;
+};
+
 /**
  * SocketResolver tries to determine the socket inode number of a given a PID and FD.
  *
@@ -46,11 +133,11 @@ class FDResolver {
   /**
    * Creates a SocketResolver for the PID and FD.
    *
-   * @param proc_parser Pointer to a /proc parser which is used to read the FD info
-   * @param pid The PID to monitor.
-   * @param fd The FD of the PID to monitor.
+   * @param fd_table_mgr Pointer to a FDTableManager which is used to read the FD info.
+   * @param upid The process to monitor.
+   * @param fd The FD of the process to monitor.
    */
-  FDResolver(system::ProcParser* proc_parser, int pid, int fd);
+  FDResolver(FDTableManager* fd_table_mgr, const struct upid_t& upid, int fd);
 
   /**
    * Collects the first sample from Linux, to begin the tracking process.
@@ -59,6 +146,8 @@ class FDResolver {
 
   /**
    * Collects another sample from Linux to update its view of the PID+FD.
+   * Samples are only refreshed once per generation of the FDTableManager, so this should be
+   * called after FDTableManager::Flush().
    */
   bool Update();
 
@@ -80,14 +169,14 @@ class FDResolver {
   bool IsActive() { return active_; }
 
   std::string DebugInfo() {
-    return absl::Substitute("pid=$0 fd=$1 t=$2-$3 active=$4 fdlink=$5", pid_, fd_,
+    return absl::Substitute("pid=$0 fd=$1 t=$2-$3 active=$4 fdlink=$5", upid_.pid, fd_,
                             first_timestamp_.time_since_epoch().count(),
                             last_timestamp_.time_since_epoch().count(), active_, fd_link_);
   }
 
  private:
-  system::ProcParser* proc_parser_;
-  int pid_;
+  FDTableManager* fd_table_mgr_;
+  struct upid_t upid_;
   int fd_;
 
   bool active_;
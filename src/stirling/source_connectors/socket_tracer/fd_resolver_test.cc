@@ -20,8 +20,11 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <memory>
+#include <vector>
 
 #include "src/common/base/types.h"
+#include "src/common/testing/testing.h"
 #include "src/common/system/tcp_socket.h"
 #include "src/stirling/source_connectors/socket_tracer/fd_resolver.h"
 
@@ -32,17 +35,23 @@ class FDResolverTest : public ::testing::Test {
  protected:
   void SetUp() {
     proc_parser_ = std::make_unique<system::ProcParser>(system::Config::GetInstance());
+    fd_table_mgr_ = std::make_unique<FDTableManager>(proc_parser_.get());
+
+    upid_.pid = getpid();
+    ASSERT_OK_AND_ASSIGN(int64_t start_time_ticks, proc_parser_->GetPIDStartTimeTicks(upid_.pid));
+    upid_.start_time_ticks = start_time_ticks;
   }
 
   std::unique_ptr<system::ProcParser> proc_parser_;
+  std::unique_ptr<FDTableManager> fd_table_mgr_;
+  struct upid_t upid_ = {};
 };
 
 TEST_F(FDResolverTest, ResolveStdin) {
-  int pid = getpid();
   int fd = STDOUT_FILENO;
 
   // Step 1 - Setup FDResolver.
-  auto resolver = FDResolver(proc_parser_.get(), pid, fd);
+  auto resolver = FDResolver(fd_table_mgr_.get(), upid_, fd);
 
   std::optional<std::string_view> fd_link;
   bool success;
@@ -60,6 +69,7 @@ TEST_F(FDResolverTest, ResolveStdin) {
   auto t = std::chrono::steady_clock::now();
 
   // Step 2 - Update FDResolver to capture connection if stable.
+  fd_table_mgr_->Flush();
   success = resolver.Update();
   EXPECT_TRUE(success);
 
@@ -76,11 +86,10 @@ TEST_F(FDResolverTest, ResolveStdin) {
 
 TEST_F(FDResolverTest, CaptureLongLivedSocket) {
   system::TCPSocket socket;
-  int pid = getpid();
   int fd = socket.sockfd();
 
   // Step 1 - Setup FDResolver.
-  auto resolver = FDResolver(proc_parser_.get(), pid, fd);
+  auto resolver = FDResolver(fd_table_mgr_.get(), upid_, fd);
 
   std::optional<std::string_view> fd_link;
   bool success;
@@ -98,6 +107,7 @@ TEST_F(FDResolverTest, CaptureLongLivedSocket) {
   auto t = std::chrono::steady_clock::now();
 
   // Step 2 - Update FDResolver to capture connection if stable.
+  fd_table_mgr_->Flush();
   success = resolver.Update();
   EXPECT_TRUE(success);
 
@@ -114,14 +124,13 @@ TEST_F(FDResolverTest, CaptureLongLivedSocket) {
 
 TEST_F(FDResolverTest, MissShortLivedSocketNoWindow) {
   system::TCPSocket socket;
-  int pid = getpid();
   int fd = socket.sockfd();
 
   std::optional<std::string_view> fd_link;
   bool success;
 
   // Step 1 - Setup FDResolver.
-  auto resolver = FDResolver(proc_parser_.get(), pid, fd);
+  auto resolver = FDResolver(fd_table_mgr_.get(), upid_, fd);
   success = resolver.Setup();
   ASSERT_TRUE(success);
 
@@ -130,6 +139,7 @@ TEST_F(FDResolverTest, MissShortLivedSocketNoWindow) {
   socket.Close();
 
   // Step 2 - Update FDResolver to capture connection if stable.
+  fd_table_mgr_->Flush();
   // Resolver should return nullopt, because connection was already gone before Update() call.
   // Resolver can build any time window validity for the socket.
   success = resolver.Update();
@@ -140,28 +150,26 @@ TEST_F(FDResolverTest, MissShortLivedSocketNoWindow) {
 
 TEST_F(FDResolverTest, MissShortLivedSocketNoSetup) {
   system::TCPSocket socket;
-  int pid = getpid();
   int fd = socket.sockfd();
   // Some activity at time t, between socket creation and close.
   auto t = std::chrono::steady_clock::now();
   PL_UNUSED(t);
   socket.Close();
 
-  auto resolver = FDResolver(proc_parser_.get(), pid, fd);
+  auto resolver = FDResolver(fd_table_mgr_.get(), upid_, fd);
   bool success = resolver.Setup();
   EXPECT_FALSE(success);
 }
 
 TEST_F(FDResolverTest, NewSocketSameFD) {
   system::TCPSocket socket;
-  int pid = getpid();
   int fd = socket.sockfd();
 
   std::optional<std::string_view> fd_link;
   bool success;
 
   // Step 1 - Setup FDResolver.
-  auto resolver = FDResolver(proc_parser_.get(), pid, fd);
+  auto resolver = FDResolver(fd_table_mgr_.get(), upid_, fd);
   success = resolver.Setup();
   ASSERT_TRUE(success);
 
@@ -175,6 +183,7 @@ TEST_F(FDResolverTest, NewSocketSameFD) {
   auto t2 = std::chrono::steady_clock::now();
 
   // Step 2 - Update FDResolver to capture connection if stable.
+  fd_table_mgr_->Flush();
   // Resolver should return nullopt, because connection was already gone before Update() call.
   // Resolver can build any time window validity for the socket.
   success = resolver.Update();
@@ -187,5 +196,83 @@ TEST_F(FDResolverTest, NewSocketSameFD) {
   EXPECT_FALSE(fd_link.has_value());
 }
 
+TEST_F(FDResolverTest, FewFDsReadIndividually) {
+  system::TCPSocket socket1;
+  system::TCPSocket socket2;
+
+  ASSERT_OK_AND_ASSIGN(FDTableManager::FDLink fd_link1,
+                       fd_table_mgr_->ReadFDLink(upid_, socket1.sockfd()));
+  ASSERT_OK_AND_ASSIGN(FDTableManager::FDLink fd_link2,
+                       fd_table_mgr_->ReadFDLink(upid_, socket2.sockfd()));
+  EXPECT_TRUE(absl::StartsWith(fd_link1.link, "socket:["));
+  EXPECT_TRUE(absl::StartsWith(fd_link2.link, "socket:["));
+  EXPECT_NE(fd_link1.link, fd_link2.link);
+
+  // Each FD is read on its own, rather than from a snapshot of the FD table.
+  EXPECT_LE(fd_link1.end_time, fd_link2.start_time);
+
+  // A closed FD is not found.
+  int fd1 = socket1.sockfd();
+  socket1.Close();
+  EXPECT_NOT_OK(fd_table_mgr_->ReadFDLink(upid_, fd1));
+
+  socket2.Close();
+}
+
+TEST_F(FDResolverTest, SharedFDTable) {
+  constexpr int kNumSockets = FDTableManager::kMinFDsPerSnapshot + 1;
+  std::vector<std::unique_ptr<system::TCPSocket>> sockets;
+  std::vector<FDTableManager::FDLink> fd_links;
+  for (int i = 0; i < kNumSockets; ++i) {
+    sockets.push_back(std::make_unique<system::TCPSocket>());
+    ASSERT_OK_AND_ASSIGN(FDTableManager::FDLink fd_link,
+                         fd_table_mgr_->ReadFDLink(upid_, sockets.back()->sockfd()));
+    EXPECT_TRUE(absl::StartsWith(fd_link.link, "socket:["));
+    fd_links.push_back(std::move(fd_link));
+  }
+
+  // The first FDs are read one at a time, until enough FDs are read to take a snapshot.
+  constexpr int kFirstSnapshotFD = FDTableManager::kMinFDsPerSnapshot - 1;
+  EXPECT_LE(fd_links[kFirstSnapshotFD - 1].end_time, fd_links[kFirstSnapshotFD].start_time);
+  // The remaining FDs come from the same snapshot of the FD table.
+  EXPECT_EQ(fd_links[kFirstSnapshotFD].start_time, fd_links[kNumSockets - 1].start_time);
+  EXPECT_EQ(fd_links[kFirstSnapshotFD].end_time, fd_links[kNumSockets - 1].end_time);
+
+  // A closed FD is still in the snapshot until the next generation.
+  int closed_fd = sockets.back()->sockfd();
+  sockets.back()->Close();
+  ASSERT_OK_AND_ASSIGN(FDTableManager::FDLink fd_link,
+                       fd_table_mgr_->ReadFDLink(upid_, closed_fd));
+  EXPECT_EQ(fd_link.link, fd_links.back().link);
+
+  // Since many FDs were read in the last generation, the snapshot is taken on the first read.
+  fd_table_mgr_->Flush();
+  ASSERT_OK_AND_ASSIGN(FDTableManager::FDLink fd_link0,
+                       fd_table_mgr_->ReadFDLink(upid_, sockets[0]->sockfd()));
+  ASSERT_OK_AND_ASSIGN(FDTableManager::FDLink fd_link1,
+                       fd_table_mgr_->ReadFDLink(upid_, sockets[1]->sockfd()));
+  EXPECT_EQ(fd_link0.link, fd_links[0].link);
+  EXPECT_EQ(fd_link1.link, fd_links[1].link);
+  EXPECT_EQ(fd_link0.start_time, fd_link1.start_time);
+  EXPECT_GT(fd_link0.start_time, fd_links[kFirstSnapshotFD].start_time);
+  EXPECT_NOT_OK(fd_table_mgr_->ReadFDLink(upid_, closed_fd));
+}
+
+TEST_F(FDResolverTest, ReusedPID) {
+  system::TCPSocket socket;
+
+  // A UPID whose PID now belongs to another process (here, this one) is never resolved.
+  struct upid_t old_upid = upid_;
+  --old_upid.start_time_ticks;
+  EXPECT_NOT_OK(fd_table_mgr_->ReadFDLink(old_upid, socket.sockfd()));
+
+  // The process that reused the PID has its own FD table.
+  ASSERT_OK_AND_ASSIGN(FDTableManager::FDLink fd_link,
+                       fd_table_mgr_->ReadFDLink(upid_, socket.sockfd()));
+  EXPECT_TRUE(absl::StartsWith(fd_link.link, "socket:["));
+
+  socket.Close();
+}
+
 }  // namespace stirling
 }  // namespace px
@@ -35,6 +35,26 @@ SocketTracerMetrics::SocketTracerMetrics(prometheus::Registry* registry,
               .Help("Total bytes of data loss for this protocol. Measured by bytes that weren't "
                     "successfully parsed.")
               .Register(*registry)
+              .Add({{"protocol", std::string(magic_enum::enum_name(protocol))}})),
+      parse_wasted_attempts(
+          prometheus::BuildCounter()
+              .Name("parse_wasted_attempts")
+              .Help("Total number of parse attempts for this protocol that produced no frames.")
+              .Register(*registry)
+              .Add({{"protocol", std::string(magic_enum::enum_name(protocol))}})),
+      parse_wasted_bytes(
+          prometheus::BuildCounter()
+              .Name("parse_wasted_bytes")
+              .Help("Total bytes that the parser of this protocol found invalid or resynced "
+                    "over without producing frames. Each byte is counted once.")
+              .Register(*registry)
+              .Add({{"protocol", std::string(magic_enum::enum_name(protocol))}})),
+      parse_budget_exhausted_conns(
+          prometheus::BuildCounter()
+              .Name("parse_budget_exhausted_conns")
+              .Help("Total number of connections of this protocol that were disabled because "
+                    "parsing them wasted too many resources.")
+              .Register(*registry)
               .Add({{"protocol", std::string(magic_enum::enum_name(protocol))}})) {}
 
 namespace {
@@ -30,6 +30,9 @@ namespace stirling {
 struct SocketTracerMetrics {
   SocketTracerMetrics(prometheus::Registry* registry, traffic_protocol_t protocol);
   prometheus::Counter& data_loss_bytes;
+  prometheus::Counter& parse_wasted_attempts;
+  prometheus::Counter& parse_wasted_bytes;
+  prometheus::Counter& parse_budget_exhausted_conns;
 
   static SocketTracerMetrics& GetProtocolMetrics(traffic_protocol_t protocol);
 
@@ -26,6 +26,7 @@
 #include "src/common/base/base.h"
 #include "src/common/json/json.h"
 #include "src/common/zlib/zlib_wrapper.h"
+#include "src/stirling/source_connectors/socket_tracer/protocols/http/parse.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/http/types.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/http/utils.h"
 
@@ -43,6 +44,28 @@ namespace stirling {
 namespace protocols {
 namespace http {
 
+namespace {
+
+// Replaces the body with its decompressed content. Decompression stops at the body limit that is
+// also applied to uncompressed bodies during parsing, since anything beyond it would be dropped
+// before the body reaches the table.
+void InflateBody(px::zlib::CompressionFormat format, Message* message) {
+  auto result_or = px::zlib::InflateBounded(message->body, FLAGS_http_body_limit_bytes, format);
+  if (!result_or.ok() && format == px::zlib::CompressionFormat::kZlib) {
+    // Some servers send raw deflate streams for Content-Encoding: deflate.
+    result_or = px::zlib::InflateBounded(message->body, FLAGS_http_body_limit_bytes,
+                                         px::zlib::CompressionFormat::kRawDeflate);
+  }
+  if (!result_or.ok()) {
+    message->body = format == px::zlib::CompressionFormat::kGzip ? "<Failed to gunzip body>"
+                                                                 : "<Failed to inflate body>";
+    return;
+  }
+  message->body = std::move(result_or.ValueOrDie().data);
+}
+
+}  // namespace
+
 void PreProcessMessage(Message* message) {
   // Parse the flags on the first time only.
   static const HTTPHeaderFilter kHTTPResponseHeaderFilter =
@@ -67,8 +90,12 @@ void PreProcessMessage(Message* message) {
 
   auto content_encoding_iter = message->headers.find(kContentEncoding);
   // Replace body with decompressed version, if required.
-  if (content_encoding_iter != message->headers.end() && content_encoding_iter->second == "gzip") {
-    message->body = px::zlib::Inflate(message->body).ConsumeValueOr("<Failed to gunzip body>");
+  if (content_encoding_iter != message->headers.end()) {
+    if (content_encoding_iter->second == "gzip") {
+      InflateBody(px::zlib::CompressionFormat::kGzip, message);
+    } else if (content_encoding_iter->second == "deflate") {
+      InflateBody(px::zlib::CompressionFormat::kZlib, message);
+    }
   }
 }
 
@@ -19,6 +19,11 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <string>
+#include <utility>
+
+#include "src/common/zlib/zlib_wrapper.h"
+#include "src/stirling/source_connectors/socket_tracer/protocols/http/parse.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/http/stitcher.h"
 
 namespace px {
@@ -44,6 +49,25 @@ TEST(PreProcessRecordTest, GzipCompressedContentIsDecompressed) {
   EXPECT_EQ("This is a test\n", message.body);
 }
 
+TEST(PreProcessRecordTest, CompressedContentIsDecompressedUpToBodyLimit) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_http_body_limit_bytes = 16;
+
+  const std::string content = R"({"items":["a","b","c","d","e","f","g"]})";
+  for (auto [encoding, format] :
+       {std::make_pair("gzip", px::zlib::CompressionFormat::kGzip),
+        std::make_pair("deflate", px::zlib::CompressionFormat::kZlib),
+        std::make_pair("deflate", px::zlib::CompressionFormat::kRawDeflate)}) {
+    Message message;
+    message.type = message_type_t::kResponse;
+    message.headers.insert({kContentEncoding, encoding});
+    message.headers.insert({kContentType, "json"});
+    message.body = px::zlib::Deflate(content, format).ConsumeValueOrDie();
+    PreProcessMessage(&message);
+    EXPECT_EQ(message.body, content.substr(0, 16));
+  }
+}
+
 TEST(PreProcessRecordTest, ContentHeaderIsNotAdded) {
   Message message;
   message.type = message_type_t::kResponse;
@@ -29,6 +29,9 @@
 
 DEFINE_bool(socket_tracer_enable_http2_gzip, false,
             "If true, decompress gzipped request and response bodies of HTTP2 messages.");
+DEFINE_uint32(socket_tracer_http2_gzip_max_inflated_bytes, 4096,
+              "The maximum number of bytes to decompress from each gzipped gRPC message. The "
+              "decompressed message is parsed as a partial protobuf if it is cut off.");
 
 namespace px {
 namespace stirling {
@@ -103,9 +106,10 @@ Status GRPCPBWireToText(std::string_view message, bool is_gzipped, std::string*
 
     std::string gunzipped_data;
     if (is_compressed && is_gzipped) {
-      auto data_or = px::zlib::Inflate(data);
+      auto data_or =
+          px::zlib::InflateBounded(data, FLAGS_socket_tracer_http2_gzip_max_inflated_bytes);
       if (data_or.ok()) {
-        gunzipped_data = data_or.ConsumeValueOrDie();
+        gunzipped_data = std::move(data_or.ValueOrDie().data);
       } else {
         text->append("<Failed to gunzip data>");
         continue;
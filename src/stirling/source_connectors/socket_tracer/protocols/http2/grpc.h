@@ -27,6 +27,7 @@
 #include "src/stirling/source_connectors/socket_tracer/protocols/http2/types.h"
 
 DECLARE_bool(socket_tracer_enable_http2_gzip);
+DECLARE_uint32(socket_tracer_http2_gzip_max_inflated_bytes);
 
 namespace px {
 namespace stirling {
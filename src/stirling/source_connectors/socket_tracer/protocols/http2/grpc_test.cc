@@ -22,6 +22,7 @@
 
 #include "src/common/base/base.h"
 #include "src/common/testing/testing.h"
+#include "src/common/zlib/zlib_wrapper.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/http2/testing/proto/greet.pb.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/http2/testing/proto/multi_fields.pb.h"
 
@@ -127,6 +128,19 @@ TEST(ParsePb, ParsingPartialMessage) {
 4: 0x00000419)"));
 }
 
+TEST(ParsePbTest, ParsingGZippedData) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_socket_tracer_enable_http2_gzip = true;
+
+  std::string_view serialized_pb =
+      CreateStringView<char>("\x0A\x0B\x48\x65\x6C\x6C\x6F\x20\x77\x6F\x72\x6C\x64");
+  std::string compressed = px::zlib::Deflate(serialized_pb).ConsumeValueOrDie();
+  std::string data = PackGRPCMsg(compressed);
+  // Set the compressed flag.
+  data[0] = '\x01';
+  EXPECT_THAT(ParsePB(data, /*is_gzipped*/ true), StrEq(R"(1: "Hello world")"));
+}
+
 // Tests that result of parsing when the gunzip fails and other failures.
 TEST(ParsePbTest, ParsingInvalidGZippedData) {
   std::string_view data = CreateStringView<char>("\x01\x00\x00\x00\x01\x0A");
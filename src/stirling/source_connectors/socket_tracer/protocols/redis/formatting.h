@@ -24,6 +24,8 @@
 #include "src/common/json/json.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/redis/types.h"
 
+DECLARE_bool(stirling_redis_defer_payload_rendering);
+
 namespace px {
 namespace stirling {
 namespace protocols {
@@ -33,6 +35,12 @@ namespace redis {
 // to the input message result argument.
 void FormatArrayMessage(VectorView<std::string> payloads_view, Message* msg);
 
+// Used instead of FormatArrayMessage() for top-level arrays when
+// --stirling_redis_defer_payload_rendering is set. The command is still detected, but all of the
+// payloads are stored as a px::protocols raw payload and the message is marked with raw_payload,
+// to be rendered at query time by px.redis_render_payload().
+void DeferArrayMessage(VectorView<std::string> payloads_view, Message* msg);
+
 }  // namespace redis
 }  // namespace protocols
 }  // namespace stirling
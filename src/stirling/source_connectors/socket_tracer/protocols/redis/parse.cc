@@ -115,9 +115,9 @@ bool IsPubMsg(const std::vector<std::string>& payloads) {
 
 // This calls ParseMessage(), which eventually calls ParseArray() and are both recursive
 // functions. This is because Array message can include nested array messages.
-Status ParseArray(message_type_t type, BinaryDecoder* decoder, Message* msg);
+Status ParseArray(message_type_t type, BinaryDecoder* decoder, bool nested, Message* msg);
 
-Status ParseMessage(message_type_t type, BinaryDecoder* decoder, Message* msg) {
+Status ParseMessage(message_type_t type, BinaryDecoder* decoder, bool nested, Message* msg) {
   PL_ASSIGN_OR_RETURN(const char type_marker, decoder->ExtractChar());
 
   switch (type_marker) {
@@ -140,7 +140,7 @@ Status ParseMessage(message_type_t type, BinaryDecoder* decoder, Message* msg) {
       break;
     }
     case kArrayMarker: {
-      PL_RETURN_IF_ERROR(ParseArray(type, decoder, msg));
+      PL_RETURN_IF_ERROR(ParseArray(type, decoder, nested, msg));
       break;
     }
     default:
@@ -152,7 +152,7 @@ Status ParseMessage(message_type_t type, BinaryDecoder* decoder, Message* msg) {
 }
 
 // Array is formatted as *<size_str>\r\n[one of simple string, error, bulk string, etc.]
-Status ParseArray(message_type_t type, BinaryDecoder* decoder, Message* msg) {
+Status ParseArray(message_type_t type, BinaryDecoder* decoder, bool nested, Message* msg) {
   PL_ASSIGN_OR_RETURN(int len, ParseSize(decoder));
 
   if (len == kNullSize) {
@@ -164,11 +164,17 @@ Status ParseArray(message_type_t type, BinaryDecoder* decoder, Message* msg) {
   std::vector<std::string> payloads;
   for (int i = 0; i < len; ++i) {
     Message tmp;
-    PL_RETURN_IF_ERROR(ParseMessage(type, decoder, &tmp));
+    PL_RETURN_IF_ERROR(ParseMessage(type, decoder, /*nested*/ true, &tmp));
     payloads.push_back(std::move(tmp.payload));
   }
 
-  FormatArrayMessage(VectorView<std::string>(payloads), msg);
+  // Nested arrays are always rendered, so that a deferred payload is a flat list of strings that
+  // renders exactly like the eagerly formatted message.
+  if (FLAGS_stirling_redis_defer_payload_rendering && !nested) {
+    DeferArrayMessage(VectorView<std::string>(payloads), msg);
+  } else {
+    FormatArrayMessage(VectorView<std::string>(payloads), msg);
+  }
 
   if (type == message_type_t::kResponse && IsPubMsg(payloads)) {
     msg->is_published_message = true;
@@ -196,7 +202,7 @@ size_t FindMessageBoundary(std::string_view buf, size_t start_pos) {
 ParseState ParseMessage(message_type_t type, std::string_view* buf, Message* msg) {
   BinaryDecoder decoder(*buf);
 
-  auto status = ParseMessage(type, &decoder, msg);
+  auto status = ParseMessage(type, &decoder, /*nested*/ false, msg);
 
   if (!status.ok()) {
     return TranslateStatus(status);
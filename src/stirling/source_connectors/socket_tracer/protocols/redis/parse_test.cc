@@ -22,6 +22,9 @@
 #include <vector>
 
 #include "src/common/testing/testing.h"
+#include "src/shared/protocols/raw_payload.h"
+#include "src/shared/protocols/redis/format.h"
+#include "src/stirling/source_connectors/socket_tracer/protocols/redis/formatting.h"
 
 namespace px {
 namespace stirling {
@@ -138,6 +141,81 @@ TEST(ParsePubMsgTest, DetectPublishedMessage) {
   EXPECT_TRUE(msg.is_published_message);
 }
 
+// Renders a message payload the way px.redis_render_payload() does at query time.
+std::string RenderPayload(const Message& msg) {
+  if (!msg.raw_payload) {
+    return msg.payload;
+  }
+  std::vector<std::string_view> elements =
+      px::protocols::DecodeRawPayload(msg.payload).ConsumeValueOrDie();
+  std::vector<std::string> payloads(elements.begin(), elements.end());
+  std::string_view command;
+  return px::protocols::redis::FormatArrayPayloads(VectorView<std::string>(payloads), &command);
+}
+
+TEST_P(ParseTest, DeferredRenderingMatchesEagerRendering) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_stirling_redis_defer_payload_rendering = true;
+
+  for (message_type_t type : GetParam().types_to_test) {
+    std::string_view req = GetParam().input;
+    Message msg;
+
+    EXPECT_EQ(ParseFrame(type, &req, &msg), ParseState::kSuccess);
+    EXPECT_THAT(req, IsEmpty());
+    EXPECT_THAT(RenderPayload(msg), StrEq(std::string(GetParam().expected_payload)));
+    EXPECT_THAT(std::string(msg.command), StrEq(std::string(GetParam().expected_command)));
+  }
+}
+
+TEST(ParseDeferredRenderingTest, StoresRawPayload) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_stirling_redis_defer_payload_rendering = true;
+
+  std::string_view req = kLPushMsg;
+  Message msg;
+  EXPECT_EQ(ParseFrame(message_type_t::kRequest, &req, &msg), ParseState::kSuccess);
+  EXPECT_THAT(req, IsEmpty());
+  EXPECT_EQ(msg.command, "LPUSH");
+  EXPECT_TRUE(msg.raw_payload);
+  EXPECT_THAT(px::protocols::DecodeRawPayload(msg.payload).ConsumeValueOrDie(),
+              ::testing::ElementsAre("lpush", "foo", "bar0", "bar1"));
+
+  std::string_view resp = kPubMsg;
+  Message pub_msg;
+  EXPECT_EQ(ParseFrame(message_type_t::kResponse, &resp, &pub_msg), ParseState::kSuccess);
+  EXPECT_TRUE(pub_msg.is_published_message);
+  EXPECT_TRUE(pub_msg.raw_payload);
+
+  // Non-array messages are unaffected.
+  std::string_view simple = kSimpleStringMsg;
+  Message simple_msg;
+  EXPECT_EQ(ParseFrame(message_type_t::kResponse, &simple, &simple_msg), ParseState::kSuccess);
+  EXPECT_FALSE(simple_msg.raw_payload);
+  EXPECT_EQ(simple_msg.payload, "OK");
+}
+
+// Only top-level arrays are deferred; nested arrays are rendered into their parent's elements.
+TEST(ParseDeferredRenderingTest, NestedArraysRenderedEagerly) {
+  constexpr std::string_view kNestedArrayMsg = "*2\r\n*1\r\n$3\r\nfoo\r\n$3\r\nbar\r\n";
+
+  std::string_view eager_resp = kNestedArrayMsg;
+  Message eager_msg;
+  EXPECT_EQ(ParseFrame(message_type_t::kResponse, &eager_resp, &eager_msg), ParseState::kSuccess);
+  EXPECT_FALSE(eager_msg.raw_payload);
+
+  gflags::FlagSaver flag_saver;
+  FLAGS_stirling_redis_defer_payload_rendering = true;
+
+  std::string_view resp = kNestedArrayMsg;
+  Message msg;
+  EXPECT_EQ(ParseFrame(message_type_t::kResponse, &resp, &msg), ParseState::kSuccess);
+  EXPECT_TRUE(msg.raw_payload);
+  EXPECT_THAT(px::protocols::DecodeRawPayload(msg.payload).ConsumeValueOrDie(),
+              ::testing::ElementsAre(R"(["foo"])", "bar"));
+  EXPECT_EQ(RenderPayload(msg), eager_msg.payload);
+}
+
 class ParseIncompleteInputTest : public ::testing::TestWithParam<std::string> {};
 
 TEST_P(ParseIncompleteInputTest, IncompleteInput) {
@@ -40,6 +40,10 @@ struct Message : public FrameBase {
   // clients.
   bool is_published_message = false;
 
+  // If true, payload holds the elements of an array message in the px::protocols raw payload
+  // encoding, because its rendering was deferred to query time.
+  bool raw_payload = false;
+
   size_t ByteSize() const override { return payload.size() + command.size(); }
 
   std::string ToString() const override {
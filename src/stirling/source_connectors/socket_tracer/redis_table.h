@@ -47,6 +47,16 @@ static constexpr DataElement kRedisElements[] = {
          types::DataType::STRING,
          types::SemanticType::ST_NONE,
          types::PatternType::GENERAL},
+        {"req_args_raw", "True if req_args holds a raw payload whose rendering was deferred. "
+         "See px.redis_render_payload().",
+         types::DataType::BOOLEAN,
+         types::SemanticType::ST_NONE,
+         types::PatternType::GENERAL_ENUM},
+        {"resp_raw", "True if resp holds a raw payload whose rendering was deferred. "
+         "See px.redis_render_payload().",
+         types::DataType::BOOLEAN,
+         types::SemanticType::ST_NONE,
+         types::PatternType::GENERAL_ENUM},
         canonical_data_elements::kLatencyNS,
 #ifndef NDEBUG
         canonical_data_elements::kPXInfo,
@@ -156,6 +156,7 @@ constexpr size_t kMaxPBStringLen = 64;
 SocketTraceConnector::SocketTraceConnector(std::string_view source_name)
     : SourceConnector(source_name, kTables), conn_stats_(&conn_trackers_mgr_), uprobe_mgr_(this) {
   proc_parser_ = std::make_unique<system::ProcParser>(system::Config::GetInstance());
+  fd_table_mgr_ = std::make_unique<FDTableManager>(proc_parser_.get());
   InitProtocolTransferSpecs();
 }
 
@@ -548,6 +549,7 @@ void SocketTraceConnector::UpdateCommonState(ConnectorContext* ctx) {
   if (socket_info_mgr_ != nullptr) {
     socket_info_mgr_->Flush();
   }
+  fd_table_mgr_->Flush();
 
   // Deploy uprobes on newly discovered PIDs.
   std::thread thread = RunDeployUProbesThread(ctx->GetUPIDs());
@@ -637,7 +639,7 @@ void SocketTraceConnector::TransferDataImpl(ConnectorContext* ctx,
       }
     }
 
-    conn_tracker->IterationPreTick(iteration_time_, cluster_cidrs, proc_parser_.get(),
+    conn_tracker->IterationPreTick(iteration_time_, cluster_cidrs, fd_table_mgr_.get(),
                                    socket_info_mgr_.get());
 
     if (transfer_spec.transfer_fn != nullptr) {
@@ -1134,6 +1136,8 @@ void SocketTraceConnector::AppendMessage(ConnectorContext* ctx, const ConnTracke
   r.Append<r.ColIndex("req_cmd")>(std::string(entry.req.command));
   r.Append<r.ColIndex("req_args")>(std::string(entry.req.payload));
   r.Append<r.ColIndex("resp")>(std::string(entry.resp.payload));
+  r.Append<r.ColIndex("req_args_raw")>(entry.req.raw_payload);
+  r.Append<r.ColIndex("resp_raw")>(entry.resp.raw_payload);
   r.Append<r.ColIndex("latency")>(
       CalculateLatency(entry.req.timestamp_ns, entry.resp.timestamp_ns));
 #ifndef NDEBUG
@@ -41,6 +41,7 @@
 #include "src/stirling/source_connectors/socket_tracer/conn_stats.h"
 #include "src/stirling/source_connectors/socket_tracer/conn_tracker.h"
 #include "src/stirling/source_connectors/socket_tracer/conn_trackers_manager.h"
+#include "src/stirling/source_connectors/socket_tracer/fd_resolver.h"
 #include "src/stirling/source_connectors/socket_tracer/socket_trace_bpf_tables.h"
 #include "src/stirling/source_connectors/socket_tracer/socket_trace_tables.h"
 #include "src/stirling/source_connectors/socket_tracer/uprobe_manager.h"
@@ -239,6 +240,9 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
 
   std::unique_ptr<system::ProcParser> proc_parser_;
 
+  // Portal to query for the FD links of processes, shared by all connections of a process.
+  std::unique_ptr<FDTableManager> fd_table_mgr_;
+
   std::shared_ptr<ConnInfoMapManager> conn_info_map_mgr_;
 
   UProbeManager uprobe_mgr_;
@@ -18,8 +18,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <vector>
 
+#include "src/common/base/sorted_search.h"
+
 namespace px {
 namespace stirling {
 namespace utils {
@@ -45,69 +49,23 @@ std::vector<size_t> SortedIndexes(const std::vector<T>& v) {
   return idx;
 }
 
-// An iterator that walks over a vector according to provided indexes.
-// Used in conjunction with SortedIndexes to iterate through an unsorted vector in sorted order.
-template <typename T>
-class IndexedVectorIterator {
- public:
-  typedef int difference_type;
-  typedef T value_type;
-  typedef const T& reference;
-  typedef const T* pointer;
-  typedef std::forward_iterator_tag iterator_category;
-
-  IndexedVectorIterator(const std::vector<T>& data, std::vector<size_t>::const_iterator index_iter)
-      : data_(&data), iter_(index_iter) {}
-
-  IndexedVectorIterator operator++() {
-    IndexedVectorIterator i = *this;
-    iter_++;
-    return i;
-  }
-
-  IndexedVectorIterator operator++(int) {
-    iter_++;
-    return *this;
-  }
-
-  IndexedVectorIterator operator+(int n) {
-    iter_ = iter_ + n;
-    return *this;
-  }
-
-  reference operator*() { return (*data_)[*iter_]; }
-
-  pointer operator->() { return (*data_)[*iter_]; }
-
-  bool operator==(const IndexedVectorIterator& rhs) { return iter_ == rhs.iter_; }
-
-  bool operator!=(const IndexedVectorIterator& rhs) { return iter_ != rhs.iter_; }
-
-  difference_type operator-(const IndexedVectorIterator<T>& other) {
-    return std::distance(other.iter_, iter_);
-  }
-
- private:
-  const std::vector<T>* data_;
-  std::vector<size_t>::const_iterator iter_;
-};
-
 // Searches for multiple values in a vector,
 // returning the lowest positions that are greater than or equal to the search value.
-// Uses std::lower_bound, which is a binary search for efficiency.
+// Each search is a branchless binary search through the sort indexes, starting from the position
+// of the previous search value.
 template <size_t N, typename T>
 std::array<size_t, N> SplitSortedVector(const std::vector<T>& vec,
-                                        const std::vector<size_t> sort_indexes,
+                                        const std::vector<size_t>& sort_indexes,
                                         std::array<T, N> split_vals) {
   std::array<size_t, N> out;
 
-  auto begin = IndexedVectorIterator(vec, sort_indexes.begin());
-  auto end = IndexedVectorIterator(vec, sort_indexes.end());
-
-  auto iter = begin;
+  size_t pos = 0;
   for (size_t i = 0; i < N; ++i) {
-    iter = std::lower_bound(iter, end, split_vals[i]);
-    out[i] = iter - begin;
+    pos += BranchlessLowerBound(
+        sort_indexes.size() - pos,
+        [&vec, &sort_indexes, pos](size_t j) -> const T& { return vec[sort_indexes[pos + j]]; },
+        split_vals[i]);
+    out[i] = pos;
   }
 
   return out;
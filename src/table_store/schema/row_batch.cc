@@ -126,6 +126,7 @@ void CopyIntoOutputPB(table_store::schemapb::Column* output_column, arrow::Array
 
   size_t col_length = input_column->length();
   auto casted_output_data = GetMutablePBDataColumn<T>(output_column);
+  casted_output_data->mutable_data()->Reserve(static_cast<int>(col_length));
   for (size_t i = 0; i < col_length; ++i) {
     if constexpr (T == DataType::UINT128) {
       auto out_datum = casted_output_data->add_data();
@@ -0,0 +1,265 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/table/ingest_queue.h"
+
+#include <absl/time/time.h>
+
+#include <string>
+#include <utility>
+
+#include "src/common/metrics/metrics.h"
+#include "src/shared/types/type_utils.h"
+
+DEFINE_bool(table_store_async_ingest, gflags::BoolFromEnv("PL_TABLE_STORE_ASYNC_INGEST", true),
+            "Whether data from Stirling is appended to the table store by a separate writer "
+            "thread, instead of on the Stirling thread.");
+
+DEFINE_int32(table_store_ingest_flush_period_ms,
+             gflags::Int32FromEnv("PL_TABLE_STORE_INGEST_FLUSH_PERIOD_MS", 100),
+             "How often the table store writer appends the queued batches to the tables.");
+
+DEFINE_int32(table_store_ingest_max_queued_batches,
+             gflags::Int32FromEnv("PL_TABLE_STORE_INGEST_MAX_QUEUED_BATCHES", 1024),
+             "The maximum number of batches queued per table before new batches are dropped.");
+
+DEFINE_int64(table_store_ingest_coalesce_bytes,
+             gflags::Int64FromEnv("PL_TABLE_STORE_INGEST_COALESCE_BYTES", 256 * 1024),
+             "Queued batches of the same tablet are concatenated until they reach this size.");
+
+namespace px {
+namespace table_store {
+
+namespace {
+
+int64_t RecordBatchBytes(const types::ColumnWrapperRecordBatch& record_batch) {
+  int64_t bytes = 0;
+  for (const auto& col : record_batch) {
+    bytes += col->Bytes();
+  }
+  return bytes;
+}
+
+template <types::DataType DT>
+void MoveColumnValues(types::ColumnWrapper* src, types::ColumnWrapper* dst) {
+  using ValueType = typename types::DataTypeTraits<DT>::value_type;
+  auto* typed_src = static_cast<types::ColumnWrapperTmpl<ValueType>*>(src);
+  auto* typed_dst = static_cast<types::ColumnWrapperTmpl<ValueType>*>(dst);
+  for (size_t i = 0; i < typed_src->Size(); ++i) {
+    typed_dst->Append(std::move((*typed_src)[i]));
+  }
+}
+
+// Concatenates the record batches into the first one.
+std::unique_ptr<types::ColumnWrapperRecordBatch> Concatenate(
+    std::vector<std::unique_ptr<types::ColumnWrapperRecordBatch>>* record_batches) {
+  auto out = std::move(record_batches->front());
+  if (record_batches->size() == 1) {
+    record_batches->clear();
+    return out;
+  }
+  for (size_t col_idx = 0; col_idx < out->size(); ++col_idx) {
+    auto* dst = (*out)[col_idx].get();
+    size_t total_rows = dst->Size();
+    for (size_t i = 1; i < record_batches->size(); ++i) {
+      total_rows += (*(*record_batches)[i])[col_idx]->Size();
+    }
+    dst->Reserve(total_rows);
+    for (size_t i = 1; i < record_batches->size(); ++i) {
+      auto* src = (*(*record_batches)[i])[col_idx].get();
+      DCHECK_EQ(src->data_type(), dst->data_type());
+#define TYPE_CASE(_dt_) MoveColumnValues<_dt_>(src, dst);
+      PL_SWITCH_FOREACH_DATATYPE(dst->data_type(), TYPE_CASE);
+#undef TYPE_CASE
+    }
+  }
+  record_batches->clear();
+  return out;
+}
+
+}  // namespace
+
+IngestQueue::TableQueue::TableQueue(uint64_t table_id, const std::string& table_name)
+    : table_id(table_id),
+      depth_gauge(prometheus::BuildGauge()
+                      .Name("table_ingest_queue_depth")
+                      .Help("Number of batches queued for the table when the writer last drained "
+                            "its queue")
+                      .Register(GetMetricsRegistry())
+                      .Add({{"name", table_name}})),
+      dropped_batches_counter(prometheus::BuildCounter()
+                                  .Name("table_ingest_dropped_batches")
+                                  .Help("Total batches dropped because the table's ingest queue "
+                                        "was full")
+                                  .Register(GetMetricsRegistry())
+                                  .Add({{"name", table_name}})),
+      coalesced_batches_counter(prometheus::BuildCounter()
+                                    .Name("table_ingest_coalesced_batches")
+                                    .Help("Total queued batches that were concatenated into a "
+                                          "preceding batch before being appended to the table")
+                                    .Register(GetMetricsRegistry())
+                                    .Add({{"name", table_name}})),
+      failed_batches_counter(prometheus::BuildCounter()
+                                 .Name("table_ingest_failed_batches")
+                                 .Help("Total queued batches that were lost because appending "
+                                       "them to the table failed")
+                                 .Register(GetMetricsRegistry())
+                                 .Add({{"name", table_name}})) {}
+
+IngestQueue::IngestQueue(TableStore* table_store, std::chrono::milliseconds flush_period,
+                         int64_t max_queued_batches, int64_t coalesce_bytes)
+    : table_store_(table_store),
+      flush_period_(flush_period),
+      max_queued_batches_(max_queued_batches),
+      coalesce_bytes_(coalesce_bytes) {}
+
+IngestQueue::~IngestQueue() { Stop(); }
+
+IngestQueue::TableQueue* IngestQueue::GetOrCreateQueue(uint64_t table_id) {
+  {
+    absl::ReaderMutexLock lock(&queues_lock_);
+    auto it = queues_.find(table_id);
+    if (it != queues_.end()) {
+      return it->second.get();
+    }
+  }
+  absl::MutexLock lock(&queues_lock_);
+  auto& queue = queues_[table_id];
+  if (queue == nullptr) {
+    queue = std::make_unique<TableQueue>(table_id, table_store_->GetTableName(table_id));
+  }
+  return queue.get();
+}
+
+Status IngestQueue::AppendData(uint64_t table_id, types::TabletID tablet_id,
+                               std::unique_ptr<types::ColumnWrapperRecordBatch> record_batch) {
+  TableQueue* queue = GetOrCreateQueue(table_id);
+  if (queue->depth.load(std::memory_order_relaxed) >= max_queued_batches_) {
+    queue->dropped_batches_counter.Increment();
+    LOG_EVERY_N(WARNING, 100) << absl::Substitute(
+        "Ingest queue of table $0 is full, dropping batch.", table_id);
+    return Status::OK();
+  }
+  queue->depth.fetch_add(1, std::memory_order_relaxed);
+  queue->batches.enqueue(QueuedBatch{std::move(tablet_id), std::move(record_batch)});
+  return Status::OK();
+}
+
+Status IngestQueue::DrainQueue(TableQueue* queue) {
+  int64_t depth = queue->depth.load(std::memory_order_relaxed);
+  queue->depth_gauge.Set(depth);
+
+  Status first_error;
+  types::TabletID run_tablet_id;
+  std::vector<std::unique_ptr<types::ColumnWrapperRecordBatch>> run;
+  int64_t run_bytes = 0;
+  auto append_run = [&]() {
+    if (run.empty()) {
+      return;
+    }
+    queue->coalesced_batches_counter.Increment(run.size() - 1);
+    int64_t num_batches = run.size();
+    Status s = table_store_->AppendData(queue->table_id, run_tablet_id, Concatenate(&run));
+    if (!s.ok()) {
+      queue->failed_batches_counter.Increment(num_batches);
+      LOG_EVERY_N(ERROR, 100) << absl::Substitute(
+          "Failed to append $0 queued batches to table $1: $2", num_batches, queue->table_id,
+          s.msg());
+      if (first_error.ok()) {
+        first_error = s;
+      }
+    }
+    run_bytes = 0;
+  };
+
+  // Only drain what was queued so far, so that a fast producer can't keep the writer on one table.
+  QueuedBatch item;
+  for (int64_t i = 0; i < depth && queue->batches.try_dequeue(item); ++i) {
+    queue->depth.fetch_sub(1, std::memory_order_relaxed);
+    if (!run.empty() && (item.tablet_id != run_tablet_id || run_bytes >= coalesce_bytes_)) {
+      append_run();
+    }
+    if (run.empty()) {
+      run_tablet_id = std::move(item.tablet_id);
+    }
+    run_bytes += RecordBatchBytes(*item.record_batch);
+    run.push_back(std::move(item.record_batch));
+  }
+  append_run();
+  return first_error;
+}
+
+Status IngestQueue::Flush() {
+  std::vector<TableQueue*> queues;
+  {
+    absl::ReaderMutexLock lock(&queues_lock_);
+    queues.reserve(queues_.size());
+    for (const auto& [table_id, queue] : queues_) {
+      queues.push_back(queue.get());
+    }
+  }
+
+  absl::MutexLock lock(&flush_lock_);
+  Status first_error;
+  for (auto* queue : queues) {
+    Status s = DrainQueue(queue);
+    if (!s.ok() && first_error.ok()) {
+      first_error = s;
+    }
+  }
+  return first_error;
+}
+
+void IngestQueue::Start() {
+  absl::MutexLock lock(&run_lock_);
+  if (running_) {
+    return;
+  }
+  running_ = true;
+  writer_ = std::thread(&IngestQueue::Run, this);
+}
+
+void IngestQueue::Stop() {
+  {
+    absl::MutexLock lock(&run_lock_);
+    running_ = false;
+    run_cv_.Signal();
+  }
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+}
+
+void IngestQueue::Run() {
+  bool running = true;
+  while (running) {
+    {
+      absl::MutexLock lock(&run_lock_);
+      if (running_) {
+        run_cv_.WaitWithTimeout(&run_lock_, absl::FromChrono(flush_period_));
+      }
+      running = running_;
+    }
+    // The last pass after Stop() appends whatever was queued before it. Failed appends are
+    // already logged and counted per table by DrainQueue.
+    PL_UNUSED(Flush());
+  }
+}
+
+}  // namespace table_store
+}  // namespace px
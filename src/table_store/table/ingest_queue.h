@@ -0,0 +1,137 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <prometheus/counter.h>
+#include <prometheus/gauge.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
+
+#include "concurrentqueue.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/column_wrapper.h"
+#include "src/table_store/table/table_store.h"
+
+DECLARE_bool(table_store_async_ingest);
+DECLARE_int32(table_store_ingest_flush_period_ms);
+DECLARE_int32(table_store_ingest_max_queued_batches);
+DECLARE_int64(table_store_ingest_coalesce_bytes);
+
+namespace px {
+namespace table_store {
+
+/**
+ * IngestQueue decouples data producers (Stirling) from the TableStore.
+ *
+ * AppendData has the same signature as TableStore::AppendData, but only moves the record batch
+ * onto a lock-free queue of its table and returns. A single writer thread drains the queues every
+ * flush period, concatenates consecutive small batches of the same tablet into one batch of up to
+ * coalesce_bytes, and appends those to the TableStore. This keeps the table locks, compaction
+ * and metrics off the producer's thread, and means fewer, larger hot batches per table.
+ *
+ * Each table queue holds at most max_queued_batches batches. When the writer falls behind, new
+ * batches of a full queue are dropped, and counted in the table_ingest_dropped_batches metric.
+ * Batches the TableStore fails to append are lost too; they are logged and counted in the
+ * table_ingest_failed_batches metric.
+ */
+class IngestQueue : public NotCopyable {
+ public:
+  IngestQueue(TableStore* table_store, std::chrono::milliseconds flush_period,
+              int64_t max_queued_batches, int64_t coalesce_bytes);
+  explicit IngestQueue(TableStore* table_store)
+      : IngestQueue(table_store,
+                    std::chrono::milliseconds(FLAGS_table_store_ingest_flush_period_ms),
+                    FLAGS_table_store_ingest_max_queued_batches,
+                    FLAGS_table_store_ingest_coalesce_bytes) {}
+  ~IngestQueue();
+
+  /**
+   * Queues the record batch to be appended to the specified table and tablet. Safe to call from
+   * multiple threads.
+   */
+  Status AppendData(uint64_t table_id, types::TabletID tablet_id,
+                    std::unique_ptr<types::ColumnWrapperRecordBatch> record_batch);
+
+  /**
+   * Starts the writer thread.
+   */
+  void Start();
+
+  /**
+   * Stops the writer thread, after it appended all the batches queued so far.
+   */
+  void Stop();
+
+  /**
+   * Appends all queued batches to the TableStore. This is what the writer thread runs every flush
+   * period; it's only meant to be called directly when the writer isn't started (e.g. in tests).
+   */
+  Status Flush();
+
+ private:
+  struct QueuedBatch {
+    types::TabletID tablet_id;
+    std::unique_ptr<types::ColumnWrapperRecordBatch> record_batch;
+  };
+
+  struct TableQueue {
+    TableQueue(uint64_t table_id, const std::string& table_name);
+
+    const uint64_t table_id;
+    moodycamel::ConcurrentQueue<QueuedBatch> batches;
+    // Tracked separately, since the queue's own size is only an estimate.
+    std::atomic<int64_t> depth{0};
+
+    prometheus::Gauge& depth_gauge;
+    prometheus::Counter& dropped_batches_counter;
+    prometheus::Counter& coalesced_batches_counter;
+    prometheus::Counter& failed_batches_counter;
+  };
+
+  TableQueue* GetOrCreateQueue(uint64_t table_id);
+  Status DrainQueue(TableQueue* queue);
+  void Run();
+
+  TableStore* table_store_;
+  const std::chrono::milliseconds flush_period_;
+  const int64_t max_queued_batches_;
+  const int64_t coalesce_bytes_;
+
+  absl::Mutex queues_lock_;
+  absl::flat_hash_map<uint64_t, std::unique_ptr<TableQueue>> queues_ ABSL_GUARDED_BY(queues_lock_);
+
+  // Serializes Flush() calls, so that the batches of a table are appended in order.
+  absl::Mutex flush_lock_;
+
+  absl::Mutex run_lock_;
+  absl::CondVar run_cv_;
+  bool running_ ABSL_GUARDED_BY(run_lock_) = false;
+  std::thread writer_;
+};
+
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/table/ingest_queue.h"
+#include "src/table_store/table/table_store.h"
+
+namespace px {
+namespace table_store {
+
+using types::ColumnWrapperRecordBatch;
+
+constexpr uint64_t kTableID = 1;
+constexpr auto kFlushPeriod = std::chrono::milliseconds(10);
+
+class IngestQueueTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rel_ = schema::Relation({types::DataType::TIME64NS, types::DataType::INT64},
+                            {"time_", "value"});
+    table_store_.AddTable(Table::Create("test_table", rel_), "test_table", kTableID);
+
+    // The bytes a single batch adds to a table.
+    auto ref_table = Table::Create("ref_table", rel_);
+    ASSERT_OK(ref_table->TransferRecordBatch(MakeBatch(0)));
+    batch_bytes_ = ref_table->GetTableStats().bytes_added;
+  }
+
+  std::unique_ptr<ColumnWrapperRecordBatch> MakeBatch(int64_t start_time) {
+    auto batch = std::make_unique<ColumnWrapperRecordBatch>();
+    auto time_col = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+    auto value_col = std::make_shared<types::Int64ValueColumnWrapper>(0);
+    for (int64_t i = 0; i < 3; ++i) {
+      time_col->Append(start_time + i);
+      value_col->Append(i);
+    }
+    batch->push_back(time_col);
+    batch->push_back(value_col);
+    return batch;
+  }
+
+  TableStats Stats(const types::TabletID& tablet_id = "") {
+    return table_store_.GetTable(kTableID, tablet_id)->GetTableStats();
+  }
+
+  schema::Relation rel_;
+  TableStore table_store_;
+  int64_t batch_bytes_ = 0;
+};
+
+TEST_F(IngestQueueTest, coalesces_batches) {
+  IngestQueue queue(&table_store_, kFlushPeriod, /*max_queued_batches*/ 16,
+                    /*coalesce_bytes*/ 1024 * 1024);
+  for (int64_t i = 0; i < 3; ++i) {
+    EXPECT_OK(queue.AppendData(kTableID, "", MakeBatch(3 * i)));
+  }
+  // Nothing reaches the table until the queue is flushed.
+  EXPECT_EQ(0, Stats().batches_added);
+
+  ASSERT_OK(queue.Flush());
+  EXPECT_EQ(1, Stats().batches_added);
+  EXPECT_EQ(3 * batch_bytes_, Stats().bytes_added);
+}
+
+TEST_F(IngestQueueTest, coalesce_bytes_limit) {
+  // Every batch alone reaches the limit, so none are concatenated.
+  IngestQueue queue(&table_store_, kFlushPeriod, /*max_queued_batches*/ 16, /*coalesce_bytes*/ 1);
+  for (int64_t i = 0; i < 3; ++i) {
+    EXPECT_OK(queue.AppendData(kTableID, "", MakeBatch(3 * i)));
+  }
+  ASSERT_OK(queue.Flush());
+  EXPECT_EQ(3, Stats().batches_added);
+  EXPECT_EQ(3 * batch_bytes_, Stats().bytes_added);
+}
+
+TEST_F(IngestQueueTest, tablets_not_coalesced) {
+  IngestQueue queue(&table_store_, kFlushPeriod, /*max_queued_batches*/ 16,
+                    /*coalesce_bytes*/ 1024 * 1024);
+  EXPECT_OK(queue.AppendData(kTableID, "a", MakeBatch(0)));
+  EXPECT_OK(queue.AppendData(kTableID, "a", MakeBatch(3)));
+  EXPECT_OK(queue.AppendData(kTableID, "b", MakeBatch(6)));
+  ASSERT_OK(queue.Flush());
+  EXPECT_EQ(1, Stats("a").batches_added);
+  EXPECT_EQ(2 * batch_bytes_, Stats("a").bytes_added);
+  EXPECT_EQ(1, Stats("b").batches_added);
+  EXPECT_EQ(batch_bytes_, Stats("b").bytes_added);
+}
+
+TEST_F(IngestQueueTest, drops_when_full) {
+  IngestQueue queue(&table_store_, kFlushPeriod, /*max_queued_batches*/ 2,
+                    /*coalesce_bytes*/ 1024 * 1024);
+  for (int64_t i = 0; i < 3; ++i) {
+    EXPECT_OK(queue.AppendData(kTableID, "", MakeBatch(3 * i)));
+  }
+  ASSERT_OK(queue.Flush());
+  EXPECT_EQ(2 * batch_bytes_, Stats().bytes_added);
+
+  // The queue accepts batches again once drained.
+  EXPECT_OK(queue.AppendData(kTableID, "", MakeBatch(9)));
+  ASSERT_OK(queue.Flush());
+  EXPECT_EQ(3 * batch_bytes_, Stats().bytes_added);
+}
+
+TEST_F(IngestQueueTest, append_failures_reported) {
+  constexpr uint64_t kUnknownTableID = 2;
+  IngestQueue queue(&table_store_, kFlushPeriod, /*max_queued_batches*/ 16,
+                    /*coalesce_bytes*/ 1024 * 1024);
+  EXPECT_OK(queue.AppendData(kUnknownTableID, "", MakeBatch(0)));
+  EXPECT_OK(queue.AppendData(kTableID, "", MakeBatch(3)));
+  EXPECT_NOT_OK(queue.Flush());
+  // A failing table doesn't keep the other tables from being appended.
+  EXPECT_EQ(batch_bytes_, Stats().bytes_added);
+}
+
+TEST_F(IngestQueueTest, writer_thread) {
+  IngestQueue queue(&table_store_, kFlushPeriod, /*max_queued_batches*/ 16,
+                    /*coalesce_bytes*/ 1024 * 1024);
+  queue.Start();
+  for (int64_t i = 0; i < 3; ++i) {
+    EXPECT_OK(queue.AppendData(kTableID, "", MakeBatch(3 * i)));
+  }
+  // Stop appends everything that was queued before it.
+  queue.Stop();
+  EXPECT_EQ(3 * batch_bytes_, Stats().bytes_added);
+}
+
+}  // namespace table_store
+}  // namespace px
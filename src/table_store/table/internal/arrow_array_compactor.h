@@ -32,10 +32,9 @@ namespace internal {
 
 /**
  * ArrowArrayCompactor compacts smaller row batches into a single row batch in the form of an
- * arrow::Array for each column in the row batch. ArrowArrayCompactor can accept either
- * `RecordBatchWithCache` objects or `schema::RowBatch` objects, through the variant type
- * `RecordOrRowBatch`. It also supports appending only a slice of a given row batch. Typical usage
- * should be as follows:
+ * arrow::Array for each column in the row batch. ArrowArrayCompactor accepts the hot store's
+ * `RecordOrRowBatch` objects, and also supports appending only a slice of a given row batch.
+ * Typical usage should be as follows:
  *
  *  PL_RETURN_IF_ERROR(compactor.Reserve(num_rows, variable_col_sizes_bytes));
  *  for (auto record_or_row_batch : record_or_row_batches_to_compact) {
@@ -60,11 +59,11 @@ class ArrowArrayCompactor {
    */
   Status Reserve(size_t num_rows, const std::vector<size_t>& variable_col_size_bytes);
   /**
-   * Append a slice of the given RecordBatchWithCache or schema::RowBatch, to the compacted batch,
+   * Append a slice of the given RecordOrRowBatch, to the compacted batch,
    * starting at `start_row` and including all rows up to but not including `end_row`.
    * It is required to call `Reserve` first with the total number of rows and col sizes, for all
    * slices that will be appended through UnsafeAppendBatchSlice.
-   * @param batch A std::variant containing either a RecordBatchWithCache or a schema::RowBatch.
+   * @param batch The hot batch to append a slice of.
    * @param start_row Row index in `batch` to start appending from
    * @param end_row Row index in `batch` to stop appending at (non-inclusive of `end_row`)
    */
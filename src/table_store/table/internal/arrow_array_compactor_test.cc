@@ -31,9 +31,9 @@ namespace px {
 namespace table_store {
 namespace internal {
 
-class ArrowArrayCompactorTest : public RecordOrRowBatchParamTest {
+class ArrowArrayCompactorTest : public RecordOrRowBatchTestBase {
   void SetUp() override {
-    RecordOrRowBatchParamTest::SetUp();
+    RecordOrRowBatchTestBase::SetUp();
     compactor_ = std::make_unique<ArrowArrayCompactor>(*rel_, arrow::default_memory_pool());
   }
 
@@ -41,7 +41,7 @@ class ArrowArrayCompactorTest : public RecordOrRowBatchParamTest {
   std::unique_ptr<ArrowArrayCompactor> compactor_;
 };
 
-TEST_P(ArrowArrayCompactorTest, BasicCompaction) {
+TEST_F(ArrowArrayCompactorTest, BasicCompaction) {
   std::vector<types::Time64NSValue> times_rb0 = {1, 2, 3};
   std::vector<types::BoolValue> bools_rb0 = {true, false, true};
   std::vector<types::StringValue> strings_rb0 = {"short", "longer string than first row", "s"};
@@ -93,7 +93,7 @@ TEST_P(ArrowArrayCompactorTest, BasicCompaction) {
                   ->Equals(types::ToArrow(strings_rb1, arrow::default_memory_pool())));
 }
 
-TEST_P(ArrowArrayCompactorTest, SlicedCompaction) {
+TEST_F(ArrowArrayCompactorTest, SlicedCompaction) {
   // Append last row of the first row batch and the first 2 rows of the second
   std::vector<types::Time64NSValue> times_rb0 = {1, 2, 3};
   std::vector<types::BoolValue> bools_rb0 = {true, false, true};
@@ -146,9 +146,6 @@ TEST_P(ArrowArrayCompactorTest, SlicedCompaction) {
       std::vector<types::StringValue>{"s", "one", "very"}, arrow::default_memory_pool())));
 }
 
-INSTANTIATE_RECORD_OR_ROW_BATCH_TESTSUITE(ArrowArrayCompactor, ArrowArrayCompactorTest,
-                                          /*include_mixed*/ true);
-
 }  // namespace internal
 }  // namespace table_store
 }  // namespace px
@@ -158,6 +158,12 @@ void BatchSizeAccountant::ExpireColdBatch() {
   cold_batch_bytes_.pop_front();
 }
 
+void BatchSizeAccountant::NewColdBatch(const BatchStats& batch_stats) {
+  DCHECK(batch_stats.bytes > 0) << "BatchSizeAccountant does not support 0-sized batches.";
+  cold_bytes_ += batch_stats.bytes;
+  cold_batch_bytes_.push_back(batch_stats.bytes);
+}
+
 bool BatchSizeAccountant::CompactedBatchReady() const {
   return !compacted_batch_specs_.empty() &&
          (compacted_batch_specs_.front().bytes >= non_mutable_state_.compacted_size);
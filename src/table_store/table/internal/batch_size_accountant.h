@@ -113,6 +113,12 @@ class BatchSizeAccountant {
    * should update its accounting accordingly.
    */
   void ExpireColdBatch();
+  /**
+   * NewColdBatch notifies the BatchSizeAccountant of a batch that was written directly to the cold
+   * store, bypassing the hot store and compaction.
+   * @param batch_stats output of BatchSizeAccountant::CalcBatchStats(batch) on the new cold batch.
+   */
+  void NewColdBatch(const BatchStats& batch_stats);
   /**
    * CompactedBatchReady returns whether there is enough data in the hot store to create a full
    * compacted batch.
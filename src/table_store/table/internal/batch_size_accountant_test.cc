@@ -25,10 +25,10 @@ namespace px {
 namespace table_store {
 namespace internal {
 
-class BatchSizeAccountantTest : public RecordOrRowBatchParamTest {
+class BatchSizeAccountantTest : public RecordOrRowBatchTestBase {
  protected:
   void SetUp() override {
-    RecordOrRowBatchParamTest::SetUp();
+    RecordOrRowBatchTestBase::SetUp();
 
     std::vector<types::Time64NSValue> times = {9, 10, 20, 25};
     std::vector<types::BoolValue> bools = {true, false, true, false};
@@ -74,7 +74,7 @@ class BatchSizeAccountantTest : public RecordOrRowBatchParamTest {
   int64_t string_col_idx_ = 2;
 };
 
-TEST_P(BatchSizeAccountantTest, BatchStatsBasic) {
+TEST_F(BatchSizeAccountantTest, BatchStatsBasic) {
   auto stats = BatchSizeAccountant::CalcBatchStats(accountant_->NonMutableState(),
                                                    *larger_than_compaction_rb_);
   EXPECT_EQ(4, stats.num_rows);
@@ -98,7 +98,7 @@ TEST_P(BatchSizeAccountantTest, BatchStatsBasic) {
       ::testing::Field(&BatchSizeAccountant::CompactedBatchSpec::HotSlice::last_slice_for_batch, \
                        last_slice))
 
-TEST_P(BatchSizeAccountantTest, IndexThenCompact) {
+TEST_F(BatchSizeAccountantTest, IndexThenCompact) {
   accountant_->NewHotBatch(
       BatchSizeAccountant::CalcBatchStats(accountant_->NonMutableState(), *half_compaction_rb_));
   accountant_->NewHotBatch(BatchSizeAccountant::CalcBatchStats(accountant_->NonMutableState(),
@@ -152,7 +152,7 @@ TEST_P(BatchSizeAccountantTest, IndexThenCompact) {
             accountant_->ColdBytes());
 }
 
-TEST_P(BatchSizeAccountantTest, IndexThenCompactWithExpiry) {
+TEST_F(BatchSizeAccountantTest, IndexThenCompactWithExpiry) {
   accountant_->NewHotBatch(
       BatchSizeAccountant::CalcBatchStats(accountant_->NonMutableState(), *half_compaction_rb_));
   accountant_->NewHotBatch(BatchSizeAccountant::CalcBatchStats(accountant_->NonMutableState(),
@@ -201,9 +201,6 @@ TEST_P(BatchSizeAccountantTest, IndexThenCompactWithExpiry) {
   EXPECT_EQ(2 * half_compaction_rb_bytes_, accountant_->ColdBytes());
 }
 
-INSTANTIATE_RECORD_OR_ROW_BATCH_TESTSUITE(BatchSizeAccountant, BatchSizeAccountantTest,
-                                          /*include_mixed*/ true);
-
 }  // namespace internal
 }  // namespace table_store
 }  // namespace px
@@ -18,8 +18,6 @@
 
 #pragma once
 
-#include <utility>
-#include <variant>
 #include <vector>
 
 #include "src/table_store/schema/row_batch.h"
@@ -30,20 +28,13 @@ namespace table_store {
 namespace internal {
 
 /**
- * RecordOrRowBatch is a wrapper around an `std::variant` with `RecordBatchWithCache` and
- * `schema::RowBatch` as subtypes.
- *
- * The wrapper allows for uniform access to `RecordBatchWithCache` objects and `schema::RowBatch`
- * objects, so that all other table components can ignore the details of whether a given batch is a
- * `RecordBatchWithCache` or a `schema::RowBatch`. The wrapper also allows for removing rows from
- * the start of the batch without reallocating or copying the batch. To do so, it stores a
- * `row_offset_` internally, and each operation on a batch acts as if the batch actually starts at
- * `row_offset_`.
+ * RecordOrRowBatch wraps a `schema::RowBatch` stored in a table's hot store. It allows for
+ * removing rows from the start of the batch without reallocating or copying the batch. To do so, it
+ * stores a `row_offset_` internally, and each operation on a batch acts as if the batch actually
+ * starts at `row_offset_`.
  */
 class RecordOrRowBatch {
  public:
-  explicit RecordOrRowBatch(RecordBatchWithCache&& record_batch)
-      : batch_(std::move(record_batch)) {}
   explicit RecordOrRowBatch(const schema::RowBatch& row_batch) : batch_(row_batch) {}
 
   RecordOrRowBatch(RecordOrRowBatch&&) = default;
@@ -126,7 +117,7 @@ class RecordOrRowBatch {
   std::vector<uint64_t> GetVariableSizedColumnRowBytes(size_t col_idx) const;
 
  private:
-  std::variant<RecordBatchWithCache, schema::RowBatch> batch_;
+  schema::RowBatch batch_;
   int64_t row_offset_ = 0;
 };
 
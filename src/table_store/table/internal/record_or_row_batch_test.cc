@@ -30,10 +30,10 @@ namespace px {
 namespace table_store {
 namespace internal {
 
-class RecordOrRowBatchTest : public RecordOrRowBatchParamTest {
+class RecordOrRowBatchTest : public RecordOrRowBatchTestBase {
  protected:
   void SetUp() override {
-    RecordOrRowBatchParamTest::SetUp();
+    RecordOrRowBatchTestBase::SetUp();
     times_ = {9, 10, 20, 25};
     bools_ = {true, false, true, false};
     strings_ = {
@@ -54,13 +54,13 @@ class RecordOrRowBatchTest : public RecordOrRowBatchParamTest {
   size_t strings_total_length_;
 };
 
-TEST_P(RecordOrRowBatchTest, Length) { EXPECT_EQ(4, rb_->Length()); }
-TEST_P(RecordOrRowBatchTest, RemovePrefix_Length) {
+TEST_F(RecordOrRowBatchTest, Length) { EXPECT_EQ(4, rb_->Length()); }
+TEST_F(RecordOrRowBatchTest, RemovePrefix_Length) {
   rb_->RemovePrefix(2);
   EXPECT_EQ(2, rb_->Length());
 }
 
-TEST_P(RecordOrRowBatchTest, FindTimeFirstGreaterThanOrEqual) {
+TEST_F(RecordOrRowBatchTest, FindTimeFirstGreaterThanOrEqual) {
   EXPECT_EQ(0, rb_->FindTimeFirstGreaterThanOrEqual(time_col_idx_, 0));
   EXPECT_EQ(0, rb_->FindTimeFirstGreaterThanOrEqual(time_col_idx_, 9));
   EXPECT_EQ(1, rb_->FindTimeFirstGreaterThanOrEqual(time_col_idx_, 10));
@@ -68,7 +68,7 @@ TEST_P(RecordOrRowBatchTest, FindTimeFirstGreaterThanOrEqual) {
   EXPECT_EQ(-1, rb_->FindTimeFirstGreaterThanOrEqual(time_col_idx_, 26));
 }
 
-TEST_P(RecordOrRowBatchTest, RemovePrefix_FindTimeFirstGreaterThanOrEqual) {
+TEST_F(RecordOrRowBatchTest, RemovePrefix_FindTimeFirstGreaterThanOrEqual) {
   rb_->RemovePrefix(2);
 
   EXPECT_EQ(0, rb_->FindTimeFirstGreaterThanOrEqual(time_col_idx_, 0));
@@ -79,7 +79,7 @@ TEST_P(RecordOrRowBatchTest, RemovePrefix_FindTimeFirstGreaterThanOrEqual) {
   EXPECT_EQ(-1, rb_->FindTimeFirstGreaterThanOrEqual(time_col_idx_, 26));
 }
 
-TEST_P(RecordOrRowBatchTest, FindTimeFirstGreaterThan) {
+TEST_F(RecordOrRowBatchTest, FindTimeFirstGreaterThan) {
   EXPECT_EQ(0, rb_->FindTimeFirstGreaterThan(time_col_idx_, 0));
   EXPECT_EQ(1, rb_->FindTimeFirstGreaterThan(time_col_idx_, 9));
   EXPECT_EQ(2, rb_->FindTimeFirstGreaterThan(time_col_idx_, 10));
@@ -87,7 +87,7 @@ TEST_P(RecordOrRowBatchTest, FindTimeFirstGreaterThan) {
   EXPECT_EQ(-1, rb_->FindTimeFirstGreaterThan(time_col_idx_, 25));
 }
 
-TEST_P(RecordOrRowBatchTest, RemovePrefix_FindTimeFirstGreaterThan) {
+TEST_F(RecordOrRowBatchTest, RemovePrefix_FindTimeFirstGreaterThan) {
   rb_->RemovePrefix(2);
 
   EXPECT_EQ(0, rb_->FindTimeFirstGreaterThan(time_col_idx_, 0));
@@ -98,20 +98,20 @@ TEST_P(RecordOrRowBatchTest, RemovePrefix_FindTimeFirstGreaterThan) {
   EXPECT_EQ(-1, rb_->FindTimeFirstGreaterThan(time_col_idx_, 25));
 }
 
-TEST_P(RecordOrRowBatchTest, GetTimeValue) {
+TEST_F(RecordOrRowBatchTest, GetTimeValue) {
   EXPECT_EQ(9, rb_->GetTimeValue(time_col_idx_, 0));
   EXPECT_EQ(10, rb_->GetTimeValue(time_col_idx_, 1));
   EXPECT_EQ(20, rb_->GetTimeValue(time_col_idx_, 2));
   EXPECT_EQ(25, rb_->GetTimeValue(time_col_idx_, 3));
 }
 
-TEST_P(RecordOrRowBatchTest, RemovePrefix_GetTimeValue) {
+TEST_F(RecordOrRowBatchTest, RemovePrefix_GetTimeValue) {
   rb_->RemovePrefix(2);
   EXPECT_EQ(20, rb_->GetTimeValue(time_col_idx_, 0));
   EXPECT_EQ(25, rb_->GetTimeValue(time_col_idx_, 1));
 }
 
-TEST_P(RecordOrRowBatchTest, AddBatchSliceToRowBatch) {
+TEST_F(RecordOrRowBatchTest, AddBatchSliceToRowBatch) {
   schema::RowBatch rb0(schema::RowDescriptor(rel_->col_types()), 2);
   EXPECT_OK(rb_->AddBatchSliceToRowBatch(0, 2, {0, 1, 2}, &rb0));
 
@@ -133,7 +133,7 @@ TEST_P(RecordOrRowBatchTest, AddBatchSliceToRowBatch) {
       rb1.ColumnAt(2)->Equals(types::ToArrow(strings_, arrow::default_memory_pool())->Slice(1, 2)));
 }
 
-TEST_P(RecordOrRowBatchTest, RemovePrefix_AddBatchSliceToRowBatch) {
+TEST_F(RecordOrRowBatchTest, RemovePrefix_AddBatchSliceToRowBatch) {
   rb_->RemovePrefix(1);
 
   schema::RowBatch rb0(schema::RowDescriptor(rel_->col_types()), 2);
@@ -157,7 +157,7 @@ TEST_P(RecordOrRowBatchTest, RemovePrefix_AddBatchSliceToRowBatch) {
       rb1.ColumnAt(2)->Equals(types::ToArrow(strings_, arrow::default_memory_pool())->Slice(2, 1)));
 }
 
-TEST_P(RecordOrRowBatchTest, UnsafeAppendColumnToBuilder) {
+TEST_F(RecordOrRowBatchTest, UnsafeAppendColumnToBuilder) {
   auto time_builder =
       types::MakeTypeErasedArrowBuilder(types::DataType::TIME64NS, arrow::default_memory_pool());
   EXPECT_OK(time_builder->Reserve(4));
@@ -185,7 +185,7 @@ TEST_P(RecordOrRowBatchTest, UnsafeAppendColumnToBuilder) {
   EXPECT_TRUE(string_col->Equals(types::ToArrow(strings_, arrow::default_memory_pool())));
 }
 
-TEST_P(RecordOrRowBatchTest, RemovePrefix_UnsafeAppendColumnToBuilder) {
+TEST_F(RecordOrRowBatchTest, RemovePrefix_UnsafeAppendColumnToBuilder) {
   rb_->RemovePrefix(1);
 
   auto time_builder =
@@ -216,7 +216,7 @@ TEST_P(RecordOrRowBatchTest, RemovePrefix_UnsafeAppendColumnToBuilder) {
       string_col->Equals(types::ToArrow(strings_, arrow::default_memory_pool())->Slice(1, 3)));
 }
 
-TEST_P(RecordOrRowBatchTest, UnsafeAppendColumnToBuilderSliced) {
+TEST_F(RecordOrRowBatchTest, UnsafeAppendColumnToBuilderSliced) {
   auto time_builder =
       types::MakeTypeErasedArrowBuilder(types::DataType::TIME64NS, arrow::default_memory_pool());
   EXPECT_OK(time_builder->Reserve(2));
@@ -246,7 +246,7 @@ TEST_P(RecordOrRowBatchTest, UnsafeAppendColumnToBuilderSliced) {
       string_col->Equals(types::ToArrow(strings_, arrow::default_memory_pool())->Slice(1, 2)));
 }
 
-TEST_P(RecordOrRowBatchTest, RemovePrefix_UnsafeAppendColumnToBuilderSliced) {
+TEST_F(RecordOrRowBatchTest, RemovePrefix_UnsafeAppendColumnToBuilderSliced) {
   rb_->RemovePrefix(1);
 
   auto time_builder =
@@ -278,20 +278,17 @@ TEST_P(RecordOrRowBatchTest, RemovePrefix_UnsafeAppendColumnToBuilderSliced) {
       string_col->Equals(types::ToArrow(strings_, arrow::default_memory_pool())->Slice(2, 2)));
 }
 
-TEST_P(RecordOrRowBatchTest, GetVariableSizedColumnRowBytes) {
+TEST_F(RecordOrRowBatchTest, GetVariableSizedColumnRowBytes) {
   EXPECT_THAT(rb_->GetVariableSizedColumnRowBytes(2),
               ::testing::ElementsAre(strings_[0].size(), strings_[1].size(), strings_[2].size(),
                                      strings_[3].size()));
 }
 
-TEST_P(RecordOrRowBatchTest, RemovePrefix_GetVariableSizedColumnRowBytes) {
+TEST_F(RecordOrRowBatchTest, RemovePrefix_GetVariableSizedColumnRowBytes) {
   rb_->RemovePrefix(3);
   EXPECT_THAT(rb_->GetVariableSizedColumnRowBytes(2), ::testing::ElementsAre(strings_[3].size()));
 }
 
-INSTANTIATE_RECORD_OR_ROW_BATCH_TESTSUITE(RecordOrRowBatch, RecordOrRowBatchTest,
-                                          /*include_mixed*/ false);
-
 }  // namespace internal
 }  // namespace table_store
 }  // namespace px
@@ -28,6 +28,7 @@
 #include "src/shared/types/arrow_adapter.h"
 #include "src/shared/types/column_wrapper.h"
 #include "src/table_store/schema/relation.h"
+#include "src/table_store/table/internal/time_index.h"
 #include "src/table_store/table/internal/types.h"
 
 namespace px {
@@ -40,14 +41,6 @@ inline bool RowIDIntervalComparator(const RowIDInterval& interval, RowID val) {
   return interval.second < val;
 }
 
-inline bool TimeIntervalComparatorLowerBound(const TimeInterval& interval, Time val) {
-  return interval.second < val;
-}
-
-inline bool TimeIntervalComparatorUpperBound(Time val, const TimeInterval& interval) {
-  return val < interval.second;
-}
-
 template <bool always_false = false>
 void constexpr_else_static_assert_false() {
   static_assert(always_false, "constexpr else block reached");
@@ -139,6 +132,22 @@ class StoreWithRowTimeAccounting {
     return output_rb;
   }
 
+  /**
+   * GetBatchesAfter returns the batches that only contain rows with a RowID greater than the given
+   * RowID, along with the RowID of their first row.
+   * @param row_id, the RowID after which batches should be returned.
+   * @return vector of pairs of first RowID and batch, in RowID order.
+   */
+  std::vector<std::pair<RowID, TBatch>> GetBatchesAfter(RowID row_id) const {
+    std::vector<std::pair<RowID, TBatch>> out;
+    for (size_t i = 0; i < batches_.size(); ++i) {
+      if (row_ids_[i].first > row_id) {
+        out.emplace_back(row_ids_[i].first, batches_[i]);
+      }
+    }
+    return out;
+  }
+
   /**
    * Size returns the number of batches in this store.
    * @return number of batches.
@@ -163,7 +172,7 @@ class StoreWithRowTimeAccounting {
     first_batch_id_++;
 
     row_ids_.pop_front();
-    if (time_col_idx_ != -1) times_.pop_front();
+    if (time_col_idx_ != -1) times_.PopFront();
 
     auto&& front = std::move(batches_.front());
     batches_.pop_front();
@@ -184,7 +193,7 @@ class StoreWithRowTimeAccounting {
     if (time_col_idx_ != -1) {
       auto first_time = GetTimeValue(batch, 0);
       auto last_time = GetTimeValue(batch, BatchLength(batch) - 1);
-      times_.emplace_back(first_time, last_time);
+      times_.PushBack(first_time, last_time);
     }
     return batch;
   }
@@ -218,12 +227,10 @@ class StoreWithRowTimeAccounting {
     if (time_col_idx_ == -1) {
       return std::nullopt;
     }
-    auto it =
-        std::lower_bound(times_.begin(), times_.end(), time, TimeIntervalComparatorLowerBound);
-    if (it == times_.end()) {
+    size_t batch_index = times_.FindBatchLastGreaterThanOrEqual(time);
+    if (batch_index == times_.Size()) {
       return std::nullopt;
     }
-    size_t batch_index = std::distance(times_.begin(), it);
     auto row_offset = FindTimeFirstGreaterThanOrEqual(batches_[batch_index], time);
     return row_ids_[batch_index].first + row_offset;
   }
@@ -239,12 +246,10 @@ class StoreWithRowTimeAccounting {
     if (time_col_idx_ == -1) {
       return std::nullopt;
     }
-    auto it =
-        std::upper_bound(times_.begin(), times_.end(), time, TimeIntervalComparatorUpperBound);
-    if (it == times_.end()) {
+    size_t batch_index = times_.FindBatchLastGreaterThan(time);
+    if (batch_index == times_.Size()) {
       return std::nullopt;
     }
-    size_t batch_index = std::distance(times_.begin(), it);
     auto row_offset = FindTimeFirstGreaterThan(batches_[batch_index], time);
     return row_ids_[batch_index].first + row_offset;
   }
@@ -267,7 +272,7 @@ class StoreWithRowTimeAccounting {
 
     row_ids_.front().first += num_rows;
     if (time_col_idx_ != -1) {
-      times_.front().first = GetTimeValue(batches_.front(), 0);
+      times_.SetFrontFirst(GetTimeValue(batches_.front(), 0));
     }
   }
 
@@ -278,10 +283,10 @@ class StoreWithRowTimeAccounting {
    * column.
    */
   int64_t MinTime() const {
-    if (time_col_idx_ == -1 || times_.empty()) {
+    if (time_col_idx_ == -1 || times_.Empty()) {
       return -1;
     }
-    return times_.front().first;
+    return times_.FrontFirst();
   }
 
  private:
@@ -340,8 +345,8 @@ class StoreWithRowTimeAccounting {
 
   size_t FindTimeFirstGreaterThanOrEqual(const TBatch& batch, Time time) const {
     if constexpr (std::is_same_v<TBatch, ColdBatch>) {
-      return types::SearchArrowArrayGreaterThanOrEqual<types::DataType::TIME64NS>(
-          batch[time_col_idx_].get(), time);
+      const auto* arr = batch[time_col_idx_].get();
+      return TimeLowerBound(ArrowTimeValues(arr), arr->length(), time);
     } else if constexpr (std::is_same_v<TBatch, HotBatch>) {
       return batch.FindTimeFirstGreaterThanOrEqual(time_col_idx_, time);
     } else {
@@ -351,9 +356,8 @@ class StoreWithRowTimeAccounting {
 
   size_t FindTimeFirstGreaterThan(const TBatch& batch, Time time) const {
     if constexpr (std::is_same_v<TBatch, ColdBatch>) {
-      return types::SearchArrowArrayLessThanOrEqual<types::DataType::TIME64NS>(
-                 batch[time_col_idx_].get(), time) +
-             1;
+      const auto* arr = batch[time_col_idx_].get();
+      return TimeUpperBound(ArrowTimeValues(arr), arr->length(), time);
     } else if constexpr (std::is_same_v<TBatch, HotBatch>) {
       return batch.FindTimeFirstGreaterThan(time_col_idx_, time);
     } else {
@@ -393,7 +397,7 @@ class StoreWithRowTimeAccounting {
   const int64_t time_col_idx_;
   std::deque<TBatch> batches_;
   std::deque<RowIDInterval> row_ids_;
-  std::deque<TimeInterval> times_;
+  SparseTimeIndex times_;
 };
 
 }  // namespace internal
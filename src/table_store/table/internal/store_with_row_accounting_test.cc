@@ -51,10 +51,10 @@ class ColdStoreTest : public ::testing::Test {
   std::unique_ptr<StoreWithRowTimeAccounting<StoreType::Cold>> store_;
 };
 
-class HotStoreTest : public RecordOrRowBatchParamTest {
+class HotStoreTest : public RecordOrRowBatchTestBase {
  protected:
   void SetUp() override {
-    RecordOrRowBatchParamTest::SetUp();
+    RecordOrRowBatchTestBase::SetUp();
     store_ = std::make_unique<StoreWithRowTimeAccounting<StoreType::Hot>>(*rel_, 0);
   }
   std::unique_ptr<StoreWithRowTimeAccounting<StoreType::Hot>> store_;
@@ -124,7 +124,7 @@ TEST_F(ColdStoreTest, PushRowBatchesCheckProperties) {
   EXPECT_EQ(4, optional_row_id.value());
 }
 
-TEST_P(HotStoreTest, PushRowBatchesCheckProperties) {
+TEST_F(HotStoreTest, PushRowBatchesCheckProperties) {
   std::vector<types::Time64NSValue> times = {1, 1, 10, 11};
   std::vector<types::BoolValue> bools = {true, false, true, false};
   std::vector<types::StringValue> strings = {"ab", "cd", "ef", "gh"};
@@ -188,7 +188,7 @@ TEST_P(HotStoreTest, PushRowBatchesCheckProperties) {
   EXPECT_EQ(4, optional_row_id.value());
 }
 
-TEST_P(HotStoreTest, RemovePrefix) {
+TEST_F(HotStoreTest, RemovePrefix) {
   std::vector<types::Time64NSValue> times = {1, 1, 10, 11};
   std::vector<types::BoolValue> bools = {true, false, true, false};
   std::vector<types::StringValue> strings = {"ab", "cd", "ef", "gh"};
@@ -218,8 +218,6 @@ TEST_P(HotStoreTest, RemovePrefix) {
   EXPECT_EQ(2, optional_row_id.value());
 }
 
-INSTANTIATE_RECORD_OR_ROW_BATCH_TESTSUITE(HotStore, HotStoreTest, /*include_mixed*/ true);
-
 }  // namespace internal
 }  // namespace table_store
 }  // namespace px
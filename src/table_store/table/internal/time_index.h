@@ -0,0 +1,133 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+
+#include <vector>
+
+#include "src/common/base/logging.h"
+#include "src/common/base/sorted_search.h"
+#include "src/shared/types/column_wrapper.h"
+#include "src/table_store/table/internal/types.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+/**
+ * TimeLowerBound returns the index of the first of the `n` sorted times that is greater than or
+ * equal to `time`, or `n` if there is none.
+ */
+inline size_t TimeLowerBound(const Time* times, size_t n, Time time) {
+  return BranchlessLowerBound(n, [times](size_t i) { return times[i]; }, time);
+}
+
+inline size_t TimeLowerBound(const types::Time64NSValue* times, size_t n, Time time) {
+  return BranchlessLowerBound(n, [times](size_t i) { return times[i].val; }, time);
+}
+
+/**
+ * TimeUpperBound returns the index of the first of the `n` sorted times that is greater than
+ * `time`, or `n` if there is none.
+ */
+inline size_t TimeUpperBound(const Time* times, size_t n, Time time) {
+  return BranchlessUpperBound(n, [times](size_t i) { return times[i]; }, time);
+}
+
+inline size_t TimeUpperBound(const types::Time64NSValue* times, size_t n, Time time) {
+  return BranchlessUpperBound(n, [times](size_t i) { return times[i].val; }, time);
+}
+
+/**
+ * ArrowTimeValues returns the (offset adjusted) contiguous values of a TIME64NS arrow array.
+ */
+inline const Time* ArrowTimeValues(const arrow::Array* arr) {
+  return static_cast<const arrow::Time64Array*>(arr)->raw_values();
+}
+
+/**
+ * SparseTimeIndex keeps the first and last time of each batch in a store, in batch order. It is
+ * the first level of a time lookup: the batch containing a time is found here, and the row is then
+ * found by searching the time column of that one batch.
+ *
+ * The first and last times are kept in separate contiguous arrays, so the batch search is a
+ * branchless binary search over a single array of Time values. Batches are only ever added at the
+ * back and expired from the front, so expiring a batch advances a head offset, and the arrays are
+ * compacted once the expired prefix outgrows the live part.
+ */
+class SparseTimeIndex {
+ public:
+  size_t Size() const { return lasts_.size() - head_; }
+  bool Empty() const { return Size() == 0; }
+
+  void PushBack(Time first, Time last) {
+    firsts_.push_back(first);
+    lasts_.push_back(last);
+  }
+
+  void PopFront() {
+    DCHECK(!Empty());
+    ++head_;
+    if (head_ >= kMinCompactionSize && head_ * 2 >= lasts_.size()) {
+      firsts_.erase(firsts_.begin(), firsts_.begin() + head_);
+      lasts_.erase(lasts_.begin(), lasts_.begin() + head_);
+      head_ = 0;
+    }
+  }
+
+  Time FrontFirst() const {
+    DCHECK(!Empty());
+    return firsts_[head_];
+  }
+
+  void SetFrontFirst(Time first) {
+    DCHECK(!Empty());
+    firsts_[head_] = first;
+  }
+
+  /**
+   * Returns the index of the first batch whose last time is greater than or equal to `time`, which
+   * is the first batch that can contain a row with such a time. Returns Size() if there is none.
+   */
+  size_t FindBatchLastGreaterThanOrEqual(Time time) const {
+    return TimeLowerBound(lasts_.data() + head_, Size(), time);
+  }
+
+  /**
+   * Returns the index of the first batch whose last time is greater than `time`, or Size() if there
+   * is none.
+   */
+  size_t FindBatchLastGreaterThan(Time time) const {
+    return TimeUpperBound(lasts_.data() + head_, Size(), time);
+  }
+
+ private:
+  // Don't bother compacting until at least this many batches have expired.
+  static constexpr size_t kMinCompactionSize = 64;
+
+  std::vector<Time> firsts_;
+  std::vector<Time> lasts_;
+  // Index of the first live batch in firsts_ and lasts_.
+  size_t head_ = 0;
+};
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
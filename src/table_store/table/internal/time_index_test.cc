@@ -0,0 +1,103 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/table/internal/time_index.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+TEST(TimeIndexTest, TimeBounds) {
+  std::vector<types::Time64NSValue> times = {1, 1, 10, 11};
+
+  EXPECT_EQ(0, TimeLowerBound(times.data(), times.size(), 0));
+  EXPECT_EQ(0, TimeLowerBound(times.data(), times.size(), 1));
+  EXPECT_EQ(2, TimeLowerBound(times.data(), times.size(), 2));
+  EXPECT_EQ(4, TimeLowerBound(times.data(), times.size(), 12));
+
+  EXPECT_EQ(0, TimeUpperBound(times.data(), times.size(), 0));
+  EXPECT_EQ(2, TimeUpperBound(times.data(), times.size(), 1));
+  EXPECT_EQ(3, TimeUpperBound(times.data(), times.size(), 10));
+  EXPECT_EQ(4, TimeUpperBound(times.data(), times.size(), 11));
+}
+
+TEST(TimeIndexTest, ArrowTimeValuesRespectsSliceOffset) {
+  std::vector<types::Time64NSValue> times = {1, 2, 3, 4, 5};
+  auto arr = types::ToArrow(times, arrow::default_memory_pool())->Slice(2, 3);
+
+  const Time* values = ArrowTimeValues(arr.get());
+  EXPECT_EQ(3, values[0]);
+  EXPECT_EQ(1, TimeLowerBound(values, arr->length(), 4));
+  EXPECT_EQ(3, TimeUpperBound(values, arr->length(), 5));
+}
+
+TEST(SparseTimeIndexTest, FindBatch) {
+  SparseTimeIndex index;
+  EXPECT_TRUE(index.Empty());
+  EXPECT_EQ(0, index.FindBatchLastGreaterThanOrEqual(0));
+
+  index.PushBack(0, 9);
+  index.PushBack(10, 19);
+  index.PushBack(19, 29);
+
+  EXPECT_EQ(3, index.Size());
+  EXPECT_EQ(0, index.FrontFirst());
+
+  EXPECT_EQ(0, index.FindBatchLastGreaterThanOrEqual(5));
+  EXPECT_EQ(1, index.FindBatchLastGreaterThanOrEqual(10));
+  EXPECT_EQ(1, index.FindBatchLastGreaterThanOrEqual(19));
+  EXPECT_EQ(3, index.FindBatchLastGreaterThanOrEqual(30));
+
+  EXPECT_EQ(1, index.FindBatchLastGreaterThan(9));
+  EXPECT_EQ(2, index.FindBatchLastGreaterThan(19));
+  EXPECT_EQ(3, index.FindBatchLastGreaterThan(29));
+
+  index.SetFrontFirst(4);
+  EXPECT_EQ(4, index.FrontFirst());
+
+  index.PopFront();
+  EXPECT_EQ(2, index.Size());
+  EXPECT_EQ(10, index.FrontFirst());
+  EXPECT_EQ(0, index.FindBatchLastGreaterThanOrEqual(5));
+  EXPECT_EQ(1, index.FindBatchLastGreaterThan(19));
+}
+
+TEST(SparseTimeIndexTest, PopFrontCompaction) {
+  SparseTimeIndex index;
+  for (Time t = 0; t < 1000; ++t) {
+    index.PushBack(10 * t, 10 * t + 9);
+  }
+  for (Time t = 0; t < 990; ++t) {
+    EXPECT_EQ(10 * t, index.FrontFirst());
+    EXPECT_EQ(999 - t, index.FindBatchLastGreaterThanOrEqual(9990));
+    index.PopFront();
+    index.PushBack(10 * (t + 1000), 10 * (t + 1000) + 9);
+  }
+  EXPECT_EQ(1000, index.Size());
+  EXPECT_EQ(9900, index.FrontFirst());
+  EXPECT_EQ(10, index.FindBatchLastGreaterThan(9999));
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -42,14 +42,6 @@ using RowID = int64_t;
 using RowIDInterval = std::pair<RowID, RowID>;
 using BatchID = int64_t;
 
-struct RecordBatchWithCache {
-  RecordBatchPtr record_batch;
-  // Whenever we have to convert a hot batch to an arrow array, we store the arrow array in
-  // this cache. Compaction will eventually take these arrow arrays and move them into cold.
-  mutable std::vector<ArrowArrayPtr> arrow_cache;
-  mutable std::vector<bool> cache_validity;
-};
-
 enum StoreType {
   Hot,
   Cold,
@@ -17,6 +17,7 @@
  */
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <iterator>
@@ -54,6 +55,12 @@ Table::Cursor::Cursor(const Table* table, StartSpec start, StopSpec stop)
   StopStateFromSpec(std::move(stop));
 }
 
+Table::Cursor::Cursor(const Table* table, RowID last_read_row_id, RowID stop_row_id)
+    : table_(table), hints_(internal::BatchHints{}), last_read_row_id_(last_read_row_id) {
+  stop_.spec.type = StopSpec::StopType::CurrentEndOfTable;
+  stop_.stop_row_id = stop_row_id;
+}
+
 void Table::Cursor::AdvanceToStart(const StartSpec& start) {
   switch (start.type) {
     case StartSpec::StartType::StartAtTime: {
@@ -113,6 +120,27 @@ bool Table::Cursor::Done() {
 
 void Table::Cursor::UpdateStopSpec(Cursor::StopSpec stop) { StopStateFromSpec(std::move(stop)); }
 
+StatusOr<std::vector<Table::Cursor::RowBatchWithOffset>> Table::Cursor::ReadLastBatchRows(
+    int64_t start, int64_t stop, const std::vector<int64_t>& cols) {
+  DCHECK_NE(last_batch_first_row_id_, -1) << "ReadLastBatchRows called before GetNextRowBatch";
+  DCHECK_LE(start, stop);
+  RowID stop_row_id = last_batch_first_row_id_ + stop;
+  Cursor rows_cursor(table_, last_batch_first_row_id_ + start - 1, stop_row_id);
+
+  std::vector<RowBatchWithOffset> row_batches;
+  while (!rows_cursor.Done()) {
+    // The remaining rows were expired after they were last read.
+    RowID first_row_id = table_->FirstRowID();
+    if (first_row_id == -1 || first_row_id >= stop_row_id) {
+      break;
+    }
+    PL_ASSIGN_OR_RETURN(auto rb, rows_cursor.GetNextRowBatch(cols));
+    row_batches.push_back(RowBatchWithOffset{
+        rows_cursor.last_batch_first_row_id_ - last_batch_first_row_id_, std::move(rb)});
+  }
+  return row_batches;
+}
+
 internal::RowID* Table::Cursor::LastReadRowID() { return &last_read_row_id_; }
 
 internal::BatchHints* Table::Cursor::Hints() { return &hints_; }
@@ -196,6 +224,7 @@ StatusOr<std::unique_ptr<schema::RowBatch>> Table::GetNextRowBatch(
   if (rb == nullptr) {
     return error::InvalidArgument("Data after Cursor is not in the table.");
   }
+  cursor->last_batch_first_row_id_ = *cursor->LastReadRowID() - rb->num_rows() + 1;
   return rb;
 }
 
@@ -243,17 +272,68 @@ Status Table::TransferRecordBatch(
     return Status::OK();
   }
 
-  auto record_batch_w_cache = internal::RecordBatchWithCache{
-      std::move(record_batch),
-      std::vector<ArrowArrayPtr>(rel_.NumColumns()),
-      std::vector<bool>(rel_.NumColumns(), false),
-  };
-  internal::RecordOrRowBatch record_or_row_batch(std::move(record_batch_w_cache));
+  // Convert to arrow before the batch is published to the hot store, so that cursors reading hot
+  // data never pay the conversion on the query path or while holding hot_lock_. The hot store
+  // keeps only the arrow copy, so the column wrappers are released here and the batch is
+  // accounted for by the bytes it actually holds.
+  schema::RowBatch rb(schema::RowDescriptor(rel_.col_types()), record_batch->at(0)->Size());
+  for (const auto& col : *record_batch) {
+    PL_RETURN_IF_ERROR(rb.AddColumn(col->ConvertToArrow(arrow::default_memory_pool())));
+  }
+  record_batch.reset();
 
+  internal::RecordOrRowBatch record_or_row_batch(rb);
   PL_RETURN_IF_ERROR(WriteHot(std::move(record_or_row_batch)));
   return Status::OK();
 }
 
+Status Table::WriteColdBatch(const schema::RowBatch& rb) {
+  if (rb.num_columns() == 0 || rb.ColumnAt(0)->length() == 0) {
+    return Status::OK();
+  }
+  if (rb.num_columns() != static_cast<int64_t>(rel_.NumColumns())) {
+    return error::InvalidArgument("RowBatch has $0 columns, but table has $1.", rb.num_columns(),
+                                  rel_.NumColumns());
+  }
+  for (int64_t i = 0; i < rb.num_columns(); ++i) {
+    if (rb.desc().type(i) != rel_.GetColumnType(i)) {
+      return error::InvalidArgument("Column $0 has type $1, but table expects $2.", i,
+                                    types::ToString(rb.desc().type(i)),
+                                    types::ToString(rel_.GetColumnType(i)));
+    }
+  }
+
+  internal::RecordOrRowBatch record_or_row_batch(rb);
+  auto batch_stats = internal::BatchSizeAccountant::CalcBatchStats(
+      ABSL_TS_UNCHECKED_READ(batch_size_accountant_)->NonMutableState(), record_or_row_batch);
+
+  PL_RETURN_IF_ERROR(ExpireRowBatches(batch_stats.bytes));
+
+  {
+    absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+    if (hot_store_->Size() > 0) {
+      return error::FailedPrecondition(
+          "Cannot write a cold batch while the hot store of table holds $0 batches.",
+          hot_store_->Size());
+    }
+    batch_size_accountant_->NewColdBatch(batch_stats);
+    cold_store_->EmplaceBack(next_row_id_, rb.columns());
+    next_row_id_ += rb.num_rows();
+  }
+
+  {
+    absl::base_internal::SpinLockHolder lock(&stats_lock_);
+    ++batches_added_;
+    metrics_.batches_added_counter.Increment();
+    bytes_added_ += batch_stats.bytes;
+    metrics_.bytes_added_counter.Increment(batch_stats.bytes);
+  }
+
+  PL_RETURN_IF_ERROR(UpdateTableMetricGauges());
+  return Status::OK();
+}
+
 Status Table::WriteHot(internal::RecordOrRowBatch&& record_or_row_batch) {
   // See BatchSizeAccountantNonMutableState for an explanation of the thread safety and necessity of
   // NonMutableState.
@@ -263,7 +343,10 @@ Status Table::WriteHot(internal::RecordOrRowBatch&& record_or_row_batch) {
   PL_RETURN_IF_ERROR(ExpireRowBatches(batch_stats.bytes));
 
   {
+    auto lock_wait_start = std::chrono::steady_clock::now();
     absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+    std::chrono::duration<double> lock_wait = std::chrono::steady_clock::now() - lock_wait_start;
+    metrics_.hot_write_lock_wait.Observe(lock_wait.count());
     auto batch_length = record_or_row_batch.Length();
     batch_size_accountant_->NewHotBatch(std::move(batch_stats));
     hot_store_->EmplaceBack(next_row_id_, std::move(record_or_row_batch));
@@ -283,6 +366,12 @@ Status Table::WriteHot(internal::RecordOrRowBatch&& record_or_row_batch) {
   return Status::OK();
 }
 
+std::vector<std::pair<Table::RowID, internal::ColdBatch>> Table::GetColdBatchesAfter(
+    RowID row_id) const {
+  absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+  return cold_store_->GetBatchesAfter(row_id);
+}
+
 Table::RowID Table::FirstRowID() const {
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
   if (cold_store_->Size() > 0) {
@@ -407,6 +496,7 @@ Status Table::CompactSingleBatchUnlocked(arrow::MemoryPool*) {
 }
 
 Status Table::CompactHotToCold(arrow::MemoryPool* mem_pool) {
+  px::metrics::ScopedHistogramTimer timer(&metrics_.compaction_latency);
   bool next_ready = false;
   {
     absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
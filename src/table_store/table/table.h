@@ -178,7 +178,32 @@ class Table : public NotCopyable {
     // Change the StopSpec of the cursor.
     void UpdateStopSpec(StopSpec stop);
 
+    /**
+     * A row batch along with the offset of its first row, relative to the first row of the batch
+     * that was last returned by GetNextRowBatch.
+     */
+    struct RowBatchWithOffset {
+      int64_t offset;
+      std::unique_ptr<schema::RowBatch> row_batch;
+    };
+
+    /**
+     * Reads the given columns for the rows in [start, stop) of the batch that was last returned by
+     * GetNextRowBatch, where start and stop are relative to the first row of that batch. This
+     * allows some columns to be read lazily, for instance only for the rows that pass a predicate
+     * evaluated on other columns. It does not advance the cursor.
+     *
+     * The rows can come back as several row batches, if the underlying batches were compacted
+     * since they were last read. Rows that were expired in the meantime are skipped, which is why
+     * each row batch is returned along with its offset.
+     */
+    StatusOr<std::vector<RowBatchWithOffset>> ReadLastBatchRows(int64_t start, int64_t stop,
+                                                                 const std::vector<int64_t>& cols);
+
    private:
+    // Creates a cursor over the rows in (last_read_row_id, stop_row_id).
+    Cursor(const Table* table, RowID last_read_row_id, RowID stop_row_id);
+
     void AdvanceToStart(const StartSpec& start);
     void StopStateFromSpec(StopSpec&& stop);
 
@@ -194,6 +219,8 @@ class Table : public NotCopyable {
     const Table* table_;
     internal::BatchHints hints_;
     RowID last_read_row_id_;
+    // The RowID of the first row in the batch last returned by GetNextRowBatch.
+    RowID last_batch_first_row_id_ = -1;
     StopState stop_;
 
     friend class Table;
@@ -267,6 +294,24 @@ class Table : public NotCopyable {
    */
   Status TransferRecordBatch(std::unique_ptr<px::types::ColumnWrapperRecordBatch> record_batch);
 
+  /**
+   * Writes a row batch straight into the cold store, skipping the hot store and compaction. This is
+   * meant for bulk loading already-columnar data (e.g. from an Arrow file), where the arrays can be
+   * kept as is. It fails if the hot store is not empty, since rows must stay in RowID order.
+   *
+   * @param rb Rowbatch to write to the table. Its arrays are shared, not copied.
+   * @return status
+   */
+  Status WriteColdBatch(const schema::RowBatch& rb);
+
+  /**
+   * Gets the batches of the cold store that only contain rows after the given RowID, along with
+   * the RowID of their first row. The arrays are shared with the table, not copied.
+   * @param row_id the RowID after which batches should be returned.
+   * @return vector of pairs of first RowID and cold batch, in RowID order.
+   */
+  std::vector<std::pair<RowID, internal::ColdBatch>> GetColdBatchesAfter(RowID row_id) const;
+
   schema::Relation GetRelation() const;
   StatusOr<std::vector<RecordBatchSPtr>> GetTableAsRecordBatches() const;
 
@@ -279,6 +324,11 @@ class Table : public NotCopyable {
 
   TableStats GetTableStats() const;
 
+  /**
+   * The histogram of TableStore::AppendData latencies for this table.
+   */
+  px::metrics::ShardedHistogram* append_data_latency() { return &metrics_.append_data_latency; }
+
   /**
    * Compacts hot batches into compacted_batch_size_ sized cold batches. Each call to
    * CompactHotToCold will create a maximum of kMaxBatchesPerCompactionCall cold batches.
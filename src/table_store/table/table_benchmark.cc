@@ -191,6 +191,37 @@ static void BM_TableReadLastBatchAllCold(benchmark::State& state) {
   state.SetBytesProcessed(state.iterations() * batch_size);
 }
 
+// Measures cursor seeks to random times, i.e. the batch lookup in the store's time index followed
+// by the row lookup in the time column of that batch. The argument selects the hot (0) or cold (1)
+// store.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_TableCursorSeekTime(benchmark::State& state) {
+  int64_t table_size = 16 * 1024 * 1024;
+  int64_t compaction_size = 64 * 1024;
+  int64_t batch_length = 256;
+  bool cold = state.range(0) == 1;
+  auto table = MakeTable(table_size, compaction_size);
+  auto last_time = cold ? FillTableCold(table.get(), table_size, batch_length)
+                        : FillTableHot(table.get(), table_size, batch_length);
+
+  std::default_random_engine rng(42);
+  std::uniform_int_distribution<int64_t> time_dist(0, last_time - 1);
+  std::vector<int64_t> seek_times(4096);
+  for (auto& t : seek_times) {
+    t = time_dist(rng);
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    Table::Cursor cursor(
+        table.get(),
+        Table::Cursor::StartSpec{Table::Cursor::StartSpec::StartType::StartAtTime,
+                                 seek_times[i++ % seek_times.size()]},
+        Table::Cursor::StopSpec{});
+    benchmark::DoNotOptimize(cursor);
+  }
+}
+
 // NOLINTNEXTLINE : runtime/references.
 static void BM_TableWriteEmpty(benchmark::State& state) {
   int64_t table_size = 4 * 1024 * 1024;
@@ -242,8 +273,7 @@ static void BM_TableCompaction(benchmark::State& state) {
   int64_t batch_length = 256;
   auto table = MakeTable(table_size, compaction_size);
   // Fill table first to make sure each compaction hits kMaxBatchesPerCompaction.
-  // This should be the slowest possible compaction. Since none of the batches will have an
-  // arrow_cache.
+  // This should be the slowest possible compaction.
   FillTableHot(table.get(), table_size, batch_length);
 
   for (auto _ : state) {
@@ -360,13 +390,56 @@ static void BM_TableThreaded(benchmark::State& state) {
   state.counters["Write"] = benchmark::Counter(write_average_time);
 }
 
+// Measures the latency of writing hot batches while readers repeatedly scan the hot store, i.e.
+// how long Stirling's writers stall behind queries that touch fresh data.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_TableWriteWithHotReaders(benchmark::State& state) {
+  int64_t table_size = 16 * 1024 * 1024;
+  // Keep all of the data hot for the duration of the benchmark.
+  int64_t compaction_size = table_size;
+  int64_t batch_length = 256;
+  int num_read_threads = state.range(0);
+  std::unique_ptr<Table> table = MakeTable(table_size, compaction_size);
+  int64_t time_counter = 0;
+  for (int i = 0; i < 64; ++i) {
+    PL_CHECK_OK(table->TransferRecordBatch(MakeHotBatch(batch_length, &time_counter)));
+  }
+
+  absl::Notification done;
+  std::vector<std::thread> reader_threads;
+  for (int i = 0; i < num_read_threads; ++i) {
+    reader_threads.emplace_back([&table, &done]() {
+      while (!done.HasBeenNotified()) {
+        Table::Cursor cursor(table.get());
+        ReadFullTable(&cursor);
+      }
+    });
+  }
+
+  for (auto _ : state) {
+    auto batch = MakeHotBatch(batch_length, &time_counter);
+    auto start = std::chrono::high_resolution_clock::now();
+    PL_CHECK_OK(table->TransferRecordBatch(std::move(batch)));
+    auto end = std::chrono::high_resolution_clock::now();
+    state.SetIterationTime(
+        std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count());
+  }
+
+  done.Notify();
+  for (auto& thread : reader_threads) {
+    thread.join();
+  }
+}
+
 BENCHMARK(BM_TableReadAllHot);
 BENCHMARK(BM_TableReadAllCold);
 BENCHMARK(BM_TableReadLastBatchAllHot)->Iterations(1000);
 BENCHMARK(BM_TableReadLastBatchAllCold)->Iterations(1000);
+BENCHMARK(BM_TableCursorSeekTime)->Arg(0)->Arg(1);
 BENCHMARK(BM_TableWriteEmpty);
 BENCHMARK(BM_TableWriteFull);
 BENCHMARK(BM_TableCompaction);
+BENCHMARK(BM_TableWriteWithHotReaders)->Arg(0)->Arg(4)->UseManualTime();
 BENCHMARK(BM_TableThreaded)->UseManualTime()->Iterations(1);
 
 }  // namespace px::table_store
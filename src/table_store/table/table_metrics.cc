@@ -67,4 +67,16 @@ TableMetrics::TableMetrics(prometheus::Registry* registry, std::string table_nam
                              .Name("min_time")
                              .Help("The current retention window for data in this table")
                              .Register(*registry)
-                             .Add({{"name", table_name}})) {}
+                             .Add({{"name", table_name}})),
+      append_data_latency(
+          GetOrCreateHistogramFamily(registry, "table_append_data_latency_seconds",
+                                     "Latency of appending record batches to the table")
+              .Add({{"name", table_name}})),
+      compaction_latency(
+          GetOrCreateHistogramFamily(registry, "table_compaction_latency_seconds",
+                                     "Latency of compacting hot batches into cold batches")
+              .Add({{"name", table_name}})),
+      hot_write_lock_wait(
+          GetOrCreateHistogramFamily(registry, "table_hot_write_lock_wait_seconds",
+                                     "Time writers spend waiting to acquire the hot store lock")
+              .Add({{"name", table_name}})) {}
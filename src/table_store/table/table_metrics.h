@@ -34,4 +34,7 @@ struct TableMetrics {
   prometheus::Counter& compacted_batches_counter;
   prometheus::Gauge& max_table_size_gauge;
   prometheus::Gauge& retention_ns_gauge;
+  px::metrics::ShardedHistogram& append_data_latency;
+  px::metrics::ShardedHistogram& compaction_latency;
+  px::metrics::ShardedHistogram& hot_write_lock_wait;
 };
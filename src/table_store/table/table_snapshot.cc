@@ -0,0 +1,364 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/table/table_snapshot.h"
+
+#include <arrow/builder.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <absl/strings/escaping.h>
+#include <absl/strings/numbers.h>
+#include <absl/strings/str_join.h>
+#include <absl/strings/str_split.h>
+
+#include "src/common/base/file.h"
+#include "src/common/fs/fs_wrapper.h"
+#include "src/shared/types/arrow_adapter.h"
+
+DEFINE_string(table_store_snapshot_dir, gflags::StringFromEnv("PL_TABLE_STORE_SNAPSHOT_DIR", ""),
+              "The directory to snapshot the cold data of the table store to, so that it survives "
+              "restarts. Snapshots are disabled if empty.");
+
+DEFINE_int64(table_store_snapshot_max_bytes_per_pass,
+             gflags::Int64FromEnv("PL_TABLE_STORE_SNAPSHOT_MAX_BYTES_PER_PASS", 64 * 1024 * 1024),
+             "The maximum number of bytes written to disk by a single table store snapshot pass. "
+             "Batches that don't fit are written in a later pass.");
+
+namespace px {
+namespace table_store {
+
+namespace {
+
+constexpr char kRelationFile[] = "relation.pb";
+constexpr char kManifestFile[] = "MANIFEST";
+constexpr char kBatchFilePrefix[] = "batch_";
+constexpr char kBatchFileSuffix[] = ".arrow";
+constexpr char kTmpSuffix[] = ".tmp";
+
+// UINT128 columns are stored as fixed_size_binary(16), which every Arrow reader understands.
+StatusOr<std::shared_ptr<arrow::Array>> ToFileArray(types::DataType type,
+                                                    const std::shared_ptr<arrow::Array>& arr) {
+  if (type != types::DataType::UINT128) {
+    return arr;
+  }
+  arrow::FixedSizeBinaryBuilder builder(arrow::fixed_size_binary(sizeof(absl::uint128)));
+  PL_RETURN_IF_ERROR(builder.Reserve(arr->length()));
+  for (int64_t i = 0; i < arr->length(); ++i) {
+    absl::uint128 val = types::GetValue(static_cast<arrow::UInt128Array*>(arr.get()), i);
+    uint64_t words[2] = {absl::Uint128Low64(val), absl::Uint128High64(val)};
+    PL_RETURN_IF_ERROR(builder.Append(reinterpret_cast<const uint8_t*>(words)));
+  }
+  std::shared_ptr<arrow::Array> out;
+  PL_RETURN_IF_ERROR(builder.Finish(&out));
+  return out;
+}
+
+StatusOr<std::shared_ptr<arrow::Array>> FromFileArray(types::DataType type,
+                                                      const std::shared_ptr<arrow::Array>& arr) {
+  if (type != types::DataType::UINT128) {
+    if (arr->type_id() != types::ToArrowType(type)) {
+      return error::Internal("Unexpected arrow type $0 for column of type $1.",
+                             arr->type()->ToString(), types::ToString(type));
+    }
+    return arr;
+  }
+  if (arr->type_id() != arrow::Type::FIXED_SIZE_BINARY) {
+    return error::Internal("Unexpected arrow type $0 for UINT128 column.", arr->type()->ToString());
+  }
+  const auto* fsb = static_cast<const arrow::FixedSizeBinaryArray*>(arr.get());
+  std::vector<types::UInt128Value> vals;
+  vals.reserve(arr->length());
+  for (int64_t i = 0; i < arr->length(); ++i) {
+    uint64_t words[2];
+    std::memcpy(words, fsb->GetValue(i), sizeof(words));
+    vals.emplace_back(words[1], words[0]);
+  }
+  return types::ToArrow(vals, arrow::default_memory_pool());
+}
+
+std::string BatchFileName(int64_t seq) {
+  return absl::StrCat(kBatchFilePrefix, seq, kBatchFileSuffix);
+}
+
+int64_t BatchFileSeq(std::string_view name) {
+  int64_t seq = -1;
+  if (absl::ConsumePrefix(&name, kBatchFilePrefix) &&
+      absl::ConsumeSuffix(&name, kBatchFileSuffix)) {
+    absl::SimpleAtoi(name, &seq);
+  }
+  return seq;
+}
+
+}  // namespace
+
+TableStoreSnapshotter::TableStoreSnapshotter(std::filesystem::path dir, TableStore* table_store,
+                                             int64_t max_bytes_per_pass)
+    : dir_(std::move(dir)),
+      table_store_(table_store),
+      max_bytes_per_pass_(max_bytes_per_pass),
+      bytes_written_counter_(
+          BuildCounter("table_store_snapshot_bytes_written",
+                       "Total bytes of cold batches written to table store snapshots")),
+      batches_written_counter_(
+          BuildCounter("table_store_snapshot_batches_written",
+                       "Total number of cold batches written to table store snapshots")),
+      restore_seconds_gauge_(prometheus::BuildGauge()
+                                 .Name("table_store_snapshot_restore_seconds")
+                                 .Help("Time it took to reattach the table store snapshots on "
+                                       "startup, until the tables were queryable")
+                                 .Register(GetMetricsRegistry())
+                                 .Add({})),
+      snapshot_latency_(GetOrCreateHistogramFamily("table_store_snapshot_latency_seconds",
+                                                   "Latency of a table store snapshot pass")
+                            .Add({})) {}
+
+std::filesystem::path TableStoreSnapshotter::TabletDir(const NameTablet& key) const {
+  // Tablet IDs are arbitrary strings, so hex encode them to get a valid file name.
+  return dir_ / absl::StrCat(key.name_, "@", absl::BytesToHexString(key.tablet_id_));
+}
+
+StatusOr<TableStoreSnapshotter::TabletState*> TableStoreSnapshotter::GetOrCreateTabletState(
+    const NameTablet& key, const Table& table) {
+  auto it = tablets_.find(key);
+  if (it != tablets_.end()) {
+    return &it->second;
+  }
+
+  // Anything left in the directory wasn't restored, so it is stale.
+  TabletState state;
+  state.dir = TabletDir(key);
+  if (fs::Exists(state.dir)) {
+    PL_RETURN_IF_ERROR(fs::RemoveAll(state.dir));
+  }
+  PL_RETURN_IF_ERROR(fs::CreateDirectories(state.dir));
+
+  schemapb::Relation relation_pb;
+  PL_RETURN_IF_ERROR(table.GetRelation().ToProto(&relation_pb));
+  PL_RETURN_IF_ERROR(
+      WriteFileFromString(state.dir / kRelationFile, relation_pb.SerializeAsString()));
+  PL_RETURN_IF_ERROR(WriteManifest(state));
+
+  return &tablets_.emplace(key, std::move(state)).first->second;
+}
+
+Status TableStoreSnapshotter::WriteBatchFile(const schema::Relation& relation,
+                                             const internal::ColdBatch& batch,
+                                             const std::filesystem::path& path) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> arrays;
+  for (size_t i = 0; i < batch.size(); ++i) {
+    PL_ASSIGN_OR_RETURN(auto arr, ToFileArray(relation.GetColumnType(i), batch[i]));
+    fields.push_back(arrow::field(relation.GetColumnName(i), arr->type()));
+    arrays.push_back(std::move(arr));
+  }
+  auto schema = arrow::schema(fields);
+
+  std::filesystem::path tmp_path = path;
+  tmp_path += kTmpSuffix;
+  std::shared_ptr<arrow::io::FileOutputStream> out;
+  PL_RETURN_IF_ERROR(arrow::io::FileOutputStream::Open(tmp_path.string(), &out));
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
+  PL_RETURN_IF_ERROR(arrow::ipc::RecordBatchFileWriter::Open(out.get(), schema, &writer));
+  PL_RETURN_IF_ERROR(
+      writer->WriteRecordBatch(*arrow::RecordBatch::Make(schema, batch[0]->length(), arrays)));
+  PL_RETURN_IF_ERROR(writer->Close());
+  PL_RETURN_IF_ERROR(out->Close());
+  return fs::Rename(tmp_path, path);
+}
+
+Status TableStoreSnapshotter::WriteManifest(const TabletState& state) {
+  std::vector<std::string_view> names;
+  for (const auto& file : state.files) {
+    names.push_back(file.name);
+  }
+  std::filesystem::path path = state.dir / kManifestFile;
+  std::filesystem::path tmp_path = path;
+  tmp_path += kTmpSuffix;
+  PL_RETURN_IF_ERROR(WriteFileFromString(tmp_path, absl::StrJoin(names, "\n")));
+  return fs::Rename(tmp_path, path);
+}
+
+Status TableStoreSnapshotter::SnapshotTablet(const Table& table, TabletState* state,
+                                             SnapshotStats* stats) {
+  bool manifest_changed = false;
+
+  // Drop the files of batches that were expired from the table.
+  internal::RowID first_row_id = table.FirstRowID();
+  while (!state->files.empty() &&
+         (first_row_id == -1 || state->files.front().last_row_id < first_row_id)) {
+    PL_RETURN_IF_ERROR(fs::Remove(state->dir / state->files.front().name));
+    state->files.pop_front();
+    ++stats->batches_removed;
+    manifest_changed = true;
+  }
+
+  for (const auto& [batch_first_row_id, batch] : table.GetColdBatchesAfter(state->last_row_id)) {
+    if (stats->bytes_written >= max_bytes_per_pass_) {
+      break;
+    }
+    BatchFile file{BatchFileName(state->next_file_seq++), batch_first_row_id,
+                   batch_first_row_id + batch[0]->length() - 1};
+    std::filesystem::path path = state->dir / file.name;
+    PL_RETURN_IF_ERROR(WriteBatchFile(table.GetRelation(), batch, path));
+
+    std::error_code ec;
+    int64_t file_bytes = std::filesystem::file_size(path, ec);
+    if (ec) {
+      return error::System("Could not get size of $0. Message: $1", path.string(), ec.message());
+    }
+    stats->bytes_written += file_bytes;
+    ++stats->batches_written;
+    bytes_written_counter_.Increment(file_bytes);
+    batches_written_counter_.Increment();
+
+    state->last_row_id = file.last_row_id;
+    state->files.push_back(std::move(file));
+    manifest_changed = true;
+  }
+
+  if (manifest_changed) {
+    PL_RETURN_IF_ERROR(WriteManifest(*state));
+  }
+  return Status::OK();
+}
+
+StatusOr<TableStoreSnapshotter::SnapshotStats> TableStoreSnapshotter::Snapshot() {
+  px::metrics::ScopedHistogramTimer timer(&snapshot_latency_);
+  SnapshotStats stats;
+  for (const auto& [key, table] : table_store_->GetTablets()) {
+    PL_ASSIGN_OR_RETURN(TabletState * state, GetOrCreateTabletState(key, *table));
+    PL_RETURN_IF_ERROR(SnapshotTablet(*table, state, &stats));
+  }
+  return stats;
+}
+
+Status TableStoreSnapshotter::RestoreTablet(const std::filesystem::path& dir, Table* table,
+                                            TabletState* state, RestoreStats* stats) {
+  const schema::Relation& relation = table->GetRelation();
+  PL_ASSIGN_OR_RETURN(std::string relation_str, ReadFileToString(dir / kRelationFile));
+  schemapb::Relation relation_pb;
+  if (!relation_pb.ParseFromString(relation_str)) {
+    return error::Internal("Could not parse relation of snapshot $0.", dir.string());
+  }
+  schema::Relation snapshot_relation;
+  PL_RETURN_IF_ERROR(snapshot_relation.FromProto(&relation_pb));
+  if (snapshot_relation != relation) {
+    return error::FailedPrecondition("Relation of snapshot $0 does not match the table.",
+                                     dir.string());
+  }
+
+  PL_ASSIGN_OR_RETURN(std::string manifest, ReadFileToString(dir / kManifestFile));
+  std::vector<std::string> names = absl::StrSplit(manifest, '\n', absl::SkipEmpty());
+
+  state->dir = dir;
+  for (const auto& name : names) {
+    state->next_file_seq = std::max(state->next_file_seq, BatchFileSeq(name) + 1);
+  }
+
+  schema::RowDescriptor desc(relation.col_types());
+  for (const auto& name : names) {
+    std::filesystem::path path = dir / name;
+    std::shared_ptr<arrow::io::MemoryMappedFile> file;
+    PL_RETURN_IF_ERROR(
+        arrow::io::MemoryMappedFile::Open(path.string(), arrow::io::FileMode::READ, &file));
+    std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader;
+    PL_RETURN_IF_ERROR(arrow::ipc::RecordBatchFileReader::Open(file.get(), &reader));
+    if (reader->num_record_batches() != 1) {
+      return error::Internal("Snapshot batch file $0 has $1 record batches, expected 1.",
+                             path.string(), reader->num_record_batches());
+    }
+    std::shared_ptr<arrow::RecordBatch> record_batch;
+    PL_RETURN_IF_ERROR(reader->ReadRecordBatch(0, &record_batch));
+    if (record_batch->num_columns() != static_cast<int>(relation.NumColumns())) {
+      return error::Internal("Snapshot batch file $0 has $1 columns, expected $2.", path.string(),
+                             record_batch->num_columns(), relation.NumColumns());
+    }
+
+    schema::RowBatch rb(desc, record_batch->num_rows());
+    for (int i = 0; i < record_batch->num_columns(); ++i) {
+      PL_ASSIGN_OR_RETURN(auto arr, FromFileArray(desc.type(i), record_batch->column(i)));
+      PL_RETURN_IF_ERROR(rb.AddColumn(arr));
+    }
+    PL_RETURN_IF_ERROR(table->WriteColdBatch(rb));
+
+    // Row IDs are assigned anew on restore.
+    internal::RowID last_row_id = table->LastRowID();
+    state->files.push_back({name, last_row_id - rb.num_rows() + 1, last_row_id});
+    state->last_row_id = last_row_id;
+    ++stats->batches_restored;
+    int64_t file_size = 0;
+    PL_RETURN_IF_ERROR(file->GetSize(&file_size));
+    stats->bytes_restored += file_size;
+  }
+  ++stats->tablets_restored;
+  return Status::OK();
+}
+
+StatusOr<TableStoreSnapshotter::RestoreStats> TableStoreSnapshotter::Restore() {
+  auto start = std::chrono::steady_clock::now();
+  RestoreStats stats;
+  if (!fs::Exists(dir_)) {
+    return stats;
+  }
+
+  for (const auto& [key, table] : table_store_->GetTablets()) {
+    std::filesystem::path dir = TabletDir(key);
+    if (!fs::Exists(dir)) {
+      continue;
+    }
+    TabletState state;
+    auto s = RestoreTablet(dir, table.get(), &state, &stats);
+    if (!s.ok()) {
+      // Keep whatever was restored before the failure, and drop the rest of the snapshot.
+      LOG(WARNING) << absl::Substitute("Could not fully restore snapshot $0: $1", dir.string(),
+                                       s.msg());
+      if (state.files.empty()) {
+        continue;
+      }
+      for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        const auto& name = entry.path().filename().string();
+        bool restored = std::any_of(state.files.begin(), state.files.end(),
+                                    [&name](const BatchFile& f) { return f.name == name; });
+        if (!restored && BatchFileSeq(name) != -1) {
+          PL_RETURN_IF_ERROR(fs::Remove(entry.path()));
+        }
+      }
+      PL_RETURN_IF_ERROR(WriteManifest(state));
+    }
+    tablets_.emplace(key, std::move(state));
+  }
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  restore_seconds_gauge_.Set(elapsed.count());
+  LOG(INFO) << absl::Substitute(
+      "Restored $0 batches ($1 bytes) of $2 tablets from table store snapshots in $3 s.",
+      stats.batches_restored, stats.bytes_restored, stats.tablets_restored, elapsed.count());
+  return stats;
+}
+
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <prometheus/counter.h>
+#include <prometheus/gauge.h>
+
+#include <deque>
+#include <filesystem>
+#include <string>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "src/common/base/base.h"
+#include "src/common/metrics/metrics.h"
+#include "src/table_store/table/table.h"
+#include "src/table_store/table/table_store.h"
+
+DECLARE_string(table_store_snapshot_dir);
+DECLARE_int64(table_store_snapshot_max_bytes_per_pass);
+
+namespace px {
+namespace table_store {
+
+/**
+ * TableStoreSnapshotter persists the cold batches of a TableStore to local disk, so that the
+ * history of each table survives an agent restart.
+ *
+ * Every tablet gets its own directory, named after the table and the tablet ID. It holds the
+ * relation of the table, one Arrow IPC file per cold batch, and a MANIFEST listing the batch files
+ * in row order. Files are written to a temporary name and renamed into place, so a crash never
+ * leaves a partial file in the MANIFEST.
+ *
+ * Snapshot() is incremental: it only writes the cold batches that were added since the last call,
+ * and removes the files of batches that were expired from the table. The bytes written per call are
+ * capped, and whatever is left over is picked up by the next call.
+ *
+ * Restore() reattaches the snapshot of every tablet that exists in the TableStore and has a
+ * matching relation. The batch files are memory mapped and their arrays are handed to the table's
+ * cold store without a copy, so pages are only read from disk once a query touches them.
+ */
+class TableStoreSnapshotter : public NotCopyable {
+ public:
+  struct SnapshotStats {
+    int64_t batches_written = 0;
+    int64_t bytes_written = 0;
+    int64_t batches_removed = 0;
+  };
+
+  struct RestoreStats {
+    int64_t tablets_restored = 0;
+    int64_t batches_restored = 0;
+    int64_t bytes_restored = 0;
+  };
+
+  TableStoreSnapshotter(std::filesystem::path dir, TableStore* table_store,
+                        int64_t max_bytes_per_pass);
+
+  /**
+   * Writes the cold batches that were added since the last call to disk, and removes the files of
+   * batches that have since been expired.
+   */
+  StatusOr<SnapshotStats> Snapshot();
+
+  /**
+   * Reattaches the snapshots on disk to the corresponding tablets of the TableStore. This should be
+   * called once, after the tables are created and before any data is written to them. Snapshots of
+   * tablets that don't exist, or whose relation changed, are deleted.
+   */
+  StatusOr<RestoreStats> Restore();
+
+ private:
+  struct BatchFile {
+    std::string name;
+    internal::RowID first_row_id;
+    internal::RowID last_row_id;
+  };
+
+  struct TabletState {
+    std::filesystem::path dir;
+    std::deque<BatchFile> files;
+    // The last RowID that was written to disk.
+    internal::RowID last_row_id = -1;
+    int64_t next_file_seq = 0;
+  };
+
+  std::filesystem::path TabletDir(const NameTablet& key) const;
+  StatusOr<TabletState*> GetOrCreateTabletState(const NameTablet& key, const Table& table);
+  Status SnapshotTablet(const Table& table, TabletState* state, SnapshotStats* stats);
+  Status RestoreTablet(const std::filesystem::path& dir, Table* table, TabletState* state,
+                       RestoreStats* stats);
+  Status WriteBatchFile(const schema::Relation& relation, const internal::ColdBatch& batch,
+                        const std::filesystem::path& path);
+  Status WriteManifest(const TabletState& state);
+
+  const std::filesystem::path dir_;
+  TableStore* table_store_;
+  const int64_t max_bytes_per_pass_;
+
+  absl::flat_hash_map<NameTablet, TabletState> tablets_;
+
+  prometheus::Counter& bytes_written_counter_;
+  prometheus::Counter& batches_written_counter_;
+  prometheus::Gauge& restore_seconds_gauge_;
+  px::metrics::ShardedHistogram& snapshot_latency_;
+};
+
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <memory>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/schema/row_descriptor.h"
+#include "src/table_store/table/table_snapshot.h"
+#include "src/table_store/table/table_store.h"
+
+namespace px {
+namespace table_store {
+
+using ::px::testing::TempDir;
+
+class TableStoreSnapshotterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rel_ = schema::Relation({types::DataType::TIME64NS, types::DataType::UINT128,
+                             types::DataType::STRING, types::DataType::INT64},
+                            {"time_", "upid", "service", "latency"});
+  }
+
+  // Creates a table store with a single table, that compacts every hot batch into its own cold
+  // batch.
+  std::unique_ptr<TableStore> MakeTableStore(const schema::Relation& rel) {
+    auto table_store = std::make_unique<TableStore>();
+    table_store->AddTable(std::make_shared<Table>("http_events", rel, 1024 * 1024, 1),
+                          "http_events");
+    return table_store;
+  }
+
+  std::unique_ptr<schema::RowBatch> MakeRowBatch(int64_t start_time) {
+    std::vector<types::Time64NSValue> times = {start_time, start_time + 1, start_time + 2};
+    std::vector<types::UInt128Value> upids = {types::UInt128Value(1, start_time),
+                                              types::UInt128Value(2, start_time),
+                                              types::UInt128Value(3, start_time)};
+    std::vector<types::StringValue> services = {"a", "bb", "ccc"};
+    std::vector<types::Int64Value> latencies = {start_time * 10, 20, 30};
+
+    auto rb = std::make_unique<schema::RowBatch>(schema::RowDescriptor(rel_.col_types()), 3);
+    EXPECT_OK(rb->AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+    EXPECT_OK(rb->AddColumn(types::ToArrow(upids, arrow::default_memory_pool())));
+    EXPECT_OK(rb->AddColumn(types::ToArrow(services, arrow::default_memory_pool())));
+    EXPECT_OK(rb->AddColumn(types::ToArrow(latencies, arrow::default_memory_pool())));
+    return rb;
+  }
+
+  void WriteBatches(TableStore* table_store, int64_t num_batches) {
+    Table* table = table_store->GetTable("http_events");
+    for (int64_t i = 0; i < num_batches; ++i) {
+      ASSERT_OK(table->WriteRowBatch(*MakeRowBatch(3 * i)));
+    }
+    ASSERT_OK(table->CompactHotToCold(arrow::default_memory_pool()));
+  }
+
+  schema::Relation rel_;
+  TempDir tmp_dir_;
+};
+
+TEST_F(TableStoreSnapshotterTest, snapshot_and_restore) {
+  auto table_store = MakeTableStore(rel_);
+  WriteBatches(table_store.get(), 3);
+
+  TableStoreSnapshotter snapshotter(tmp_dir_.path(), table_store.get(), 1024 * 1024);
+  ASSERT_OK_AND_ASSIGN(auto stats, snapshotter.Snapshot());
+  EXPECT_EQ(stats.batches_written, 3);
+  EXPECT_GT(stats.bytes_written, 0);
+
+  // Batches that are already on disk are not written again.
+  ASSERT_OK_AND_ASSIGN(stats, snapshotter.Snapshot());
+  EXPECT_EQ(stats.batches_written, 0);
+
+  auto restored_store = MakeTableStore(rel_);
+  TableStoreSnapshotter restored_snapshotter(tmp_dir_.path(), restored_store.get(), 1024 * 1024);
+  ASSERT_OK_AND_ASSIGN(auto restore_stats, restored_snapshotter.Restore());
+  EXPECT_EQ(restore_stats.tablets_restored, 1);
+  EXPECT_EQ(restore_stats.batches_restored, 3);
+
+  Table* restored_table = restored_store->GetTable("http_events");
+  EXPECT_EQ(restored_table->GetTableStats().hot_bytes, 0);
+  Table::Cursor cursor(restored_table);
+  for (int64_t i = 0; i < 3; ++i) {
+    ASSERT_FALSE(cursor.Done());
+    ASSERT_OK_AND_ASSIGN(auto rb, cursor.GetNextRowBatch({0, 1, 2, 3}));
+    auto expected = MakeRowBatch(3 * i);
+    for (int64_t col = 0; col < 4; ++col) {
+      EXPECT_TRUE(rb->ColumnAt(col)->Equals(expected->ColumnAt(col)));
+    }
+  }
+  EXPECT_TRUE(cursor.Done());
+
+  // The restored batches are already on disk, so only new ones are written.
+  WriteBatches(restored_store.get(), 1);
+  ASSERT_OK_AND_ASSIGN(stats, restored_snapshotter.Snapshot());
+  EXPECT_EQ(stats.batches_written, 1);
+}
+
+TEST_F(TableStoreSnapshotterTest, bytes_per_pass_are_bounded) {
+  auto table_store = MakeTableStore(rel_);
+  WriteBatches(table_store.get(), 3);
+
+  TableStoreSnapshotter snapshotter(tmp_dir_.path(), table_store.get(), 1);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK_AND_ASSIGN(auto stats, snapshotter.Snapshot());
+    EXPECT_EQ(stats.batches_written, 1);
+  }
+  ASSERT_OK_AND_ASSIGN(auto stats, snapshotter.Snapshot());
+  EXPECT_EQ(stats.batches_written, 0);
+}
+
+TEST_F(TableStoreSnapshotterTest, relation_mismatch_is_not_restored) {
+  auto table_store = MakeTableStore(rel_);
+  WriteBatches(table_store.get(), 2);
+  TableStoreSnapshotter snapshotter(tmp_dir_.path(), table_store.get(), 1024 * 1024);
+  ASSERT_OK(snapshotter.Snapshot());
+
+  schema::Relation other_rel({types::DataType::TIME64NS, types::DataType::INT64},
+                             {"time_", "latency"});
+  auto restored_store = MakeTableStore(other_rel);
+  TableStoreSnapshotter restored_snapshotter(tmp_dir_.path(), restored_store.get(), 1024 * 1024);
+  ASSERT_OK_AND_ASSIGN(auto restore_stats, restored_snapshotter.Restore());
+  EXPECT_EQ(restore_stats.batches_restored, 0);
+  EXPECT_EQ(restored_store->GetTable("http_events")->GetTableStats().bytes, 0);
+
+  // The stale snapshot is replaced on the next pass.
+  ASSERT_OK_AND_ASSIGN(auto stats, restored_snapshotter.Snapshot());
+  EXPECT_EQ(stats.batches_written, 0);
+}
+
+}  // namespace table_store
+}  // namespace px
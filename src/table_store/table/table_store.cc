@@ -27,6 +27,7 @@ namespace table_store {
 
 std::unique_ptr<std::unordered_map<std::string, schema::Relation>> TableStore::GetRelationMap() {
   auto map = std::make_unique<RelationMap>();
+  absl::ReaderMutexLock lock(&tables_lock_);
   map->reserve(name_to_relation_map_.size());
   for (auto& [table_name, relation] : name_to_relation_map_) {
     map->emplace(table_name, relation);
@@ -35,6 +36,14 @@ std::unique_ptr<std::unordered_map<std::string, schema::Relation>> TableStore::G
 }
 
 StatusOr<Table*> TableStore::CreateNewTablet(uint64_t table_id, const types::TabletID& tablet_id) {
+  absl::MutexLock lock(&tables_lock_);
+  TableIDTablet id_key = {table_id, tablet_id};
+  // Another writer may have created the tablet since the caller looked it up.
+  auto id_to_table_iter = id_to_table_map_.find(id_key);
+  if (id_to_table_iter != id_to_table_map_.end()) {
+    return id_to_table_iter->second.get();
+  }
+
   auto id_to_table_info_map_iter = id_to_table_info_map_.find(table_id);
   if (id_to_table_info_map_iter == id_to_table_info_map_.end()) {
     return error::InvalidArgument("Table_id $0 doesn't exist.", table_id);
@@ -45,7 +54,6 @@ StatusOr<Table*> TableStore::CreateNewTablet(uint64_t table_id, const types::Tab
 
   std::shared_ptr<Table> new_tablet = Table::Create(table_info.table_name, relation);
 
-  TableIDTablet id_key = {table_id, tablet_id};
   id_to_table_map_[id_key] = new_tablet;
 
   const std::string& table_name = table_info.table_name;
@@ -62,11 +70,13 @@ Status TableStore::AppendData(uint64_t table_id, types::TabletID tablet_id,
   if (table == nullptr) {
     PL_ASSIGN_OR_RETURN(table, CreateNewTablet(table_id, tablet_id));
   }
+  px::metrics::ScopedHistogramTimer timer(table->append_data_latency());
   return table->TransferRecordBatch(std::move(record_batch));
 }
 
 table_store::Table* TableStore::GetTable(const std::string& table_name,
                                          const types::TabletID& tablet_id) const {
+  absl::ReaderMutexLock lock(&tables_lock_);
   auto name_to_table_iter = name_to_table_map_.find(NameTablet{table_name, tablet_id});
   if (name_to_table_iter == name_to_table_map_.end()) {
     return nullptr;
@@ -76,6 +86,7 @@ table_store::Table* TableStore::GetTable(const std::string& table_name,
 
 table_store::Table* TableStore::GetTable(uint64_t table_id,
                                          const types::TabletID& tablet_id) const {
+  absl::ReaderMutexLock lock(&tables_lock_);
   auto id_to_table_iter = id_to_table_map_.find(TableIDTablet{table_id, tablet_id});
   if (id_to_table_iter == id_to_table_map_.end()) {
     return nullptr;
@@ -115,6 +126,7 @@ void TableStore::RegisterTableID(uint64_t table_id, TableInfo table_info,
 void TableStore::AddTable(std::shared_ptr<table_store::Table> table, const std::string& table_name,
                           std::optional<uint64_t> table_id, const types::TabletID& tablet_id) {
   const auto& table_relation = table->GetRelation();
+  absl::MutexLock lock(&tables_lock_);
 
   // Register the table by name.
   RegisterTableName(table_name, tablet_id, table_relation, table);
@@ -126,6 +138,7 @@ void TableStore::AddTable(std::shared_ptr<table_store::Table> table, const std::
 }
 
 Status TableStore::AddTableAlias(uint64_t table_id, const std::string& table_name) {
+  absl::MutexLock lock(&tables_lock_);
   auto table_iter = name_to_table_map_.find({table_name, ""});
   if (table_iter == name_to_table_map_.end()) {
     return error::Internal(
@@ -147,11 +160,13 @@ Status TableStore::AddTableAlias(uint64_t table_id, const std::string& table_nam
 }
 
 Status TableStore::SchemaAsProto(schemapb::Schema* schema) const {
+  absl::ReaderMutexLock lock(&tables_lock_);
   return schema::Schema::ToProto(schema, name_to_relation_map_);
 }
 
 std::vector<uint64_t> TableStore::GetTableIDs() const {
   std::vector<uint64_t> ids;
+  absl::ReaderMutexLock lock(&tables_lock_);
   for (const auto& it : id_to_table_map_) {
     ids.emplace_back(it.first.table_id_);
   }
@@ -159,11 +174,17 @@ std::vector<uint64_t> TableStore::GetTableIDs() const {
 }
 
 Status TableStore::RunCompaction(arrow::MemoryPool* mem_pool) {
-  for (const auto& it : name_to_table_map_) {
-    PL_RETURN_IF_ERROR(it.second->CompactHotToCold(mem_pool));
+  // Compact outside of the lock, so that lookups aren't blocked behind it.
+  for (const auto& [key, table] : GetTablets()) {
+    PL_RETURN_IF_ERROR(table->CompactHotToCold(mem_pool));
   }
   return Status::OK();
 }
 
+std::vector<std::pair<NameTablet, std::shared_ptr<Table>>> TableStore::GetTablets() const {
+  absl::ReaderMutexLock lock(&tables_lock_);
+  return {name_to_table_map_.begin(), name_to_table_map_.end()};
+}
+
 }  // namespace table_store
 }  // namespace px
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
 
 #include "src/common/base/base.h"
 #include "src/shared/types/column_wrapper.h"
@@ -74,7 +75,8 @@ struct TableInfo {
 };
 
 /**
- * TableStore keeps track of the tables in our system.
+ * TableStore keeps track of the tables in our system. Tables are added and tablets created while
+ * other threads (queries, the snapshotter) look them up, so the maps are guarded by a lock.
  */
 class TableStore {
  public:
@@ -158,6 +160,7 @@ class TableStore {
    * GetTableName returns the table name if the ID is found, else empty string.
    */
   std::string GetTableName(uint64_t id) const {
+    absl::ReaderMutexLock lock(&tables_lock_);
     const auto& it = id_to_table_info_map_.find(id);
     if (it != id_to_table_info_map_.end()) {
       return it->second.table_name;
@@ -167,13 +170,21 @@ class TableStore {
 
   Status RunCompaction(arrow::MemoryPool* mem_pool);
 
+  /**
+   * @return a copy of the tablets of all tables with their name and tablet ID. The tablets stay
+   * alive while the caller holds them, even if the table store drops them.
+   */
+  std::vector<std::pair<NameTablet, std::shared_ptr<Table>>> GetTablets() const;
+
  private:
   void RegisterTableName(const std::string& table_name, const types::TabletID& tablet_id,
                          const schema::Relation& table_relation,
-                         std::shared_ptr<table_store::Table> table);
+                         std::shared_ptr<table_store::Table> table)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(tables_lock_);
 
   void RegisterTableID(uint64_t table_id, TableInfo table_info, const types::TabletID& tablet_id,
-                       std::shared_ptr<table_store::Table> table);
+                       std::shared_ptr<table_store::Table> table)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(tables_lock_);
 
   /**
    * Create a new tablet inside of the table with table_id
@@ -186,17 +197,21 @@ class TableStore {
 
   // The default value for tablets, when tablet is not specified.
   inline static types::TabletID kDefaultTablet = "";
+  mutable absl::Mutex tables_lock_;
   // Map a name to a table.
-  absl::flat_hash_map<NameTablet, std::shared_ptr<Table>> name_to_table_map_;
+  absl::flat_hash_map<NameTablet, std::shared_ptr<Table>> name_to_table_map_
+      ABSL_GUARDED_BY(tables_lock_);
   // Map an id to a table.
-  absl::flat_hash_map<TableIDTablet, std::shared_ptr<Table>> id_to_table_map_;
+  absl::flat_hash_map<TableIDTablet, std::shared_ptr<Table>> id_to_table_map_
+      ABSL_GUARDED_BY(tables_lock_);
   // Mapping from name to relation for adding new tablets.
   // TODO(oazizi): value should likely be shared_ptr<schema::Relation> because the
   //               same information is in id_to_table_info_map_ TableInfo.
   //               Can avoid this copy.
-  absl::flat_hash_map<std::string, schema::Relation> name_to_relation_map_;
+  absl::flat_hash_map<std::string, schema::Relation> name_to_relation_map_
+      ABSL_GUARDED_BY(tables_lock_);
   // Mapping from id to name and relation pair for adding new tablets.
-  absl::flat_hash_map<uint64_t, TableInfo> id_to_table_info_map_;
+  absl::flat_hash_map<uint64_t, TableInfo> id_to_table_info_map_ ABSL_GUARDED_BY(tables_lock_);
 };
 
 }  // namespace table_store
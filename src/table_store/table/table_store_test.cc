@@ -20,6 +20,8 @@
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/message_differencer.h>
 #include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
 #include <vector>
 
 #include "src/common/testing/testing.h"
@@ -276,6 +278,30 @@ TEST_F(TableStoreTabletsTest, add_tablet_on_append_data) {
   EXPECT_EQ(tablet2->GetTableStats().batches_added, 0);
 }
 
+TEST_F(TableStoreTabletsTest, get_tablets_while_adding) {
+  auto table_store = TableStore();
+  uint64_t table_id = 123;
+  table_store.AddTable(tablet1_1, "a", table_id, "0");
+
+  // Listing the tablets must be safe while appends create new ones.
+  std::atomic<bool> done = false;
+  std::thread lister([&table_store, &done]() {
+    while (!done) {
+      for (const auto& [key, table] : table_store.GetTablets()) {
+        EXPECT_EQ("a", key.name_);
+        EXPECT_NE(nullptr, table);
+      }
+    }
+  });
+  for (int i = 1; i <= 100; ++i) {
+    EXPECT_OK(table_store.AppendData(table_id, std::to_string(i), MakeRel1ColumnWrapperBatch()));
+  }
+  done = true;
+  lister.join();
+
+  EXPECT_EQ(101, table_store.GetTablets().size());
+}
+
 using TableStoreTabletsDeathTest = TableStoreTabletsTest;
 TEST_F(TableStoreTabletsDeathTest, tablet_test) {
   auto table_store = TableStore();
@@ -414,6 +414,58 @@ TEST(TableTest, write_row_batch) {
   EXPECT_TRUE(actual_rb->ColumnAt(1)->Equals(col2_rb1_arrow));
 }
 
+TEST(TableTest, write_cold_batch) {
+  auto rd = schema::RowDescriptor({types::DataType::TIME64NS, types::DataType::INT64});
+  schema::Relation rel(rd.types(), {"time_", "col2"});
+
+  std::shared_ptr<Table> table_ptr = Table::Create("test_table", rel);
+  Table& table = *table_ptr;
+
+  schema::RowBatch rb1(rd, 3);
+  std::vector<types::Time64NSValue> col1_rb1 = {1, 2, 3};
+  std::vector<types::Int64Value> col2_rb1 = {4, 5, 6};
+  auto col1_rb1_arrow = types::ToArrow(col1_rb1, arrow::default_memory_pool());
+  auto col2_rb1_arrow = types::ToArrow(col2_rb1, arrow::default_memory_pool());
+  EXPECT_OK(rb1.AddColumn(col1_rb1_arrow));
+  EXPECT_OK(rb1.AddColumn(col2_rb1_arrow));
+  EXPECT_OK(table.WriteColdBatch(rb1));
+
+  schema::RowBatch rb2(rd, 2);
+  std::vector<types::Time64NSValue> col1_rb2 = {4, 5};
+  std::vector<types::Int64Value> col2_rb2 = {7, 8};
+  auto col1_rb2_arrow = types::ToArrow(col1_rb2, arrow::default_memory_pool());
+  auto col2_rb2_arrow = types::ToArrow(col2_rb2, arrow::default_memory_pool());
+  EXPECT_OK(rb2.AddColumn(col1_rb2_arrow));
+  EXPECT_OK(rb2.AddColumn(col2_rb2_arrow));
+  EXPECT_OK(table.WriteColdBatch(rb2));
+
+  auto stats = table.GetTableStats();
+  EXPECT_EQ(stats.hot_bytes, 0);
+  EXPECT_EQ(stats.cold_bytes, stats.bytes);
+  EXPECT_EQ(stats.batches_added, 2);
+  EXPECT_EQ(table.FindRowIDFromTimeFirstGreaterThanOrEqual(4), 3);
+
+  Table::Cursor cursor(table_ptr.get());
+  auto actual_rb1 = cursor.GetNextRowBatch({0, 1}).ConsumeValueOrDie();
+  EXPECT_TRUE(actual_rb1->ColumnAt(0)->Equals(col1_rb1_arrow));
+  EXPECT_TRUE(actual_rb1->ColumnAt(1)->Equals(col2_rb1_arrow));
+  auto actual_rb2 = cursor.GetNextRowBatch({0, 1}).ConsumeValueOrDie();
+  EXPECT_TRUE(actual_rb2->ColumnAt(0)->Equals(col1_rb2_arrow));
+  EXPECT_TRUE(actual_rb2->ColumnAt(1)->Equals(col2_rb2_arrow));
+  EXPECT_TRUE(cursor.Done());
+
+  // Mismatched types are rejected.
+  schema::RowBatch bad_rb(schema::RowDescriptor({types::DataType::INT64, types::DataType::INT64}),
+                          2);
+  EXPECT_OK(bad_rb.AddColumn(col2_rb2_arrow));
+  EXPECT_OK(bad_rb.AddColumn(col2_rb2_arrow));
+  EXPECT_NOT_OK(table.WriteColdBatch(bad_rb));
+
+  // Cold writes are rejected once there is hot data, since they would land before it.
+  EXPECT_OK(table.WriteRowBatch(rb1));
+  EXPECT_NOT_OK(table.WriteColdBatch(rb2));
+}
+
 TEST(TableTest, hot_batches_test) {
   schema::Relation rel({types::DataType::BOOLEAN, types::DataType::INT64}, {"col1", "col2"});
 
@@ -937,5 +989,50 @@ TEST(TableTest, GetNextRowBatch_after_expiry) {
   EXPECT_TRUE(rb1->ColumnAt(0)->Equals(types::ToArrow(col1_in2, arrow::default_memory_pool())));
   EXPECT_TRUE(rb1->ColumnAt(1)->Equals(types::ToArrow(col2_in2, arrow::default_memory_pool())));
 }
+
+TEST(TableTest, ReadLastBatchRows_w_compaction) {
+  schema::Relation rel({types::DataType::BOOLEAN, types::DataType::INT64}, {"col1", "col2"});
+
+  std::vector<types::BoolValue> col1_in1 = {true, false, true};
+  std::vector<types::BoolValue> col1_in2 = {false, false};
+  std::vector<types::Int64Value> col2_in1 = {1, 2, 3};
+  std::vector<types::Int64Value> col2_in2 = {5, 6};
+
+  auto rb_wrapper_1 = std::make_unique<types::ColumnWrapperRecordBatch>();
+  rb_wrapper_1->push_back(
+      types::ColumnWrapper::FromArrow(types::ToArrow(col1_in1, arrow::default_memory_pool())));
+  rb_wrapper_1->push_back(
+      types::ColumnWrapper::FromArrow(types::ToArrow(col2_in1, arrow::default_memory_pool())));
+  auto rb_wrapper_2 = std::make_unique<types::ColumnWrapperRecordBatch>();
+  rb_wrapper_2->push_back(
+      types::ColumnWrapper::FromArrow(types::ToArrow(col1_in2, arrow::default_memory_pool())));
+  rb_wrapper_2->push_back(
+      types::ColumnWrapper::FromArrow(types::ToArrow(col2_in2, arrow::default_memory_pool())));
+  int64_t total_size = 5 * sizeof(bool) + 5 * sizeof(int64_t);
+
+  Table table("test_table", rel, 128 * 1024, total_size);
+  EXPECT_OK(table.TransferRecordBatch(std::move(rb_wrapper_1)));
+  EXPECT_OK(table.TransferRecordBatch(std::move(rb_wrapper_2)));
+
+  Table::Cursor cursor(&table);
+  auto rb1 = cursor.GetNextRowBatch({0}).ConsumeValueOrDie();
+  EXPECT_EQ(3, rb1->num_rows());
+
+  // Compacting merges both hot batches into a single cold batch, but the rows of the first batch
+  // should still be readable.
+  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+
+  auto row_batches = cursor.ReadLastBatchRows(1, 3, {1}).ConsumeValueOrDie();
+  ASSERT_EQ(1, row_batches.size());
+  EXPECT_EQ(1, row_batches[0].offset);
+  std::vector<types::Int64Value> expected = {2, 3};
+  EXPECT_TRUE(row_batches[0].row_batch->ColumnAt(0)->Equals(
+      types::ToArrow(expected, arrow::default_memory_pool())));
+
+  // Reading the extra columns shouldn't advance the cursor.
+  auto rb2 = cursor.GetNextRowBatch({1}).ConsumeValueOrDie();
+  EXPECT_TRUE(rb2->ColumnAt(0)->Equals(types::ToArrow(col2_in2, arrow::default_memory_pool())));
+}
+
 }  // namespace table_store
 }  // namespace px
@@ -17,7 +17,9 @@
  */
 
 #pragma once
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "src/carnot/udf/registry.h"
@@ -276,44 +278,71 @@ class AgentProcSMapsUDTF final : public carnot::udf::UDTF<AgentProcSMapsUDTF> {
     return proc_parser.ParseProcPIDSMaps(ctx->metadata_state()->pid(), &stats_);
   }
 
-  bool NextRecord(FunctionContext* ctx, RecordWriter* rw) {
-    if (static_cast<size_t>(current_idx_) >= stats_.size()) {
-      return false;
-    }
-    auto smap = stats_[current_idx_];
+  // A process may have thousands of mappings, so they are written a column at a time.
+  bool NextBatch(FunctionContext* ctx, int max_records, ColumnWriter* cw) {
+    size_t end = std::min(current_idx_ + max_records, stats_.size());
 
-    rw->Append<IndexOf("asid")>(ctx->metadata_state()->asid());
-    rw->Append<IndexOf("address")>(smap.ToAddress());
-    rw->Append<IndexOf("offset")>(stats_[current_idx_].offset);
-    rw->Append<IndexOf("pathname")>(stats_[current_idx_].pathname);
-    rw->Append<IndexOf("size_bytes")>(stats_[current_idx_].size_bytes);
-    rw->Append<IndexOf("kernel_page_size_bytes")>(stats_[current_idx_].kernel_page_size_bytes);
-    rw->Append<IndexOf("mmu_page_size_bytes")>(stats_[current_idx_].mmu_page_size_bytes);
-    rw->Append<IndexOf("rss_bytes")>(stats_[current_idx_].rss_bytes);
-    rw->Append<IndexOf("pss_bytes")>(stats_[current_idx_].pss_bytes);
-    rw->Append<IndexOf("shared_clean_bytes")>(stats_[current_idx_].shared_clean_bytes);
-    rw->Append<IndexOf("shared_dirty_bytes")>(stats_[current_idx_].shared_dirty_bytes);
-    rw->Append<IndexOf("private_clean_bytes")>(stats_[current_idx_].private_clean_bytes);
-    rw->Append<IndexOf("private_dirty_bytes")>(stats_[current_idx_].private_dirty_bytes);
-    rw->Append<IndexOf("referenced_bytes")>(stats_[current_idx_].referenced_bytes);
-    rw->Append<IndexOf("anonymous_bytes")>(stats_[current_idx_].anonymous_bytes);
-    rw->Append<IndexOf("lazy_free_bytes")>(stats_[current_idx_].lazy_free_bytes);
-    rw->Append<IndexOf("anon_huge_pages_bytes")>(stats_[current_idx_].anon_huge_pages_bytes);
-    rw->Append<IndexOf("shmem_pmd_mapped_bytes")>(stats_[current_idx_].shmem_pmd_mapped_bytes);
-    rw->Append<IndexOf("file_pmd_mapped_bytes")>(stats_[current_idx_].file_pmd_mapped_bytes);
-    rw->Append<IndexOf("shared_hugetlb_bytes")>(stats_[current_idx_].shared_hugetlb_bytes);
-    rw->Append<IndexOf("private_hugetlb_bytes")>(stats_[current_idx_].private_hugetlb_bytes);
-    rw->Append<IndexOf("swap_bytes")>(stats_[current_idx_].swap_bytes);
-    rw->Append<IndexOf("swap_pss_bytes")>(stats_[current_idx_].swap_pss_bytes);
-    rw->Append<IndexOf("locked_bytes")>(stats_[current_idx_].locked_bytes);
-
-    ++current_idx_;
-    return static_cast<size_t>(current_idx_) < stats_.size();
+    std::vector<int64_t> asids(end - current_idx_, ctx->metadata_state()->asid());
+    cw->AppendValues<IndexOf("asid")>(asids.begin(), asids.end());
+    std::vector<std::string> addresses;
+    addresses.reserve(end - current_idx_);
+    for (size_t i = current_idx_; i < end; ++i) {
+      addresses.push_back(stats_[i].ToAddress());
+    }
+    cw->AppendValues<IndexOf("address")>(addresses.begin(), addresses.end());
+
+    AppendField<IndexOf("offset")>(cw, end, &ProcParser::ProcessSMaps::offset);
+    AppendField<IndexOf("pathname")>(cw, end, &ProcParser::ProcessSMaps::pathname);
+    AppendField<IndexOf("size_bytes")>(cw, end, &ProcParser::ProcessSMaps::size_bytes);
+    AppendField<IndexOf("kernel_page_size_bytes")>(
+        cw, end, &ProcParser::ProcessSMaps::kernel_page_size_bytes);
+    AppendField<IndexOf("mmu_page_size_bytes")>(cw, end,
+                                                &ProcParser::ProcessSMaps::mmu_page_size_bytes);
+    AppendField<IndexOf("rss_bytes")>(cw, end, &ProcParser::ProcessSMaps::rss_bytes);
+    AppendField<IndexOf("pss_bytes")>(cw, end, &ProcParser::ProcessSMaps::pss_bytes);
+    AppendField<IndexOf("shared_clean_bytes")>(cw, end,
+                                               &ProcParser::ProcessSMaps::shared_clean_bytes);
+    AppendField<IndexOf("shared_dirty_bytes")>(cw, end,
+                                               &ProcParser::ProcessSMaps::shared_dirty_bytes);
+    AppendField<IndexOf("private_clean_bytes")>(cw, end,
+                                                &ProcParser::ProcessSMaps::private_clean_bytes);
+    AppendField<IndexOf("private_dirty_bytes")>(cw, end,
+                                                &ProcParser::ProcessSMaps::private_dirty_bytes);
+    AppendField<IndexOf("referenced_bytes")>(cw, end, &ProcParser::ProcessSMaps::referenced_bytes);
+    AppendField<IndexOf("anonymous_bytes")>(cw, end, &ProcParser::ProcessSMaps::anonymous_bytes);
+    AppendField<IndexOf("lazy_free_bytes")>(cw, end, &ProcParser::ProcessSMaps::lazy_free_bytes);
+    AppendField<IndexOf("anon_huge_pages_bytes")>(
+        cw, end, &ProcParser::ProcessSMaps::anon_huge_pages_bytes);
+    AppendField<IndexOf("shmem_pmd_mapped_bytes")>(
+        cw, end, &ProcParser::ProcessSMaps::shmem_pmd_mapped_bytes);
+    AppendField<IndexOf("file_pmd_mapped_bytes")>(
+        cw, end, &ProcParser::ProcessSMaps::file_pmd_mapped_bytes);
+    AppendField<IndexOf("shared_hugetlb_bytes")>(cw, end,
+                                                 &ProcParser::ProcessSMaps::shared_hugetlb_bytes);
+    AppendField<IndexOf("private_hugetlb_bytes")>(
+        cw, end, &ProcParser::ProcessSMaps::private_hugetlb_bytes);
+    AppendField<IndexOf("swap_bytes")>(cw, end, &ProcParser::ProcessSMaps::swap_bytes);
+    AppendField<IndexOf("swap_pss_bytes")>(cw, end, &ProcParser::ProcessSMaps::swap_pss_bytes);
+    AppendField<IndexOf("locked_bytes")>(cw, end, &ProcParser::ProcessSMaps::locked_bytes);
+
+    current_idx_ = end;
+    return current_idx_ < stats_.size();
   }
 
  private:
+  // Appends one field of the mappings in [current_idx_, end) to the column.
+  template <size_t idx, typename TField>
+  void AppendField(ColumnWriter* cw, size_t end, TField ProcParser::ProcessSMaps::*field) {
+    std::vector<TField> values;
+    values.reserve(end - current_idx_);
+    for (size_t i = current_idx_; i < end; ++i) {
+      values.push_back(stats_[i].*field);
+    }
+    cw->AppendValues<idx>(values.begin(), values.end());
+  }
+
   std::vector<ProcParser::ProcessSMaps> stats_;
-  int current_idx_ = 0;
+  size_t current_idx_ = 0;
 };
 
 class HeapReleaseFreeMemoryUDTF final : public carnot::udf::UDTF<HeapReleaseFreeMemoryUDTF> {
@@ -363,21 +392,39 @@ class HeapRangesUDTF final : public carnot::udf::UDTF<HeapRangesUDTF> {
 #endif
     return Status::OK();
   }
-  bool NextRecord(FunctionContext* ctx, RecordWriter* rw) {
+  // tcmalloc may report thousands of ranges, so they are written a column at a time.
+  bool NextBatch(FunctionContext* ctx, int max_records, ColumnWriter* cw) {
 #ifdef TCMALLOC
-    if (idx_ >= ranges_.size()) {
-      return false;
+    size_t end = std::min(idx_ + max_records, ranges_.size());
+    size_t n = end - idx_;
+
+    std::vector<int64_t> asids(n, ctx->metadata_state()->asid());
+    std::vector<int64_t> addresses;
+    std::vector<std::string_view> types;
+    std::vector<int64_t> lengths;
+    std::vector<double> inuse_fractions;
+    addresses.reserve(n);
+    types.reserve(n);
+    lengths.reserve(n);
+    inuse_fractions.reserve(n);
+    for (size_t i = idx_; i < end; ++i) {
+      addresses.push_back(static_cast<int64_t>(ranges_[i].address));
+      types.push_back(magic_enum::enum_name(ranges_[i].type));
+      lengths.push_back(ranges_[i].length);
+      inuse_fractions.push_back(ranges_[i].fraction);
     }
-    rw->Append<IndexOf("asid")>(ctx->metadata_state()->asid());
-    rw->Append<IndexOf("address")>(static_cast<int64_t>(ranges_[idx_].address));
-    rw->Append<IndexOf("type")>(std::string(magic_enum::enum_name(ranges_[idx_].type)));
-    rw->Append<IndexOf("length")>(ranges_[idx_].length);
-    rw->Append<IndexOf("inuse_fraction")>(ranges_[idx_].fraction);
-    idx_++;
+    cw->AppendValues<IndexOf("asid")>(asids.begin(), asids.end());
+    cw->AppendValues<IndexOf("address")>(addresses.begin(), addresses.end());
+    cw->AppendValues<IndexOf("type")>(types.begin(), types.end());
+    cw->AppendValues<IndexOf("length")>(lengths.begin(), lengths.end());
+    cw->AppendValues<IndexOf("inuse_fraction")>(inuse_fractions.begin(), inuse_fractions.end());
+
+    idx_ = end;
     return idx_ < ranges_.size();
 #else
     PL_UNUSED(ctx);
-    PL_UNUSED(rw);
+    PL_UNUSED(max_records);
+    PL_UNUSED(cw);
     return false;
 #endif
   }
@@ -22,6 +22,7 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -132,33 +133,26 @@ class GetTables final : public carnot::udf::UDTF<GetTables> {
     }
 
     for (const auto& [table_name, rel] : resp.schema().relation_map()) {
-      table_info_.emplace_back(table_name, rel.desc());
+      table_names_.push_back(table_name);
+      table_descs_.push_back(rel.desc());
     }
     return Status::OK();
   }
 
-  bool NextRecord(FunctionContext*, RecordWriter* rw) {
-    if (!table_info_.size()) {
-      return false;
-    }
-    const auto& r = table_info_[idx_];
-    rw->Append<IndexOf("table_name")>(r.table_name);
-    rw->Append<IndexOf("table_desc")>(r.table_desc);
-
-    idx_++;
-    return idx_ < static_cast<int>(table_info_.size());
+  bool NextBatch(FunctionContext*, int max_records, ColumnWriter* cw) {
+    size_t end = std::min(idx_ + max_records, table_names_.size());
+    cw->AppendValues<IndexOf("table_name")>(table_names_.begin() + idx_,
+                                            table_names_.begin() + end);
+    cw->AppendValues<IndexOf("table_desc")>(table_descs_.begin() + idx_,
+                                            table_descs_.begin() + end);
+    idx_ = end;
+    return idx_ < table_names_.size();
   }
 
  private:
-  struct TableInfo {
-    TableInfo(const std::string& table_name, const std::string& table_desc)
-        : table_name(table_name), table_desc(table_desc) {}
-    std::string table_name;
-    std::string table_desc;
-  };
-
-  int idx_ = 0;
-  std::vector<TableInfo> table_info_;
+  size_t idx_ = 0;
+  std::vector<std::string> table_names_;
+  std::vector<std::string> table_descs_;
   std::shared_ptr<MDSStub> stub_;
   std::function<void(grpc::ClientContext*)> add_context_authentication_func_;
 };
@@ -201,53 +195,41 @@ class GetTableSchemas final : public carnot::udf::UDTF<GetTableSchemas> {
       return error::Internal("Failed to make RPC call to metadata service");
     }
 
-    // TODO(zasgar): We store the data since it's hard to traverse two maps at once. We should
-    // either do that or perhaps have an interface that allows UDTFs to write multiple records in
-    // a single invocation.
     for (const auto& [table_name, rel] : resp.schema().relation_map()) {
       for (const auto& col : rel.columns()) {
-        relation_info_.emplace_back(
-            table_name, col.column_name(), std::string(magic_enum::enum_name(col.column_type())),
-            std::string(types::ToString(col.pattern_type())), col.column_desc());
+        table_names_.push_back(table_name);
+        column_names_.push_back(col.column_name());
+        column_types_.emplace_back(magic_enum::enum_name(col.column_type()));
+        pattern_types_.emplace_back(types::ToString(col.pattern_type()));
+        column_descs_.push_back(col.column_desc());
       }
     }
     return Status::OK();
   }
 
-  bool NextRecord(FunctionContext*, RecordWriter* rw) {
-    if (!relation_info_.size()) {
-      return false;
-    }
-    const auto& r = relation_info_[idx_];
-    rw->Append<IndexOf("table_name")>(r.table_name);
-    rw->Append<IndexOf("column_name")>(r.column_name);
-    rw->Append<IndexOf("column_type")>(r.column_type);
-    rw->Append<IndexOf("pattern_type")>(r.pattern_type);
-    rw->Append<IndexOf("column_desc")>(r.column_desc);
-
-    idx_++;
-    return idx_ < static_cast<int>(relation_info_.size());
+  bool NextBatch(FunctionContext*, int max_records, ColumnWriter* cw) {
+    size_t end = std::min(idx_ + max_records, table_names_.size());
+    cw->AppendValues<IndexOf("table_name")>(table_names_.begin() + idx_,
+                                            table_names_.begin() + end);
+    cw->AppendValues<IndexOf("column_name")>(column_names_.begin() + idx_,
+                                             column_names_.begin() + end);
+    cw->AppendValues<IndexOf("column_type")>(column_types_.begin() + idx_,
+                                             column_types_.begin() + end);
+    cw->AppendValues<IndexOf("pattern_type")>(pattern_types_.begin() + idx_,
+                                              pattern_types_.begin() + end);
+    cw->AppendValues<IndexOf("column_desc")>(column_descs_.begin() + idx_,
+                                             column_descs_.begin() + end);
+    idx_ = end;
+    return idx_ < table_names_.size();
   }
 
  private:
-  struct RelationInfo {
-    RelationInfo(const std::string& table_name, const std::string& column_name,
-                 const std::string& column_type, const std::string& pattern_type,
-                 const std::string& column_desc)
-        : table_name(table_name),
-          column_name(column_name),
-          column_type(column_type),
-          pattern_type(pattern_type),
-          column_desc(column_desc) {}
-    std::string table_name;
-    std::string column_name;
-    std::string column_type;
-    std::string pattern_type;
-    std::string column_desc;
-  };
-
-  int idx_ = 0;
-  std::vector<RelationInfo> relation_info_;
+  size_t idx_ = 0;
+  std::vector<std::string> table_names_;
+  std::vector<std::string> column_names_;
+  std::vector<std::string> column_types_;
+  std::vector<std::string> pattern_types_;
+  std::vector<std::string> column_descs_;
   std::shared_ptr<MDSStub> stub_;
   std::function<void(grpc::ClientContext*)> add_context_authentication_func_;
 };
@@ -285,44 +267,63 @@ class GetAgentStatus final : public carnot::udf::UDTF<GetAgentStatus> {
 
   Status Init(FunctionContext*) {
     px::vizier::services::metadata::AgentInfoRequest req;
-    resp_ = std::make_unique<px::vizier::services::metadata::AgentInfoResponse>();
+    px::vizier::services::metadata::AgentInfoResponse resp;
 
     grpc::ClientContext ctx;
     add_context_authentication_func_(&ctx);
-    auto s = stub_->GetAgentInfo(&ctx, req, resp_.get());
+    auto s = stub_->GetAgentInfo(&ctx, req, &resp);
     if (!s.ok()) {
       return error::Internal("Failed to make RPC call to GetAgentInfo");
     }
-    return Status::OK();
-  }
 
-  bool NextRecord(FunctionContext*, RecordWriter* rw) {
-    const auto& agent_metadata = resp_->info(idx_);
-    const auto& agent_info = agent_metadata.agent();
-    const auto& agent_status = agent_metadata.status();
+    for (const auto& agent_metadata : resp.info()) {
+      const auto& agent_info = agent_metadata.agent();
+      const auto& agent_status = agent_metadata.status();
 
-    auto u_or_s = ParseUUID(agent_info.info().agent_id());
-    sole::uuid u;
-    if (u_or_s.ok()) {
-      u = u_or_s.ConsumeValueOrDie();
+      auto u_or_s = ParseUUID(agent_info.info().agent_id());
+      sole::uuid u;
+      if (u_or_s.ok()) {
+        u = u_or_s.ConsumeValueOrDie();
+      }
+      // TODO(zasgar): Figure out abort mechanism;
+
+      agent_ids_.push_back(absl::MakeUint128(u.ab, u.cd));
+      asids_.push_back(agent_info.asid());
+      hostnames_.push_back(agent_info.info().host_info().hostname());
+      ip_addresses_.push_back(agent_info.info().ip_address());
+      agent_states_.emplace_back(magic_enum::enum_name(agent_status.state()));
+      create_times_.push_back(agent_info.create_time_ns());
+      last_heartbeats_.push_back(agent_status.ns_since_last_heartbeat());
     }
-    // TODO(zasgar): Figure out abort mechanism;
-
-    rw->Append<IndexOf("agent_id")>(absl::MakeUint128(u.ab, u.cd));
-    rw->Append<IndexOf("asid")>(agent_info.asid());
-    rw->Append<IndexOf("hostname")>(agent_info.info().host_info().hostname());
-    rw->Append<IndexOf("ip_address")>(agent_info.info().ip_address());
-    rw->Append<IndexOf("agent_state")>(StringValue(magic_enum::enum_name(agent_status.state())));
-    rw->Append<IndexOf("create_time")>(agent_info.create_time_ns());
-    rw->Append<IndexOf("last_heartbeat_ns")>(agent_status.ns_since_last_heartbeat());
+    return Status::OK();
+  }
 
-    ++idx_;
-    return idx_ < resp_->info_size();
+  bool NextBatch(FunctionContext*, int max_records, ColumnWriter* cw) {
+    size_t end = std::min(idx_ + max_records, agent_ids_.size());
+    cw->AppendValues<IndexOf("agent_id")>(agent_ids_.begin() + idx_, agent_ids_.begin() + end);
+    cw->AppendValues<IndexOf("asid")>(asids_.begin() + idx_, asids_.begin() + end);
+    cw->AppendValues<IndexOf("hostname")>(hostnames_.begin() + idx_, hostnames_.begin() + end);
+    cw->AppendValues<IndexOf("ip_address")>(ip_addresses_.begin() + idx_,
+                                            ip_addresses_.begin() + end);
+    cw->AppendValues<IndexOf("agent_state")>(agent_states_.begin() + idx_,
+                                             agent_states_.begin() + end);
+    cw->AppendValues<IndexOf("create_time")>(create_times_.begin() + idx_,
+                                             create_times_.begin() + end);
+    cw->AppendValues<IndexOf("last_heartbeat_ns")>(last_heartbeats_.begin() + idx_,
+                                                   last_heartbeats_.begin() + end);
+    idx_ = end;
+    return idx_ < agent_ids_.size();
   }
 
  private:
-  int idx_ = 0;
-  std::unique_ptr<px::vizier::services::metadata::AgentInfoResponse> resp_;
+  size_t idx_ = 0;
+  std::vector<absl::uint128> agent_ids_;
+  std::vector<int64_t> asids_;
+  std::vector<std::string> hostnames_;
+  std::vector<std::string> ip_addresses_;
+  std::vector<std::string> agent_states_;
+  std::vector<int64_t> create_times_;
+  std::vector<int64_t> last_heartbeats_;
   std::shared_ptr<MDSStub> stub_;
   std::function<void(grpc::ClientContext*)> add_context_authentication_func_;
 };
@@ -674,41 +675,67 @@ class GetDebugTableInfo final : public carnot::udf::UDTF<GetDebugTableInfo> {
                 "The minimum timestamp currently present in this table. -1 if there is no time_ "
                 "column on the table."));
   }
-  Status Init(FunctionContext*) {
-    table_ids_ = table_store_->GetTableIDs();
+  Status Init(FunctionContext* ctx) {
+    int64_t asid = ctx->metadata_state()->asid();
+    for (uint64_t id : table_store_->GetTableIDs()) {
+      auto info = table_store_->GetTable(id)->GetTableStats();
+      asids_.push_back(asid);
+      names_.push_back(table_store_->GetTableName(id));
+      ids_.push_back(id);
+      batches_added_.push_back(info.batches_added);
+      batches_expired_.push_back(info.batches_expired);
+      bytes_added_.push_back(info.bytes_added);
+      num_batches_.push_back(info.num_batches);
+      compacted_batches_.push_back(info.compacted_batches);
+      sizes_.push_back(info.bytes);
+      cold_sizes_.push_back(info.cold_bytes);
+      max_table_sizes_.push_back(info.max_table_size);
+      min_times_.push_back(info.min_time);
+    }
     return Status::OK();
   }
 
-  bool NextRecord(FunctionContext* ctx, RecordWriter* rw) {
-    if (static_cast<size_t>(current_idx_) >= table_ids_.size()) {
-      return false;
-    }
-
-    uint64_t selected_id = table_ids_[current_idx_];
-    const auto* table = table_store_->GetTable(selected_id);
-    auto info = table->GetTableStats();
-
-    rw->Append<IndexOf("asid")>(ctx->metadata_state()->asid());
-    rw->Append<IndexOf("name")>(table_store_->GetTableName(selected_id));
-    rw->Append<IndexOf("id")>(selected_id);
-    rw->Append<IndexOf("batches_added")>(info.batches_added);
-    rw->Append<IndexOf("batches_expired")>(info.batches_expired);
-    rw->Append<IndexOf("bytes_added")>(info.bytes_added);
-    rw->Append<IndexOf("num_batches")>(info.num_batches);
-    rw->Append<IndexOf("compacted_batches")>(info.compacted_batches);
-    rw->Append<IndexOf("size")>(info.bytes);
-    rw->Append<IndexOf("cold_size")>(info.cold_bytes);
-    rw->Append<IndexOf("max_table_size")>(info.max_table_size);
-    rw->Append<IndexOf("min_time")>(info.min_time);
-
-    ++current_idx_;
-    return static_cast<size_t>(current_idx_) < table_ids_.size();
+  bool NextBatch(FunctionContext*, int max_records, ColumnWriter* cw) {
+    size_t end = std::min(current_idx_ + max_records, ids_.size());
+    cw->AppendValues<IndexOf("asid")>(asids_.begin() + current_idx_, asids_.begin() + end);
+    cw->AppendValues<IndexOf("name")>(names_.begin() + current_idx_, names_.begin() + end);
+    cw->AppendValues<IndexOf("id")>(ids_.begin() + current_idx_, ids_.begin() + end);
+    cw->AppendValues<IndexOf("batches_added")>(batches_added_.begin() + current_idx_,
+                                               batches_added_.begin() + end);
+    cw->AppendValues<IndexOf("batches_expired")>(batches_expired_.begin() + current_idx_,
+                                                 batches_expired_.begin() + end);
+    cw->AppendValues<IndexOf("bytes_added")>(bytes_added_.begin() + current_idx_,
+                                             bytes_added_.begin() + end);
+    cw->AppendValues<IndexOf("num_batches")>(num_batches_.begin() + current_idx_,
+                                             num_batches_.begin() + end);
+    cw->AppendValues<IndexOf("compacted_batches")>(compacted_batches_.begin() + current_idx_,
+                                                   compacted_batches_.begin() + end);
+    cw->AppendValues<IndexOf("size")>(sizes_.begin() + current_idx_, sizes_.begin() + end);
+    cw->AppendValues<IndexOf("cold_size")>(cold_sizes_.begin() + current_idx_,
+                                           cold_sizes_.begin() + end);
+    cw->AppendValues<IndexOf("max_table_size")>(max_table_sizes_.begin() + current_idx_,
+                                                max_table_sizes_.begin() + end);
+    cw->AppendValues<IndexOf("min_time")>(min_times_.begin() + current_idx_,
+                                          min_times_.begin() + end);
+    current_idx_ = end;
+    return current_idx_ < ids_.size();
   }
 
  private:
   const ::px::table_store::TableStore* table_store_;
-  int current_idx_ = 0;
-  std::vector<uint64_t> table_ids_;
+  size_t current_idx_ = 0;
+  std::vector<int64_t> asids_;
+  std::vector<std::string> names_;
+  std::vector<int64_t> ids_;
+  std::vector<int64_t> batches_added_;
+  std::vector<int64_t> batches_expired_;
+  std::vector<int64_t> bytes_added_;
+  std::vector<int64_t> num_batches_;
+  std::vector<int64_t> compacted_batches_;
+  std::vector<int64_t> sizes_;
+  std::vector<int64_t> cold_sizes_;
+  std::vector<int64_t> max_table_sizes_;
+  std::vector<int64_t> min_times_;
 };
 
 /**
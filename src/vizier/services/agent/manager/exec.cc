@@ -26,6 +26,7 @@
 
 #include "src/common/base/base.h"
 #include "src/common/event/task.h"
+#include "src/common/metrics/metrics.h"
 #include "src/common/perf/perf.h"
 #include "src/vizier/services/agent/manager/manager.h"
 
@@ -51,7 +52,11 @@ class ExecuteQueryMessageHandler::ExecuteQueryTask : public AsyncTask {
     LOG(INFO) << absl::Substitute("Executing query: id=$0", query_id_.str());
     VLOG(1) << absl::Substitute("Query Plan: $0=$1", query_id_.str(), req_.plan().DebugString());
 
-    auto s = carnot_->ExecutePlan(req_.plan(), query_id_, req_.analyze());
+    Status s;
+    {
+      px::metrics::ScopedHistogramTimer timer(&query_latency_histogram());
+      s = carnot_->ExecutePlan(req_.plan(), query_id_, req_.analyze());
+    }
     if (!s.ok()) {
       if (s.code() == px::statuspb::Code::CANCELLED) {
         LOG(WARNING) << absl::Substitute("Cancelled query: $0", query_id_.str());
@@ -67,6 +72,12 @@ class ExecuteQueryMessageHandler::ExecuteQueryTask : public AsyncTask {
   void Done() override { parent_->HandleQueryExecutionComplete(query_id_); }
 
  private:
+  static px::metrics::ShardedHistogram& query_latency_histogram() {
+    return GetOrCreateHistogramFamily("agent_query_latency_seconds",
+                                      "End-to-end latency of query fragments executed on the agent")
+        .Add({});
+  }
+
   ExecuteQueryMessageHandler* parent_;
   carnot::Carnot* carnot_;
 
@@ -357,8 +357,7 @@ Status Manager::PostRegisterHook(uint32_t asid) {
       // Returning without calling EnableTimer to prevent future timer calls.
       return;
     }
-    auto& registry = GetMetricsRegistry();
-    auto metrics = registry.Collect();
+    auto metrics = CollectMetrics();
     int64_t timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                                std::chrono::system_clock::now().time_since_epoch())
                                .count();
@@ -38,6 +38,8 @@ namespace px {
 namespace vizier {
 namespace agent {
 
+PEMManager::~PEMManager() { StopTableStoreSnapshots(); }
+
 Status PEMManager::InitImpl() {
   PL_RETURN_IF_ERROR(InitClockConverters());
   StartNodeMemoryCollector();
@@ -45,9 +47,17 @@ Status PEMManager::InitImpl() {
 }
 
 Status PEMManager::PostRegisterHookImpl() {
-  stirling_->RegisterDataPushCallback(std::bind(&table_store::TableStore::AppendData, table_store(),
-                                                std::placeholders::_1, std::placeholders::_2,
-                                                std::placeholders::_3));
+  if (FLAGS_table_store_async_ingest) {
+    // Stirling only queues its batches; a writer thread appends them to the table store.
+    ingest_queue_ = std::make_unique<table_store::IngestQueue>(table_store());
+    stirling_->RegisterDataPushCallback(std::bind(&table_store::IngestQueue::AppendData,
+                                                  ingest_queue_.get(), std::placeholders::_1,
+                                                  std::placeholders::_2, std::placeholders::_3));
+  } else {
+    stirling_->RegisterDataPushCallback(std::bind(&table_store::TableStore::AppendData,
+                                                  table_store(), std::placeholders::_1,
+                                                  std::placeholders::_2, std::placeholders::_3));
+  }
 
   // Enable use of USR1/USR2 for controlling Stirling debug.
   stirling_->RegisterUserDebugSignalHandlers();
@@ -57,6 +67,11 @@ Status PEMManager::PostRegisterHookImpl() {
       std::bind(&px::md::AgentMetadataStateManager::CurrentAgentMetadataState, mds_manager()));
 
   PL_RETURN_IF_ERROR(InitSchemas());
+  // Snapshots must be restored before Stirling starts writing to the tables.
+  PL_RETURN_IF_ERROR(InitTableStoreSnapshots());
+  if (ingest_queue_ != nullptr) {
+    ingest_queue_->Start();
+  }
   PL_RETURN_IF_ERROR(stirling_->RunAsThread());
 
   auto execute_query_handler = std::make_shared<ExecuteQueryMessageHandler>(
@@ -73,8 +88,13 @@ Status PEMManager::PostRegisterHookImpl() {
 }
 
 Status PEMManager::StopImpl(std::chrono::milliseconds) {
+  StopTableStoreSnapshots();
   stirling_->Stop();
   stirling_.reset();
+  // Only stopped after Stirling, so that the last pushed batches make it to the table store.
+  if (ingest_queue_ != nullptr) {
+    ingest_queue_->Stop();
+  }
   return Status::OK();
 }
 
@@ -107,6 +127,67 @@ Status PEMManager::InitSchemas() {
   return Status::OK();
 }
 
+Status PEMManager::InitTableStoreSnapshots() {
+  if (FLAGS_table_store_snapshot_dir.empty()) {
+    return Status::OK();
+  }
+  table_store_snapshotter_ = std::make_unique<table_store::TableStoreSnapshotter>(
+      FLAGS_table_store_snapshot_dir, table_store(),
+      FLAGS_table_store_snapshot_max_bytes_per_pass);
+  auto restore_stats_or_s = table_store_snapshotter_->Restore();
+  LOG_IF(ERROR, !restore_stats_or_s.ok())
+      << "Failed to restore table store snapshots: " << restore_stats_or_s.msg();
+
+  // The timer is only re-armed once the pass it requested has completed, so passes never overlap.
+  table_store_snapshot_timer_ = dispatcher()->CreateTimer([this]() {
+    absl::MutexLock lock(&table_store_snapshot_lock_);
+    table_store_snapshot_requested_ = true;
+    table_store_snapshot_cv_.Signal();
+  });
+  table_store_snapshot_thread_ = std::thread(&PEMManager::RunTableStoreSnapshots, this);
+  table_store_snapshot_timer_->EnableTimer(kTableStoreSnapshotPeriod);
+  return Status::OK();
+}
+
+void PEMManager::RunTableStoreSnapshots() {
+  while (true) {
+    {
+      absl::MutexLock lock(&table_store_snapshot_lock_);
+      while (!table_store_snapshot_requested_ && !table_store_snapshot_stopped_) {
+        table_store_snapshot_cv_.Wait(&table_store_snapshot_lock_);
+      }
+      if (table_store_snapshot_stopped_) {
+        return;
+      }
+      table_store_snapshot_requested_ = false;
+    }
+
+    auto stats_or_s = table_store_snapshotter_->Snapshot();
+    Status s = stats_or_s.status();
+    auto stats = stats_or_s.ok() ? stats_or_s.ConsumeValueOrDie()
+                                 : table_store::TableStoreSnapshotter::SnapshotStats{};
+    dispatcher()->Post([this, s, stats]() {
+      LOG_IF(ERROR, !s.ok()) << "Failed to snapshot table store: " << s.msg();
+      VLOG(1) << "Table store snapshot wrote " << stats.batches_written << " batches ("
+              << stats.bytes_written << " bytes), removed " << stats.batches_removed;
+      if (table_store_snapshot_timer_) {
+        table_store_snapshot_timer_->EnableTimer(kTableStoreSnapshotPeriod);
+      }
+    });
+  }
+}
+
+void PEMManager::StopTableStoreSnapshots() {
+  {
+    absl::MutexLock lock(&table_store_snapshot_lock_);
+    table_store_snapshot_stopped_ = true;
+    table_store_snapshot_cv_.Signal();
+  }
+  if (table_store_snapshot_thread_.joinable()) {
+    table_store_snapshot_thread_.join();
+  }
+}
+
 Status PEMManager::InitClockConverters() {
   clock_converter_timer_ = dispatcher()->CreateTimer([this]() {
     auto clock_converter = px::system::Config::GetInstance().clock_converter();
@@ -22,11 +22,15 @@
 #include <memory>
 #include <numeric>
 #include <string>
+#include <thread>
 #include <utility>
 
+#include <absl/synchronization/mutex.h>
 #include <prometheus/gauge.h>
 
 #include "src/stirling/stirling.h"
+#include "src/table_store/table/ingest_queue.h"
+#include "src/table_store/table/table_snapshot.h"
 #include "src/vizier/services/agent/manager/manager.h"
 #include "src/vizier/services/agent/pem/tracepoint_manager.h"
 
@@ -35,6 +39,7 @@ namespace vizier {
 namespace agent {
 
 constexpr auto kNodeMemoryCollectionPeriod = std::chrono::minutes(1);
+constexpr auto kTableStoreSnapshotPeriod = std::chrono::minutes(1);
 
 class PEMManager : public Manager {
  public:
@@ -45,7 +50,7 @@ class PEMManager : public Manager {
     return std::unique_ptr<Manager>(std::move(m));
   }
 
-  ~PEMManager() override = default;
+  ~PEMManager() override;
 
  protected:
   PEMManager() = delete;
@@ -83,12 +88,18 @@ class PEMManager : public Manager {
   Status InitSchemas();
   Status InitClockConverters();
   void StartNodeMemoryCollector();
+  Status InitTableStoreSnapshots();
+  void RunTableStoreSnapshots();
+  void StopTableStoreSnapshots();
   static services::shared::agent::AgentCapabilities Capabilities() {
     services::shared::agent::AgentCapabilities capabilities;
     capabilities.set_collects_data(true);
     return capabilities;
   }
 
+  // Queues the data pushed by Stirling for the table store, if async ingest is enabled. Declared
+  // before stirling_, so that it outlives Stirling's data push callbacks on destruction.
+  std::unique_ptr<table_store::IngestQueue> ingest_queue_;
   std::unique_ptr<stirling::Stirling> stirling_;
   std::shared_ptr<TracepointManager> tracepoint_manager_;
 
@@ -98,6 +109,17 @@ class PEMManager : public Manager {
   px::event::TimerUPtr node_memory_timer_;
   prometheus::Gauge& node_available_memory_;
   prometheus::Gauge& node_total_memory_;
+
+  // Persists the cold data of the table store, so that it survives restarts. The timer runs on
+  // the dispatcher and only requests a pass; the disk writes run on the snapshot thread, which
+  // posts the result back to the dispatcher to re-arm the timer.
+  std::unique_ptr<table_store::TableStoreSnapshotter> table_store_snapshotter_;
+  px::event::TimerUPtr table_store_snapshot_timer_;
+  absl::Mutex table_store_snapshot_lock_;
+  absl::CondVar table_store_snapshot_cv_;
+  bool table_store_snapshot_requested_ ABSL_GUARDED_BY(table_store_snapshot_lock_) = false;
+  bool table_store_snapshot_stopped_ ABSL_GUARDED_BY(table_store_snapshot_lock_) = false;
+  std::thread table_store_snapshot_thread_;
 };
 
 }  // namespace agent